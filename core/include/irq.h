@@ -66,6 +66,16 @@ void irq_restore(unsigned state);
  */
 int irq_is_in(void);
 
+/**
+ * @brief   Check whether interrupts are currently enabled
+ *
+ * Code that may sleep, e.g. by waiting on a mutex, must not do so while
+ * interrupts are disabled, as nothing could wake it up.
+ *
+ * @return  true, if interrupts are enabled, false if not
+ */
+int irq_is_enabled(void);
+
 #ifdef __cplusplus
 }
 #endif
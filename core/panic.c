@@ -36,6 +36,14 @@
 #include "ps.h"
 #endif
 
+#ifdef MODULE_LOG_DEFERRED
+#include "log_deferred.h"
+#endif
+
+#ifdef MODULE_STDIO_UART_TXBUF
+#include "stdio_uart.h"
+#endif
+
 const char assert_crash_message[] = "FAILED ASSERTION.";
 
 /* flag preventing "recursive crash printing loop" */
@@ -53,6 +61,10 @@ NORETURN void core_panic(core_panic_t crash_code, const char *message)
     if (crashed == 0) {
         /* print panic message to console (if possible) */
         crashed = 1;
+#ifdef MODULE_STDIO_UART_TXBUF
+        /* the buffered output may wait for a lock or an interrupt */
+        stdio_uart_panic();
+#endif
 #ifndef NDEBUG
         if (crash_code == PANIC_ASSERT_FAIL) {
             cpu_print_last_instruction();
@@ -68,6 +80,9 @@ NORETURN void core_panic(core_panic_t crash_code, const char *message)
         LOG_ERROR("*** halted.\n\n");
 #else
         LOG_ERROR("*** rebooting...\n\n");
+#endif
+#ifdef MODULE_LOG_DEFERRED
+        log_deferred_panic();
 #endif
     }
     /* disable watchdog and all possible sources of interrupts */
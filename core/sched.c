@@ -37,6 +37,10 @@
 #include "xtimer.h"
 #endif
 
+#ifdef MODULE_SCHED_ROUND_ROBIN
+#include "sched_round_robin.h"
+#endif
+
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
@@ -132,6 +136,10 @@ int __attribute__((used)) sched_run(void)
     }
 #endif
 
+#ifdef MODULE_SCHED_ROUND_ROBIN
+    sched_round_robin_update(next_thread);
+#endif
+
     next_thread->status = STATUS_RUNNING;
     sched_active_pid = next_thread->pid;
     sched_active_thread = (volatile thread_t *) next_thread;
@@ -166,6 +174,14 @@ void sched_set_status(thread_t *process, unsigned int status)
                   process->pid, process->priority);
             clist_rpush(&sched_runqueues[process->priority], &(process->rq_entry));
             runqueue_bitcache |= 1 << process->priority;
+#ifdef MODULE_SCHED_ROUND_ROBIN
+            /* the active thread may have got a sibling to share time with */
+            thread_t *active_thread = (thread_t *)sched_active_thread;
+            if (active_thread && (active_thread != process) &&
+                (active_thread->priority == process->priority)) {
+                sched_round_robin_update(active_thread);
+            }
+#endif
         }
     }
     else {
@@ -216,6 +232,10 @@ NORETURN void sched_task_exit(void)
     sched_threads[sched_active_pid] = NULL;
     sched_num_threads--;
 
+#ifdef MODULE_SCHED_ROUND_ROBIN
+    sched_round_robin_exit(sched_active_pid);
+#endif
+
     sched_set_status((thread_t *)sched_active_thread, STATUS_STOPPED);
 
     sched_active_thread = NULL;
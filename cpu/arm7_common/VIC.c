@@ -48,6 +48,11 @@ unsigned irq_restore(unsigned oldCPSR)
     return _cpsr;
 }
 
+int irq_is_enabled(void)
+{
+    return (__get_cpsr() & IRQ_MASK) == 0;
+}
+
 unsigned IRQenabled(void)
 {
     unsigned _cpsr;
@@ -89,3 +89,11 @@ int irq_is_in(void)
 {
     return __in_isr;
 }
+
+/**
+ * @brief Check if interrupts are enabled
+ */
+int irq_is_enabled(void)
+{
+    return (__get_interrupt_state() != 0);
+}
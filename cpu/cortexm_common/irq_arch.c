@@ -56,3 +56,11 @@ int irq_is_in(void)
 {
     return (__get_IPSR() & 0xFF);
 }
+
+/**
+ * @brief Check if interrupts are enabled
+ */
+int irq_is_enabled(void)
+{
+    return (__get_PRIMASK() == 0);
+}
@@ -85,3 +85,14 @@ int IRAM irq_is_in(void)
     DEBUG("irq_interrupt_nesting = %d\n", irq_interrupt_nesting);
     return irq_interrupt_nesting;
 }
+
+/**
+ * @brief Check if interrupts are enabled, i.e. the interrupt level is 0
+ */
+int IRAM irq_is_enabled(void)
+{
+    uint32_t ps;
+
+    __asm__ volatile ("rsr %0, ps" : "=a" (ps));
+    return (ps & 0xf) == 0;
+}
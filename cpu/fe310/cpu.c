@@ -129,6 +129,14 @@ int irq_is_in(void)
     return __in_isr;
 }
 
+/**
+ * @brief Check if interrupts are enabled
+ */
+int irq_is_enabled(void)
+{
+    return (read_csr(mstatus) & MSTATUS_MIE) != 0;
+}
+
 /**
  * @brief   Set External ISR callback
  */
@@ -40,3 +40,8 @@ int irq_is_in(void)
 {
     return (mips32_get_c0(C0_STATUS) & SR_EXL) != 0;
 }
+
+int irq_is_enabled(void)
+{
+    return (mips32_get_c0(C0_STATUS) & SR_IE) != 0;
+}
@@ -63,3 +63,10 @@ int irq_is_in(void)
 {
     return __irq_is_in;
 }
+
+int irq_is_enabled(void)
+{
+    unsigned int state;
+    __asm__("mov.w r2,%0" : "=r"(state));
+    return (state & GIE) != 0;
+}
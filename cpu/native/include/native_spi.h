@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     cpu_native
+ * @defgroup    cpu_native_spi Native SPI emulation
+ * @{
+ *
+ * @file
+ * @brief       Emulated SPI bus and device models for native
+ *
+ * Devices are attached to an emulated SPI bus together with the GPIO pin used
+ * as their chip select line. A device is selected while its chip select pin
+ * is low, no matter whether the pin is driven by the SPI driver or by the
+ * user of the bus. Bytes transferred on the bus are exchanged with the
+ * selected device. Toggling the bus' clock pin (see @ref spi_conf_t) while a
+ * device is selected emulates bit-banged access.
+ *
+ * Two device models are provided by the `native_spi_dev` module: an SD card
+ * in SPI mode (SDHC, block addressing) and a NOR flash using the common
+ * M25P16 command set.
+ */
+
+#ifndef NATIVE_SPI_H
+#define NATIVE_SPI_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "periph/spi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Forward declaration of the emulated device type
+ */
+typedef struct native_spi_dev native_spi_dev_t;
+
+/**
+ * @brief   Interface of an emulated SPI device
+ *
+ * For each byte transferred on the bus, @p tx is called first to get the byte
+ * shifted out by the device, followed by @p rx with the byte shifted in.
+ */
+typedef struct {
+    void (*select)(native_spi_dev_t *dev, bool selected); /**< chip select
+                                                             *   changed */
+    uint8_t (*tx)(native_spi_dev_t *dev);               /**< get next byte */
+    void (*rx)(native_spi_dev_t *dev, uint8_t data);    /**< take a byte */
+} native_spi_dev_driver_t;
+
+/**
+ * @brief   Emulated SPI device
+ */
+struct native_spi_dev {
+    native_spi_dev_t *next;                 /**< next device on the bus */
+    const native_spi_dev_driver_t *driver;  /**< device model */
+    gpio_t cs;                              /**< chip select pin */
+    bool selected;                          /**< chip select is active */
+};
+
+/**
+ * @brief   Attach an emulated device to the given bus
+ *
+ * @param[in] bus       SPI bus to attach @p dev to
+ * @param[in] dev       device to attach, its driver must be set
+ * @param[in] cs        chip select pin of @p dev
+ */
+void native_spi_attach(spi_t bus, native_spi_dev_t *dev, gpio_t cs);
+
+/**
+ * @brief   Notify the SPI emulation about a changed pin
+ *
+ * @internal    called by the GPIO emulation
+ *
+ * @param[in] pin       pin that changed
+ * @param[in] value     new value of @p pin
+ */
+void native_spi_gpio_changed(gpio_t pin, int value);
+
+/**
+ * @brief   Get the value of a pin driven by an emulated device
+ *
+ * @internal    called by the GPIO emulation
+ *
+ * @param[in] pin       pin to read
+ *
+ * @return  value of @p pin
+ * @return  -1 if @p pin is not driven by an emulated device
+ */
+int native_spi_gpio_read(gpio_t pin);
+
+/**
+ * @name    SD card model
+ * @{
+ */
+/**
+ * @brief   Block size of the emulated SD card
+ */
+#define NATIVE_SDCARD_BLOCK_SIZE    (512U)
+
+/**
+ * @brief   Number of busy bytes the card sends after each written block
+ */
+#ifndef NATIVE_SDCARD_BUSY_BYTES
+#define NATIVE_SDCARD_BUSY_BYTES    (8U)
+#endif
+
+/**
+ * @brief   Emulated SD card
+ */
+typedef struct {
+    native_spi_dev_t dev;       /**< SPI device */
+    uint8_t *mem;               /**< card contents */
+    uint32_t blocks;            /**< number of blocks in @p mem */
+    uint32_t addr;              /**< current block of a read or write */
+    uint16_t out_pos;           /**< next byte of @p out to send */
+    uint16_t out_len;           /**< number of bytes in @p out */
+    uint16_t data_len;          /**< bytes of a written block received */
+    uint16_t busy;              /**< busy bytes left to send */
+    uint8_t state;              /**< command processing state */
+    uint8_t cmd_len;            /**< bytes of @p cmd received */
+    bool idle;                  /**< card is in idle state */
+    bool app_cmd;               /**< next command is an application command */
+    bool crc_on;                /**< check CRCs of commands and data */
+    uint8_t cmd[6];             /**< command being received */
+    /** response being sent: Ncr, R1, Nac, token, data block and CRC */
+    uint8_t out[4 + NATIVE_SDCARD_BLOCK_SIZE + 2];
+    uint8_t data[NATIVE_SDCARD_BLOCK_SIZE + 2]; /**< block being written */
+} native_sdcard_t;
+
+/**
+ * @brief   Initialize an emulated SD card
+ *
+ * The capacity reported by the card is rounded down to a multiple of 512 KiB,
+ * as dictated by the CSD register.
+ *
+ * @param[out] card     card to initialize
+ * @param[in]  mem      memory holding the card contents
+ * @param[in]  size     size of @p mem in bytes, at least 512 KiB
+ */
+void native_sdcard_init(native_sdcard_t *card, uint8_t *mem, size_t size);
+/** @} */
+
+/**
+ * @name    NOR flash model
+ * @{
+ */
+/**
+ * @brief   Page size of the emulated NOR flash
+ */
+#define NATIVE_SPI_NOR_PAGE_SIZE    (256U)
+
+/**
+ * @brief   Size of the smallest erasable sector of the emulated NOR flash
+ */
+#define NATIVE_SPI_NOR_SECTOR_SIZE  (4096U)
+
+/**
+ * @brief   Emulated page program time in microseconds
+ */
+#ifndef NATIVE_SPI_NOR_PAGE_US
+#define NATIVE_SPI_NOR_PAGE_US      (700U)
+#endif
+
+/**
+ * @brief   Emulated erase time per 4 KiB sector in microseconds
+ */
+#ifndef NATIVE_SPI_NOR_ERASE_US
+#define NATIVE_SPI_NOR_ERASE_US     (5000U)
+#endif
+
+/**
+ * @brief   Emulated NOR flash
+ */
+typedef struct {
+    native_spi_dev_t dev;       /**< SPI device */
+    uint8_t *mem;               /**< flash contents */
+    size_t size;                /**< size of @p mem */
+    uint32_t busy_until;        /**< end of the current program or erase */
+    uint32_t addr;              /**< address of the current command */
+    uint32_t pos;               /**< bytes received since selection */
+    uint8_t cmd;                /**< current command */
+    bool busy;                  /**< program or erase in progress */
+    bool wel;                   /**< write enable latch */
+    bool programmed;            /**< data was programmed by the command */
+} native_spi_nor_t;
+
+/**
+ * @brief   Initialize an emulated NOR flash
+ *
+ * @param[out] nor      flash to initialize
+ * @param[in]  mem      memory holding the flash contents
+ * @param[in]  size     size of @p mem in bytes, multiple of
+ *                      @ref NATIVE_SPI_NOR_SECTOR_SIZE, at most 16 MiB
+ */
+void native_spi_nor_init(native_spi_nor_t *nor, uint8_t *mem, size_t size);
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NATIVE_SPI_H */
+/** @} */
@@ -27,6 +27,7 @@ extern "C" {
 #include <stdint.h>
 #include "net/netdev.h"
 
+#include "net/ethernet.h"
 #include "net/ethernet/hdr.h"
 
 #ifdef __MACH__
@@ -35,6 +36,18 @@ extern "C" {
 #include "net/if.h"
 #endif
 
+/**
+ * @brief   Number of received frames a tap interface can buffer
+ *
+ * When the tap interface signals incoming data, up to this many frames are
+ * read from the host at once and handed to the upper layer one after another
+ * within the same interrupt service round-trip. Frames that are not addressed
+ * to this interface are already dropped when they are read.
+ */
+#ifndef NETDEV_TAP_RX_BUF_NUMOF
+#define NETDEV_TAP_RX_BUF_NUMOF     (4U)
+#endif
+
 /**
  * @brief tap interface state
  */
@@ -44,6 +57,14 @@ typedef struct netdev_tap {
     int tap_fd;                         /**< host file descriptor for the TAP */
     uint8_t addr[ETHERNET_ADDR_LEN];    /**< The MAC address of the TAP */
     uint8_t promiscous;                 /**< Flag for promiscous mode */
+    uint8_t rx_head;                    /**< index of oldest frame in rx_buf */
+    uint8_t rx_num;                     /**< number of frames in rx_buf */
+    uint16_t rx_len[NETDEV_TAP_RX_BUF_NUMOF];   /**< lengths of buffered
+                                                 *   frames */
+    /**
+     * @brief   Ring of received frames
+     */
+    uint8_t rx_buf[NETDEV_TAP_RX_BUF_NUMOF][ETHERNET_FRAME_LEN];
 } netdev_tap_t;
 
 /**
@@ -16,6 +16,8 @@
 #ifndef PERIPH_CONF_H
 #define PERIPH_CONF_H
 
+#include "periph_cpu.h"
+
 #ifdef __cplusplus
  extern "C" {
 #endif
@@ -70,6 +72,24 @@
 #ifndef UART_NUMOF
 #define UART_NUMOF (1U)
 #endif
+
+/**
+ * @brief   Emulate the transmission time of the configured baudrate
+ *
+ * If set to 1, uart_write() blocks as long as sending the data would take on
+ * a real UART, and uart_tx_start() paces its callback like a UART with a
+ * transmit FIFO of @ref NATIVE_UART_TX_FIFO_SIZE bytes.
+ */
+#ifndef NATIVE_UART_EMULATE_BAUDRATE
+#define NATIVE_UART_EMULATE_BAUDRATE    (0)
+#endif
+
+/**
+ * @brief   Size of the emulated transmit FIFO
+ */
+#ifndef NATIVE_UART_TX_FIFO_SIZE
+#define NATIVE_UART_TX_FIFO_SIZE        (16U)
+#endif
 /** @} */
 
 /**
@@ -79,6 +99,23 @@
 #define QDEC_NUMOF (8U)
 #endif
 
+/**
+ * @brief SPI configuration
+ *
+ * The pins match the default bit-bang pins of the sdcard_spi driver.
+ * @{
+ */
+static const spi_conf_t spi_config[] = {
+    {
+        .clk  = 5,
+        .mosi = 6,
+        .miso = 7,
+    }
+};
+
+#define SPI_NUMOF           (sizeof(spi_config) / sizeof(spi_config[0]))
+/** @} */
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,8 +19,6 @@
 #ifndef PERIPH_CPU_H
 #define PERIPH_CPU_H
 
-#include "periph/dev_enums.h"
-
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -32,6 +30,17 @@ extern "C" {
 #define CPUID_LEN           (4U)
 #endif
 
+/**
+ * @brief   Number of emulated GPIO pins, GPIO_PIN(x, y) maps to pin y
+ */
+#define NATIVE_GPIO_NUMOF   (32U)
+
+/**
+ * @brief   Native GPIO pins are plain numbers
+ */
+#define HAVE_GPIO_T
+typedef unsigned int gpio_t;
+
 /**
  * @brief   Prevent shared timer functions from being used
  */
@@ -45,6 +54,28 @@ extern "C" {
 #define PROVIDES_PM_SET_LOWEST
 /** @} */
 
+/**
+ * @name    SPI configuration
+ * @{
+ */
+#define PERIPH_SPI_NEEDS_INIT_CS
+#define PERIPH_SPI_NEEDS_TRANSFER_BYTE
+#define PERIPH_SPI_NEEDS_TRANSFER_REG
+#define PERIPH_SPI_NEEDS_TRANSFER_REGS
+
+/**
+ * @brief   Pins of an emulated SPI bus
+ *
+ * The pins are only used to emulate bit-banged access to the devices attached
+ * to the bus, see @ref native_spi.h.
+ */
+typedef struct {
+    gpio_t clk;             /**< SCK pin */
+    gpio_t mosi;            /**< MOSI pin */
+    gpio_t miso;            /**< MISO pin */
+} spi_conf_t;
+/** @} */
+
 #ifdef __cplusplus
 }
 #endif
@@ -34,23 +34,70 @@ extern "C" {
 /* 127 - 25 as in at86rf2xx */
 #define SOCKET_ZEP_FRAME_PAYLOAD_LEN    (102)   /**< maximum possible payload size */
 
+/**
+ * @brief   Number of received ZEP datagrams a device can buffer
+ *
+ * When the socket signals incoming data, up to this many datagrams are
+ * fetched from the host at once (with a single `recvmmsg()` call on Linux)
+ * and handed to the upper layer one after another within the same interrupt
+ * service round-trip.
+ */
+#ifndef SOCKET_ZEP_RX_BUF_NUMOF
+#define SOCKET_ZEP_RX_BUF_NUMOF         (4U)
+#endif
+
+/**
+ * @brief   Number of outgoing ZEP datagrams a device can batch
+ *
+ * With a value larger than 1, sent frames are queued and written to the host
+ * with a single `sendmmsg()` call on Linux once either the queue is full or
+ * the device's ISR is serviced, i.e. when the thread driving the device has
+ * processed all sends that were already waiting for it. In this mode
+ * @ref NETDEV_EVENT_TX_COMPLETE is signaled when the batch is written and
+ * @ref NETDEV_EVENT_TX_STARTED is not signaled at all.
+ *
+ * The default of 1 sends every frame immediately.
+ */
+#ifndef SOCKET_ZEP_TX_BUF_NUMOF
+#define SOCKET_ZEP_TX_BUF_NUMOF         (1U)
+#endif
+
+/**
+ * @brief   Size of a buffer holding a complete ZEP datagram
+ */
+#define SOCKET_ZEP_BUF_SIZE     (sizeof(zep_v2_data_hdr_t) + \
+                                 IEEE802154_FRAME_LEN_MAX)
+
 /**
  * @brief   ZEP device state
  */
 typedef struct {
     netdev_ieee802154_t netdev;     /**< netdev internal member */
     int sock_fd;                    /**< socket fd */
-    netdev_event_t last_event;      /**< event triggered */
+    volatile uint8_t events;        /**< pending events to handle in ISR */
+    uint8_t rcv_head;               /**< index of oldest datagram in rcv_buf */
+    uint8_t rcv_num;                /**< number of datagrams in rcv_buf */
     uint32_t seq;                   /**< ZEP sequence number */
+    uint16_t rcv_len[SOCKET_ZEP_RX_BUF_NUMOF];  /**< datagram lengths in
+                                                 *   rcv_buf */
     /**
      * @brief   Receive buffer
      */
-    uint8_t rcv_buf[sizeof(zep_v2_data_hdr_t) + IEEE802154_FRAME_LEN_MAX];
+    uint8_t rcv_buf[SOCKET_ZEP_RX_BUF_NUMOF][SOCKET_ZEP_BUF_SIZE];
     /**
      * @brief   Buffer for send header
      */
     uint8_t snd_hdr_buf[sizeof(zep_v2_data_hdr_t)];
     uint16_t chksum_buf;            /**< buffer for send checksum calculation */
+#if (SOCKET_ZEP_TX_BUF_NUMOF > 1) || defined(DOXYGEN)
+    uint8_t snd_num;                /**< number of datagrams in snd_buf */
+    uint16_t snd_len[SOCKET_ZEP_TX_BUF_NUMOF];  /**< datagram lengths in
+                                                 *   snd_buf */
+    /**
+     * @brief   Send buffer for batched datagrams
+     */
+    uint8_t snd_buf[SOCKET_ZEP_TX_BUF_NUMOF][SOCKET_ZEP_BUF_SIZE];
+#endif
 } socket_zep_t;
 
 /**
@@ -145,6 +145,9 @@ void native_print_signals(void)
 
 /**
  * block signals
+ *
+ * With NATIVE_VIRTUAL_IRQ the signals are not blocked in the kernel, they
+ * are only recorded by native_isr_entry() while the flag is cleared.
  */
 unsigned irq_disable(void)
 {
@@ -157,12 +160,18 @@ unsigned irq_disable(void)
         DEBUG("irq_disable + _native_in_isr\n");
     }
 
+#ifndef NATIVE_VIRTUAL_IRQ
     if (sigprocmask(SIG_SETMASK, &_native_sig_set_dint, NULL) == -1) {
         err(EXIT_FAILURE, "irq_disable: sigprocmask");
     }
+#endif
 
     prev_state = native_interrupts_enabled;
     native_interrupts_enabled = 0;
+#ifdef NATIVE_VIRTUAL_IRQ
+    /* the flag is the only mask, keep the critical section behind it */
+    __asm__ volatile ("" : : : "memory");
+#endif
 
     DEBUG("irq_disable(): return\n");
     _native_syscall_leave();
@@ -193,12 +202,18 @@ unsigned irq_enable(void)
      */
 
     prev_state = native_interrupts_enabled;
+#ifdef NATIVE_VIRTUAL_IRQ
+    __asm__ volatile ("" : : : "memory");
+    native_interrupts_enabled = 1;
+#else
     native_interrupts_enabled = 1;
 
     if (sigprocmask(SIG_SETMASK, &_native_sig_set, NULL) == -1) {
         err(EXIT_FAILURE, "irq_enable: sigprocmask");
     }
+#endif
 
+    /* handles signals which became pending while interrupts were disabled */
     _native_syscall_leave();
 
     DEBUG("irq_enable(): return\n");
@@ -226,6 +241,11 @@ int irq_is_in(void)
     return _native_in_isr;
 }
 
+int irq_is_enabled(void)
+{
+    return native_interrupts_enabled;
+}
+
 int _native_popsig(void)
 {
     int nread, nleft, i;
@@ -276,7 +296,13 @@ void native_irq_handler(void)
 
 void isr_set_sigmask(ucontext_t *ctx)
 {
+#ifdef NATIVE_VIRTUAL_IRQ
+    /* irq_enable() does not unblock anything, so the interrupted thread
+     * must keep its mask */
+    (void)ctx;
+#else
     ctx->uc_sigmask = _native_sig_set_dint;
+#endif
     native_interrupts_enabled = 0;
 }
 
@@ -306,7 +332,8 @@ void native_isr_entry(int sig, siginfo_t *info, void *context)
     }
 
     /* XXX: Workaround safety check - whenever this happens it really
-     * indicates a bug in irq_disable */
+     * indicates a bug in irq_disable, except with NATIVE_VIRTUAL_IRQ where
+     * the signal stays pending until irq_enable() */
     if (native_interrupts_enabled == 0) {
         //printf("interrupts are off, but I caught a signal.\n");
         return;
@@ -541,6 +568,11 @@ void native_interrupt_init(void)
         err(EXIT_FAILURE, "native_interrupt_init: sigaction");
     }
 
+#ifdef NATIVE_VIRTUAL_IRQ
+    /* threads never block signals, so the ISR context has to */
+    native_isr_context.uc_sigmask = _native_sig_set_dint;
+#endif
+
 
     puts("RIOT native interrupts/signals initialized.");
 }
@@ -68,6 +68,7 @@
 static int _init(netdev_t *netdev);
 static int _send(netdev_t *netdev, const iolist_t *iolist);
 static int _recv(netdev_t *netdev, void *buf, size_t n, void *info);
+static void _isr(netdev_t *netdev);
 
 static inline void _get_mac_addr(netdev_t *netdev, uint8_t *dst)
 {
@@ -94,18 +95,6 @@ static inline int _set_promiscous(netdev_t *netdev, int value)
     return value;
 }
 
-static inline void _isr(netdev_t *netdev)
-{
-    if (netdev->event_callback) {
-        netdev->event_callback(netdev, NETDEV_EVENT_RX_COMPLETE);
-    }
-#if DEVELHELP
-    else {
-        puts("netdev_tap: _isr(): no event_callback set.");
-    }
-#endif
-}
-
 static int _get(netdev_t *dev, netopt_t opt, void *value, size_t max_len)
 {
     int res = 0;
@@ -204,77 +193,141 @@ static void _continue_reading(netdev_tap_t *dev)
     _native_in_syscall--;
 }
 
-static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
+static inline bool _dst_not_me(netdev_tap_t *dev, uint8_t *frame)
 {
-    netdev_tap_t *dev = (netdev_tap_t*)netdev;
-    (void)info;
+    ethernet_hdr_t *hdr = (ethernet_hdr_t *)frame;
+
+    if (!(dev->promiscous) && !_is_addr_multicast(hdr->dst) &&
+        !_is_addr_broadcast(hdr->dst) &&
+        (memcmp(hdr->dst, dev->addr, ETHERNET_ADDR_LEN) != 0)) {
+        DEBUG("netdev_tap: received for %02x:%02x:%02x:%02x:%02x:%02x\n"
+              "That's not me => Dropped\n",
+              hdr->dst[0], hdr->dst[1], hdr->dst[2],
+              hdr->dst[3], hdr->dst[4], hdr->dst[5]);
+        return true;
+    }
+    return false;
+}
 
-    if (!buf) {
-        if (len > 0) {
-            /* no memory available in pktbuf, discarding the frame */
-            DEBUG("netdev_tap: discarding the frame\n");
+/**
+ * @brief   Reads as many frames from the TAP as fit into the RX ring
+ *
+ * @return  true, if the TAP might still hold frames after the ring is full
+ * @return  false, if the TAP was drained
+ */
+static bool _fill_rx_buf(netdev_tap_t *dev)
+{
+    while (dev->rx_num < NETDEV_TAP_RX_BUF_NUMOF) {
+        unsigned idx = (dev->rx_head + dev->rx_num) % NETDEV_TAP_RX_BUF_NUMOF;
+        int nread = _native_read(dev->tap_fd, dev->rx_buf[idx],
+                                 sizeof(dev->rx_buf[idx]));
 
-            /* repeating `real_read` for small size on tap device results in
-             * freeze for some reason. Using a large buffer for now. */
-            /*
-            uint8_t buf[4];
-            while (real_read(dev->tap_fd, buf, sizeof(buf)) > 0) {
+        DEBUG("netdev_tap: read %d bytes\n", nread);
+        if (nread > 0) {
+#ifdef MODULE_NETSTATS_L2
+            /* a TAP read returns a single frame */
+            dev->netdev.stats.rx_batches++;
+#endif
+            if (!_dst_not_me(dev, dev->rx_buf[idx])) {
+                dev->rx_len[idx] = (uint16_t)nread;
+                dev->rx_num++;
             }
-            */
-
-            static uint8_t buf[ETHERNET_FRAME_LEN];
+        }
+        else if (nread == -1) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                err(EXIT_FAILURE, "netdev_tap: read");
+            }
+            return false;
+        }
+        else if (nread == 0) {
+            DEBUG("_native_handle_tap_input: ignoring null-event\n");
+            return false;
+        }
+        else {
+            errx(EXIT_FAILURE, "internal error _rx_event");
+        }
+    }
+    return true;
+}
 
-            real_read(dev->tap_fd, buf, sizeof(buf));
+static inline void _drop_rx_buf_head(netdev_tap_t *dev)
+{
+    dev->rx_head = (dev->rx_head + 1) % NETDEV_TAP_RX_BUF_NUMOF;
+    dev->rx_num--;
+}
 
-            _continue_reading(dev);
-        }
+static void _isr(netdev_t *netdev)
+{
+    netdev_tap_t *dev = (netdev_tap_t*)netdev;
 
-        /* no way of figuring out packet size without racey buffering,
-         * so we return the maximum possible size */
-        return ETHERNET_FRAME_LEN;
+    if (!netdev->event_callback) {
+#if DEVELHELP
+        puts("netdev_tap: _isr(): no event_callback set.");
+#endif
+        return;
     }
 
-    int nread = real_read(dev->tap_fd, buf, len);
-    DEBUG("netdev_tap: read %d bytes\n", nread);
+    bool more = _fill_rx_buf(dev);
 
-    if (nread > 0) {
-        ethernet_hdr_t *hdr = (ethernet_hdr_t *)buf;
-        if (!(dev->promiscous) && !_is_addr_multicast(hdr->dst) &&
-            !_is_addr_broadcast(hdr->dst) &&
-            (memcmp(hdr->dst, dev->addr, ETHERNET_ADDR_LEN) != 0)) {
-            DEBUG("netdev_tap: received for %02x:%02x:%02x:%02x:%02x:%02x\n"
-                  "That's not me => Dropped\n",
-                  hdr->dst[0], hdr->dst[1], hdr->dst[2],
-                  hdr->dst[3], hdr->dst[4], hdr->dst[5]);
+    /* hand all frames read in one go to the upper layer */
+    while (dev->rx_num > 0) {
+        unsigned num = dev->rx_num;
 
-            native_async_read_continue(dev->tap_fd);
-
-            return 0;
+        netdev->event_callback(netdev, NETDEV_EVENT_RX_COMPLETE);
+        if (dev->rx_num == num) {
+            /* upper layer did not fetch the frame, drop it to make progress */
+            _drop_rx_buf_head(dev);
         }
+    }
 
+    if (more) {
+        /* ring was full, there might be more frames waiting */
         _continue_reading(dev);
+    }
+    else {
+        native_async_read_continue(dev->tap_fd);
+    }
+}
 
-#ifdef MODULE_NETSTATS_L2
-        netdev->stats.rx_count++;
-        netdev->stats.rx_bytes += nread;
-#endif
-        return nread;
+static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
+{
+    netdev_tap_t *dev = (netdev_tap_t*)netdev;
+    (void)info;
+
+    if ((dev->rx_num == 0) && _fill_rx_buf(dev)) {
+        /* the ring was empty, so _fill_rx_buf() can only report more frames
+         * if there are at least NETDEV_TAP_RX_BUF_NUMOF of them */
+        _continue_reading(dev);
     }
-    else if (nread == -1) {
-        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
-        }
-        else {
-            err(EXIT_FAILURE, "netdev_tap: read");
-        }
+    if (dev->rx_num == 0) {
+        return (buf == NULL) ? 0 : -1;
     }
-    else if (nread == 0) {
-        DEBUG("_native_handle_tap_input: ignoring null-event\n");
+
+    unsigned idx = dev->rx_head;
+    int nread = dev->rx_len[idx];
+
+    if (!buf) {
+        if (len > 0) {
+            /* no memory available in pktbuf, discarding the frame */
+            DEBUG("netdev_tap: discarding the frame\n");
+            _drop_rx_buf_head(dev);
+        }
+        return nread;
     }
-    else {
-        errx(EXIT_FAILURE, "internal error _rx_event");
+
+    if ((size_t)nread > len) {
+        DEBUG("netdev_tap: frame does not fit into buffer\n");
+        _drop_rx_buf_head(dev);
+        return -ENOBUFS;
     }
+    memcpy(buf, dev->rx_buf[idx], nread);
+    _drop_rx_buf_head(dev);
 
-    return -1;
+#ifdef MODULE_NETSTATS_L2
+    netdev->stats.rx_count++;
+    netdev->stats.rx_bytes += nread;
+#endif
+    return nread;
 }
 
 static int _send(netdev_t *netdev, const iolist_t *iolist)
@@ -288,6 +341,7 @@ static int _send(netdev_t *netdev, const iolist_t *iolist)
 
     int res = _native_writev(dev->tap_fd, iov, n);
 #ifdef MODULE_NETSTATS_L2
+    netdev->stats.tx_batches++;
     netdev->stats.tx_bytes += bytes;
 #else
     (void)bytes;
@@ -341,6 +395,8 @@ static int _init(netdev_t *netdev)
 #endif
     /* initialize device descriptor */
     dev->promiscous = 0;
+    dev->rx_head = 0;
+    dev->rx_num = 0;
     /* implicitly create the tap interface */
     if ((dev->tap_fd = real_open(clonedev, O_RDWR | O_NONBLOCK)) == -1) {
         err(EXIT_FAILURE, "open(%s)", clonedev);
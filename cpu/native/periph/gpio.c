@@ -12,40 +12,77 @@
  * @{
  *
  * @file
- * @brief       empty GPIO implementation
+ * @brief       GPIO emulation
+ *
+ * The pins only keep their state. Pins used by an emulated SPI bus forward
+ * their changes to the attached devices.
  *
  * @author      Takuo Yonezawa <Yonezawa-T2@mail.dnp.co.jp>
  */
 
+#include <stdint.h>
+
 #include "periph/gpio.h"
+#ifdef MODULE_PERIPH_SPI
+#include "native_spi.h"
+#endif
+
+static uint32_t _state;
 
 int gpio_init(gpio_t pin, gpio_mode_t mode) {
-  (void) pin;
-  (void) mode;
+  if (pin >= NATIVE_GPIO_NUMOF) {
+    return -1;
+  }
+  if (mode == GPIO_IN_PU) {
+    _state |= (1UL << pin);
+  }
+  else if (mode == GPIO_IN_PD) {
+    _state &= ~(1UL << pin);
+  }
 
-  return -1;
+  return 0;
 }
 
 int gpio_read(gpio_t pin) {
-  (void) pin;
+  if (pin >= NATIVE_GPIO_NUMOF) {
+    return 0;
+  }
+#ifdef MODULE_PERIPH_SPI
+  int res = native_spi_gpio_read(pin);
+  if (res >= 0) {
+    return res;
+  }
+#endif
 
-  return 0;
+  return (_state & (1UL << pin)) ? 1 : 0;
+}
+
+void gpio_write(gpio_t pin, int value) {
+  if (pin >= NATIVE_GPIO_NUMOF) {
+    return;
+  }
+
+  uint32_t mask = (1UL << pin);
+  if (!value == !(_state & mask)) {
+    return;
+  }
+  _state ^= mask;
+#ifdef MODULE_PERIPH_SPI
+  native_spi_gpio_changed(pin, value);
+#endif
 }
 
 void gpio_set(gpio_t pin) {
-  (void) pin;
+  gpio_write(pin, 1);
 }
 
 void gpio_clear(gpio_t pin) {
-  (void) pin;
+  gpio_write(pin, 0);
 }
 
 void gpio_toggle(gpio_t pin) {
-  (void) pin;
-}
-
-void gpio_write(gpio_t pin, int value) {
-  (void) pin;
-  (void) value;
+  if (pin < NATIVE_GPIO_NUMOF) {
+    gpio_write(pin, !(_state & (1UL << pin)));
+  }
 }
 /** @} */
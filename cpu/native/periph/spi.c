@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     cpu_native_spi
+ * @ingroup     drivers_periph_spi
+ * @{
+ *
+ * @file
+ * @brief       Emulated SPI bus
+ *
+ * @}
+ */
+
+#include <assert.h>
+
+#include "mutex.h"
+#include "native_spi.h"
+#include "periph/spi.h"
+
+/* state of an emulated bus */
+typedef struct {
+    mutex_t lock;
+    native_spi_dev_t *devs;     /* attached devices */
+    native_spi_dev_t *sel;      /* currently selected device */
+    uint8_t out;                /* byte shifted out by bit-banged access */
+    uint8_t in;                 /* byte shifted in by bit-banged access */
+    uint8_t bits;               /* bits of the current byte shifted */
+    uint8_t miso;               /* current MISO level */
+} _bus_t;
+
+static _bus_t _bus[SPI_NUMOF];
+
+void spi_init(spi_t bus)
+{
+    assert(bus < SPI_NUMOF);
+
+    mutex_init(&_bus[bus].lock);
+}
+
+void spi_init_pins(spi_t bus)
+{
+    (void)bus;
+}
+
+int spi_acquire(spi_t bus, spi_cs_t cs, spi_mode_t mode, spi_clk_t clk)
+{
+    (void)cs;
+    (void)mode;
+    (void)clk;
+
+    mutex_lock(&_bus[bus].lock);
+    return SPI_OK;
+}
+
+void spi_release(spi_t bus)
+{
+    mutex_unlock(&_bus[bus].lock);
+}
+
+void spi_transfer_bytes(spi_t bus, spi_cs_t cs, bool cont,
+                        const void *out, void *in, size_t len)
+{
+    const uint8_t *out_buf = out;
+    uint8_t *in_buf = in;
+
+    if (cs != SPI_CS_UNDEF) {
+        gpio_clear((gpio_t)cs);
+    }
+
+    native_spi_dev_t *dev = _bus[bus].sel;
+    for (size_t i = 0; i < len; i++) {
+        /* MISO is pulled up when no device drives it */
+        uint8_t tmp = (dev) ? dev->driver->tx(dev) : 0xff;
+        if (dev) {
+            dev->driver->rx(dev, (out_buf) ? out_buf[i] : 0xff);
+        }
+        /* only written after reading out_buf[i], so both may alias */
+        if (in_buf) {
+            in_buf[i] = tmp;
+        }
+    }
+
+    if ((!cont) && (cs != SPI_CS_UNDEF)) {
+        gpio_set((gpio_t)cs);
+    }
+}
+
+void native_spi_attach(spi_t bus, native_spi_dev_t *dev, gpio_t cs)
+{
+    assert((bus < SPI_NUMOF) && dev && dev->driver);
+
+    /* chip select lines are pulled up */
+    gpio_init(cs, GPIO_OUT);
+    gpio_set(cs);
+
+    dev->cs = cs;
+    dev->selected = false;
+    dev->next = _bus[bus].devs;
+    _bus[bus].devs = dev;
+}
+
+static void _clock(_bus_t *b, const spi_conf_t *conf)
+{
+    native_spi_dev_t *dev = b->sel;
+
+    if (b->bits == 0) {
+        b->out = dev->driver->tx(dev);
+    }
+    b->miso = (b->out >> (7 - b->bits)) & 0x1;
+    b->in = (b->in << 1) | (gpio_read(conf->mosi) ? 0x1 : 0x0);
+    if (++b->bits == 8) {
+        dev->driver->rx(dev, b->in);
+        b->bits = 0;
+    }
+}
+
+void native_spi_gpio_changed(gpio_t pin, int value)
+{
+    for (unsigned i = 0; i < SPI_NUMOF; i++) {
+        _bus_t *b = &_bus[i];
+
+        if ((pin == spi_config[i].clk) && value && b->sel) {
+            _clock(b, &spi_config[i]);
+            continue;
+        }
+
+        for (native_spi_dev_t *dev = b->devs; dev; dev = dev->next) {
+            if (dev->cs != pin) {
+                continue;
+            }
+            dev->selected = !value;
+            if (dev->driver->select) {
+                dev->driver->select(dev, dev->selected);
+            }
+            if (dev->selected) {
+                b->sel = dev;
+                b->bits = 0;
+            }
+            else if (b->sel == dev) {
+                b->sel = NULL;
+            }
+        }
+    }
+}
+
+int native_spi_gpio_read(gpio_t pin)
+{
+    for (unsigned i = 0; i < SPI_NUMOF; i++) {
+        if ((pin == spi_config[i].miso) && _bus[i].sel) {
+            return _bus[i].miso;
+        }
+    }
+    return -1;
+}
@@ -19,13 +19,20 @@
  * @}
  */
 
+#include <assert.h>
+#include <err.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 #include <termios.h>
+#include <time.h>
 #include <fcntl.h>
 
+#include "irq.h"
 #include "thread.h"
 #include "periph/uart.h"
 #include "native_internal.h"
@@ -49,6 +56,54 @@ static char *tty_device_filenames[UART_NUMOF];
  */
 static int tty_fds[UART_NUMOF];
 
+/**
+ * @brief baudrates the devices were initialized with
+ */
+static uint32_t _baudrate[UART_NUMOF];
+
+#define NS_PER_SEC  (1000000000ULL)
+
+/* interrupt driven transmission is emulated with a POSIX timer */
+#if defined(MODULE_PERIPH_UART_TX_IRQ) && NATIVE_UART_EMULATE_BAUDRATE && \
+    !defined(__MACH__)
+#define EMULATE_TX_IRQ  (1)
+#endif
+
+#ifdef MODULE_PERIPH_UART_TX_IRQ
+/**
+ * @brief state of interrupt driven transmission
+ */
+static struct {
+    uart_tx_cb_t cb;    /**< callback, NULL if idle */
+    void *arg;          /**< argument of the callback */
+    uint64_t next;      /**< time the emulated FIFO runs empty */
+} _tx[UART_NUMOF];
+#endif
+
+#ifdef EMULATE_TX_IRQ
+static timer_t _tx_timer;
+static bool _tx_timer_created;
+#endif
+
+static uint64_t _now_ns(void)
+{
+    struct timespec t;
+
+    real_clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * NS_PER_SEC + t.tv_nsec;
+}
+
+/**
+ * @brief time needed to send len bytes in 8N1 format
+ */
+static uint64_t _tx_time_ns(uart_t uart, size_t len)
+{
+    if (_baudrate[uart] == 0) {
+        return 0;
+    }
+    return ((uint64_t)len * 10 * NS_PER_SEC) / _baudrate[uart];
+}
+
 void tty_uart_setup(uart_t uart, const char *filename)
 {
     tty_device_filenames[uart] = strndup(filename, PATH_MAX - 1);
@@ -140,6 +195,7 @@ int uart_init(uart_t uart, uint32_t baudrate, uart_rx_cb_t rx_cb, void *arg)
         break;
     }
 
+    _baudrate[uart] = baudrate;
     cfsetospeed(&termios, speed);
     cfsetispeed(&termios, speed);
 
@@ -175,8 +231,125 @@ void uart_write(uart_t uart, const uint8_t *data, size_t len)
 
     DEBUG("\n");
 
+    uint64_t end = _now_ns() + _tx_time_ns(uart, len);
+
     _native_write(tty_fds[uart], data, len);
+
+    if (NATIVE_UART_EMULATE_BAUDRATE) {
+        while (_now_ns() < end) {}
+    }
+}
+
+#ifdef MODULE_PERIPH_UART_TX_IRQ
+/**
+ * @brief   fetch up to max bytes from the callback and write them
+ *
+ * @return  number of bytes written
+ */
+static size_t _tx_fill(uart_t uart, size_t max)
+{
+    uint8_t buf[NATIVE_UART_TX_FIFO_SIZE];
+    size_t n = 0;
+
+    while (n < max) {
+        int c = _tx[uart].cb(_tx[uart].arg);
+        if (c < 0) {
+            _tx[uart].cb = NULL;
+            break;
+        }
+        buf[n++] = (uint8_t)c;
+    }
+    if (n > 0) {
+        _native_write(tty_fds[uart], buf, n);
+    }
+    return n;
+}
+
+#ifdef EMULATE_TX_IRQ
+static void _tx_arm(void)
+{
+    uint64_t next = UINT64_MAX;
+
+    for (uart_t uart = 0; uart < UART_NUMOF; uart++) {
+        if (_tx[uart].cb && (_tx[uart].next < next)) {
+            next = _tx[uart].next;
+        }
+    }
+    if (next == UINT64_MAX) {
+        return;
+    }
+
+    struct itimerspec its = {
+        .it_value = { .tv_sec = next / NS_PER_SEC, .tv_nsec = next % NS_PER_SEC }
+    };
+    _native_syscall_enter();
+    if (timer_settime(_tx_timer, TIMER_ABSTIME, &its, NULL) == -1) {
+        err(EXIT_FAILURE, "uart: timer_settime");
+    }
+    _native_syscall_leave();
+}
+
+/**
+ * @brief emulated transmit FIFO empty interrupt
+ */
+static void _tx_isr(void)
+{
+    uint64_t now = _now_ns();
+
+    for (uart_t uart = 0; uart < UART_NUMOF; uart++) {
+        if (_tx[uart].cb && (_tx[uart].next <= now)) {
+            size_t n = _tx_fill(uart, NATIVE_UART_TX_FIFO_SIZE);
+            _tx[uart].next = now + _tx_time_ns(uart, n);
+        }
+    }
+    _tx_arm();
+}
+#endif /* EMULATE_TX_IRQ */
+
+void uart_tx_start(uart_t uart, uart_tx_cb_t cb, void *arg)
+{
+    assert((uart < UART_NUMOF) && (_tx[uart].cb == NULL));
+
+#ifdef EMULATE_TX_IRQ
+    if (_baudrate[uart] > 0) {
+        unsigned state = irq_disable();
+
+        if (!_tx_timer_created) {
+            struct sigevent sev = {
+                .sigev_notify = SIGEV_SIGNAL,
+                .sigev_signo = SIGVTALRM,
+            };
+            _native_syscall_enter();
+            if (timer_create(CLOCK_MONOTONIC, &sev, &_tx_timer) == -1) {
+                err(EXIT_FAILURE, "uart: timer_create");
+            }
+            _native_syscall_leave();
+            register_interrupt(SIGVTALRM, _tx_isr);
+            _tx_timer_created = true;
+        }
+
+        _tx[uart].cb = cb;
+        _tx[uart].arg = arg;
+        /* an idle transmitter takes the first bytes right away */
+        uint64_t now = _now_ns();
+        if (_tx[uart].next < now) {
+            _tx[uart].next = now;
+        }
+        _tx_arm();
+
+        irq_restore(state);
+        return;
+    }
+#endif
+
+    /* without emulation the data is written right away */
+    _tx[uart].cb = cb;
+    _tx[uart].arg = arg;
+    while (_tx[uart].cb) {
+        _tx_fill(uart, NATIVE_UART_TX_FIFO_SIZE);
+    }
 }
+#endif /* MODULE_PERIPH_UART_TX_IRQ */
 
 void uart_poweron(uart_t uart)
 {
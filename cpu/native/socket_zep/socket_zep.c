@@ -13,6 +13,10 @@
  * @author  Martine Lenders <m.lenders@fu-berlin.de>
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE     /* for recvmmsg() and sendmmsg() */
+#endif
+
 #include <assert.h>
 #include <err.h>
 #include <errno.h>
@@ -21,11 +25,13 @@
 #include <string.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <sys/socket.h>
 #include <sys/time.h>
 
 #include "async_read.h"
 #include "byteorder.h"
 #include "checksum/ucrc16.h"
+#include "irq.h"
 #include "native_internal.h"
 #include "random.h"
 
@@ -36,6 +42,26 @@
 
 #define _UNIX_NTP_ERA_OFFSET    (2208988800U)
 
+/**
+ * @name    Events pending for the device's ISR
+ * @{
+ */
+#define _EVENT_RX               (0x01)
+#define _EVENT_TX_STARTED       (0x02)
+#define _EVENT_TX_COMPLETE      (0x04)
+#define _EVENT_TX_FLUSH         (0x08)
+/** @} */
+
+static inline void _post_event(socket_zep_t *dev, uint8_t event)
+{
+    netdev_t *netdev = (netdev_t *)dev;
+    unsigned state = irq_disable();
+
+    dev->events |= event;
+    irq_restore(state);
+    netdev->event_callback(netdev, NETDEV_EVENT_ISR);
+}
+
 static size_t _zep_hdr_fill_v2_data(socket_zep_t *dev, zep_v2_data_hdr_t *hdr,
                                     size_t payload_len)
 {
@@ -92,6 +118,106 @@ static size_t _prep_vector(socket_zep_t *dev, const iolist_t *iolist,
     return bytes;
 }
 
+#if SOCKET_ZEP_TX_BUF_NUMOF > 1
+static void _flush_tx_buf(socket_zep_t *dev)
+{
+    netdev_t *netdev = (netdev_t *)dev;
+    unsigned num = dev->snd_num;
+    unsigned sent = 0;
+
+    if (num == 0) {
+        return;
+    }
+#ifdef __linux__
+    struct mmsghdr msgs[num];
+    struct iovec v[num];
+
+    memset(msgs, 0, sizeof(msgs));
+    for (unsigned i = 0; i < num; i++) {
+        v[i].iov_base = dev->snd_buf[i];
+        v[i].iov_len = dev->snd_len[i];
+        msgs[i].msg_hdr.msg_iov = &v[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    while (sent < num) {
+        /* a datagram that fails after others were sent only shortens the
+         * batch, its error is reported when retrying it */
+        _native_syscall_enter();
+        int res = sendmmsg(dev->sock_fd, &msgs[sent], num - sent, 0);
+        _native_syscall_leave();
+        if (res <= 0) {
+            DEBUG("socket_zep::flush: error writing packets: %s\n",
+                  strerror(errno));
+            break;
+        }
+#ifdef MODULE_NETSTATS_L2
+        netdev->stats.tx_batches++;
+#endif
+        sent += res;
+    }
+#else
+    for (; sent < num; sent++) {
+        if (_native_write(dev->sock_fd, dev->snd_buf[sent],
+                          dev->snd_len[sent]) < 0) {
+            DEBUG("socket_zep::flush: error writing packets: %s\n",
+                  strerror(errno));
+            break;
+        }
+#ifdef MODULE_NETSTATS_L2
+        netdev->stats.tx_batches++;
+#endif
+    }
+#endif
+    DEBUG("socket_zep::flush: sent %u of %u datagrams\n", sent, num);
+    dev->snd_num = 0;
+    if (netdev->event_callback) {
+        for (unsigned i = 0; i < num; i++) {
+            netdev->event_callback(netdev, (i < sent)
+                                           ? NETDEV_EVENT_TX_COMPLETE
+                                           : NETDEV_EVENT_TX_MEDIUM_BUSY);
+        }
+    }
+}
+
+static int _send(netdev_t *netdev, const iolist_t *iolist)
+{
+    socket_zep_t *dev = (socket_zep_t *)netdev;
+    unsigned n = iolist_count(iolist);
+    struct iovec v[n + 2];
+    uint8_t *ptr;
+    size_t bytes;
+    unsigned idx;
+
+    assert((dev != NULL) && (dev->sock_fd != 0));
+    bytes = _prep_vector(dev, iolist, n, v);
+    if ((v[0].iov_len + bytes) > SOCKET_ZEP_BUF_SIZE) {
+        return -EOVERFLOW;
+    }
+    DEBUG("socket_zep::send(%p, %p, %u)\n", (void *)netdev, (void *)iolist, n);
+    /* the iolist is handed back to the caller on return, so the datagram
+     * needs to be copied into the batch */
+    idx = dev->snd_num++;
+    ptr = dev->snd_buf[idx];
+    for (unsigned i = 0; i < (n + 2); i++) {
+        memcpy(ptr, v[i].iov_base, v[i].iov_len);
+        ptr += v[i].iov_len;
+    }
+    dev->snd_len[idx] = ptr - dev->snd_buf[idx];
+    if ((dev->snd_num == SOCKET_ZEP_TX_BUF_NUMOF) || !netdev->event_callback) {
+        _flush_tx_buf(dev);
+    }
+    else if (dev->snd_num == 1) {
+        /* the ISR is serviced after all sends already queued for the driving
+         * thread, so flush then */
+        _post_event(dev, _EVENT_TX_FLUSH);
+    }
+#ifdef MODULE_NETSTATS_L2
+    netdev->stats.tx_bytes += bytes;
+#endif
+
+    return bytes - sizeof(uint16_t);
+}
+#else   /* SOCKET_ZEP_TX_BUF_NUMOF > 1 */
 static int _send(netdev_t *netdev, const iolist_t *iolist)
 {
     socket_zep_t *dev = (socket_zep_t *)netdev;
@@ -105,8 +231,7 @@ static int _send(netdev_t *netdev, const iolist_t *iolist)
     DEBUG("socket_zep::send(%p, %p, %u)\n", (void *)netdev, (void *)iolist, n);
     /* simulate TX_STARTED interrupt */
     if (netdev->event_callback) {
-        dev->last_event = NETDEV_EVENT_TX_STARTED;
-        netdev->event_callback(netdev, NETDEV_EVENT_ISR);
+        _post_event(dev, _EVENT_TX_STARTED);
         thread_yield();
     }
     res = writev(dev->sock_fd, v, n + 2);
@@ -116,11 +241,11 @@ static int _send(netdev_t *netdev, const iolist_t *iolist)
     }
     /* simulate TX_COMPLETE interrupt */
     if (netdev->event_callback) {
-        dev->last_event = NETDEV_EVENT_TX_COMPLETE;
-        netdev->event_callback(netdev, NETDEV_EVENT_ISR);
+        _post_event(dev, _EVENT_TX_COMPLETE);
         thread_yield();
     }
 #ifdef MODULE_NETSTATS_L2
+    netdev->stats.tx_batches++;
     netdev->stats.tx_bytes += bytes;
 #else
     (void)bytes;
@@ -128,6 +253,7 @@ static int _send(netdev_t *netdev, const iolist_t *iolist)
 
     return res - v[0].iov_len - v[n + 1].iov_len;
 }
+#endif  /* SOCKET_ZEP_TX_BUF_NUMOF > 1 */
 
 static void _continue_reading(socket_zep_t *dev)
 {
@@ -173,6 +299,60 @@ static inline bool _dst_not_me(socket_zep_t *dev, const void *buf)
     }
 }
 
+static void _fill_rx_buf(socket_zep_t *dev)
+{
+    unsigned free_num = SOCKET_ZEP_RX_BUF_NUMOF - dev->rcv_num;
+    unsigned tail = (dev->rcv_head + dev->rcv_num) % SOCKET_ZEP_RX_BUF_NUMOF;
+    int res;
+
+    if (free_num == 0) {
+        return;
+    }
+#ifdef __linux__
+    struct mmsghdr msgs[free_num];
+    struct iovec v[free_num];
+
+    memset(msgs, 0, sizeof(msgs));
+    for (unsigned i = 0; i < free_num; i++) {
+        v[i].iov_base = dev->rcv_buf[(tail + i) % SOCKET_ZEP_RX_BUF_NUMOF];
+        v[i].iov_len = SOCKET_ZEP_BUF_SIZE;
+        msgs[i].msg_hdr.msg_iov = &v[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    _native_syscall_enter();
+    res = recvmmsg(dev->sock_fd, msgs, free_num, MSG_DONTWAIT, NULL);
+    _native_syscall_leave();
+    for (int i = 0; i < res; i++) {
+        dev->rcv_len[(tail + i) % SOCKET_ZEP_RX_BUF_NUMOF] = msgs[i].msg_len;
+    }
+#else
+    _native_syscall_enter();
+    res = recv(dev->sock_fd, dev->rcv_buf[tail], SOCKET_ZEP_BUF_SIZE,
+               MSG_DONTWAIT);
+    _native_syscall_leave();
+    if (res >= 0) {
+        dev->rcv_len[tail] = res;
+        res = 1;
+    }
+#endif
+    DEBUG("socket_zep::fill_rx_buf: received %d datagrams\n", res);
+    if (res > 0) {
+#ifdef MODULE_NETSTATS_L2
+        dev->netdev.netdev.stats.rx_batches++;
+#endif
+        dev->rcv_num += res;
+    }
+    else if ((res < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+        err(EXIT_FAILURE, "zep: read");
+    }
+}
+
+static inline void _drop_rx_buf_head(socket_zep_t *dev)
+{
+    dev->rcv_head = (dev->rcv_head + 1) % SOCKET_ZEP_RX_BUF_NUMOF;
+    dev->rcv_num--;
+}
+
 static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
 {
     socket_zep_t *dev = (socket_zep_t *)netdev;
@@ -180,78 +360,63 @@ static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
 
     DEBUG("socket_zep::recv(%p, %p, %u, %p)\n", (void *)netdev, buf,
           (unsigned)len, (void *)info);
+    if (dev->rcv_num == 0) {
+        _fill_rx_buf(dev);
+        if (dev->rcv_num == 0) {
+            DEBUG("socket_zep::recv: ignoring null-event\n");
+            return (buf == NULL) ? 0 : -1;
+        }
+    }
     if ((buf == NULL) || (len == 0)) {
-        int res = real_ioctl(dev->sock_fd, FIONREAD, &size);
-#if ENABLE_DEBUG
-        if (res < 0) {
-            DEBUG("socket_zep::recv: error reading FIONREAD: %s",
-                  strerror(errno));
+        size = dev->rcv_len[dev->rcv_head];
+        if ((buf == NULL) && (len > 0)) {
+            _drop_rx_buf_head(dev);
         }
-#else
-        (void)res;
-#endif
         return size;
     }
-    else if (len > 0) {
-        size = real_read(dev->sock_fd, dev->rcv_buf, sizeof(dev->rcv_buf));
 
-        if (size > 0) {
-            zep_hdr_t *tmp = (zep_hdr_t *)&dev->rcv_buf;
+    uint8_t *rcv_buf = dev->rcv_buf[dev->rcv_head];
+    zep_hdr_t *tmp = (zep_hdr_t *)rcv_buf;
 
-            if ((tmp->preamble[0] != 'E') || (tmp->preamble[1] != 'X')) {
-                DEBUG("socket_zep::recv: invalid ZEP header");
+    size = dev->rcv_len[dev->rcv_head];
+    /* the datagram is consumed, whether it is valid or not */
+    _drop_rx_buf_head(dev);
+    if ((size < (int)sizeof(zep_hdr_t)) ||
+        (tmp->preamble[0] != 'E') || (tmp->preamble[1] != 'X')) {
+        DEBUG("socket_zep::recv: invalid ZEP header");
+        return -1;
+    }
+    switch (tmp->version) {
+        case 2: {
+            zep_v2_data_hdr_t *zep = (zep_v2_data_hdr_t *)tmp;
+            void *payload = &rcv_buf[sizeof(zep_v2_data_hdr_t)];
+
+            if (zep->type != ZEP_V2_TYPE_DATA) {
+                DEBUG("socket_zep::recv: unexpect ZEP type\n");
+                /* don't support ACK frames for now*/
                 return -1;
             }
-            switch (tmp->version) {
-                case 2: {
-                    zep_v2_data_hdr_t *zep = (zep_v2_data_hdr_t *)tmp;
-                    void *payload = &dev->rcv_buf[sizeof(zep_v2_data_hdr_t)];
-
-                    if (zep->type != ZEP_V2_TYPE_DATA) {
-                        DEBUG("socket_zep::recv: unexpect ZEP type\n");
-                        /* don't support ACK frames for now*/
-                        return -1;
-                    }
-                    if (((sizeof(zep_v2_data_hdr_t) + zep->length) != (unsigned)size) ||
-                        (zep->length > len) || (zep->chan != dev->netdev.chan) ||
-                        /* TODO promiscous mode */
-                        _dst_not_me(dev, payload)) {
-                        /* TODO: check checksum */
-                        return -1;
-                    }
-                    /* don't hand FCS to stack */
-                    size = zep->length - sizeof(uint16_t);
-                    if (buf != NULL) {
-                        memcpy(buf, payload, size);
-                        if (info != NULL) {
-                            struct netdev_radio_rx_info *rx_info = info;
-                            rx_info->lqi = zep->lqi_val;
-                            rx_info->rssi = UINT8_MAX;
-                        }
-                    }
-                    break;
-                }
-                default:
-                    DEBUG("socket_zep::recv: unexpected ZEP version\n");
-                    return -1;
-            }
-        }
-        else if (size == 0) {
-            DEBUG("socket_zep::recv: ignoring null-event\n");
-            return -1;
-        }
-        else if (size == -1) {
-            if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            if (((sizeof(zep_v2_data_hdr_t) + zep->length) != (unsigned)size) ||
+                (zep->length > len) || (zep->chan != dev->netdev.chan) ||
+                /* TODO promiscous mode */
+                _dst_not_me(dev, payload)) {
+                /* TODO: check checksum */
+                return -1;
             }
-            else {
-                err(EXIT_FAILURE, "zep: read");
+            /* don't hand FCS to stack */
+            size = zep->length - sizeof(uint16_t);
+            memcpy(buf, payload, size);
+            if (info != NULL) {
+                struct netdev_radio_rx_info *rx_info = info;
+                rx_info->lqi = zep->lqi_val;
+                rx_info->rssi = UINT8_MAX;
             }
+            break;
         }
-        else {
-            errx(EXIT_FAILURE, "internal error _rx_event");
-        }
+        default:
+            DEBUG("socket_zep::recv: unexpected ZEP version\n");
+            return -1;
     }
-    _continue_reading(dev);
 #ifdef MODULE_NETSTATS_L2
     netdev->stats.rx_count++;
     netdev->stats.rx_bytes += size;
@@ -261,13 +426,42 @@ static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
 
 static void _isr(netdev_t *netdev)
 {
-    if (netdev->event_callback) {
-        socket_zep_t *dev = (socket_zep_t *)netdev;
+    socket_zep_t *dev = (socket_zep_t *)netdev;
+    unsigned state = irq_disable();
+    uint8_t events = dev->events;
 
-        DEBUG("socket_zep::isr: firing %u\n", (unsigned)dev->last_event);
-        netdev->event_callback(netdev, dev->last_event);
+    dev->events = 0;
+    irq_restore(state);
+    DEBUG("socket_zep::isr: firing 0x%02x\n", (unsigned)events);
+    if (netdev->event_callback == NULL) {
+        return;
+    }
+    if (events & _EVENT_TX_STARTED) {
+        netdev->event_callback(netdev, NETDEV_EVENT_TX_STARTED);
+    }
+    if (events & _EVENT_TX_COMPLETE) {
+        netdev->event_callback(netdev, NETDEV_EVENT_TX_COMPLETE);
+    }
+#if SOCKET_ZEP_TX_BUF_NUMOF > 1
+    if (events & _EVENT_TX_FLUSH) {
+        _flush_tx_buf(dev);
+    }
+#endif
+    if (events & _EVENT_RX) {
+        _fill_rx_buf(dev);
+        /* hand all datagrams fetched in one go to the upper layer */
+        while (dev->rcv_num > 0) {
+            unsigned num = dev->rcv_num;
+
+            netdev->event_callback(netdev, NETDEV_EVENT_RX_COMPLETE);
+            if (dev->rcv_num == num) {
+                /* upper layer did not fetch the frame, drop it to make
+                 * progress */
+                _drop_rx_buf_head(dev);
+            }
+        }
+        _continue_reading(dev);
     }
-    return;
 }
 
 static void _socket_isr(int fd, void *arg)
@@ -284,7 +478,8 @@ static void _socket_isr(int fd, void *arg)
     if (netdev->event_callback) {
         socket_zep_t *dev = (socket_zep_t *)netdev;
 
-        dev->last_event = NETDEV_EVENT_RX_COMPLETE;
+        /* we are in interrupt context already */
+        dev->events |= _EVENT_RX;
         netdev->event_callback(netdev, NETDEV_EVENT_ISR);
     }
 }
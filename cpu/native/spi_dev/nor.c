@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     cpu_native_spi
+ * @{
+ *
+ * @file
+ * @brief       Emulated SPI NOR flash
+ *
+ * The model identifies as Micron M25P16 and uses 3 byte addresses. Commands
+ * are executed when the chip select line is released, page program and erase
+ * operations keep the device busy for the emulated time afterwards.
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "native_spi.h"
+#include "xtimer.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define CMD_PP          (0x02)
+#define CMD_READ        (0x03)
+#define CMD_WRDI        (0x04)
+#define CMD_RDSR        (0x05)
+#define CMD_WREN        (0x06)
+#define CMD_FAST_READ   (0x0b)
+#define CMD_SE          (0x20)
+#define CMD_BE_32K      (0x52)
+#define CMD_CE_ALT      (0x60)
+#define CMD_RDID        (0x9f)
+#define CMD_RES         (0xab)
+#define CMD_DP          (0xb9)
+#define CMD_CE          (0xc7)
+#define CMD_BE          (0xd8)
+
+#define STATUS_WIP      (0x01)
+#define STATUS_WEL      (0x02)
+
+#define ADDR_LEN        (3U)
+
+static const uint8_t _jedec_id[] = { 0x20, 0x20, 0x15 };
+
+static bool _busy(native_spi_nor_t *nor)
+{
+    if (nor->busy && ((int32_t)(nor->busy_until - xtimer_now_usec()) <= 0)) {
+        nor->busy = false;
+    }
+    return nor->busy;
+}
+
+static uint8_t _tx(native_spi_dev_t *dev)
+{
+    native_spi_nor_t *nor = (native_spi_nor_t *)dev;
+    uint32_t pos = nor->pos;
+
+    if (pos == 0) {
+        return 0xff;
+    }
+    switch (nor->cmd) {
+        case CMD_RDSR:
+            return ((_busy(nor)) ? STATUS_WIP : 0) |
+                   ((nor->wel) ? STATUS_WEL : 0);
+        case CMD_RDID:
+            return (pos <= sizeof(_jedec_id)) ? _jedec_id[pos - 1] : 0x00;
+        case CMD_READ:
+        case CMD_FAST_READ:
+            /* data follows the address and the dummy byte of fast reads */
+            pos -= 1 + ADDR_LEN + ((nor->cmd == CMD_FAST_READ) ? 1 : 0);
+            if ((int32_t)pos < 0) {
+                return 0xff;
+            }
+            return nor->mem[(nor->addr + pos) % nor->size];
+        default:
+            return 0xff;
+    }
+}
+
+static void _rx(native_spi_dev_t *dev, uint8_t data)
+{
+    native_spi_nor_t *nor = (native_spi_nor_t *)dev;
+    uint32_t pos = nor->pos++;
+
+    if (pos == 0) {
+        /* only the status can be read while the device is busy */
+        nor->cmd = ((data != CMD_RDSR) && _busy(nor)) ? 0x00 : data;
+        nor->addr = 0;
+        nor->programmed = false;
+        return;
+    }
+    if (pos <= ADDR_LEN) {
+        nor->addr = (nor->addr << 8) | data;
+        return;
+    }
+    if ((nor->cmd == CMD_PP) && nor->wel) {
+        /* programming can only clear bits, the address wraps in the page */
+        uint32_t page = nor->addr & ~(NATIVE_SPI_NOR_PAGE_SIZE - 1);
+        uint32_t offset = (nor->addr + pos - (1 + ADDR_LEN)) %
+                          NATIVE_SPI_NOR_PAGE_SIZE;
+        if (page < nor->size) {
+            nor->mem[page + offset] &= data;
+            nor->programmed = true;
+        }
+    }
+}
+
+static void _erase(native_spi_nor_t *nor, uint32_t len)
+{
+    uint32_t addr = nor->addr & ~(len - 1);
+
+    if (addr + len > nor->size) {
+        return;
+    }
+    memset(&nor->mem[addr], 0xff, len);
+    nor->busy_until = xtimer_now_usec() +
+                      (len / NATIVE_SPI_NOR_SECTOR_SIZE) * NATIVE_SPI_NOR_ERASE_US;
+    nor->busy = true;
+}
+
+static void _execute(native_spi_nor_t *nor)
+{
+    switch (nor->cmd) {
+        case CMD_WREN:
+            nor->wel = true;
+            return;
+        case CMD_WRDI:
+            nor->wel = false;
+            return;
+        case CMD_PP:
+            if (nor->programmed) {
+                nor->busy_until = xtimer_now_usec() + NATIVE_SPI_NOR_PAGE_US;
+                nor->busy = true;
+            }
+            break;
+        case CMD_SE:
+            if (nor->wel && (nor->pos >= 1 + ADDR_LEN)) {
+                _erase(nor, NATIVE_SPI_NOR_SECTOR_SIZE);
+            }
+            break;
+        case CMD_BE_32K:
+            if (nor->wel && (nor->pos >= 1 + ADDR_LEN)) {
+                _erase(nor, 32 * 1024UL);
+            }
+            break;
+        case CMD_BE:
+            if (nor->wel && (nor->pos >= 1 + ADDR_LEN)) {
+                _erase(nor, 64 * 1024UL);
+            }
+            break;
+        case CMD_CE:
+        case CMD_CE_ALT:
+            if (nor->wel) {
+                nor->addr = 0;
+                _erase(nor, nor->size);
+            }
+            break;
+        default:
+            return;
+    }
+    /* the write enable latch is reset by every program or erase command */
+    nor->wel = false;
+}
+
+static void _select(native_spi_dev_t *dev, bool selected)
+{
+    native_spi_nor_t *nor = (native_spi_nor_t *)dev;
+
+    if (!selected && (nor->pos > 0)) {
+        DEBUG("native_spi_nor: cmd 0x%02x, addr 0x%06x, %u bytes\n",
+              (unsigned)nor->cmd, (unsigned)nor->addr, (unsigned)nor->pos);
+        _execute(nor);
+    }
+    nor->pos = 0;
+}
+
+static const native_spi_dev_driver_t _driver = {
+    .select = _select,
+    .tx = _tx,
+    .rx = _rx,
+};
+
+void native_spi_nor_init(native_spi_nor_t *nor, uint8_t *mem, size_t size)
+{
+    assert((size % NATIVE_SPI_NOR_SECTOR_SIZE) == 0);
+    assert(size <= (1UL << (8 * ADDR_LEN)));
+
+    memset(nor, 0, sizeof(*nor));
+    nor->dev.driver = &_driver;
+    nor->mem = mem;
+    nor->size = size;
+}
@@ -0,0 +1,373 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     cpu_native_spi
+ * @{
+ *
+ * @file
+ * @brief       Emulated SD card in SPI mode
+ *
+ * The model implements the subset of the SD SPI protocol needed by
+ * `sdcard_spi`: initialization (CMD0, CMD8, ACMD41, CMD58, CMD59), register
+ * access (CMD9, CMD10, ACMD13) and single and multiple block transfers
+ * (CMD17, CMD18, CMD12, CMD24, CMD25).
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "checksum/crc16_ccitt.h"
+#include "native_spi.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define R1_IDLE             (0x01)
+#define R1_ILLEGAL_CMD      (0x04)
+#define R1_CMD_CRC_ERR      (0x08)
+#define R1_PARAM_ERR        (0x40)
+
+#define TOKEN_START         (0xfe)
+#define TOKEN_START_MULTI   (0xfc)
+#define TOKEN_STOP          (0xfd)
+
+#define DATA_ACCEPTED       (0x05)
+#define DATA_CRC_ERR        (0x0b)
+#define DATA_WRITE_ERR      (0x0d)
+
+#define REG_SIZE            (16U)
+#define SD_STATUS_SIZE      (64U)
+
+enum {
+    STATE_CMD,              /* waiting for a command */
+    STATE_READ_MULTI,       /* sending blocks until CMD12 */
+    STATE_WRITE_TOKEN,      /* waiting for a start token */
+    STATE_WRITE_TOKEN_MULTI,/* waiting for a start or stop token */
+    STATE_WRITE_DATA,       /* receiving a block */
+    STATE_WRITE_DATA_MULTI, /* receiving a block of a multiple block write */
+};
+
+static uint8_t _crc7(const uint8_t *data, size_t len)
+{
+    uint8_t crc = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        uint8_t d = data[i];
+        for (unsigned j = 0; j < 8; j++) {
+            crc <<= 1;
+            if ((d ^ crc) & 0x80) {
+                crc ^= 0x09;
+            }
+            d <<= 1;
+        }
+    }
+    return (crc << 1) | 1;
+}
+
+static void _put(native_sdcard_t *card, uint8_t data)
+{
+    assert(card->out_len < sizeof(card->out));
+    card->out[card->out_len++] = data;
+}
+
+static void _put_block(native_sdcard_t *card, const uint8_t *data, size_t len)
+{
+    uint16_t crc = crc16_ccitt_update(0, data, len);
+
+    _put(card, 0xff);               /* Nac */
+    _put(card, TOKEN_START);
+    memcpy(&card->out[card->out_len], data, len);
+    card->out_len += len;
+    _put(card, crc >> 8);
+    _put(card, crc & 0xff);
+}
+
+static void _put_reg(native_sdcard_t *card, uint8_t *reg)
+{
+    reg[REG_SIZE - 1] = _crc7(reg, REG_SIZE - 1);
+    _put_block(card, reg, REG_SIZE);
+}
+
+static void _put_csd(native_sdcard_t *card)
+{
+    /* CSD version 2.0, see SD physical layer specification 5.3.3 */
+    uint32_t c_size = (card->blocks / 1024) - 1;
+    uint8_t csd[REG_SIZE] = {
+        0x40, 0x0e, 0x00, 0x32, 0x5b, 0x59, 0x00,
+        (c_size >> 16) & 0x3f, (c_size >> 8) & 0xff, c_size & 0xff,
+        0x7f, 0x80, 0x0a, 0x40, 0x00, 0x00
+    };
+
+    _put_reg(card, csd);
+}
+
+static void _put_cid(native_sdcard_t *card)
+{
+    uint8_t cid[REG_SIZE] = {
+        0x52, 'R', 'T', 'N', 'A', 'T', 'I', 'V', 0x10,
+        0x12, 0x34, 0x56, 0x78, 0x01, 0x2a, 0x00
+    };
+
+    _put_reg(card, cid);
+}
+
+static void _put_sd_status(native_sdcard_t *card)
+{
+    uint8_t sds[SD_STATUS_SIZE] = { 0 };
+
+    sds[10] = 0x90;             /* AU_SIZE: 4 MiB */
+    _put_block(card, sds, sizeof(sds));
+}
+
+static void _command(native_sdcard_t *card)
+{
+    uint8_t idx = card->cmd[0] & 0x3f;
+    uint32_t arg = ((uint32_t)card->cmd[1] << 24) |
+                   ((uint32_t)card->cmd[2] << 16) |
+                   ((uint32_t)card->cmd[3] << 8) | card->cmd[4];
+    bool app_cmd = card->app_cmd;
+    uint8_t r1 = 0;
+
+    DEBUG("native_sdcard: %sCMD%u (0x%08x)\n", (app_cmd) ? "A" : "",
+          (unsigned)idx, (unsigned)arg);
+
+    card->app_cmd = false;
+    card->out_pos = 0;
+    card->out_len = 0;
+    _put(card, 0xff);               /* Ncr */
+
+    if ((card->crc_on || (idx == 0)) &&
+        (_crc7(card->cmd, 5) != card->cmd[5])) {
+        _put(card, R1_CMD_CRC_ERR | ((card->idle) ? R1_IDLE : 0));
+        return;
+    }
+
+    switch (idx) {
+        case 0:
+            card->idle = true;
+            card->crc_on = false;
+            card->state = STATE_CMD;
+            break;
+        case 8:
+        case 9:
+        case 10:
+        case 16:
+        case 58:
+        case 59:
+            break;
+        case 12:
+            /* the byte following CMD12 is a stuff byte */
+            card->state = STATE_CMD;
+            _put(card, 0xff);
+            card->busy = NATIVE_SDCARD_BUSY_BYTES;
+            break;
+        case 13:
+        case 41:
+            if (!app_cmd) {
+                r1 = R1_ILLEGAL_CMD;
+            }
+            else if (idx == 41) {
+                card->idle = false;
+            }
+            break;
+        case 17:
+        case 18:
+        case 24:
+        case 25:
+            if (arg >= card->blocks) {
+                r1 = R1_PARAM_ERR;
+            }
+            card->addr = arg;
+            break;
+        case 55:
+            card->app_cmd = true;
+            break;
+        default:
+            r1 = R1_ILLEGAL_CMD;
+            break;
+    }
+
+    if (card->idle) {
+        r1 |= R1_IDLE;
+    }
+    _put(card, r1);
+    if (r1 & ~R1_IDLE) {
+        return;
+    }
+
+    switch (idx) {
+        case 8:
+            /* R7: echo voltage range and check pattern */
+            _put(card, 0x00);
+            _put(card, 0x00);
+            _put(card, (arg >> 8) & 0x0f);
+            _put(card, arg & 0xff);
+            break;
+        case 9:
+            _put_csd(card);
+            break;
+        case 10:
+            _put_cid(card);
+            break;
+        case 13:
+            _put(card, 0x00);       /* second byte of R2 */
+            _put_sd_status(card);
+            break;
+        case 17:
+            _put_block(card, &card->mem[arg * NATIVE_SDCARD_BLOCK_SIZE],
+                       NATIVE_SDCARD_BLOCK_SIZE);
+            break;
+        case 18:
+            card->state = STATE_READ_MULTI;
+            break;
+        case 24:
+            card->state = STATE_WRITE_TOKEN;
+            break;
+        case 25:
+            card->state = STATE_WRITE_TOKEN_MULTI;
+            break;
+        case 58:
+            /* OCR: powered up, CCS, 2.7V - 3.6V */
+            _put(card, 0xc0);
+            _put(card, 0xff);
+            _put(card, 0x80);
+            _put(card, 0x00);
+            break;
+        case 59:
+            card->crc_on = (arg & 0x1);
+            break;
+        default:
+            break;
+    }
+}
+
+static void _write_block(native_sdcard_t *card, bool multi)
+{
+    uint16_t crc = ((uint16_t)card->data[NATIVE_SDCARD_BLOCK_SIZE] << 8) |
+                   card->data[NATIVE_SDCARD_BLOCK_SIZE + 1];
+    uint8_t res = DATA_ACCEPTED;
+
+    if (card->crc_on &&
+        (crc16_ccitt_update(0, card->data, NATIVE_SDCARD_BLOCK_SIZE) != crc)) {
+        res = DATA_CRC_ERR;
+    }
+    else if (card->addr >= card->blocks) {
+        res = DATA_WRITE_ERR;
+    }
+    else {
+        memcpy(&card->mem[card->addr * NATIVE_SDCARD_BLOCK_SIZE], card->data,
+               NATIVE_SDCARD_BLOCK_SIZE);
+        card->addr++;
+    }
+
+    card->out_pos = 0;
+    card->out_len = 0;
+    _put(card, res);
+    card->busy = NATIVE_SDCARD_BUSY_BYTES;
+    card->state = (multi && (res == DATA_ACCEPTED)) ? STATE_WRITE_TOKEN_MULTI
+                                                    : STATE_CMD;
+}
+
+static uint8_t _tx(native_spi_dev_t *dev)
+{
+    native_sdcard_t *card = (native_sdcard_t *)dev;
+
+    if ((card->out_pos == card->out_len) &&
+        (card->state == STATE_READ_MULTI)) {
+        card->out_pos = 0;
+        card->out_len = 0;
+        if (card->addr < card->blocks) {
+            _put_block(card, &card->mem[card->addr * NATIVE_SDCARD_BLOCK_SIZE],
+                       NATIVE_SDCARD_BLOCK_SIZE);
+            card->addr++;
+        }
+    }
+    if (card->out_pos < card->out_len) {
+        return card->out[card->out_pos++];
+    }
+    if (card->busy) {
+        card->busy--;
+        return 0x00;
+    }
+    return 0xff;
+}
+
+static void _rx(native_spi_dev_t *dev, uint8_t data)
+{
+    native_sdcard_t *card = (native_sdcard_t *)dev;
+
+    switch (card->state) {
+        case STATE_WRITE_TOKEN:
+        case STATE_WRITE_TOKEN_MULTI:
+            if ((card->state == STATE_WRITE_TOKEN) && (data == TOKEN_START)) {
+                card->data_len = 0;
+                card->state = STATE_WRITE_DATA;
+            }
+            else if ((card->state == STATE_WRITE_TOKEN_MULTI) &&
+                     (data == TOKEN_START_MULTI)) {
+                card->data_len = 0;
+                card->state = STATE_WRITE_DATA_MULTI;
+            }
+            else if ((data == TOKEN_STOP) &&
+                     (card->state == STATE_WRITE_TOKEN_MULTI)) {
+                card->busy = NATIVE_SDCARD_BUSY_BYTES;
+                card->state = STATE_CMD;
+            }
+            return;
+        case STATE_WRITE_DATA:
+        case STATE_WRITE_DATA_MULTI:
+            card->data[card->data_len++] = data;
+            if (card->data_len == sizeof(card->data)) {
+                _write_block(card, (card->state == STATE_WRITE_DATA_MULTI));
+            }
+            return;
+        default:
+            break;
+    }
+
+    /* commands start with 0b01 */
+    if ((card->cmd_len == 0) && ((data & 0xc0) != 0x40)) {
+        return;
+    }
+    card->cmd[card->cmd_len++] = data;
+    if (card->cmd_len == sizeof(card->cmd)) {
+        card->cmd_len = 0;
+        _command(card);
+    }
+}
+
+static void _select(native_spi_dev_t *dev, bool selected)
+{
+    native_sdcard_t *card = (native_sdcard_t *)dev;
+
+    if (!selected) {
+        card->cmd_len = 0;
+    }
+}
+
+static const native_spi_dev_driver_t _driver = {
+    .select = _select,
+    .tx = _tx,
+    .rx = _rx,
+};
+
+void native_sdcard_init(native_sdcard_t *card, uint8_t *mem, size_t size)
+{
+    assert(size >= (1024 * NATIVE_SDCARD_BLOCK_SIZE));
+
+    memset(card, 0, sizeof(*card));
+    card->dev.driver = &_driver;
+    card->mem = mem;
+    /* C_SIZE counts units of 512 KiB */
+    card->blocks = (size / (1024 * NATIVE_SDCARD_BLOCK_SIZE)) * 1024;
+    card->idle = true;
+    card->state = STATE_CMD;
+}
@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+"""Decode the output of the log_deferred module in binary mode.
+
+Lines starting with "#L" hold a hex encoded log record, consisting of the
+record length, the log level, the address of the format string and the raw
+arguments. The format string is looked up in the ELF file of the application.
+All other lines are passed through unchanged.
+
+usage: logdecode.py <app.elf> [<logfile>]
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+EM_386 = 3
+EM_X86_64 = 62
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+
+CONV = re.compile(r"%([-+ #0-9.*]*)(hh|h|ll|l|j|z|t|L)?([diouxXcaAeEfFgGspn%])")
+
+
+class Elf(object):
+    """Minimal ELF reader to resolve addresses of constant data"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError("{} is no ELF file".format(path))
+        self.bits = 64 if self.data[4] == 2 else 32
+        self.endian = "<" if self.data[5] == 1 else ">"
+        if self.bits == 32:
+            hdr = struct.unpack_from(self.endian + "HHIIIIIHHHHHH", self.data, 16)
+            machine, shoff, shentsize, shnum = hdr[1], hdr[5], hdr[10], hdr[11]
+            shfmt = "IIIIIIIIII"
+        else:
+            hdr = struct.unpack_from(self.endian + "HHIQQQIHHHHHH", self.data, 16)
+            machine, shoff, shentsize, shnum = hdr[1], hdr[5], hdr[10], hdr[11]
+            shfmt = "IIQQQQIIQQ"
+        self.sections = []
+        for i in range(shnum):
+            sh = struct.unpack_from(self.endian + shfmt, self.data, shoff + i * shentsize)
+            sh_type, flags, addr, offset, size = sh[1], sh[2], sh[3], sh[4], sh[5]
+            if (sh_type != SHT_NOBITS) and (flags & SHF_ALLOC) and addr:
+                self.sections.append((addr, offset, size))
+        self.ptr_size = self.bits // 8
+        self.long_size = self.ptr_size
+        self.ldouble_size = {EM_386: 12, EM_X86_64: 16}.get(machine, 8)
+
+    def string(self, addr):
+        for start, offset, size in self.sections:
+            if start <= addr < start + size:
+                pos = offset + addr - start
+                end = self.data.index(b"\0", pos)
+                return self.data[pos:end].decode("utf-8", "replace")
+        raise KeyError("no format string at 0x{:x}".format(addr))
+
+
+class Record(object):
+    """Sequential reader for the arguments of a record"""
+
+    def __init__(self, elf, data):
+        self.elf = elf
+        self.data = data
+        self.pos = 0
+
+    def get(self, fmt):
+        fmt = self.elf.endian + fmt
+        value = struct.unpack_from(fmt, self.data, self.pos)[0]
+        self.pos += struct.calcsize(fmt)
+        return value
+
+    def integer(self, size, signed):
+        codes = {1: "b", 2: "h", 4: "i", 8: "q"}
+        code = codes[size]
+        return self.get(code if signed else code.upper())
+
+    def string(self):
+        end = self.data.index(b"\0", self.pos)
+        value = self.data[self.pos:end].decode("utf-8", "replace")
+        self.pos = end + 1
+        return value
+
+    def ldouble(self):
+        size = self.elf.ldouble_size
+        if size == 8:
+            return self.get("d")
+        raw = self.data[self.pos:self.pos + 10]
+        self.pos += size
+        # x87 extended precision
+        mant, exp = struct.unpack(self.elf.endian + "QH", raw)
+        sign = -1.0 if exp & 0x8000 else 1.0
+        exp &= 0x7fff
+        if exp == 0 and mant == 0:
+            return 0.0 * sign
+        return sign * mant * 2.0 ** (exp - 16383 - 63)
+
+
+def _arg_size(elf, mod):
+    if mod in ("ll", "j"):
+        return 8
+    if mod in ("l", "z", "t"):
+        return elf.long_size
+    return 4
+
+
+def render(elf, line):
+    data = bytes.fromhex(line)
+    fmt_addr = int.from_bytes(data[2:2 + elf.ptr_size],
+                              "little" if elf.endian == "<" else "big")
+    fmt = elf.string(fmt_addr)
+    rec = Record(elf, data[:data[0]])
+    rec.pos = 2 + elf.ptr_size
+
+    def conv(m):
+        flags, mod, spec = m.group(1), m.group(2) or "", m.group(3)
+        if spec == "%":
+            return "%"
+        while "*" in flags:
+            flags = flags.replace("*", str(rec.get("i")), 1)
+        if spec in "di":
+            return ("%" + flags + "d") % rec.integer(_arg_size(elf, mod), True)
+        if spec in "ouxX":
+            value = rec.integer(_arg_size(elf, mod), False)
+            return ("%" + flags + ("d" if spec == "u" else spec)) % value
+        if spec == "c":
+            return ("%" + flags + "c") % (rec.get("i") & 0xff)
+        if spec in "aA":
+            value = rec.ldouble() if mod == "L" else rec.get("d")
+            text = float.hex(value)
+            return text.upper() if spec == "A" else text
+        if spec in "eEfFgG":
+            value = rec.ldouble() if mod == "L" else rec.get("d")
+            return ("%" + flags + spec) % value
+        if spec == "s":
+            return ("%" + flags + "s") % rec.string()
+        if spec == "p":
+            return "0x{:x}".format(rec.integer(elf.ptr_size, False))
+        return ""
+
+    return CONV.sub(conv, fmt)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode binary log_deferred output")
+    parser.add_argument("elf", help="ELF file of the application")
+    parser.add_argument("log", nargs="?", type=argparse.FileType("r"),
+                        default=sys.stdin, help="log output (default: stdin)")
+    args = parser.parse_args()
+
+    elf = Elf(args.elf)
+    for line in args.log:
+        pos = line.find("#L")
+        if pos < 0:
+            sys.stdout.write(line)
+            continue
+        try:
+            sys.stdout.write(line[:pos] + render(elf, line[pos + 2:].strip()))
+        except (ValueError, KeyError, IndexError, struct.error) as e:
+            sys.stdout.write("logdecode: {}: {}".format(e, line))
+        sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
@@ -43,6 +43,14 @@
  *    configures the bus with specific parameters (clock, mode) for the duration
  *    of that transaction.
  *
+ * Besides the blocking transfer functions, this interface allows to queue
+ * chains of transfer descriptors (@ref spi_xfer_t) using
+ * `spi_transfer_async()`. Implementations can back this with DMA, so that the
+ * CPU is free to e.g. compute checksums while a transfer is in progress. For
+ * platforms not providing their own implementation, a generic fallback based
+ * on `spi_transfer_bytes()` is used, which completes all queued descriptors
+ * before returning.
+ *
  * @{
  * @file
  * @brief       Low-level SPI peripheral driver interface definition
@@ -166,6 +174,33 @@ typedef enum {
 } spi_clk_t;
 #endif
 
+/**
+ * @brief   Signature of the completion callback of a queued SPI transfer
+ *
+ * @param[in] arg       optional context for the callback
+ */
+typedef void (*spi_xfer_cb_t)(void *arg);
+
+/**
+ * @brief   Descriptor of a queued SPI transfer
+ *
+ * Descriptors are linked to chains using their @p next field. Queued
+ * descriptors are processed in order and must stay valid until their
+ * completion callback was called (or `spi_transfer_wait()` returned).
+ */
+typedef struct spi_xfer {
+    struct spi_xfer *next;  /**< next descriptor in the chain, NULL for last */
+    const void *out;        /**< buffer to send data from, NULL if only
+                             *   receiving */
+    void *in;               /**< buffer to read into, NULL if only sending */
+    size_t len;             /**< number of bytes to transfer */
+    bool cont;              /**< if true, keep device selected after this
+                             *   descriptor */
+    spi_xfer_cb_t cb;       /**< called when this descriptor is done, may be
+                             *   NULL */
+    void *arg;              /**< argument passed to @p cb */
+} spi_xfer_t;
+
 /**
  * @brief   Basic initialization of the given SPI bus
  *
@@ -285,6 +320,35 @@ uint8_t spi_transfer_byte(spi_t bus, spi_cs_t cs, bool cont, uint8_t out);
 void spi_transfer_bytes(spi_t bus, spi_cs_t cs, bool cont,
                         const void *out, void *in, size_t len);
 
+/**
+ * @brief   Queue a chain of transfer descriptors on the given SPI bus
+ *
+ * The bus must have been acquired with `spi_acquire()` before. The
+ * descriptors are processed in order, each of them behaving like a call to
+ * `spi_transfer_bytes()` with the descriptor's parameters. When the bus is
+ * still busy with previously queued descriptors, @p xfer is appended to them
+ * by linking it to the last queued descriptor.
+ *
+ * Completion callbacks may be called in interrupt context. They are allowed to
+ * queue further descriptors for the same chip select line.
+ *
+ * @note    @p out and @p in of a descriptor may point to the same buffer, the
+ *          data to send is then replaced by the received data.
+ *
+ * @param[in] bus       SPI device to use
+ * @param[in] cs        chip select pin/line to use, set to SPI_CS_UNDEF if chip
+ *                      select should not be handled by the SPI driver
+ * @param[in] xfer      first descriptor of the chain to queue
+ */
+void spi_transfer_async(spi_t bus, spi_cs_t cs, spi_xfer_t *xfer);
+
+/**
+ * @brief   Wait until all descriptors queued on the given bus are done
+ *
+ * @param[in] bus       SPI device to wait for
+ */
+void spi_transfer_wait(spi_t bus);
+
 /**
  * @brief   Transfer one byte to/from a given register address
  *
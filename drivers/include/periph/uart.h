@@ -30,6 +30,11 @@
  * many bytes are going to be received and might want to handle that in your specific
  * callback function. The transmit function can be implemented in any way.
  *
+ * Platforms providing the `periph_uart_tx_irq` feature can additionally send
+ * data in the background: after uart_tx_start() was called, the driver fetches
+ * the bytes to send one by one from a callback, executed in interrupt context
+ * whenever the transmitter is ready to take more data.
+ *
  * By default the @p UART_DEV(0) device of each board is initialized and mapped to STDIO
  * in RIOT which is used for standard input/output functions like `printf()` or
  * `puts()`.
@@ -87,6 +92,16 @@ typedef unsigned int uart_t;
  */
 typedef void(*uart_rx_cb_t)(void *arg, uint8_t data);
 
+/**
+ * @brief   Signature for the transmit callback
+ *
+ * @param[in] arg           context to the callback (optional)
+ *
+ * @return                  the next byte to send
+ * @return                  -1 if there is nothing more to send
+ */
+typedef int(*uart_tx_cb_t)(void *arg);
+
 /**
  * @brief   Interrupt context for a UART device
  */
@@ -148,6 +163,28 @@ int uart_init(uart_t uart, uint32_t baudrate, uart_rx_cb_t rx_cb, void *arg);
  */
 void uart_write(uart_t uart, const uint8_t *data, size_t len);
 
+#if defined(MODULE_PERIPH_UART_TX_IRQ) || defined(DOXYGEN)
+/**
+ * @brief   Start interrupt driven transmission on the given UART device
+ *
+ * The driver calls @p cb each time the transmitter can take another byte,
+ * until @p cb returns -1. The callback may be executed from the context of
+ * the caller of this function, if the transmitter is ready right away. It
+ * must not block.
+ *
+ * Must not be called again before @p cb returned -1. Mixing with uart_write()
+ * is allowed, but the order of the data sent is undefined then.
+ *
+ * @note    You have to add the module `periph_uart_tx_irq` to your project to
+ *          enable this function
+ *
+ * @param[in] uart          UART device to use for transmission
+ * @param[in] cb            callback returning the next byte to send
+ * @param[in] arg           optional argument passed to the callback
+ */
+void uart_tx_start(uart_t uart, uart_tx_cb_t cb, void *arg);
+#endif /* MODULE_PERIPH_UART_TX_IRQ */
+
 /**
  * @brief   Power on the given UART device
  *
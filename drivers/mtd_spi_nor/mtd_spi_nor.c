@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 #include <errno.h>
+#include <string.h>
 
 #include "mtd.h"
 #if MODULE_XTIMER
@@ -48,6 +49,12 @@
 #define MTD_SPI_NOR_WRITE_WAIT_US (50 * US_PER_MS)
 #endif
 
+/* first interval when polling for the end of a write or erase, it doubles
+ * with each poll up to MTD_SPI_NOR_WRITE_WAIT_US */
+#ifndef MTD_SPI_NOR_POLL_WAIT_US
+#define MTD_SPI_NOR_POLL_WAIT_US  (100U)
+#endif
+
 #define MTD_32K             (32768ul)
 #define MTD_32K_ADDR_MASK   (0x7FFF)
 #define MTD_4K              (4096ul)
@@ -93,19 +100,23 @@ static void mtd_spi_cmd_addr_read(const mtd_spi_nor_t *dev, uint8_t opcode,
         TRACE("\n");
     }
 
-    do {
-        /* Send opcode followed by address */
-        spi_transfer_byte(dev->spi, dev->cs, true, opcode);
-        spi_transfer_bytes(dev->spi, dev->cs, true, (char *)addr_buf, NULL, dev->addr_width);
-
-        /* Read data */
-        spi_transfer_bytes(dev->spi, dev->cs, false, NULL, dest, count);
-    } while (0);
+    /* Send opcode followed by address, then read data */
+    uint8_t cmd[1 + sizeof(addr)];
+    cmd[0] = opcode;
+    memcpy(&cmd[1], addr_buf, dev->addr_width);
+
+    spi_xfer_t xfer[] = {
+        { .next = &xfer[1], .out = cmd, .len = 1 + dev->addr_width, .cont = true },
+        { .in = dest, .len = count },
+    };
+    spi_transfer_async(dev->spi, dev->cs, xfer);
+    spi_transfer_wait(dev->spi);
 }
 
 /**
  * @internal
- * @brief Send command opcode followed by address, followed by a write from buffer
+ * @brief Enable writes, then send command opcode followed by address, followed
+ *        by a write from buffer
  *
  * @param[in]  dev    pointer to device descriptor
  * @param[in]  opcode command opcode
@@ -129,16 +140,22 @@ static void mtd_spi_cmd_addr_write(const mtd_spi_nor_t *dev, uint8_t opcode,
         TRACE("\n");
     }
 
-    do {
-        /* Send opcode followed by address */
-        spi_transfer_byte(dev->spi, dev->cs, true, opcode);
-        bool cont = (count > 0); /* only keep CS asserted when there is data that follows */
-        spi_transfer_bytes(dev->spi, dev->cs, cont, (char *)addr_buf, NULL, dev->addr_width);
-        /* Write data */
-        if (cont) {
-            spi_transfer_bytes(dev->spi, dev->cs, false, (void *)src, NULL, count);
-        }
-    } while (0);
+    /* Queue write enable, opcode followed by address and data at once */
+    uint8_t cmd[1 + sizeof(addr)];
+    cmd[0] = opcode;
+    memcpy(&cmd[1], addr_buf, dev->addr_width);
+
+    spi_xfer_t xfer[] = {
+        { .next = &xfer[1], .out = &dev->opcode->wren, .len = 1 },
+        /* only keep CS asserted when there is data that follows */
+        { .out = cmd, .len = 1 + dev->addr_width, .cont = (count > 0) },
+        { .out = src, .len = count },
+    };
+    if (count > 0) {
+        xfer[1].next = &xfer[2];
+    }
+    spi_transfer_async(dev->spi, dev->cs, xfer);
+    spi_transfer_wait(dev->spi);
 }
 
 /**
@@ -258,6 +275,9 @@ static int mtd_spi_read_jedec_id(const mtd_spi_nor_t *dev, mtd_jedec_id_t *out)
 
 static inline void wait_for_write_complete(const mtd_spi_nor_t *dev)
 {
+#if MODULE_XTIMER
+    uint32_t us = MTD_SPI_NOR_POLL_WAIT_US;
+#endif
     do {
         uint8_t status;
         mtd_spi_cmd_read(dev, dev->opcode->rdsr, &status, sizeof(status));
@@ -267,7 +287,11 @@ static inline void wait_for_write_complete(const mtd_spi_nor_t *dev)
             break;
         }
 #if MODULE_XTIMER
-        xtimer_usleep(MTD_SPI_NOR_WRITE_WAIT_US);
+        /* most writes are done after a short time, erases take longer */
+        xtimer_usleep(us);
+        if (us < MTD_SPI_NOR_WRITE_WAIT_US) {
+            us *= 2;
+        }
 #else
         thread_yield();
 #endif
@@ -359,17 +383,11 @@ static int mtd_spi_nor_read(mtd_dev_t *mtd, void *dest, uint32_t addr, uint32_t
     if (addr > chipsize) {
         return -EOVERFLOW;
     }
-    if (size > mtd->page_size) {
-        size = mtd->page_size;
-    }
+    /* the read command continues across page boundaries, so the whole range
+     * is read at once */
     if ((addr + size) > chipsize) {
         size = chipsize - addr;
     }
-    uint32_t page_addr_mask = dev->page_addr_mask;
-    if ((addr & page_addr_mask) != ((addr + size - 1) & page_addr_mask)) {
-        /* Reads across page boundaries must be split */
-        size = mtd->page_size - (addr & ~(page_addr_mask));
-    }
     if (size == 0) {
         return 0;
     }
@@ -407,10 +425,7 @@ static int mtd_spi_nor_write(mtd_dev_t *mtd, const void *src, uint32_t addr, uin
     be_uint32_t addr_be = byteorder_htonl(addr);
 
     spi_acquire(dev->spi, dev->cs, dev->mode, dev->clk);
-    /* write enable */
-    mtd_spi_cmd(dev, dev->opcode->wren);
-
-    /* Page program */
+    /* write enable and page program */
     mtd_spi_cmd_addr_write(dev, dev->opcode->page_program, addr_be, src, size);
 
     /* waiting for the command to complete before returning */
@@ -447,10 +462,10 @@ static int mtd_spi_nor_erase(mtd_dev_t *mtd, uint32_t addr, uint32_t size)
     spi_acquire(dev->spi, dev->cs, dev->mode, dev->clk);
     while (size) {
         be_uint32_t addr_be = byteorder_htonl(addr);
-        /* write enable */
-        mtd_spi_cmd(dev, dev->opcode->wren);
 
         if (size == total_size) {
+            /* write enable */
+            mtd_spi_cmd(dev, dev->opcode->wren);
             mtd_spi_cmd(dev, dev->opcode->chip_erase);
             size -= total_size;
         }
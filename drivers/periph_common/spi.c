@@ -19,6 +19,7 @@
  *
  * @}
  */
+#include <assert.h>
 #include <stddef.h>
 
 #include "board.h"
@@ -70,4 +71,48 @@ void spi_transfer_regs(spi_t bus, spi_cs_t cs,
 }
 #endif
 
+#ifndef PERIPH_SPI_PROVIDES_TRANSFER_ASYNC
+/* descriptors queued but not yet done, only non-empty while
+ * spi_transfer_async() processes them (SPI_DEV() is not an identity mapping
+ * on all platforms, hence the size) */
+static spi_xfer_t *_queue_head[SPI_DEV(SPI_NUMOF)];
+static spi_xfer_t *_queue_tail[SPI_DEV(SPI_NUMOF)];
+
+void spi_transfer_async(spi_t bus, spi_cs_t cs, spi_xfer_t *xfer)
+{
+    assert(xfer);
+
+    spi_xfer_t *last = xfer;
+    while (last->next) {
+        last = last->next;
+    }
+
+    if (_queue_head[bus]) {
+        /* called from a completion callback, the outer call will process the
+         * appended descriptors in order */
+        _queue_tail[bus]->next = xfer;
+        _queue_tail[bus] = last;
+        return;
+    }
+
+    _queue_head[bus] = xfer;
+    _queue_tail[bus] = last;
+    while (_queue_head[bus]) {
+        spi_xfer_t *cur = _queue_head[bus];
+        spi_transfer_bytes(bus, cs, cur->cont, cur->out, cur->in, cur->len);
+        if (cur->cb) {
+            cur->cb(cur->arg);
+        }
+        /* only advance now, the callback may have appended to the chain */
+        _queue_head[bus] = cur->next;
+    }
+}
+
+void spi_transfer_wait(spi_t bus)
+{
+    /* the fallback implementation is synchronous */
+    (void)bus;
+}
+#endif
+
 #endif /* SPI_NUMOF */
@@ -49,7 +49,7 @@ extern "C" {
 #define SD_R1_RESPONSE_ILLEGAL_CMD_ERROR (1<<2)
 #define SD_R1_RESPONSE_ERASE_RESET       (1<<1)
 #define SD_R1_RESPONSE_IN_IDLE_STATE     (0x01)
-#define SD_INVALID_R1_RESPONSE           (1<<7)
+#define SD_INVALID_R1_RESPONSE           ((char)(1<<7))
 
 #define R1_VALID(X) (((X) >> 7) == 0)
 #define R1_PARAM_ERR(X)   ((((X) &SD_R1_RESPONSE_PARAM_ERROR) != 0))
@@ -113,9 +113,9 @@ extern "C" {
 #define SD_CMD_59_ARG_DIS 0x00000000
 
 /* see sd spec. 7.3.3 Control Tokens */
-#define SD_DATA_TOKEN_CMD_17_18_24 0xFE
-#define SD_DATA_TOKEN_CMD_25       0xFC
-#define SD_DATA_TOKEN_CMD_25_STOP  0xFD
+#define SD_DATA_TOKEN_CMD_17_18_24 ((char)0xFE)
+#define SD_DATA_TOKEN_CMD_25       ((char)0xFC)
+#define SD_DATA_TOKEN_CMD_25_STOP  ((char)0xFD)
 
 #define SD_SIZE_OF_CID_AND_CSD_REG 16
 #define SD_SIZE_OF_SD_STATUS 64
@@ -147,7 +147,7 @@ extern "C" {
 /* after init procedure is finished the driver auto sets the card to this speed */
 #define SD_CARD_SPI_SPEED_POSTINIT SPI_CLK_10MHZ
 
-#define SD_CARD_DUMMY_BYTE 0xFF
+#define SD_CARD_DUMMY_BYTE ((char)0xFF)
 
 #define SDCARD_SPI_IEC_KIBI (1024L)
 #define SDCARD_SPI_SI_KILO  (1000L)
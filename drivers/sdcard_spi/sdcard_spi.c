@@ -24,7 +24,7 @@
 #include "sdcard_spi_params.h"
 #include "periph/spi.h"
 #include "periph/gpio.h"
-#include "checksum/ucrc16.h"
+#include "checksum/crc16_ccitt.h"
 #include "xtimer.h"
 
 #include <stdio.h>
@@ -40,8 +40,10 @@ static inline bool _wait_for_token(sdcard_spi_t *card, char token, int32_t max_r
 static sd_init_fsm_state_t _init_sd_fsm_step(sdcard_spi_t *card, sd_init_fsm_state_t state);
 static sd_rw_response_t _read_cid(sdcard_spi_t *card);
 static sd_rw_response_t _read_csd(sdcard_spi_t *card);
-static sd_rw_response_t _read_data_packet(sdcard_spi_t *card, char token, char *data, int size);
-static sd_rw_response_t _write_data_packet(sdcard_spi_t *card, char token, const char *data, int size);
+static sd_rw_response_t _read_data_packets(sdcard_spi_t *card, char token, char *data, int size,
+                                           int nbl, int *reads);
+static sd_rw_response_t _write_data_packets(sdcard_spi_t *card, char token, const char *data,
+                                            int size, int nbl, int *written);
 
 /* CRC-7 (polynomial: x^7 + x^3 + 1) LSB of CRC-7 in a 8-bit variable is always 1*/
 static char _crc_7(const char *data, int n);
@@ -59,6 +61,15 @@ static inline int _hw_spi_rxtx_byte(sdcard_spi_t *card, char out, char *in);
 /* function pointer to switch to hw spi mode after init sequence */
 static int (*_dyn_spi_rxtx_byte)(sdcard_spi_t *card, char out, char *in);
 
+/* CRC16 of data blocks (CRC-16/XMODEM) */
+static inline uint16_t _crc_16(const char *data, int n)
+{
+    return crc16_ccitt_update(0, (const unsigned char *)data, n);
+}
+
+/* dummy bytes sent while reading CRCs and data responses */
+static const char _dummy_bytes[2] = { SD_CARD_DUMMY_BYTE, SD_CARD_DUMMY_BYTE };
+
 int sdcard_spi_init(sdcard_spi_t *card, const sdcard_spi_params_t *params)
 {
     sd_init_fsm_state_t state = SD_INIT_START;
@@ -172,7 +183,7 @@ static sd_init_fsm_state_t _init_sd_fsm_step(sdcard_spi_t *card, sd_init_fsm_sta
                     /* check if lower 12 bits (voltage range and check pattern) of response and arg
                        are equal to verify compatibility and communication is working properly */
                     if (((r7[2] & 0x0F) == ((cmd8_arg >> 8) & 0x0F)) &&
-                        (r7[3] == (cmd8_arg & 0xFF))) {
+                        ((uint8_t)r7[3] == (cmd8_arg & 0xFF))) {
                         DEBUG("CMD8: [R7 MATCH]\n");
                         return SD_INIT_SEND_ACMD41_HCS;
                     }
@@ -567,6 +578,17 @@ static inline int _transfer_bytes(sdcard_spi_t *card, const char *out, char *in,
     unsigned trans_bytes = 0;
     char in_temp;
 
+    if ((_dyn_spi_rxtx_byte == &_hw_spi_rxtx_byte) && ((out != NULL) || (in != NULL))) {
+        if (out == NULL) {
+            /* send dummy bytes from the receive buffer, they get replaced by
+               the received data */
+            memset(in, SD_CARD_DUMMY_BYTE, length);
+            out = in;
+        }
+        spi_transfer_bytes(card->params.spi_dev, GPIO_UNDEF, true, out, in, length);
+        return length;
+    }
+
     for (trans_bytes = 0; trans_bytes < length; trans_bytes++) {
         if (out != NULL) {
             trans_ret = _dyn_spi_rxtx_byte(card, out[trans_bytes], &in_temp);
@@ -585,45 +607,61 @@ static inline int _transfer_bytes(sdcard_spi_t *card, const char *out, char *in,
     return trans_bytes;
 }
 
-static sd_rw_response_t _read_data_packet(sdcard_spi_t *card, char token, char *data, int size)
+static sd_rw_response_t _read_data_packets(sdcard_spi_t *card, char token, char *data, int size,
+                                           int nbl, int *reads)
 {
-    DEBUG("_read_data_packet: size: %d\n", size);
-    if (_wait_for_token(card, token, SD_DATA_TOKEN_RETRY_CNT) == true) {
-        DEBUG("_read_data_packet: [GOT TOKEN]\n");
-    }
-    else {
-        DEBUG("_read_data_packet: [GOT NO TOKEN]\n");
-        return SD_RW_NO_TOKEN;
-    }
-
-    if (_transfer_bytes(card, NULL, data, size) == size) {
-
-        DEBUG("_read_data_packet: data: ");
-        for (int i = 0; i < size; i++) {
-            DEBUG("0x%02X ", data[i]);
+    DEBUG("_read_data_packets: size: %d, nbl: %d\n", size, nbl);
+
+    sd_rw_response_t state = SD_RW_OK;
+    /* CRCs of the blocks in flight and of the previous one */
+    char crc_bytes[2][2];
+    spi_xfer_t xfer[2];
+
+    /* the CRC of each block is verified while the next one is transferred */
+    for (int i = 0; (i <= nbl) && (state == SD_RW_OK); i++) {
+        bool queued = false;
+
+        if (i < nbl) {
+            if (_wait_for_token(card, token, SD_DATA_TOKEN_RETRY_CNT) == true) {
+                char *block = &data[i * size];
+
+                /* dummy bytes are sent from the block buffer, they get
+                   replaced by the received data */
+                memset(block, SD_CARD_DUMMY_BYTE, size);
+                xfer[0] = (spi_xfer_t){ .next = &xfer[1], .out = block, .in = block,
+                                        .len = size, .cont = true };
+                xfer[1] = (spi_xfer_t){ .out = _dummy_bytes, .in = crc_bytes[i & 1],
+                                        .len = sizeof(crc_bytes[0]), .cont = true };
+                spi_transfer_async(card->params.spi_dev, GPIO_UNDEF, xfer);
+                queued = true;
+            }
+            else {
+                DEBUG("_read_data_packets: [GOT NO TOKEN]\n");
+                state = SD_RW_NO_TOKEN;
+            }
         }
-        DEBUG("\n");
 
-        char crc_bytes[2];
-        if (_transfer_bytes(card, 0, crc_bytes, sizeof(crc_bytes)) == sizeof(crc_bytes)) {
-            uint16_t data_crc16 = (crc_bytes[0] << 8) | crc_bytes[1];
+        if (i > 0) {
+            char *crc = crc_bytes[(i - 1) & 1];
+            uint16_t data_crc16 = ((uint8_t)crc[0] << 8) | (uint8_t)crc[1];
 
-            if (ucrc16_calc_be((uint8_t *)data, size, UCRC16_CCITT_POLY_BE, 0) == data_crc16) {
-                DEBUG("_read_data_packet: [OK]\n");
-                return SD_RW_OK;
+            if (_crc_16(&data[(i - 1) * size], size) == data_crc16) {
+                (*reads)++;
             }
             else {
-                DEBUG("_read_data_packet: [CRC_MISMATCH]\n");
-                return SD_RW_CRC_MISMATCH;
+                DEBUG("_read_data_packets: [CRC_MISMATCH]\n");
+                if (state == SD_RW_OK) {
+                    state = SD_RW_CRC_MISMATCH;
+                }
             }
         }
 
-        DEBUG("_read_data_packet: _transfer_bytes [RX_TX_ERROR] (while transmitting crc)\n");
-        return SD_RW_RX_TX_ERROR;
+        if (queued) {
+            spi_transfer_wait(card->params.spi_dev);
+        }
     }
 
-    DEBUG("_read_data_packet: _transfer_bytes [RX_TX_ERROR] (while transmitting payload)\n");
-    return SD_RW_RX_TX_ERROR;
+    return state;
 }
 
 static inline int _read_blocks(sdcard_spi_t *card, int cmd_idx, int bladdr, char *data, int blsz,
@@ -638,17 +676,12 @@ static inline int _read_blocks(sdcard_spi_t *card, int cmd_idx, int bladdr, char
     if (R1_VALID(cmd_r1_resu) && !R1_ERROR(cmd_r1_resu)) {
         DEBUG("_read_blocks: send CMD%d: [OK]\n", cmd_idx);
 
-        for (int i = 0; i < nbl; i++) {
-            *state = _read_data_packet(card, SD_DATA_TOKEN_CMD_17_18_24, &(data[i * blsz]), blsz);
+        *state = _read_data_packets(card, SD_DATA_TOKEN_CMD_17_18_24, data, blsz, nbl, &reads);
 
-            if (*state != SD_RW_OK) {
-                DEBUG("_read_blocks: _read_data_packet: [FAILED]\n");
-                _unselect_card_spi(card);
-                return reads;
-            }
-            else {
-                reads++;
-            }
+        if (*state != SD_RW_OK) {
+            DEBUG("_read_blocks: _read_data_packets: [FAILED]\n");
+            _unselect_card_spi(card);
+            return reads;
         }
 
         /* if this was a multi-block read */
@@ -689,59 +722,57 @@ int sdcard_spi_read_blocks(sdcard_spi_t *card, int blockaddr, char *data, int bl
     }
 }
 
-static sd_rw_response_t _write_data_packet(sdcard_spi_t *card, char token, const char *data, int size)
+static sd_rw_response_t _write_data_packets(sdcard_spi_t *card, char token, const char *data,
+                                            int size, int nbl, int *written)
 {
+    char crc_bytes[sizeof(uint16_t)];
+    uint16_t data_crc16 = _crc_16(data, size);
+
+    for (int i = 0; i < nbl; i++) {
+        char data_response;
+
+        crc_bytes[0] = data_crc16 >> 8;
+        crc_bytes[1] = data_crc16 & 0xFF;
+
+        spi_xfer_t xfer[] = {
+            { .next = &xfer[1], .out = &token, .len = 1, .cont = true },
+            { .next = &xfer[2], .out = &data[i * size], .len = size, .cont = true },
+            { .next = &xfer[3], .out = crc_bytes, .len = sizeof(crc_bytes), .cont = true },
+            { .out = _dummy_bytes, .in = &data_response, .len = 1, .cont = true },
+        };
+        spi_transfer_async(card->params.spi_dev, GPIO_UNDEF, xfer);
+
+        /* compute the CRC of the next block while this one is transferred */
+        if (i + 1 < nbl) {
+            data_crc16 = _crc_16(&data[(i + 1) * size], size);
+        }
+        spi_transfer_wait(card->params.spi_dev);
 
-    spi_transfer_byte(card->params.spi_dev, GPIO_UNDEF, true, token);
-
-    if (_transfer_bytes(card, data, 0, size) == size) {
-
-        uint16_t data_crc16 = ucrc16_calc_be((uint8_t *)data, size, UCRC16_CCITT_POLY_BE, 0);
-        char crc[sizeof(uint16_t)] = { data_crc16 >> 8, data_crc16 & 0xFF };
-
-        if (_transfer_bytes(card, crc, 0, sizeof(crc)) == sizeof(crc)) {
-
-            char data_response;
-
-            data_response = (char)spi_transfer_byte(card->params.spi_dev, GPIO_UNDEF,
-                                                    true, SD_CARD_DUMMY_BYTE);
-
-            DEBUG("_write_data_packet: DATA_RESPONSE: 0x%02x\n", data_response);
-
-            if (DATA_RESPONSE_IS_VALID(data_response)) {
-
-                if (DATA_RESPONSE_ACCEPTED(data_response)) {
-                    DEBUG("_write_data_packet: DATA_RESPONSE: [OK]\n");
-                    return SD_RW_OK;
-                }
-                else {
-
-                    if (DATA_RESPONSE_WRITE_ERR(data_response)) {
-                        DEBUG("_write_data_packet: DATA_RESPONSE: [WRITE_ERROR]\n");
-                    }
-
-                    if (DATA_RESPONSE_CRC_ERR(data_response)) {
-                        DEBUG("_write_data_packet: DATA_RESPONSE: [CRC_ERROR]\n");
-                    }
-                    return SD_RW_WRITE_ERROR;
-                }
+        DEBUG("_write_data_packets: DATA_RESPONSE: 0x%02x\n", data_response);
 
+        if (!DATA_RESPONSE_IS_VALID(data_response)) {
+            DEBUG("_write_data_packets: DATA_RESPONSE invalid\n");
+            return SD_RW_RX_TX_ERROR;
+        }
+        if (!DATA_RESPONSE_ACCEPTED(data_response)) {
+            if (DATA_RESPONSE_WRITE_ERR(data_response)) {
+                DEBUG("_write_data_packets: DATA_RESPONSE: [WRITE_ERROR]\n");
             }
-            else {
-                DEBUG("_write_data_packet: DATA_RESPONSE invalid\n");
-                return SD_RW_RX_TX_ERROR;
+            if (DATA_RESPONSE_CRC_ERR(data_response)) {
+                DEBUG("_write_data_packets: DATA_RESPONSE: [CRC_ERROR]\n");
             }
-
+            return SD_RW_WRITE_ERROR;
         }
-        else {
-            DEBUG("_write_data_packet: [RX_TX_ERROR] (while transmitting CRC16)\n");
-            return SD_RW_RX_TX_ERROR;
+
+        if (!_wait_for_not_busy(card, SD_WAIT_FOR_NOT_BUSY_CNT)) {
+            DEBUG("_write_data_packets: _wait_for_not_busy: [FAILED]\n");
+            return SD_RW_TIMEOUT;
         }
+        (*written)++;
     }
-    else {
-        DEBUG("_write_data_packet: [RX_TX_ERROR] (while transmitting payload)\n");
-        return SD_RW_RX_TX_ERROR;
-    }
+
+    DEBUG("_write_data_packets: [OK]\n");
+    return SD_RW_OK;
 }
 
 static inline int _write_blocks(sdcard_spi_t *card, char cmd_idx, int bladdr, const char *data, int blsz,
@@ -756,7 +787,7 @@ static inline int _write_blocks(sdcard_spi_t *card, char cmd_idx, int bladdr, co
     if (R1_VALID(cmd_r1_resu) && !R1_ERROR(cmd_r1_resu)) {
         DEBUG("_write_blocks: send CMD%d: [OK]\n", cmd_idx);
 
-        int token;
+        char token;
         if (cmd_idx == SD_CMD_25) {
             token = SD_DATA_TOKEN_CMD_25;
         }
@@ -764,21 +795,13 @@ static inline int _write_blocks(sdcard_spi_t *card, char cmd_idx, int bladdr, co
             token = SD_DATA_TOKEN_CMD_17_18_24;
         }
 
-        for (int i = 0; i < nbl; i++) {
-            sd_rw_response_t write_resu = _write_data_packet(card, token, &(data[i * blsz]), blsz);
-            if (write_resu != SD_RW_OK) {
-                DEBUG("_write_blocks: _write_data_packet: [FAILED]\n");
-                _unselect_card_spi(card);
-                *state = write_resu;
-                return written;
-            }
-            if (!_wait_for_not_busy(card, SD_WAIT_FOR_NOT_BUSY_CNT)) {
-                DEBUG("_write_blocks: _wait_for_not_busy: [FAILED]\n");
-                _unselect_card_spi(card);
-                *state = SD_RW_TIMEOUT;
-                return written;
-            }
-            written++;
+        sd_rw_response_t write_resu = _write_data_packets(card, token, data, blsz, nbl,
+                                                          &written);
+        if (write_resu != SD_RW_OK) {
+            DEBUG("_write_blocks: _write_data_packets: [FAILED]\n");
+            _unselect_card_spi(card);
+            *state = write_resu;
+            return written;
         }
 
         /* if this is a multi-block write it is needed to issue a stop
@@ -791,8 +814,10 @@ static inline int _write_blocks(sdcard_spi_t *card, char cmd_idx, int bladdr, co
             /* sd card needs dummy byte before we can wait for not-busy
                state */
             _send_dummy_byte(card);
-            if (!_wait_for_not_busy(card, SD_WAIT_FOR_NOT_BUSY_CNT)) {
-                _unselect_card_spi(card);
+            if (_wait_for_not_busy(card, SD_WAIT_FOR_NOT_BUSY_CNT)) {
+                *state = SD_RW_OK;
+            }
+            else {
                 *state = SD_RW_TIMEOUT;
             }
         }
@@ -151,7 +151,8 @@ static int cmd_pub(int argc, char **argv)
     }
 
     /* step 2: publish data */
-    if (emcute_pub(&t, argv[2], strlen(argv[2]), flags) != EMCUTE_OK) {
+    if ((emcute_pub(&t, argv[2], strlen(argv[2]), flags) != EMCUTE_OK) ||
+        (emcute_flush() != EMCUTE_OK)) {
         printf("error: unable to publish data to topic '%s [%i]'\n",
                 t.name, (int)t.id);
         return 1;
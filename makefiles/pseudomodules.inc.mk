@@ -69,10 +69,16 @@ PSEUDOMODULES += saul_adc
 PSEUDOMODULES += saul_default
 PSEUDOMODULES += saul_gpio
 PSEUDOMODULES += schedstatistics
+PSEUDOMODULES += sha256_shani
+PSEUDOMODULES += sha256_unrolled
 PSEUDOMODULES += sock
+PSEUDOMODULES += sock_dns_async
+PSEUDOMODULES += sock_dns_cache
 PSEUDOMODULES += sock_ip
 PSEUDOMODULES += sock_tcp
 PSEUDOMODULES += sock_udp
+PSEUDOMODULES += stdio_uart_txbuf
+PSEUDOMODULES += vfs_buffer
 
 # print ascii representation in function od_hex_dump()
 PSEUDOMODULES += od_string
@@ -214,6 +214,31 @@ LUALIB_API int lua_riot_do_module(const char *modname, void *memory, size_t mem_
 LUALIB_API int lua_riot_do_buffer(const uint8_t *buf, size_t buflen, void *memory,
                                   size_t mem_size, uint16_t modmask, int *retval);
 
+/**
+ * Initialize the interpreter and run precompiled bytecode in protected mode.
+ *
+ * The bytecode is created at build time by luac, see `LUA_BYTECODE` in
+ * @ref pkg_lua. It is read in place from @p buf, so @p buf can stay in ROM.
+ * This skips the parser, which saves both startup time and heap. The loaded
+ * functions, including their instructions and constants, are still copied
+ * into the Lua heap, which needs at least about @p buflen bytes for them.
+ *
+ * @warning The interpreter does not verify bytecode. Only run bytecode
+ *          that was built together with the application.
+ *
+ * @see lua_riot_do_module() for more information on internal errors.
+ *
+ * @param       buf     Bytecode, as output by luac.
+ * @param       buflen  Size of the bytecode in bytes.
+ * @param       memory      @see lua_riot_newstate()
+ * @param       mem_size    @see lua_riot_newstate()
+ * @param       modmask     @see lua_riot_newstate()
+ * @param[out]  retval      @see lua_riot_do_module()
+ * @return      @see lua_riot_do_module().
+ */
+LUALIB_API int lua_riot_do_bytecode(const uint8_t *buf, size_t buflen, void *memory,
+                                    size_t mem_size, uint16_t modmask, int *retval);
+
 #ifdef __cplusplus
 extern "C" }
 #endif
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup  pkg_lua
+ * @{
+ * @file
+ *
+ * @brief   Host build of the Lua compiler (luac)
+ *
+ * luaL_newstate() is removed from the package, as applications on RIOT must
+ * supply their own allocator. The stock compiler needs it, so it is provided
+ * here before including the compiler itself.
+ *
+ * @}
+ */
+
+#define luac_c
+#define LUA_CORE
+
+#include "lprefix.h"
+
+#include <stdlib.h>
+
+#include "lua.h"
+
+static void *_alloc(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+    (void)ud;
+    (void)osize;
+
+    if (nsize == 0) {
+        free(ptr);
+        return NULL;
+    }
+    return realloc(ptr, nsize);
+}
+
+static lua_State *luaL_newstate(void)
+{
+    return lua_newstate(_alloc, NULL);
+}
+
+#include "luac.c"
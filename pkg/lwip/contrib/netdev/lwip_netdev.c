@@ -14,6 +14,7 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <sys/uio.h>
 #include <inttypes.h>
 
@@ -31,6 +32,7 @@
 #include "net/ipv6/addr.h"
 #include "net/netdev.h"
 #include "net/netopt.h"
+#include "kernel_defines.h"
 #include "utlist.h"
 #include "thread.h"
 
@@ -49,7 +51,21 @@
 static kernel_pid_t _pid = KERNEL_PID_UNDEF;
 static char _stack[LWIP_NETDEV_STACKSIZE];
 static msg_t _queue[LWIP_NETDEV_QUEUE_LEN];
-static char _tmp_buf[LWIP_NETDEV_BUFLEN];
+
+#if LWIP_NETDEV_RX_BUF_NUMOF
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error "LWIP_NETDEV_RX_BUF_NUMOF requires LWIP_SUPPORT_CUSTOM_PBUF"
+#endif
+
+/* receive buffer lent to lwIP as a custom pbuf */
+typedef struct {
+    struct pbuf_custom pbuf;
+    volatile bool used;     /* set by the multiplexing thread, cleared on free */
+    uint8_t data[LWIP_NETDEV_BUFLEN];
+} _rx_buf_t;
+
+static _rx_buf_t _rx_bufs[LWIP_NETDEV_RX_BUF_NUMOF];
+#endif
 
 #ifdef MODULE_NETDEV_ETH
 static err_t _eth_link_output(struct netif *netif, struct pbuf *p);
@@ -231,22 +247,69 @@ static err_t _ieee802154_link_output(struct netif *netif, struct pbuf *p)
 }
 #endif
 
+#if LWIP_NETDEV_RX_BUF_NUMOF
+static void _rx_buf_free(struct pbuf *p)
+{
+    /* may be called from any thread that frees the packet */
+    _rx_buf_t *buf = container_of((struct pbuf_custom *)p, _rx_buf_t, pbuf);
+
+    buf->used = false;
+}
+
+static struct pbuf *_rx_buf_alloc(u16_t len)
+{
+    for (unsigned i = 0; i < LWIP_NETDEV_RX_BUF_NUMOF; i++) {
+        _rx_buf_t *buf = &_rx_bufs[i];
+
+        if (!buf->used) {
+            buf->pbuf.custom_free_function = _rx_buf_free;
+            struct pbuf *p = pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF,
+                                                 &buf->pbuf, buf->data,
+                                                 sizeof(buf->data));
+            if (p != NULL) {
+                buf->used = true;
+            }
+            return p;
+        }
+    }
+    return NULL;
+}
+#endif
+
 static struct pbuf *_get_recv_pkt(netdev_t *dev)
 {
-    int len = dev->driver->recv(dev, _tmp_buf, sizeof(_tmp_buf), NULL);
+    struct pbuf *p = NULL;
+    int len = dev->driver->recv(dev, NULL, 0, NULL);
 
-    if (len < 0) {
+    if (len <= 0) {
         DEBUG("lwip_netdev: an error occurred while reading the packet\n");
         return NULL;
     }
     assert(((unsigned)len) <= UINT16_MAX);
-    struct pbuf *p = pbuf_alloc(PBUF_RAW, (u16_t)len, PBUF_POOL);
-
+#if LWIP_NETDEV_RX_BUF_NUMOF
+    p = _rx_buf_alloc((u16_t)len);
+#endif
+    if (p == NULL) {
+        /* all receive buffers are held by the stack (or too small), so
+         * receive into a contiguous pbuf from the heap instead */
+        p = pbuf_alloc(PBUF_RAW, (u16_t)len, PBUF_RAM);
+    }
     if (p == NULL) {
         DEBUG("lwip_netdev: can not allocate in pbuf\n");
+        /* drop packet */
+        dev->driver->recv(dev, NULL, len, NULL);
+        return NULL;
+    }
+    /* the driver copies the frame directly into the pbuf */
+    int res = dev->driver->recv(dev, p->payload, len, NULL);
+    if (res < 0) {
+        DEBUG("lwip_netdev: an error occurred while reading the packet\n");
+        pbuf_free(p);
         return NULL;
     }
-    pbuf_take(p, _tmp_buf, len);
+    if (res < len) {
+        pbuf_realloc(p, (u16_t)res);
+    }
     return p;
 }
 
@@ -274,6 +337,7 @@ static void _event_cb(netdev_t *dev, netdev_event_t event)
                 }
                 if (netif->input(p, netif) != ERR_OK) {
                     DEBUG("lwip_netdev: error inputing packet\n");
+                    pbuf_free(p);
                     return;
                 }
             }
@@ -32,13 +32,26 @@ extern "C" {
 #endif
 
 /**
- * @brief   Length of the temporary copying buffer for receival.
+ * @brief   Length of the receive buffers.
  * @note    It should be as long as the maximum packet length of all the netdev you use.
  */
 #ifndef LWIP_NETDEV_BUFLEN
 #define LWIP_NETDEV_BUFLEN      (ETHERNET_MAX_LEN)
 #endif
 
+/**
+ * @brief   Number of receive buffers of @ref LWIP_NETDEV_BUFLEN bytes
+ *
+ * Received frames are read by the driver directly into one of these buffers,
+ * which is handed to lwIP as a custom pbuf and returned when lwIP frees the
+ * pbuf. If all buffers are in use, e.g. because TCP segments wait to be read
+ * by the application, frames are received into a pbuf from lwIP's heap
+ * instead. Set to 0 to always use the heap.
+ */
+#ifndef LWIP_NETDEV_RX_BUF_NUMOF
+#define LWIP_NETDEV_RX_BUF_NUMOF    (2)
+#endif
+
 /**
  * @brief   Initializes the netdev adapter.
  *
@@ -139,6 +139,7 @@ extern "C" {
 
 #define LWIP_DONT_PROVIDE_BYTEORDER_FUNCTIONS
 #define MEMP_MEM_MALLOC         (1)
+#define LWIP_SUPPORT_CUSTOM_PBUF    (1)     /* receive buffers of lwip_netdev */
 #define NETIF_MAX_HWADDR_LEN    (GNRC_NETIF_HDR_L2ADDR_MAX_LEN)
 
 #define TCPIP_THREAD_STACKSIZE  (THREAD_STACKSIZE_DEFAULT)
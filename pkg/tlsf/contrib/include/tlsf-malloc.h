@@ -24,6 +24,16 @@
  * used. Boards should use tlsf_add_global_pool() at startup to add all the memory
  * regions they want to make available for dynamic allocation via malloc().
  *
+ * Subsystems with a bursty or unbounded memory demand (packet buffers, script
+ * interpreters, ...) can carve a named arena out of the global heap (or out
+ * of a dedicated buffer) with tlsf_arena_init(). An arena is a TLSF control
+ * block of its own, so its allocations can neither exhaust nor fragment the
+ * global heap. The global heap itself is the arena named "heap".
+ *
+ * Every arena keeps track of its current and peak usage and of the number of
+ * failed allocations. Use tlsf_arena_stats() or the `heap` shell command to
+ * read them.
+ *
  * @{
  * @file
  *
@@ -43,6 +53,46 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   A memory area of an arena
+ *
+ * Kept at the start of the area itself, so an arena takes any number of them.
+ */
+typedef struct tlsf_arena_pool {
+    struct tlsf_arena_pool *next;           /**< next area of the arena */
+    pool_t pool;                            /**< TLSF pool of the area */
+} tlsf_arena_pool_t;
+
+/**
+ * @brief   A named TLSF arena
+ *
+ * @note    All members are private, use tlsf_arena_stats() to read them.
+ */
+typedef struct tlsf_arena {
+    struct tlsf_arena *next;                /**< next registered arena */
+    const char *name;                       /**< name of the arena */
+    tlsf_t tlsf;                            /**< TLSF control block */
+    tlsf_arena_pool_t *pools;               /**< memory areas of the arena */
+    size_t size;                            /**< total size of all pools */
+    size_t used;                            /**< bytes currently allocated */
+    size_t max_used;                        /**< high-water mark of @p used */
+    unsigned failed;                        /**< number of failed allocations */
+} tlsf_arena_t;
+
+/**
+ * @brief   Usage statistics of an arena
+ */
+typedef struct {
+    size_t size;            /**< total size of all pools of the arena */
+    size_t used;            /**< bytes currently allocated */
+    size_t max_used;        /**< highest number of bytes allocated at once */
+    size_t free;            /**< sum of all free blocks */
+    size_t largest_free;    /**< largest free block */
+    unsigned failed;        /**< number of failed allocations */
+    unsigned fragmentation; /**< share of free memory not in the largest
+                             *   free block in percent */
+} tlsf_arena_stats_t;
+
 /**
  * @brief Struct to hold the total sizes of free and used blocks
  * Used for @ref tlsf_size_walker()
@@ -69,7 +119,8 @@ void tlsf_size_walker(void* ptr, size_t size, int used, void* user);
  * Add an area of memory to the global allocator pool.
  *
  * The first time this function is called, it will automatically perform a
- * tlsf_create() on the global tlsf_control block.
+ * tlsf_create() on the global tlsf_control block. It can be called for any
+ * number of areas. Each one loses a few bytes to link it to the others.
  *
  * @warning If this module is used, then this function MUST be called at least
  *          once, before any allocations take place.
@@ -88,6 +139,101 @@ int tlsf_add_global_pool(void *mem, size_t bytes);
  */
 tlsf_t *_tlsf_get_global_control(void);
 
+/**
+ * @brief   Initialize and register a named arena
+ *
+ * @param[out] arena    arena to initialize
+ * @param[in] name      name of the arena, used for statistics only
+ * @param[in] mem       memory for the arena, should be aligned to 4 bytes.
+ *                      If NULL, @p bytes are allocated from the global heap.
+ * @param[in] bytes     size in bytes of the memory area
+ *
+ * @return  0 on success
+ * @return  -ENOMEM if @p mem is NULL and the global heap is exhausted
+ * @return  -EINVAL if @p bytes is too small or too large for a TLSF pool
+ */
+int tlsf_arena_init(tlsf_arena_t *arena, const char *name, void *mem,
+                    size_t bytes);
+
+/**
+ * @brief   Add another area of memory to an arena
+ *
+ * There is no limit on the number of areas of an arena.
+ *
+ * @param[in,out] arena the arena
+ * @param[in] mem       pointer to memory area, should be aligned to 4 bytes
+ * @param[in] bytes     size in bytes of the memory area
+ *
+ * @return  0 on success, nonzero on failure
+ */
+int tlsf_arena_add_pool(tlsf_arena_t *arena, void *mem, size_t bytes);
+
+/**
+ * @brief   Allocate a block of @p bytes from an arena
+ *
+ * @param[in,out] arena the arena
+ * @param[in] bytes     size of the block
+ *
+ * @return  the block, NULL if the arena is exhausted
+ */
+void *tlsf_arena_malloc(tlsf_arena_t *arena, size_t bytes);
+
+/**
+ * @brief   Allocate a block of @p bytes aligned to @p align from an arena
+ *
+ * @param[in,out] arena the arena
+ * @param[in] align     alignment, power of two
+ * @param[in] bytes     size of the block
+ *
+ * @return  the block, NULL if the arena is exhausted
+ */
+void *tlsf_arena_memalign(tlsf_arena_t *arena, size_t align, size_t bytes);
+
+/**
+ * @brief   Resize a block of an arena
+ *
+ * Behaves like realloc(3).
+ *
+ * @param[in,out] arena the arena @p ptr was allocated from
+ * @param[in] ptr       the block, may be NULL
+ * @param[in] bytes     new size of the block
+ *
+ * @return  the resized block, NULL if the arena is exhausted
+ */
+void *tlsf_arena_realloc(tlsf_arena_t *arena, void *ptr, size_t bytes);
+
+/**
+ * @brief   Return a block to an arena
+ *
+ * @param[in,out] arena the arena @p ptr was allocated from
+ * @param[in] ptr       the block, may be NULL
+ */
+void tlsf_arena_free(tlsf_arena_t *arena, void *ptr);
+
+/**
+ * @brief   Get usage statistics of an arena
+ *
+ * Walks all blocks of the arena with interrupts disabled.
+ *
+ * @param[in] arena     the arena
+ * @param[out] stats    the statistics
+ */
+void tlsf_arena_stats(tlsf_arena_t *arena, tlsf_arena_stats_t *stats);
+
+/**
+ * @brief   Iterate over all arenas, starting with the global heap
+ *
+ * @param[in] prev      previous arena, NULL to get the first one
+ *
+ * @return  the arena registered after @p prev, NULL if there is none
+ */
+tlsf_arena_t *tlsf_arena_iter(const tlsf_arena_t *prev);
+
+/**
+ * @brief   Print the statistics of all arenas
+ */
+void heap_stats(void);
+
 
 #ifdef __cplusplus
 }
@@ -18,7 +18,10 @@
  *
  */
 
+#include <errno.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "irq.h"
@@ -26,9 +29,10 @@
 #include "tlsf-malloc.h"
 
 /**
- * Global memory heap (really a collection of pools, or areas)
+ * Global memory heap (really a collection of pools, or areas), also the head
+ * of the list of all arenas
  **/
-static tlsf_t gheap = NULL;
+static tlsf_arena_t gheap = { .name = "heap" };
 
 /* TODO: Add defines for other compilers */
 #if defined(__GNUC__) && !defined(__clang__)    /* Clang supports __GNUC__ but
@@ -49,20 +53,187 @@ static tlsf_t gheap = NULL;
 
 #endif /* __GNUC__ */
 
+static inline void _account_alloc(tlsf_arena_t *arena, void *ptr)
+{
+    if (ptr == NULL) {
+        arena->failed++;
+        return;
+    }
+    arena->used += tlsf_block_size(ptr);
+    if (arena->used > arena->max_used) {
+        arena->max_used = arena->used;
+    }
+}
+
+/* room for the link at the start of each area, keeping the TLSF alignment */
+#define POOL_HDR_SIZE   ((sizeof(tlsf_arena_pool_t) + 7U) & ~7U)
+
+static int _add_pool(tlsf_arena_t *arena, void *mem, size_t bytes)
+{
+    if (arena->tlsf == NULL) {
+        if (bytes < tlsf_size()) {
+            return -EINVAL;
+        }
+        arena->tlsf = tlsf_create(mem);
+        if (arena->tlsf == NULL) {
+            return -EINVAL;
+        }
+        mem = (char *)mem + tlsf_size();
+        bytes -= tlsf_size();
+    }
+    if (bytes < POOL_HDR_SIZE) {
+        return -EINVAL;
+    }
+    tlsf_arena_pool_t *area = mem;
+    area->pool = tlsf_add_pool(arena->tlsf, (char *)mem + POOL_HDR_SIZE,
+                               bytes - POOL_HDR_SIZE);
+    if (area->pool == NULL) {
+        return -EINVAL;
+    }
+    area->next = arena->pools;
+    arena->pools = area;
+    arena->size += bytes - POOL_HDR_SIZE;
+    return 0;
+}
+
 int tlsf_add_global_pool(void *mem, size_t bytes)
 {
-    if (gheap == NULL) {
-        gheap = tlsf_create_with_pool(mem, bytes);
-        return gheap == NULL;
+    return tlsf_arena_add_pool(&gheap, mem, bytes);
+}
+
+tlsf_t *_tlsf_get_global_control(void)
+{
+    return gheap.tlsf;
+}
+
+int tlsf_arena_init(tlsf_arena_t *arena, const char *name, void *mem,
+                    size_t bytes)
+{
+    void *carved = NULL;
+    int res;
+
+    memset(arena, 0, sizeof(*arena));
+    arena->name = name;
+    if ((mem == NULL) && ((mem = carved = malloc(bytes)) == NULL)) {
+        return -ENOMEM;
+    }
+    res = _add_pool(arena, mem, bytes);
+    if (res < 0) {
+        free(carved);
+        return res;
+    }
+
+    unsigned old_state = irq_disable();
+    tlsf_arena_t *last = &gheap;
+
+    while (last->next != NULL) {
+        last = last->next;
+    }
+    last->next = arena;
+    irq_restore(old_state);
+    return 0;
+}
+
+int tlsf_arena_add_pool(tlsf_arena_t *arena, void *mem, size_t bytes)
+{
+    unsigned old_state = irq_disable();
+    int res = _add_pool(arena, mem, bytes);
+
+    irq_restore(old_state);
+    return res;
+}
+
+void *tlsf_arena_malloc(tlsf_arena_t *arena, size_t bytes)
+{
+    unsigned old_state = irq_disable();
+    void *result = tlsf_malloc(arena->tlsf, bytes);
+
+    _account_alloc(arena, result);
+    irq_restore(old_state);
+    return result;
+}
+
+void *tlsf_arena_memalign(tlsf_arena_t *arena, size_t align, size_t bytes)
+{
+    unsigned old_state = irq_disable();
+    void *result = tlsf_memalign(arena->tlsf, align, bytes);
+
+    _account_alloc(arena, result);
+    irq_restore(old_state);
+    return result;
+}
+
+void *tlsf_arena_realloc(tlsf_arena_t *arena, void *ptr, size_t bytes)
+{
+    unsigned old_state = irq_disable();
+    size_t old_size = (ptr) ? tlsf_block_size(ptr) : 0;
+    void *result = tlsf_realloc(arena->tlsf, ptr, bytes);
+
+    if (result != NULL) {
+        arena->used -= old_size;
+        _account_alloc(arena, result);
+    }
+    else if (bytes == 0) {
+        /* tlsf_realloc() freed ptr */
+        arena->used -= old_size;
     }
     else {
-        return tlsf_add_pool(gheap, mem, bytes) == NULL;
+        arena->failed++;
     }
+    irq_restore(old_state);
+    return result;
 }
 
-tlsf_t *_tlsf_get_global_control(void)
+void tlsf_arena_free(tlsf_arena_t *arena, void *ptr)
 {
-    return gheap;
+    if (ptr == NULL) {
+        return;
+    }
+
+    unsigned old_state = irq_disable();
+
+    arena->used -= tlsf_block_size(ptr);
+    tlsf_free(arena->tlsf, ptr);
+    irq_restore(old_state);
+}
+
+static void _stats_walker(void *ptr, size_t size, int used, void *user)
+{
+    tlsf_arena_stats_t *stats = user;
+
+    (void)ptr;
+    if (!used) {
+        stats->free += size;
+        if (size > stats->largest_free) {
+            stats->largest_free = size;
+        }
+    }
+}
+
+void tlsf_arena_stats(tlsf_arena_t *arena, tlsf_arena_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+
+    unsigned old_state = irq_disable();
+
+    for (tlsf_arena_pool_t *area = arena->pools; area; area = area->next) {
+        tlsf_walk_pool(area->pool, _stats_walker, stats);
+    }
+    stats->size = arena->size;
+    stats->used = arena->used;
+    stats->max_used = arena->max_used;
+    stats->failed = arena->failed;
+    irq_restore(old_state);
+
+    if (stats->free > 0) {
+        stats->fragmentation = 100 - (unsigned)(((uint64_t)stats->largest_free
+                                                 * 100) / stats->free);
+    }
+}
+
+tlsf_arena_t *tlsf_arena_iter(const tlsf_arena_t *prev)
+{
+    return (prev == NULL) ? &gheap : prev->next;
 }
 
 void tlsf_size_walker(void* ptr, size_t size, int used, void* user)
@@ -77,16 +248,29 @@ void tlsf_size_walker(void* ptr, size_t size, int used, void* user)
     }
 }
 
+void heap_stats(void)
+{
+    printf("%-12s %8s %8s %8s %8s %8s %5s %7s\n", "arena", "size", "used",
+           "peak", "free", "largest", "frag", "failed");
+    for (tlsf_arena_t *arena = tlsf_arena_iter(NULL); arena != NULL;
+         arena = tlsf_arena_iter(arena)) {
+        tlsf_arena_stats_t stats;
+
+        tlsf_arena_stats(arena, &stats);
+        printf("%-12s %8u %8u %8u %8u %8u %4u%% %7u\n", arena->name,
+               (unsigned)stats.size, (unsigned)stats.used,
+               (unsigned)stats.max_used, (unsigned)stats.free,
+               (unsigned)stats.largest_free, stats.fragmentation,
+               stats.failed);
+    }
+}
+
 /**
  * Allocate a block of size "bytes"
  */
 ATTR_MALLOC void *malloc(size_t bytes)
 {
-    unsigned old_state = irq_disable();
-    void *result = tlsf_malloc(gheap, bytes);
-
-    irq_restore(old_state);
-    return result;
+    return tlsf_arena_malloc(&gheap, bytes);
 }
 
 /**
@@ -107,11 +291,7 @@ ATTR_CALLOC void *calloc(size_t count, size_t bytes)
  */
 ATTR_MALIGN void *memalign(size_t align, size_t bytes)
 {
-    unsigned old_state = irq_disable();
-    void *result = tlsf_memalign(gheap, align, bytes);
-
-    irq_restore(old_state);
-    return result;
+    return tlsf_arena_memalign(&gheap, align, bytes);
 }
 
 /**
@@ -119,11 +299,7 @@ ATTR_MALIGN void *memalign(size_t align, size_t bytes)
  */
 ATTR_REALLOC void *realloc(void *ptr, size_t size)
 {
-    unsigned old_state = irq_disable();
-    void *result = tlsf_realloc(gheap, ptr, size);
-
-    irq_restore(old_state);
-    return result;
+    return tlsf_arena_realloc(&gheap, ptr, size);
 }
 
 
@@ -132,10 +308,7 @@ ATTR_REALLOC void *realloc(void *ptr, size_t size)
  */
 void free(void *ptr)
 {
-    unsigned old_state = irq_disable();
-
-    tlsf_free(gheap, ptr);
-    irq_restore(old_state);
+    tlsf_arena_free(&gheap, ptr);
 }
 
 /**
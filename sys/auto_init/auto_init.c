@@ -28,6 +28,14 @@
 #include "xtimer.h"
 #endif
 
+#ifdef MODULE_LOG_DEFERRED
+#include "log_deferred.h"
+#endif
+
+#ifdef MODULE_SAUL_SAMPLER
+#include "saul_sampler.h"
+#endif
+
 #ifdef MODULE_GNRC_SIXLOWPAN
 #include "net/gnrc/sixlowpan.h"
 #endif
@@ -101,6 +109,14 @@ void auto_init(void)
     DEBUG("Auto init xtimer module.\n");
     xtimer_init();
 #endif
+#ifdef MODULE_LOG_DEFERRED
+    DEBUG("Auto init log_deferred module.\n");
+    log_deferred_init();
+#endif
+#ifdef MODULE_SAUL_SAMPLER
+    DEBUG("Auto init saul_sampler module.\n");
+    saul_sampler_init();
+#endif
 #ifdef MODULE_MCI
     DEBUG("Auto init mci module.\n");
     mci_initialize();
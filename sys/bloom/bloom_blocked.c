@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_bloom
+ * @{
+ *
+ * @file
+ * @brief       Blocked Bloom filter implementation
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "bloom.h"
+#include "bitfield.h"
+
+#define BLOCK_BITS      (8U * BLOOM_BLOCKED_BLOCK_SIZE)
+
+#if (BLOOM_BLOCKED_BLOCK_SIZE & (BLOOM_BLOCKED_BLOCK_SIZE - 1)) != 0
+#error "BLOOM_BLOCKED_BLOCK_SIZE must be a power of two"
+#endif
+
+/**
+ * @brief   Spread the entropy of weak input hashes over all 64 bits
+ *
+ * (MurmurHash3 finalizer)
+ */
+static inline uint64_t _mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static inline uint8_t *_block(const bloom_blocked_t *bloom, uint64_t h)
+{
+    /* maps the upper half of h to [0, numof) without a division */
+    size_t idx = (size_t)(((h >> 32) * bloom->numof) >> 32);
+
+    return &bloom->blocks[idx * BLOOM_BLOCKED_BLOCK_SIZE];
+}
+
+static inline void _add(const bloom_blocked_t *bloom, uint64_t h)
+{
+    uint8_t *block = _block(bloom, h);
+    uint32_t pos = (uint32_t)h;
+    /* odd step: the first BLOCK_BITS probes never repeat */
+    uint32_t step = (uint32_t)(h >> 16) | 1;
+
+    for (unsigned i = 0; i < bloom->k; i++) {
+        bf_set(block, pos & (BLOCK_BITS - 1));
+        pos += step;
+    }
+}
+
+static inline bool _check(const bloom_blocked_t *bloom, uint64_t h)
+{
+    const uint8_t *block = _block(bloom, h);
+    uint32_t pos = (uint32_t)h;
+    uint32_t step = (uint32_t)(h >> 16) | 1;
+
+    for (unsigned i = 0; i < bloom->k; i++) {
+        if (!bf_isset((uint8_t *)block, pos & (BLOCK_BITS - 1))) {
+            return false;
+        }
+        pos += step;
+    }
+    return true;
+}
+
+static inline void _prefetch(const bloom_blocked_t *bloom, uint64_t h)
+{
+#ifdef __GNUC__
+    __builtin_prefetch(_block(bloom, h));
+#else
+    (void)bloom;
+    (void)h;
+#endif
+}
+
+void bloom_blocked_init(bloom_blocked_t *bloom, void *buf, size_t size,
+                        unsigned k)
+{
+    assert(size >= BLOOM_BLOCKED_BLOCK_SIZE);
+    assert((k > 0) && (k <= BLOCK_BITS));
+
+    bloom->blocks = buf;
+    bloom->numof = size / BLOOM_BLOCKED_BLOCK_SIZE;
+    bloom->k = k;
+    bloom_blocked_clear(bloom);
+}
+
+void bloom_blocked_clear(bloom_blocked_t *bloom)
+{
+    memset(bloom->blocks, 0, bloom->numof * BLOOM_BLOCKED_BLOCK_SIZE);
+}
+
+void bloom_blocked_add_hash(bloom_blocked_t *bloom, uint64_t hash)
+{
+    _add(bloom, _mix(hash));
+}
+
+bool bloom_blocked_check_hash(const bloom_blocked_t *bloom, uint64_t hash)
+{
+    return _check(bloom, _mix(hash));
+}
+
+/* hashes a chunk of the batch and issues the block fetches for it */
+static size_t _hash_chunk(const bloom_blocked_t *bloom,
+                          const uint8_t *const bufs[], const size_t lens[],
+                          size_t numof, uint64_t *h)
+{
+    if (numof > BLOOM_BLOCKED_BATCH_SIZE) {
+        numof = BLOOM_BLOCKED_BATCH_SIZE;
+    }
+    for (size_t i = 0; i < numof; i++) {
+        h[i] = _mix(fnv64a_hash(bufs[i], lens[i]));
+        _prefetch(bloom, h[i]);
+    }
+    return numof;
+}
+
+void bloom_blocked_add_batch(bloom_blocked_t *bloom,
+                             const uint8_t *const bufs[], const size_t lens[],
+                             size_t numof)
+{
+    uint64_t h[BLOOM_BLOCKED_BATCH_SIZE];
+
+    for (size_t done = 0; done < numof;) {
+        size_t n = _hash_chunk(bloom, &bufs[done], &lens[done],
+                               numof - done, h);
+
+        for (size_t i = 0; i < n; i++) {
+            _add(bloom, h[i]);
+        }
+        done += n;
+    }
+}
+
+size_t bloom_blocked_check_batch(const bloom_blocked_t *bloom,
+                                 const uint8_t *const bufs[],
+                                 const size_t lens[], size_t numof,
+                                 bool *res)
+{
+    uint64_t h[BLOOM_BLOCKED_BATCH_SIZE];
+    size_t in = 0;
+
+    for (size_t done = 0; done < numof;) {
+        size_t n = _hash_chunk(bloom, &bufs[done], &lens[done],
+                               numof - done, h);
+
+        for (size_t i = 0; i < n; i++) {
+            bool found = _check(bloom, h[i]);
+
+            if (res) {
+                res[done + i] = found;
+            }
+            in += found;
+        }
+        done += n;
+    }
+    return in;
+}
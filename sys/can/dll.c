@@ -263,11 +263,12 @@ int raw_can_unsubscribe_rx_mbox(int ifnum, struct can_filter *filter, mbox_t *mb
 
 int raw_can_free_frame(can_rx_data_t *frame)
 {
-    int ret = can_router_free_frame((struct can_frame *)frame->data.iov_base);
+    struct can_frame *can_frame = frame->data.iov_base;
 
+    /* the rx data might be carried by the packet, so free it first */
     can_pkt_free_rx_data(frame);
 
-    return ret;
+    return can_router_free_frame(can_frame);
 }
 
 int raw_can_get_can_opt(int ifnum, can_opt_t *opt)
@@ -156,9 +156,26 @@ can_rx_data_t *can_pkt_alloc_rx_data(void *data, size_t len, void *arg)
     return rx;
 }
 
+can_rx_data_t *can_pkt_get_rx_data(can_pkt_t *pkt, unsigned idx, void *arg)
+{
+    if (idx >= CAN_PKT_RX_DATA_NUMOF) {
+        return can_pkt_alloc_rx_data(&pkt->frame, sizeof(pkt->frame), arg);
+    }
+
+    can_rx_data_t *rx = &pkt->rx_data[idx];
+
+    rx->data.iov_base = &pkt->frame;
+    rx->data.iov_len = sizeof(pkt->frame);
+    rx->arg = arg;
+    rx->snip = NULL;
+
+    return rx;
+}
+
 void can_pkt_free_rx_data(can_rx_data_t *data)
 {
-    if (!data) {
+    /* rx data carried by a packet has no snip of its own */
+    if (!data || !data->snip) {
         return;
     }
 
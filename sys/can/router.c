@@ -19,6 +19,7 @@
 
 #include <stdint.h>
 #include <errno.h>
+#include <string.h>
 
 #include "kernel_defines.h"
 
@@ -42,6 +43,10 @@
 #include <inttypes.h>
 #endif
 
+#if (CAN_ROUTER_HASH_BUCKETS & (CAN_ROUTER_HASH_BUCKETS - 1)) != 0
+#error "CAN_ROUTER_HASH_BUCKETS must be a power of two"
+#endif
+
 /**
  * This is a can_id element
  */
@@ -54,29 +59,62 @@ typedef struct filter_el {
 } filter_el_t;
 
 /**
- * This table contains @p CAN_ROUTER_APP_MAX lists of CAN IDs per interface
+ * This is a group of filters sharing the same mask
  */
-static can_reg_entry_t *table[CAN_DLL_NUMOF];
+typedef struct mask_group {
+    struct mask_group *next; /**< next group of the interface */
+    canid_t mask;            /**< Mask of all elements in the group */
+    unsigned numof;          /**< Number of elements in the group */
+    gnrc_pktsnip_t *snip;    /**< Pointer to the allocated snip */
+    /**
+     * Elements of the group, hashed by CAN ID
+     */
+    can_reg_entry_t *buckets[CAN_ROUTER_HASH_BUCKETS];
+} mask_group_t;
 
+/**
+ * This table contains the filter groups per interface
+ */
+static mask_group_t *table[CAN_DLL_NUMOF];
 
-static mutex_t lock = MUTEX_INIT;
+/**
+ * Locks protecting @ref table, one per interface
+ * (a zero-initialized mutex_t equals MUTEX_INIT)
+ */
+static mutex_t lock[CAN_DLL_NUMOF];
 
 static filter_el_t *_alloc_filter_el(canid_t can_id, canid_t mask, void *data);
 static void _free_filter_el(filter_el_t *el);
-static void _insert_to_list(can_reg_entry_t **list, filter_el_t *el);
-static filter_el_t *_find_filter_el(can_reg_entry_t *list, can_reg_entry_t *entry, canid_t can_id, canid_t mask, void *data);
+static filter_el_t *_find_filter_el(mask_group_t *group, can_reg_entry_t *entry, canid_t can_id, void *data);
 static int _filter_is_used(unsigned int ifnum, canid_t can_id, canid_t mask);
 
+static inline unsigned _hash(canid_t can_id)
+{
+    return (can_id ^ (can_id >> 11) ^ (can_id >> 22)) &
+           (CAN_ROUTER_HASH_BUCKETS - 1);
+}
+
+static inline can_reg_entry_t **_bucket(mask_group_t *group, canid_t can_id)
+{
+    return &group->buckets[_hash(can_id)];
+}
+
 #if ENABLE_DEBUG
 static void _print_filters(void)
 {
     for (int i = 0; i < (int)CAN_DLL_NUMOF; i++) {
         DEBUG("--- Ifnum: %d ---\n", i);
-        can_reg_entry_t *entry;
-        LL_FOREACH(table[i], entry) {
-            filter_el_t *el = container_of(entry, filter_el_t, entry);
-            DEBUG("App pid=%" PRIkernel_pid ", el=%p, can_id=0x%" PRIx32 ", mask=0x%" PRIx32 ", data=%p\n",
-                  el->entry.target.pid, (void*)el, el->can_id, el->mask, el->data);
+        mask_group_t *group;
+        LL_FOREACH(table[i], group) {
+            DEBUG("Mask=0x%" PRIx32 ", %u filters\n", group->mask, group->numof);
+            for (unsigned b = 0; b < CAN_ROUTER_HASH_BUCKETS; b++) {
+                can_reg_entry_t *entry;
+                LL_FOREACH(group->buckets[b], entry) {
+                    filter_el_t *el = container_of(entry, filter_el_t, entry);
+                    DEBUG("App pid=%" PRIkernel_pid ", el=%p, can_id=0x%" PRIx32 ", mask=0x%" PRIx32 ", data=%p\n",
+                          el->entry.target.pid, (void*)el, el->can_id, el->mask, el->data);
+                }
+            }
         }
     }
 }
@@ -114,40 +152,46 @@ static void _free_filter_el(filter_el_t *el)
     gnrc_pktbuf_release(el->snip);
 }
 
-/* Insert to the list in a sorted way
- * Lower CAN IDs are inserted first */
-static void _insert_to_list(can_reg_entry_t **list, filter_el_t *el)
+static mask_group_t *_find_group(unsigned int ifnum, canid_t mask)
 {
-    can_reg_entry_t *next_entry = *list;
-    filter_el_t *next_el = container_of(next_entry, filter_el_t, entry);
+    mask_group_t *group;
 
-    DEBUG("_insert_to_list: list=%p, el=%p\n", (void *)list, (void *)el);
+    LL_SEARCH_SCALAR(table[ifnum], group, mask, mask);
+    return group;
+}
+
+static mask_group_t *_get_group(unsigned int ifnum, canid_t mask)
+{
+    mask_group_t *group = _find_group(ifnum, mask);
 
-    if (!(*list) || (next_el->can_id > el->can_id)) {
-        LL_PREPEND(*list, &el->entry);
-        DEBUG("_insert_to_list: inserting first el, list=%p\n", (void *)list);
+    if (group) {
+        return group;
     }
-    else {
-        do {
-            if (el->can_id <= next_el->can_id) {
-                DEBUG("_insert_to_list: found next_el can_id:0x%" PRIx32
-                      "\n", next_el->can_id);
-                LL_PREPEND_ELEM(*list, next_entry, &el->entry);
-                return;
-            }
-            else if (next_el->entry.next == NULL) {
-                DEBUG("_insert_to_list: insert at the end\n");
-                LL_APPEND(next_entry, &el->entry);
-                return;
-            }
-            else {
-                next_entry = next_entry->next;
-                next_el = container_of(next_entry, filter_el_t, entry);
-                DEBUG("_insert_to_list: going to next el: %p\n", (void*) next_el);
-            }
-        } while (next_el);
 
+    gnrc_pktsnip_t *snip = gnrc_pktbuf_add(NULL, NULL, sizeof(*group), GNRC_NETTYPE_UNDEF);
+    if (!snip) {
+        DEBUG("can_router: _get_group: out of memory\n");
+        return NULL;
+    }
+
+    group = snip->data;
+    memset(group, 0, sizeof(*group));
+    group->mask = mask;
+    group->snip = snip;
+    /* new masks are likely to be more specific, so look them up first */
+    LL_PREPEND(table[ifnum], group);
+    DEBUG("_get_group: group allocated with mask=0x%" PRIx32 "\n", mask);
+    return group;
+}
+
+static void _put_group(unsigned int ifnum, mask_group_t *group)
+{
+    if (group->numof > 0) {
+        return;
     }
+    DEBUG("_put_group: group freed with mask=0x%" PRIx32 "\n", group->mask);
+    LL_DELETE(table[ifnum], group);
+    gnrc_pktbuf_release(group->snip);
 }
 
 #ifdef MODULE_CAN_MBOX
@@ -158,40 +202,40 @@ static void _insert_to_list(can_reg_entry_t **list, filter_el_t *el)
 #define ENTRY_MATCHES(e1, e2)  ((e1)->target.pid == (e2)->target.pid)
 #endif
 
-static filter_el_t *_find_filter_el(can_reg_entry_t *list, can_reg_entry_t *entry, canid_t can_id, canid_t mask, void *data)
+static filter_el_t *_find_filter_el(mask_group_t *group, can_reg_entry_t *entry, canid_t can_id, void *data)
 {
-    filter_el_t *el = container_of(list, filter_el_t, entry);
-    if (!el) {
-        return el;
-    }
-    do {
-        if ((el->can_id == can_id) && (el->mask == mask) && (el->data == data) &&
+    can_reg_entry_t *cur;
+
+    LL_FOREACH(*_bucket(group, can_id), cur) {
+        filter_el_t *el = container_of(cur, filter_el_t, entry);
+        if ((el->can_id == can_id) && (el->data == data) &&
                 ENTRY_MATCHES(&el->entry, entry)) {
             DEBUG("_find_filter_el: found el=%p, can_id=%" PRIx32 ", mask=%" PRIx32 ", data=%p\n",
                   (void *)el, el->can_id, el->mask, el->data);
             return el;
         }
-        el = container_of(el->entry.next, filter_el_t, entry);
-    }  while (el);
+    }
 
     return NULL;
 }
 
 static int _filter_is_used(unsigned int ifnum, canid_t can_id, canid_t mask)
 {
-    filter_el_t *el = container_of(table[ifnum], filter_el_t, entry);
-    if (!el) {
-        DEBUG("_filter_is_used: empty list\n");
+    mask_group_t *group = _find_group(ifnum, mask);
+    if (!group) {
+        DEBUG("_filter_is_used: no filter with this mask\n");
         return 0;
     }
-    do {
-        if ((el->can_id == can_id) && (el->mask == mask)) {
+
+    can_reg_entry_t *cur;
+    LL_FOREACH(*_bucket(group, can_id), cur) {
+        filter_el_t *el = container_of(cur, filter_el_t, entry);
+        if (el->can_id == can_id) {
             DEBUG("_filter_is_used: found el=%p, can_id=%" PRIx32 ", mask=%" PRIx32 ", data=%p\n",
                   (void *)el, el->can_id, el->mask, el->data);
             return 1;
         }
-        el = container_of(el->entry.next, filter_el_t, entry);
-    }  while (el);
+    }
 
     DEBUG("_filter_is_used: filter not found\n");
 
@@ -201,6 +245,7 @@ static int _filter_is_used(unsigned int ifnum, canid_t can_id, canid_t mask)
 /* register interested users */
 int can_router_register(can_reg_entry_t *entry, canid_t can_id, canid_t mask, void *param)
 {
+    mask_group_t *group;
     filter_el_t *filter;
     int ret;
 
@@ -214,12 +259,18 @@ int can_router_register(can_reg_entry_t *entry, canid_t can_id, canid_t mask, vo
     }
 #endif
 
-    mutex_lock(&lock);
+    mutex_lock(&lock[entry->ifnum]);
     ret = _filter_is_used(entry->ifnum, can_id, mask);
 
+    group = _get_group(entry->ifnum, mask);
+    if (!group) {
+        mutex_unlock(&lock[entry->ifnum]);
+        return -ENOMEM;
+    }
     filter = _alloc_filter_el(can_id, mask, param);
     if (!filter) {
-        mutex_unlock(&lock);
+        _put_group(entry->ifnum, group);
+        mutex_unlock(&lock[entry->ifnum]);
         return -ENOMEM;
     }
 
@@ -238,8 +289,9 @@ int can_router_register(can_reg_entry_t *entry, canid_t can_id, canid_t mask, vo
     filter->entry.target.pid = entry->target.pid;
 #endif
     filter->entry.ifnum = entry->ifnum;
-    _insert_to_list(&table[entry->ifnum], filter);
-    mutex_unlock(&lock);
+    LL_PREPEND(*_bucket(group, can_id), &filter->entry);
+    group->numof++;
+    mutex_unlock(&lock[entry->ifnum]);
 
     PRINT_FILTERS();
 
@@ -250,6 +302,7 @@ int can_router_register(can_reg_entry_t *entry, canid_t can_id, canid_t mask, vo
 int can_router_unregister(can_reg_entry_t *entry, canid_t can_id,
                           canid_t mask, void *param)
 {
+    mask_group_t *group;
     filter_el_t *el;
     int ret;
 
@@ -263,16 +316,19 @@ int can_router_unregister(can_reg_entry_t *entry, canid_t can_id,
     }
 #endif
 
-    mutex_lock(&lock);
-    el = _find_filter_el(table[entry->ifnum], entry, can_id, mask, param);
+    mutex_lock(&lock[entry->ifnum]);
+    group = _find_group(entry->ifnum, mask);
+    el = group ? _find_filter_el(group, entry, can_id, param) : NULL;
     if (!el) {
-        mutex_unlock(&lock);
+        mutex_unlock(&lock[entry->ifnum]);
         return -EINVAL;
     }
-    LL_DELETE(table[entry->ifnum], &el->entry);
+    LL_DELETE(*_bucket(group, can_id), &el->entry);
     _free_filter_el(el);
+    group->numof--;
+    _put_group(entry->ifnum, group);
     ret = _filter_is_used(entry->ifnum, can_id, mask);
-    mutex_unlock(&lock);
+    mutex_unlock(&lock[entry->ifnum]);
 
     PRINT_FILTERS();
 
@@ -305,44 +361,51 @@ int can_router_dispatch_rx_indic(can_pkt_t *pkt)
     }
 
     int res = 0;
+    unsigned msg_cnt = 0;
+    int ifnum = pkt->entry.ifnum;
     msg_t msg;
     msg.type = CAN_MSG_RX_INDICATION;
-#if ENABLE_DEBUG
-    int msg_cnt = 0;
-#endif
     DEBUG("can_router_dispatch_rx_indic: pkt=%p, ifnum=%d, can_id=%" PRIx32 "\n",
-          (void *)pkt, pkt->entry.ifnum, pkt->frame.can_id);
-
-    mutex_lock(&lock);
-    can_reg_entry_t *entry;
-    filter_el_t *el;
-    LL_FOREACH(table[pkt->entry.ifnum], entry) {
-        el = container_of(entry, filter_el_t, entry);
-        if ((pkt->frame.can_id & el->mask) == el->can_id) {
+          (void *)pkt, ifnum, pkt->frame.can_id);
+
+    /* hold a reference while dispatching, a subscriber might release its
+     * reference before the packet is handed to all others */
+    atomic_fetch_add(&pkt->ref_count, 1);
+    /* filters are freed by can_router_unregister(), so they can only be
+     * walked with the lock of the interface held */
+    mutex_lock(&lock[ifnum]);
+    mask_group_t *group;
+    LL_FOREACH(table[ifnum], group) {
+        canid_t can_id = pkt->frame.can_id & group->mask;
+        can_reg_entry_t *entry;
+        LL_FOREACH(*_bucket(group, can_id), entry) {
+            filter_el_t *el = container_of(entry, filter_el_t, entry);
+            if (el->can_id != can_id) {
+                continue;
+            }
             DEBUG("can_router_dispatch_rx_indic: found el=%p, data=%p\n",
                   (void *)el, (void *)el->data);
             DEBUG("can_router_dispatch_rx_indic: rx_ind to pid: %"
                   PRIkernel_pid "\n", entry->target.pid);
             atomic_fetch_add(&pkt->ref_count, 1);
-            msg.content.ptr = can_pkt_alloc_rx_data(&pkt->frame, sizeof(pkt->frame), el->data);
-#if ENABLE_DEBUG
-            msg_cnt++;
-#endif
+            /* all subscribers share the packet, the first ones do not even
+             * need to allocate their rx data */
+            msg.content.ptr = can_pkt_get_rx_data(pkt, msg_cnt++, el->data);
             if (!msg.content.ptr || (_send_msg(&msg, entry) <= 0)) {
                 can_pkt_free_rx_data(msg.content.ptr);
                 atomic_fetch_sub(&pkt->ref_count, 1);
                 DEBUG("can_router_dispatch_rx_indic: failed to send msg to "
                       "pid=%" PRIkernel_pid "\n", entry->target.pid);
                 res = -EBUSY;
-                break;
+                goto out;
             }
         }
     }
-    mutex_unlock(&lock);
-#if ENABLE_DEBUG
-    DEBUG("can_router_dispatch_rx: msg send to %d threads\n", msg_cnt);
-#endif
-    if (atomic_load(&pkt->ref_count) == 0) {
+out:
+    mutex_unlock(&lock[ifnum]);
+    DEBUG("can_router_dispatch_rx: msg send to %u threads\n", msg_cnt);
+    (void)msg_cnt;
+    if (atomic_fetch_sub(&pkt->ref_count, 1) == 1) {
         can_pkt_free(pkt);
     }
 
@@ -393,9 +456,8 @@ int can_router_free_frame(struct can_frame *frame)
         return -1;
     }
 
-    atomic_fetch_sub(&pkt->ref_count, 1);
-
-    if (atomic_load(&pkt->ref_count) == 0) {
+    /* only the one dropping the last reference may free the packet */
+    if (atomic_fetch_sub(&pkt->ref_count, 1) == 1) {
         can_pkt_free(pkt);
     }
     return 0;
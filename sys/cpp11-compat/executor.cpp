@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup cpp11-compat
+ * @{
+ *
+ * @file
+ * @brief   Thread pool with preallocated stacks and job slots
+ *
+ * @}
+ */
+
+#include <system_error>
+
+#include "riot/executor.hpp"
+
+using namespace std;
+
+namespace riot {
+
+executor::executor(char* stacks, size_t stack_size, unsigned workers,
+                   unsigned char* slots, size_t slot_size, unsigned slots_numof,
+                   size_t job_size, uint8_t priority, const char* name)
+    : m_free{nullptr},
+      m_head{nullptr},
+      m_tail{nullptr},
+      m_pending{0},
+      m_job_size{job_size},
+      m_priority{priority} {
+  for (unsigned i = 0; i < slots_numof; i++) {
+    auto job = reinterpret_cast<detail::job_header*>(slots + i * slot_size);
+    job->next = m_free;
+    m_free = job;
+  }
+  for (unsigned i = 0; i < workers; i++) {
+    if (thread_create(stacks + i * stack_size, stack_size, priority, 0,
+                      &executor::worker, this, name) < 0) {
+      throw system_error(
+        make_error_code(errc::resource_unavailable_try_again),
+          "Failed to create worker thread.");
+    }
+  }
+}
+
+void* executor::worker(void* arg) {
+  auto self = static_cast<executor*>(arg);
+  while (true) {
+    detail::job_header* job;
+    {
+      unique_lock<mutex> lk(self->m_mtx);
+      while (self->m_head == nullptr) {
+        self->m_work.wait(lk);
+      }
+      job = self->m_head;
+      self->m_head = job->next;
+      if (self->m_head == nullptr) {
+        self->m_tail = nullptr;
+      }
+    }
+    job->invoke(reinterpret_cast<unsigned char*>(job)
+                + offsetof(detail::job_slot<1>, callable));
+    {
+      lock_guard<mutex> lk(self->m_mtx);
+      job->next = self->m_free;
+      self->m_free = job;
+      if (--self->m_pending == 0) {
+        self->m_idle.notify_all();
+      }
+    }
+  }
+  return nullptr;
+}
+
+detail::job_header* executor::alloc_job() {
+  lock_guard<mutex> lk(m_mtx);
+  detail::job_header* job = m_free;
+  if (job != nullptr) {
+    m_free = job->next;
+    m_pending++;
+  }
+  return job;
+}
+
+void executor::enqueue_job(detail::job_header* job) {
+  unique_lock<mutex> lk(m_mtx);
+  job->next = nullptr;
+  if (m_tail == nullptr) {
+    m_head = job;
+  }
+  else {
+    m_tail->next = job;
+  }
+  m_tail = job;
+  // wake the worker only after the mutex is released, so it can run at once
+  lk.unlock();
+  m_work.notify_one();
+}
+
+void executor::wait_idle() {
+  unique_lock<mutex> lk(m_mtx);
+  while (m_pending != 0) {
+    m_idle.wait(lk);
+  }
+}
+
+unsigned executor::pending() {
+  lock_guard<mutex> lk(m_mtx);
+  return m_pending;
+}
+
+} // namespace riot
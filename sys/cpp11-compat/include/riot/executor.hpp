@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup cpp11-compat
+ * @{
+ *
+ * @file
+ * @brief   Thread pool with preallocated stacks and job slots
+ *
+ * Creating a riot::thread allocates its stack and arguments on the heap, so
+ * short-lived workers fragment the heap and may fail at run time. An executor
+ * instead owns a fixed number of worker threads and job slots, allocated
+ * together with the executor object (usually statically). Posting a job
+ * stores the callable in a free slot and never allocates.
+ *
+ * @}
+ */
+
+#ifndef RIOT_EXECUTOR_HPP
+#define RIOT_EXECUTOR_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "thread.h"
+
+#include "riot/mutex.hpp"
+#include "riot/condition_variable.hpp"
+
+namespace riot {
+
+/** @cond INTERNAL */
+namespace detail {
+/**
+ * @brief Header of a job slot, the callable is stored right behind it.
+ */
+struct job_header {
+  job_header* next;
+  void (*invoke)(void* callable);
+};
+
+template <size_t JobSize>
+struct job_slot {
+  job_header hdr;
+  alignas(std::max_align_t) unsigned char callable[JobSize];
+};
+
+/**
+ * @brief Storage of a riot::static_executor
+ */
+template <unsigned Workers, unsigned Jobs, size_t StackSize, size_t JobSize>
+struct executor_storage {
+  job_slot<JobSize> slots[Jobs];
+  char stacks[Workers][StackSize];
+};
+
+template <class F>
+void invoke_job(void* callable) {
+  F* f = static_cast<F*>(callable);
+  try {
+    (*f)();
+  }
+  catch (...) {
+    // nop, like riot::thread
+  }
+  f->~F();
+}
+} // namespace detail
+/** @endcond */
+
+/**
+ * @brief   A pool of worker threads running posted jobs in FIFO order
+ *
+ * Use riot::static_executor to create an executor with its storage. The
+ * worker threads never terminate, so an executor must not be destroyed.
+ */
+class executor {
+public:
+  executor(const executor&) = delete;
+  executor& operator=(const executor&) = delete;
+
+  /**
+   * @brief Post a job to be run by one of the workers.
+   *
+   * The callable is moved into a free job slot. It must be no larger than
+   * the job size of the executor, riot::static_executor checks this at
+   * compile time.
+   *
+   * @param[in] f   Callable without arguments.
+   * @return  `true` if the job was queued, `false` if all slots are in use
+   *          or the callable does not fit into a slot.
+   */
+  template <class F>
+  bool post(F&& f);
+
+  /**
+   * @brief Block until all posted jobs have been run.
+   */
+  void wait_idle();
+
+  /**
+   * @brief Returns the number of jobs queued or running.
+   */
+  unsigned pending();
+
+  /**
+   * @brief Returns the priority of the worker threads.
+   */
+  inline uint8_t priority() const noexcept { return m_priority; }
+
+protected:
+  /** @cond INTERNAL */
+  executor(char* stacks, size_t stack_size, unsigned workers,
+           unsigned char* slots, size_t slot_size, unsigned slots_numof,
+           size_t job_size, uint8_t priority, const char* name);
+  /** @endcond */
+
+private:
+  static void* worker(void* arg);
+  detail::job_header* alloc_job();
+  void enqueue_job(detail::job_header* job);
+
+  mutex m_mtx;
+  condition_variable m_work;
+  condition_variable m_idle;
+  detail::job_header* m_free;
+  detail::job_header* m_head;
+  detail::job_header* m_tail;
+  unsigned m_pending;
+  size_t m_job_size;
+  uint8_t m_priority;
+};
+
+/**
+ * @brief   An executor together with the storage of its workers and jobs
+ *
+ * The storage is a base class, so it is in place before the workers start.
+ *
+ * @tparam Workers    Number of worker threads.
+ * @tparam Jobs       Number of jobs that can be queued or running at once.
+ * @tparam StackSize  Stack size of every worker thread.
+ * @tparam JobSize    Maximum size of a posted callable, e.g. the captures
+ *                    of a lambda.
+ */
+template <unsigned Workers, unsigned Jobs = 8,
+          size_t StackSize = THREAD_STACKSIZE_DEFAULT,
+          size_t JobSize = 4 * sizeof(void*)>
+class static_executor : private detail::executor_storage<Workers, Jobs,
+                                                         StackSize, JobSize>,
+                        public executor {
+  static_assert(Workers > 0, "an executor needs at least one worker");
+  static_assert(Jobs > 0, "an executor needs at least one job slot");
+
+  using storage = detail::executor_storage<Workers, Jobs, StackSize, JobSize>;
+
+public:
+  /**
+   * @brief Start the worker threads.
+   *
+   * @param[in] priority  Priority of the worker threads.
+   * @param[in] name      Name of the worker threads.
+   */
+  explicit static_executor(uint8_t priority = THREAD_PRIORITY_MAIN - 1,
+                           const char* name = "riot_executor")
+      : executor(this->stacks[0], StackSize, Workers,
+                 reinterpret_cast<unsigned char*>(this->slots),
+                 sizeof(detail::job_slot<JobSize>), Jobs, JobSize, priority,
+                 name) {
+    // nop
+  }
+
+  /**
+   * @brief Post a job to be run by one of the workers.
+   *
+   * Like executor::post(), but a callable larger than `JobSize` does not
+   * compile.
+   */
+  template <class F>
+  bool post(F&& f) {
+    static_assert(sizeof(typename std::decay<F>::type) <= JobSize,
+                  "callable is larger than the job size of the executor");
+    return executor::post(std::forward<F>(f));
+  }
+};
+
+template <class F>
+bool executor::post(F&& f) {
+  using callable = typename std::decay<F>::type;
+  static_assert(alignof(callable) <= alignof(std::max_align_t),
+                "over-aligned jobs are not supported");
+  if (sizeof(callable) > m_job_size) {
+    return false;
+  }
+  detail::job_header* job = alloc_job();
+  if (job == nullptr) {
+    return false;
+  }
+  // the callable is placed right behind the header, see detail::job_slot
+  new (reinterpret_cast<unsigned char*>(job)
+       + offsetof(detail::job_slot<1>, callable)) callable(std::forward<F>(f));
+  job->invoke = &detail::invoke_job<callable>;
+  enqueue_job(job);
+  return true;
+}
+
+} // namespace riot
+
+#endif // RIOT_EXECUTOR_HPP
@@ -0,0 +1,416 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup cpp11-compat
+ * @{
+ *
+ * @file
+ * @brief   C++20 coroutines driven by an event queue
+ *
+ * A riot::loop runs any number of coroutines on the stack of a single
+ * thread. A suspended coroutine only occupies its frame on the heap, which
+ * holds the variables living across a `co_await`. Coroutines are resumed by
+ * events posted to the event queue of the loop (see @ref sys_event), so
+ * timers and interrupts can wake them up without an extra thread.
+ *
+ * ~~~~~~~~~~~~~~~~ {.cpp}
+ * riot::task<> blink(riot::loop& loop) {
+ *   while (true) {
+ *     LED0_TOGGLE;
+ *     co_await loop.sleep_for(std::chrono::milliseconds(500));
+ *   }
+ * }
+ *
+ * int main() {
+ *   riot::loop loop;
+ *   loop.spawn(blink(loop));
+ *   loop.run();
+ * }
+ * ~~~~~~~~~~~~~~~~
+ *
+ * Needs a compiler supporting coroutines (e.g. `CXXEXFLAGS += -std=c++20`
+ * with GCC >= 10) and the `event_timeout` module. Sources of the
+ * cpp11-compat module itself are still built as C++11, so everything here is
+ * defined in the header.
+ *
+ * @}
+ */
+
+#ifndef RIOT_TASK_HPP
+#define RIOT_TASK_HPP
+
+#if defined(__cpp_impl_coroutine) || defined(DOXYGEN)
+
+#include <cerrno>
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "event.h"
+#include "event/timeout.h"
+#include "xtimer.h"
+#ifdef MODULE_SOCK_UDP
+#include "net/sock/udp.h"
+#endif
+
+namespace riot {
+
+/** @cond INTERNAL */
+namespace detail {
+/**
+ * @brief Event resuming a coroutine when handled
+ */
+struct resume_event : event_t {
+  std::coroutine_handle<> handle;
+
+  void init(std::coroutine_handle<> h) noexcept {
+    list_node.next = nullptr;
+    handler = &resume_event::handle_event;
+    handle = h;
+  }
+
+  static void handle_event(event_t* ev) {
+    static_cast<resume_event*>(ev)->handle.resume();
+  }
+};
+
+struct promise_base {
+  std::coroutine_handle<> continuation = std::noop_coroutine();
+
+  std::suspend_always initial_suspend() noexcept { return {}; }
+
+  struct final_awaiter {
+    bool await_ready() noexcept { return false; }
+    template <class P>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+      // symmetric transfer to the awaiting coroutine, if any
+      return h.promise().continuation;
+    }
+    void await_resume() noexcept {}
+  };
+
+  final_awaiter final_suspend() noexcept { return {}; }
+  void unhandled_exception() noexcept { std::terminate(); }
+};
+
+template <class T>
+struct promise : promise_base {
+  std::optional<T> value;
+
+  template <class U>
+  void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+  T result() { return std::move(*value); }
+};
+
+template <>
+struct promise<void> : promise_base {
+  void return_void() noexcept {}
+  void result() noexcept {}
+};
+} // namespace detail
+/** @endcond */
+
+/**
+ * @brief   A lazily started coroutine returning a @p T
+ *
+ * The coroutine starts running when the task is awaited by another
+ * coroutine, or when it is passed to riot::loop::spawn().
+ */
+template <class T = void>
+class task {
+public:
+  /** @cond INTERNAL */
+  struct promise_type : detail::promise<T> {
+    task get_return_object() noexcept {
+      return task{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+  };
+  /** @endcond */
+
+  task(const task&) = delete;
+  task& operator=(const task&) = delete;
+
+  /**
+   * @brief Move constructor.
+   */
+  task(task&& other) noexcept : m_handle{other.m_handle} {
+    other.m_handle = nullptr;
+  }
+
+  ~task() {
+    if (m_handle) {
+      m_handle.destroy();
+    }
+  }
+
+  /**
+   * @brief Run the task until it finishes and return its result.
+   */
+  auto operator co_await() && noexcept {
+    struct awaiter {
+      std::coroutine_handle<promise_type> handle;
+
+      bool await_ready() noexcept { return !handle || handle.done(); }
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> h) noexcept {
+        handle.promise().continuation = h;
+        return handle;
+      }
+      T await_resume() { return handle.promise().result(); }
+    };
+    return awaiter{m_handle};
+  }
+
+  /** @copydoc operator co_await() && */
+  auto operator co_await() & noexcept {
+    return std::move(*this).operator co_await();
+  }
+
+private:
+  explicit task(std::coroutine_handle<promise_type> h) noexcept
+      : m_handle{h} {}
+
+  std::coroutine_handle<promise_type> m_handle;
+};
+
+/**
+ * @brief   Awaitable continuing the awaiting coroutine on an event queue
+ *
+ * `co_await riot::resume_on(queue)` moves the rest of the coroutine to the
+ * thread serving @p queue, after the events already queued.
+ */
+class resume_on {
+public:
+  /**
+   * @brief Create an awaitable for @p queue.
+   */
+  explicit resume_on(event_queue_t& queue) noexcept : m_queue{&queue} {}
+
+  /** @cond INTERNAL */
+  bool await_ready() noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> h) noexcept {
+    m_event.init(h);
+    event_post(m_queue, &m_event);
+  }
+  void await_resume() noexcept {}
+  /** @endcond */
+
+private:
+  event_queue_t* m_queue;
+  detail::resume_event m_event;
+};
+
+/**
+ * @brief   Awaitable resuming the awaiting coroutine after a timeout
+ */
+class sleep_awaiter {
+public:
+  /**
+   * @brief Create an awaitable resuming on @p queue after @p us microseconds.
+   */
+  sleep_awaiter(event_queue_t& queue, uint32_t us) noexcept
+      : m_queue{&queue}, m_us{us} {}
+
+  /** @cond INTERNAL */
+  bool await_ready() noexcept { return m_us == 0; }
+  void await_suspend(std::coroutine_handle<> h) noexcept {
+    m_event.init(h);
+    event_timeout_init(&m_timeout, m_queue, &m_event);
+    event_timeout_set(&m_timeout, m_us);
+  }
+  void await_resume() noexcept {}
+  /** @endcond */
+
+private:
+  event_queue_t* m_queue;
+  uint32_t m_us;
+  detail::resume_event m_event;
+  event_timeout_t m_timeout;
+};
+
+#if defined(MODULE_SOCK_UDP) || defined(DOXYGEN)
+/**
+ * @brief   Awaitable receiving from a UDP sock
+ *
+ * The sock API has no notification for received data, so the sock is polled
+ * every riot::recv_awaiter::poll_interval microseconds while the coroutine
+ * is suspended. The loop thread itself never blocks.
+ */
+class recv_awaiter {
+public:
+  /**
+   * @brief Poll interval in microseconds.
+   */
+  static constexpr uint32_t poll_interval = 10U * US_PER_MS;
+
+  /**
+   * @brief Create an awaitable, the arguments are those of sock_udp_recv().
+   */
+  recv_awaiter(event_queue_t& queue, sock_udp_t* sock, void* data,
+               size_t max_len, uint32_t timeout, sock_udp_ep_t* remote) noexcept
+      : m_queue{&queue}, m_sock{sock}, m_data{data}, m_max_len{max_len},
+        m_timeout{timeout}, m_remote{remote} {}
+
+  /** @cond INTERNAL */
+  bool await_ready() noexcept {
+    return try_recv() || (m_timeout == 0);
+  }
+  void await_suspend(std::coroutine_handle<> h) noexcept {
+    m_handle = h;
+    m_start = xtimer_now_usec();
+    m_event.list_node.next = nullptr;
+    m_event.handler = &recv_awaiter::poll;
+    m_event.self = this;
+    event_timeout_init(&m_poll, m_queue, &m_event);
+    event_timeout_set(&m_poll, poll_interval);
+  }
+  ssize_t await_resume() noexcept { return m_res; }
+  /** @endcond */
+
+private:
+  struct poll_event : event_t {
+    recv_awaiter* self;
+  };
+
+  bool try_recv() noexcept {
+    m_res = sock_udp_recv(m_sock, m_data, m_max_len, 0, m_remote);
+    return m_res != -EAGAIN;
+  }
+
+  static void poll(event_t* ev) {
+    recv_awaiter* self = static_cast<poll_event*>(ev)->self;
+    if (!self->try_recv()) {
+      if ((self->m_timeout == SOCK_NO_TIMEOUT) ||
+          ((xtimer_now_usec() - self->m_start) < self->m_timeout)) {
+        event_timeout_set(&self->m_poll, poll_interval);
+        return;
+      }
+      self->m_res = -ETIMEDOUT;
+    }
+    self->m_handle.resume();
+  }
+
+  event_queue_t* m_queue;
+  sock_udp_t* m_sock;
+  void* m_data;
+  size_t m_max_len;
+  uint32_t m_timeout;
+  sock_udp_ep_t* m_remote;
+  ssize_t m_res = -EAGAIN;
+  uint32_t m_start = 0;
+  std::coroutine_handle<> m_handle;
+  poll_event m_event;
+  event_timeout_t m_poll;
+};
+#endif
+
+/** @cond INTERNAL */
+namespace detail {
+/**
+ * @brief Coroutine owning a spawned task, destroys itself when done
+ */
+struct detached {
+  struct promise_type {
+    resume_event start;
+
+    detached get_return_object() noexcept {
+      return {std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+inline detached run_detached(task<> t) {
+  co_await std::move(t);
+}
+} // namespace detail
+/** @endcond */
+
+/**
+ * @brief   Runs coroutines on the thread it was created on
+ */
+class loop {
+public:
+  /**
+   * @brief Create a loop owned by the calling thread.
+   */
+  loop() noexcept { event_queue_init(&m_queue); }
+
+  loop(const loop&) = delete;
+  loop& operator=(const loop&) = delete;
+
+  /**
+   * @brief Handle events and resume coroutines, never returns.
+   *
+   * Must be called by the thread that created the loop.
+   */
+  [[noreturn]] void run() {
+    event_loop(&m_queue);
+    while (true) {}
+  }
+
+  /**
+   * @brief Start running @p t on the loop.
+   *
+   * The frame of the task is freed when it finishes. May be called from
+   * any thread.
+   */
+  void spawn(task<> t) {
+    auto d = detail::run_detached(std::move(t));
+    d.handle.promise().start.init(d.handle);
+    event_post(&m_queue, &d.handle.promise().start);
+  }
+
+  /**
+   * @brief Awaitable moving the awaiting coroutine to the end of the queue,
+   *        so other ready coroutines can run.
+   */
+  resume_on yield() noexcept { return resume_on(m_queue); }
+
+  /**
+   * @brief Awaitable resuming the awaiting coroutine after @p d.
+   */
+  template <class Rep, class Period>
+  sleep_awaiter sleep_for(const std::chrono::duration<Rep, Period>& d) noexcept {
+    using namespace std::chrono;
+    return sleep_awaiter(m_queue, duration_cast<microseconds>(d).count());
+  }
+
+#if defined(MODULE_SOCK_UDP) || defined(DOXYGEN)
+  /**
+   * @brief Awaitable receiving from a UDP sock, see sock_udp_recv().
+   *
+   * `co_await` yields the result of sock_udp_recv().
+   */
+  recv_awaiter recv(sock_udp_t* sock, void* data, size_t max_len,
+                    uint32_t timeout, sock_udp_ep_t* remote = nullptr) noexcept {
+    return recv_awaiter(m_queue, sock, data, max_len, timeout, remote);
+  }
+#endif
+
+  /**
+   * @brief Returns the event queue of the loop.
+   */
+  event_queue_t& queue() noexcept { return m_queue; }
+
+private:
+  event_queue_t m_queue;
+};
+
+} // namespace riot
+
+#endif /* __cpp_impl_coroutine */
+
+#endif // RIOT_TASK_HPP
@@ -50,6 +50,14 @@
 
 #include "hashes/sha256.h"
 
+#ifdef MODULE_SHA256_SHANI
+#if !defined(__i386__) && !defined(__x86_64__)
+#error "sha256_shani is only available on x86"
+#endif
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
 #ifdef __BIG_ENDIAN__
 /* Copy a vector of big-endian uint32_t into a vector of bytes */
 #define be32enc_vect memcpy
@@ -122,11 +130,17 @@ static const uint32_t K[64] = {
     0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
 };
 
+static const uint32_t H0[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+    0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19,
+};
+
+#ifndef MODULE_SHA256_UNROLLED
 /*
  * SHA256 block compression function.  The 256-bit state is transformed via
  * the 512-bit input block to produce a new state.
  */
-static void sha256_transform(uint32_t *state, const unsigned char block[64])
+static void sha256_transform_block(uint32_t *state, const unsigned char block[64])
 {
     uint32_t W[64];
     uint32_t S[8];
@@ -159,6 +173,142 @@ static void sha256_transform(uint32_t *state, const unsigned char block[64])
         state[i] += S[i];
     }
 }
+#else /* MODULE_SHA256_UNROLLED */
+/* One round, the caller rotates the names of the working variables instead
+ * of moving their values */
+#define RND(a, b, c, d, e, f, g, h, i) \
+    do { \
+        uint32_t t0 = h + S1(e) + Ch(e, f, g) + W[(i) & 15] + K[i]; \
+        d += t0; \
+        h = t0 + S0(a) + Maj(a, b, c); \
+    } while (0)
+
+/*
+ * SHA256 block compression function, unrolled by eight rounds.  The working
+ * variables stay in registers and only the last 16 words of the message
+ * schedule are kept.
+ */
+static void sha256_transform_block(uint32_t *state, const unsigned char block[64])
+{
+    uint32_t W[16];
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    be32dec_vect(W, block, 64);
+    for (int i = 0; i < 64; i += 8) {
+        if (i >= 16) {
+            for (int j = i; j < i + 8; j++) {
+                W[j & 15] += s1(W[(j - 2) & 15]) + W[(j - 7) & 15] +
+                             s0(W[(j - 15) & 15]);
+            }
+        }
+        RND(a, b, c, d, e, f, g, h, i + 0);
+        RND(h, a, b, c, d, e, f, g, i + 1);
+        RND(g, h, a, b, c, d, e, f, i + 2);
+        RND(f, g, h, a, b, c, d, e, i + 3);
+        RND(e, f, g, h, a, b, c, d, i + 4);
+        RND(d, e, f, g, h, a, b, c, i + 5);
+        RND(c, d, e, f, g, h, a, b, i + 6);
+        RND(b, c, d, e, f, g, h, a, i + 7);
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+#endif /* MODULE_SHA256_UNROLLED */
+
+#ifdef MODULE_SHA256_SHANI
+static int _shani_supported(void)
+{
+    static int supported = -1;
+
+    if (supported < 0) {
+        unsigned eax, ebx, ecx, edx;
+        supported = __get_cpuid(1, &eax, &ebx, &ecx, &edx) &&
+                    (ecx & bit_SSSE3) && (ecx & bit_SSE4_1) &&
+                    __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) &&
+                    (ebx & bit_SHA);
+    }
+    return supported;
+}
+
+/*
+ * SHA256 block compression function using the SHA extensions of x86 CPUs.
+ * Each sha256rnds2 instruction performs two rounds, the message schedule is
+ * computed four words at a time by sha256msg1 and sha256msg2.
+ */
+__attribute__((target("sha,ssse3,sse4.1")))
+static void sha256_transform_shani(uint32_t *state, const unsigned char *blocks,
+                                   size_t n)
+{
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+                                         0x0405060700010203ULL);
+    __m128i msg[4], tmp, abef, cdgh;
+
+    /* the instructions expect the state as ABEF and CDGH */
+    tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xB1);
+    cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]), 0x1B);
+    abef = _mm_alignr_epi8(tmp, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, tmp, 0xF0);
+
+    while (n--) {
+        __m128i abef_save = abef, cdgh_save = cdgh;
+
+        for (int i = 0; i < 16; i++) {
+            __m128i *m = &msg[i & 3];
+            if (i < 4) {
+                *m = _mm_shuffle_epi8(
+                    _mm_loadu_si128((const __m128i *)&blocks[i * 16]), bswap);
+            }
+            else {
+                /* W[i..i+3] from the groups W[i-16..i-13] (*m) to W[i-4..i-1] */
+                tmp = _mm_alignr_epi8(msg[(i + 3) & 3], msg[(i + 2) & 3], 4);
+                *m = _mm_add_epi32(_mm_sha256msg1_epu32(*m, msg[(i + 1) & 3]),
+                                   tmp);
+                *m = _mm_sha256msg2_epu32(*m, msg[(i + 3) & 3]);
+            }
+            tmp = _mm_add_epi32(*m, _mm_loadu_si128((const __m128i *)&K[i * 4]));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, tmp);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh,
+                                         _mm_shuffle_epi32(tmp, 0x0E));
+        }
+
+        abef = _mm_add_epi32(abef, abef_save);
+        cdgh = _mm_add_epi32(cdgh, cdgh_save);
+        blocks += 64;
+    }
+
+    tmp = _mm_shuffle_epi32(abef, 0x1B);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128((__m128i *)&state[0], _mm_blend_epi16(tmp, cdgh, 0xF0));
+    _mm_storeu_si128((__m128i *)&state[4], _mm_alignr_epi8(cdgh, tmp, 8));
+}
+#endif /* MODULE_SHA256_SHANI */
+
+/*
+ * Transform the state with @p n consecutive 512-bit blocks, using the
+ * compression function selected at build time.
+ */
+static void sha256_transform(uint32_t *state, const unsigned char *blocks,
+                             size_t n)
+{
+#ifdef MODULE_SHA256_SHANI
+    if (_shani_supported()) {
+        sha256_transform_shani(state, blocks, n);
+        return;
+    }
+#endif
+    while (n--) {
+        sha256_transform_block(state, blocks);
+        blocks += 64;
+    }
+}
 
 static unsigned char PAD[64] = {
     0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -194,14 +344,7 @@ void sha256_init(sha256_context_t *ctx)
     ctx->count[0] = ctx->count[1] = 0;
 
     /* Magic initialization constants */
-    ctx->state[0] = 0x6A09E667;
-    ctx->state[1] = 0xBB67AE85;
-    ctx->state[2] = 0x3C6EF372;
-    ctx->state[3] = 0xA54FF53A;
-    ctx->state[4] = 0x510E527F;
-    ctx->state[5] = 0x9B05688C;
-    ctx->state[6] = 0x1F83D9AB;
-    ctx->state[7] = 0x5BE0CD19;
+    memcpy(ctx->state, H0, sizeof(ctx->state));
 }
 
 /* Add bytes into the hash */
@@ -231,16 +374,14 @@ void sha256_update(sha256_context_t *ctx, const void *data, size_t len)
     const unsigned char *src = data;
 
     memcpy(&ctx->buf[r], src, 64 - r);
-    sha256_transform(ctx->state, ctx->buf);
+    sha256_transform(ctx->state, ctx->buf, 1);
     src += 64 - r;
     len -= 64 - r;
 
     /* Perform complete blocks */
-    while (len >= 64) {
-        sha256_transform(ctx->state, src);
-        src += 64;
-        len -= 64;
-    }
+    sha256_transform(ctx->state, src, len / 64);
+    src += len & ~(size_t)63;
+    len &= 63;
 
     /* Copy left over data into buffer */
     memcpy(ctx->buf, src, len);
@@ -278,6 +419,114 @@ void *sha256(const void *data, size_t len, void *digest)
     return digest;
 }
 
+#if (SHA256_MULTI_LANES & (SHA256_MULTI_LANES - 1))
+#error "SHA256_MULTI_LANES must be a power of two"
+#endif
+
+/* One word of every lane, mapped to a vector register where available */
+typedef uint32_t sha256_lanes_t __attribute__((vector_size(SHA256_MULTI_LANES * 4)));
+
+/*
+ * SHA256 block compression function for SHA256_MULTI_LANES independent
+ * states.  The lanes are processed in lockstep as vectors, which GCC maps to
+ * SIMD instructions if the target has them and to scalar code otherwise.
+ */
+static void sha256_transform_multi(sha256_lanes_t state[8],
+                                   const unsigned char *blocks[SHA256_MULTI_LANES])
+{
+    sha256_lanes_t W[16];
+    sha256_lanes_t S[8];
+
+    for (unsigned l = 0; l < SHA256_MULTI_LANES; l++) {
+        uint32_t w[16];
+        be32dec_vect(w, blocks[l], 64);
+        for (unsigned i = 0; i < 16; i++) {
+            W[i][l] = w[i];
+        }
+    }
+    memcpy(S, state, sizeof(S));
+
+    for (int i = 0; i < 64; i++) {
+        if (i >= 16) {
+            W[i & 15] += s1(W[(i - 2) & 15]) + W[(i - 7) & 15] +
+                         s0(W[(i - 15) & 15]);
+        }
+
+        /* same rotation of the working variables as in the single block
+         * compression function */
+        sha256_lanes_t a = S[(64 - i) % 8], b = S[(65 - i) % 8];
+        sha256_lanes_t c = S[(66 - i) % 8];
+        sha256_lanes_t e = S[(68 - i) % 8], f = S[(69 - i) % 8];
+        sha256_lanes_t g = S[(70 - i) % 8], h = S[(71 - i) % 8];
+        sha256_lanes_t t0 = h + S1(e) + Ch(e, f, g) + W[i & 15] + K[i];
+        sha256_lanes_t t1 = S0(a) + Maj(a, b, c);
+
+        S[(67 - i) % 8] += t0;
+        S[(71 - i) % 8] = t0 + t1;
+    }
+
+    for (unsigned i = 0; i < 8; i++) {
+        state[i] += S[i];
+    }
+}
+
+void sha256_multi(const void *const data[], size_t len,
+                  void *const digest[], unsigned n)
+{
+    sha256_lanes_t state[8];
+    const unsigned char *blocks[SHA256_MULTI_LANES];
+    unsigned char tail[SHA256_MULTI_LANES][2 * SHA256_INTERNAL_BLOCK_SIZE];
+    /* all messages have the same length, and thus the same padding */
+    size_t r = len & 63;
+    size_t tail_len = (r < 56) ? 64 : 128;
+    uint64_t bitlen = (uint64_t)len << 3;
+
+    for (unsigned first = 0; first < n; first += SHA256_MULTI_LANES) {
+        const unsigned char *msg[SHA256_MULTI_LANES];
+        unsigned lanes = n - first;
+
+        if (lanes > SHA256_MULTI_LANES) {
+            lanes = SHA256_MULTI_LANES;
+        }
+        /* unused lanes hash the first message again */
+        for (unsigned l = 0; l < SHA256_MULTI_LANES; l++) {
+            msg[l] = data[first + ((l < lanes) ? l : 0)];
+            for (unsigned i = 0; i < 8; i++) {
+                state[i][l] = H0[i];
+            }
+        }
+
+        for (size_t off = 0; off < len - r; off += 64) {
+            for (unsigned l = 0; l < SHA256_MULTI_LANES; l++) {
+                blocks[l] = msg[l] + off;
+            }
+            sha256_transform_multi(state, blocks);
+        }
+
+        for (unsigned l = 0; l < SHA256_MULTI_LANES; l++) {
+            memset(tail[l], 0, tail_len);
+            memcpy(tail[l], msg[l] + (len - r), r);
+            tail[l][r] = 0x80;
+            for (unsigned i = 0; i < 8; i++) {
+                tail[l][tail_len - 1 - i] = (unsigned char)(bitlen >> (8 * i));
+            }
+        }
+        for (size_t off = 0; off < tail_len; off += 64) {
+            for (unsigned l = 0; l < SHA256_MULTI_LANES; l++) {
+                blocks[l] = &tail[l][off];
+            }
+            sha256_transform_multi(state, blocks);
+        }
+
+        for (unsigned l = 0; l < lanes; l++) {
+            uint32_t res[8];
+            for (unsigned i = 0; i < 8; i++) {
+                res[i] = state[i][l];
+            }
+            be32enc_vect(digest[first + l], res, SHA256_DIGEST_LENGTH);
+        }
+    }
+}
 
 void hmac_sha256_init(hmac_context_t *ctx, const void *key, size_t key_length)
 {
@@ -127,6 +127,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "hashes.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -228,6 +230,163 @@ void bloom_add(bloom_t *bloom, const uint8_t *buf, size_t len);
  */
 bool bloom_check(bloom_t *bloom, const uint8_t *buf, size_t len);
 
+/**
+ * @name    Blocked Bloom filter
+ *
+ * The classic filter above calls @p k independent hash functions and each
+ * of the resulting bits may live anywhere in the bitfield, so a single
+ * membership test costs k passes over the input and k scattered memory
+ * accesses.
+ *
+ * The blocked variant hashes the input exactly once with a 64 bit hash
+ * (@ref fnv64a_hash). The upper half of that hash selects one block of
+ * @ref BLOOM_BLOCKED_BLOCK_SIZE bytes (one cache line on most hosts), the
+ * lower half provides the two seeds of a double hashing scheme
+ *
+ *      g_i(x) = h1(x) + i * h2(x)     mod (8 * BLOOM_BLOCKED_BLOCK_SIZE)
+ *
+ * from which all k bit positions inside that block are derived. Confining
+ * an element to a single block slightly raises the false positive rate
+ * compared to a classic filter of the same size, but every operation
+ * touches only one block of memory.
+ *
+ * Callers that already own a suitable hash of their element (e.g. a
+ * digest of a packet's source and sequence number) can skip hashing by
+ * using the `*_hash()` functions directly.
+ * @{
+ */
+/**
+ * @brief   Size of a block in bytes
+ *
+ * Must be a power of two. The default matches the cache line size of
+ * common hosts; on cache-less MCUs smaller blocks only raise the false
+ * positive rate and are not faster.
+ */
+#ifndef BLOOM_BLOCKED_BLOCK_SIZE
+#define BLOOM_BLOCKED_BLOCK_SIZE    (64U)
+#endif
+
+/**
+ * @brief   Number of elements hashed ahead of the first probe in
+ *          bloom_blocked_add_batch() and bloom_blocked_check_batch()
+ */
+#ifndef BLOOM_BLOCKED_BATCH_SIZE
+#define BLOOM_BLOCKED_BATCH_SIZE    (8U)
+#endif
+
+/**
+ * @brief   Blocked Bloom filter object
+ */
+typedef struct {
+    uint8_t *blocks;    /**< bit array, @p numof blocks */
+    size_t numof;       /**< number of blocks */
+    unsigned k;         /**< number of bits set per element */
+} bloom_blocked_t;
+
+/**
+ * @brief   Initialize a blocked Bloom filter and clear all bits
+ *
+ * @param[out] bloom    filter to initialize
+ * @param[in] buf       memory holding the blocks
+ * @param[in] size      size of @p buf in bytes, a multiple of
+ *                      @ref BLOOM_BLOCKED_BLOCK_SIZE
+ * @param[in] k         number of bits set per element
+ *
+ * @pre     @p size >= @ref BLOOM_BLOCKED_BLOCK_SIZE
+ * @pre     0 < @p k <= 8 * @ref BLOOM_BLOCKED_BLOCK_SIZE
+ */
+void bloom_blocked_init(bloom_blocked_t *bloom, void *buf, size_t size,
+                        unsigned k);
+
+/**
+ * @brief   Remove all elements from a blocked Bloom filter
+ *
+ * @param[in,out] bloom filter to clear
+ */
+void bloom_blocked_clear(bloom_blocked_t *bloom);
+
+/**
+ * @brief   Add an element given by its 64 bit hash
+ *
+ * @param[in,out] bloom filter
+ * @param[in] hash      well distributed 64 bit hash of the element
+ */
+void bloom_blocked_add_hash(bloom_blocked_t *bloom, uint64_t hash);
+
+/**
+ * @brief   Determine if an element given by its 64 bit hash may be in the
+ *          filter
+ *
+ * @param[in] bloom     filter
+ * @param[in] hash      well distributed 64 bit hash of the element
+ *
+ * @return  false if the element is not in the filter
+ * @return  true if the element may be in the filter
+ */
+bool bloom_blocked_check_hash(const bloom_blocked_t *bloom, uint64_t hash);
+
+/**
+ * @brief   Add a string to a blocked Bloom filter
+ *
+ * @param[in,out] bloom filter
+ * @param[in] buf       string to add
+ * @param[in] len       length of @p buf
+ */
+static inline void bloom_blocked_add(bloom_blocked_t *bloom,
+                                     const uint8_t *buf, size_t len)
+{
+    bloom_blocked_add_hash(bloom, fnv64a_hash(buf, len));
+}
+
+/**
+ * @brief   Determine if a string may be in a blocked Bloom filter
+ *
+ * @param[in] bloom     filter
+ * @param[in] buf       string to check
+ * @param[in] len       length of @p buf
+ *
+ * @return  false if string does not exist in the filter
+ * @return  true if string may be in the filter
+ */
+static inline bool bloom_blocked_check(const bloom_blocked_t *bloom,
+                                       const uint8_t *buf, size_t len)
+{
+    return bloom_blocked_check_hash(bloom, fnv64a_hash(buf, len));
+}
+
+/**
+ * @brief   Add several strings to a blocked Bloom filter
+ *
+ * Hashes up to @ref BLOOM_BLOCKED_BATCH_SIZE strings before touching the
+ * bit array, so the block fetches of consecutive elements overlap.
+ *
+ * @param[in,out] bloom filter
+ * @param[in] bufs      strings to add
+ * @param[in] lens      lengths of the strings in @p bufs
+ * @param[in] numof     number of strings
+ */
+void bloom_blocked_add_batch(bloom_blocked_t *bloom,
+                             const uint8_t *const bufs[], const size_t lens[],
+                             size_t numof);
+
+/**
+ * @brief   Check several strings against a blocked Bloom filter
+ *
+ * @param[in] bloom     filter
+ * @param[in] bufs      strings to check
+ * @param[in] lens      lengths of the strings in @p bufs
+ * @param[in] numof     number of strings
+ * @param[out] res      result of bloom_blocked_check() for each string,
+ *                      may be NULL
+ *
+ * @return  number of strings that may be in the filter
+ */
+size_t bloom_blocked_check_batch(const bloom_blocked_t *bloom,
+                                 const uint8_t *const bufs[],
+                                 const size_t lens[], size_t numof,
+                                 bool *res);
+/** @} */
+
 #ifdef __cplusplus
 }
 #endif
@@ -35,6 +35,18 @@ extern "C" {
 #include "mbox.h"
 #endif
 
+/**
+ * @brief Number of subscribers that can receive a frame without allocating
+ *        per-subscriber rx data
+ *
+ * A received packet carries this many @ref can_rx_data_t, which are handed
+ * to the first subscribers of the frame. Only further subscribers need rx data
+ * allocated with can_pkt_alloc_rx_data().
+ */
+#ifndef CAN_PKT_RX_DATA_NUMOF
+#define CAN_PKT_RX_DATA_NUMOF   (2U)
+#endif
+
 /**
  * @brief A CAN packet
  *
@@ -46,6 +58,10 @@ typedef struct {
     int handle;              /**< handle (for tx frames */
     struct can_frame frame;  /**< CAN Frame */
     gnrc_pktsnip_t *snip;    /**< Pointer to the allocated snip */
+    /**
+     * @brief rx data for the first subscribers of a received frame
+     */
+    can_rx_data_t rx_data[CAN_PKT_RX_DATA_NUMOF];
 } can_pkt_t;
 
 /**
@@ -116,8 +132,27 @@ void can_pkt_free(can_pkt_t *pkt);
  */
 can_rx_data_t *can_pkt_alloc_rx_data(void *data, size_t len, void *arg);
 
+/**
+ * @brief Get rx data for the @p idx-th subscriber of a received packet
+ *
+ * The rx data is taken from the ones carried by @p pkt if possible and
+ * allocated with can_pkt_alloc_rx_data() otherwise.
+ *
+ * @param[in] pkt   the received packet
+ * @param[in] idx   index of the subscriber for this packet
+ * @param[in] arg   optional argument for the upper layer
+ *
+ * @return a @p can_rx_data_t pointer referencing the frame of @p pkt,
+ *         NULL if out of memory
+ */
+can_rx_data_t *can_pkt_get_rx_data(can_pkt_t *pkt, unsigned idx, void *arg);
+
 /**
  * @brief Free rx data previously allocated by can_pkt_alloc_rx_data()
+ *        or returned by can_pkt_get_rx_data()
+ *
+ * rx data carried by a packet is released together with the packet, so
+ * this function must be called before the packet's frame is freed.
  *
  * @param[in] data  the pointer to free
  */
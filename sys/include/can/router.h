@@ -29,6 +29,19 @@ extern "C" {
 #include "can/can.h"
 #include "can/pkt.h"
 
+/**
+ * @brief   Number of hash buckets per filter mask
+ *
+ * Filters are grouped by their mask and, within a group, hashed by their
+ * CAN ID. Dispatching a frame therefore costs one hash lookup per distinct
+ * mask registered on the interface instead of one comparison per filter.
+ *
+ * @note    Must be a power of two
+ */
+#ifndef CAN_ROUTER_HASH_BUCKETS
+#define CAN_ROUTER_HASH_BUCKETS     (16U)
+#endif
+
 /**
  * @brief Register a user @p entry to receive a frame @p can_id
  *
@@ -75,9 +88,10 @@ int can_router_free_frame(struct can_frame *frame);
 /**
  * @brief Dispatch a RX indication to subscribers threads
  *
- * This function goes through the list of subscribed filters to send a message to each
- * subscriber's thread. If all the subscriber's threads cannot receive message,
- * the packet is freed.
+ * This function looks up the subscribed filters matching the frame to send a message
+ * to each subscriber's thread. All subscribers share @p pkt, which is reference
+ * counted. If all the subscriber's threads cannot receive message, the packet is
+ * freed.
  *
  * @param[in] pkt   the packet to dispatch
  *
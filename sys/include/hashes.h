@@ -171,6 +171,23 @@ uint32_t rotating_hash(const uint8_t *buf, size_t len);
  */
 uint32_t one_at_a_time_hash(const uint8_t *buf, size_t len);
 
+/**
+ * @defgroup sys_hashes_fnv64a Fowler–Noll–Vo (64 bit, FNV-1a)
+ * @ingroup sys_hashes_non_crypto
+ * @brief 64 bit FNV-1a hash algorithm.
+ *
+ * Wide enough to derive several independent indices from a single hash
+ * value (see @ref bloom_blocked_t).
+ *
+ * found on
+ * http://www.isthe.com/chongo/tech/comp/fnv/index.html
+ *
+ * @param buf input buffer to hash
+ * @param len length of buffer
+ * @return 64 bit sized hash
+ */
+uint64_t fnv64a_hash(const uint8_t *buf, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
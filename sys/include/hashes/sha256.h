@@ -34,6 +34,14 @@
  * @defgroup    sys_hashes_sha256 SHA-256
  * @ingroup     sys_hashes_unkeyed
  * @brief       Implementation of the SHA-256 hashing function
+ *
+ * The block compression function is selected at build time:
+ *  - portable C (default)
+ *  - `sha256_unrolled`: unrolled by eight rounds with a 16 word message
+ *    schedule, faster on e.g. Cortex-M3/M4 and with less stack
+ *  - `sha256_shani`: SHA extensions of x86 CPUs for @ref boards_native,
+ *    falling back to portable C if the host CPU lacks them
+ *
  * @{
  *
  * @file
@@ -65,6 +73,14 @@ extern "C" {
  */
 #define SHA256_INTERNAL_BLOCK_SIZE (64)
 
+/**
+ * @brief   Number of messages hashed in lockstep by sha256_multi(), must be
+ *          a power of two
+ */
+#ifndef SHA256_MULTI_LANES
+#define SHA256_MULTI_LANES (4)
+#endif
+
 /**
  * @brief Context for cipher operations based on sha256
  */
@@ -134,6 +150,22 @@ void sha256_final(sha256_context_t *ctx, void *digest);
  */
 void *sha256(const void *data, size_t len, void *digest);
 
+/**
+ * @brief   Hashes @p n independent messages of the same length
+ *
+ * The messages are hashed SHA256_MULTI_LANES at a time with their rounds
+ * interleaved, which the compiler can map to vector instructions. The result
+ * is the same as calling sha256() for every message.
+ *
+ * @param[in]  data     pointers to the @p n messages
+ * @param[in]  len      length of every message in bytes
+ * @param[out] digest   pointers to @p n arrays of SHA256_DIGEST_LENGTH bytes
+ *                      for the results
+ * @param[in]  n        number of messages
+ */
+void sha256_multi(const void *const data[], size_t len,
+                  void *const digest[], unsigned n);
+
 /**
  * @brief hmac_sha256_init HMAC SHA-256 calculation. Initiate calculation of a HMAC
  * @param[in] ctx hmac_context_t handle to use
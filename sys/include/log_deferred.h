@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_log_deferred Deferred binary logging
+ * @ingroup     sys
+ * @brief       Log module that defers formatting and output of log messages
+ *
+ * With this module, the `LOG_*` macros neither format their message nor
+ * wait for the output device. Instead, the address of the format string and
+ * the raw arguments are copied into a ring buffer. A thread running at the
+ * lowest priority renders the buffered messages and prints them when the
+ * system is otherwise idle.
+ *
+ * Logging is safe from interrupt context. If the ring buffer is full, new
+ * messages are dropped and counted, the caller is never blocked. Arguments
+ * are recorded as described by the format string, strings passed for `%%s`
+ * are copied (and truncated to fit into @ref LOG_DEFERRED_MSG_MAX).
+ *
+ * If @ref LOG_DEFERRED_BINARY is set to 1, messages are not rendered on the
+ * device but printed as hex encoded records, one per line and prefixed with
+ * `#L`. These lines can be decoded on the host with the ELF file of the
+ * application:
+ *
+ *     make term | dist/tools/logdecode/logdecode.py bin/<board>/<app>.elf
+ *
+ * @{
+ *
+ * @file
+ * @brief       Deferred binary logging interface
+ */
+
+#ifndef LOG_DEFERRED_H
+#define LOG_DEFERRED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Size of the ring buffer in bytes, must be a power of two
+ */
+#ifndef LOG_DEFERRED_BUF_SIZE
+#define LOG_DEFERRED_BUF_SIZE       (1024U)
+#endif
+
+/**
+ * @brief   Maximum size of a single record in the ring buffer
+ *
+ * A record consists of a 2 byte header, the address of the format string and
+ * the arguments. Messages that do not fit are dropped, strings are truncated.
+ * Must not exceed 255.
+ */
+#ifndef LOG_DEFERRED_MSG_MAX
+#define LOG_DEFERRED_MSG_MAX        (64U)
+#endif
+
+/**
+ * @brief   Print binary records instead of rendered messages
+ */
+#ifndef LOG_DEFERRED_BINARY
+#define LOG_DEFERRED_BINARY         (0)
+#endif
+
+/**
+ * @brief   Stack size of the output thread
+ */
+#ifndef LOG_DEFERRED_STACKSIZE
+#define LOG_DEFERRED_STACKSIZE      (THREAD_STACKSIZE_DEFAULT)
+#endif
+
+/**
+ * @brief   Priority of the output thread
+ */
+#ifndef LOG_DEFERRED_PRIO
+#define LOG_DEFERRED_PRIO           (THREAD_PRIORITY_IDLE - 1)
+#endif
+
+/**
+ * @brief   Start the output thread
+ *
+ * Called by auto_init. Messages logged before are buffered.
+ */
+void log_deferred_init(void);
+
+/**
+ * @brief   Record a log message
+ *
+ * @param[in] level     log level of the message
+ * @param[in] format    format string, must stay valid for the lifetime of
+ *                      the application (e.g. a string literal)
+ */
+void log_deferred_write(unsigned level, const char *format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief   Output all buffered messages from the calling thread
+ *
+ * Useful before a reboot, when the output thread will not get the chance to
+ * run anymore. Only call this function from interrupt context if the system
+ * is about to halt.
+ */
+void log_deferred_flush(void);
+
+/**
+ * @brief   Output all buffered messages on a kernel panic
+ *
+ * Like log_deferred_flush(), but never blocks, even if the output lock is
+ * held by the panicking thread or interrupts are disabled. Called by
+ * core_panic(), the system must halt afterwards.
+ */
+void log_deferred_panic(void);
+
+/**
+ * @brief   Get the number of messages dropped because the buffer was full
+ *
+ * @return  number of dropped messages since boot
+ */
+unsigned log_deferred_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOG_DEFERRED_H */
+/** @} */
@@ -164,6 +164,18 @@ extern "C" {
 #define EMCUTE_N_RETRY          (3U)
 #endif
 
+#ifndef EMCUTE_WINDOW_SIZE
+/**
+ * @brief   Number of QoS 1 PUBLISH and REGISTER messages that may await their
+ *          acknowledgment at the same time
+ *
+ * Every message in flight is kept in a buffer of @ref EMCUTE_BUFSIZE bytes
+ * for retransmission. emcute_pub() and emcute_reg_multi() block while the
+ * window is full.
+ */
+#define EMCUTE_WINDOW_SIZE      (2U)
+#endif
+
 /**
  * @brief   MQTT-SN flags
  *
@@ -274,9 +286,34 @@ int emcute_discon(void);
  */
 int emcute_reg(emcute_topic_t *topic);
 
+/**
+ * @brief   Get topic IDs for several topic names at once
+ *
+ * Up to @ref EMCUTE_WINDOW_SIZE REGISTER messages are sent back-to-back
+ * instead of waiting for the REGACK of each topic before registering the
+ * next one.
+ *
+ * @param[in,out] topics    topics to register, all topic names **must not**
+ *                          be NULL
+ * @param[in] numof         number of elements in @p topics
+ *
+ * @return  EMCUTE_OK if all topics were registered
+ * @return  EMCUTE_NOGW if not connected to a gateway
+ * @return  EMCUTE_OVERFLOW if length of a topic name exceeds
+ *          @ref EMCUTE_TOPIC_MAXLEN, no topic is registered in this case
+ * @return  EMCUTE_REJECT if the gateway rejected at least one topic
+ * @return  EMCUTE_TIMEOUT if at least one topic timed out
+ */
+int emcute_reg_multi(emcute_topic_t *topics, size_t numof);
+
 /**
  * @brief   Publish data on the given topic
  *
+ * QoS 1 messages are queued in a window of @ref EMCUTE_WINDOW_SIZE messages
+ * and retransmitted until they are acknowledged, this function returns as
+ * soon as the message is sent for the first time. Use emcute_flush() to wait
+ * for the acknowledgments and to learn about failed messages.
+ *
  * @param[in] topic     topic to send data to, topic **must** be registered
  *                      (topic.id **must** populated).
  * @param[in] buf       data to publish
@@ -285,14 +322,25 @@ int emcute_reg(emcute_topic_t *topic);
  *
  * @return  EMCUTE_OK on success
  * @return  EMCUTE_NOGW if not connected to a gateway
- * @return  EMCUTE_REJECT if publish message was rejected (QoS > 0 only)
  * @return  EMCUTE_OVERFLOW if length of data exceeds @ref EMCUTE_BUFSIZE
- * @return  EMCUTE_TIMEOUT on connection timeout (QoS > 0 only)
  * @return  EMCUTE_NOTSUP on unsupported flag values
  */
 int emcute_pub(emcute_topic_t *topic, const void *buf, size_t len,
                unsigned flags);
 
+/**
+ * @brief   Wait until all QoS 1 messages are acknowledged or timed out
+ *
+ * @note    Only one thread may call this function at a time.
+ *
+ * @return  EMCUTE_OK if all messages published since the last call were
+ *          acknowledged
+ * @return  EMCUTE_REJECT if at least one message was rejected
+ * @return  EMCUTE_TIMEOUT if at least one message timed out
+ * @return  EMCUTE_NOGW if the connection was closed with messages in flight
+ */
+int emcute_flush(void);
+
 /**
  * @brief   Subscribe to the given topic
  *
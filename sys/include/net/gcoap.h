@@ -169,6 +169,43 @@
  * the Observe option value set to 1. The server does not support cancellation
  * via a reset (RST) response to a non-confirmable notification.
  *
+ * ## Block-wise Transfer ##
+ *
+ * gcoap supports block-wise transfers (RFC 7959) of resources larger than a
+ * single PDU.
+ *
+ * ### Server ###
+ *
+ * Instead of writing a handler, register gcoap_block_handler() for a resource
+ * and pass a gcoap_block_resource_t as its context. The read() callback
+ * produces the data for a GET request one block at a time, gcoap adds the
+ * Block2 and, if size() is given, Size2 options. The write() callback consumes
+ * the payload of a PUT or POST request one Block1 block at a time, gcoap
+ * responds with 2.31 (Continue) until the last block was written.
+ *
+ * The block size is the smaller of the size asked for by the client and
+ * GCOAP_BLOCK_SZX, and is reduced further until a block fits into
+ * GCOAP_PDU_BUF_SIZE.
+ *
+ * ### Client ###
+ *
+ * gcoap continues a GET request automatically when a response carries a
+ * Block2 option with the more flag set. The response handler is called once
+ * for each block; use coap_get_block2() to find the offset of the payload.
+ * The transfer is complete with the block without the more flag.
+ *
+ * Continuation requires a copy of the request in one of the
+ * GCOAP_RESEND_BUFS_MAX buffers. A confirmable request always has one. A
+ * non-confirmable request only gets one if it carries a Block2 option, add it
+ * with gcoap_add_block2() before gcoap_finish(). Otherwise the handler only
+ * receives the first block.
+ *
+ * The next block is requested only after the previous one arrived. For a
+ * non-confirmable request, gcoap keeps up to GCOAP_BLOCK2_WINDOW block
+ * requests in flight instead, once the server revealed the size of the
+ * resource with the Size2 option. Raise GCOAP_BLOCK2_WINDOW only for peers
+ * that allow more than one outstanding interaction (NSTART > 1).
+ *
  * ## Implementation Notes ##
  *
  * ### Building a packet ###
@@ -207,6 +244,7 @@
  *   in a user provided callback.
  * - Client generates token; length defined at compile time.
  * - Options: Supports Content-Format for payload.
+ * - Block-wise transfer: Block2 for server and client, Block1 for a server.
  *
  * @{
  *
@@ -220,6 +258,7 @@
 #ifndef NET_GCOAP_H
 #define NET_GCOAP_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "net/ipv6/addr.h"
@@ -267,6 +306,33 @@ extern "C" {
  */
 #define GCOAP_RESP_OPTIONS_BUF  (8)
 
+/**
+ * @brief   Additional space reserved for options by gcoap_block_handler()
+ *
+ * Accommodates Block1 or Block2 and Size2.
+ */
+#define GCOAP_BLOCK_OPTIONS_BUF (12)
+
+/**
+ * @brief   Preferred block size exponent (SZX) for block-wise transfers
+ *
+ * The block size is 2^(SZX + 4) bytes, the default of 2 yields 64 byte blocks
+ * which fit into the default GCOAP_PDU_BUF_SIZE.
+ */
+#ifndef GCOAP_BLOCK_SZX
+#define GCOAP_BLOCK_SZX         (2)
+#endif
+
+/**
+ * @brief   Maximum number of non-confirmable Block2 requests in flight for a
+ *          single transfer
+ *
+ * Must not exceed 32.
+ */
+#ifndef GCOAP_BLOCK2_WINDOW
+#define GCOAP_BLOCK2_WINDOW     (1)
+#endif
+
 /**
  * @brief   Size of the buffer used to write options in an Observe notification
  *
@@ -457,6 +523,25 @@ typedef struct {
     size_t pdu_len;                     /**< Length of pdu_buf */
 } gcoap_resend_t;
 
+/**
+ * @brief   Extends request memo for the Block2 transfer of a response
+ */
+typedef struct {
+    uint32_t base;                      /**< Lowest block number not received */
+    uint32_t next;                      /**< Next block number to request */
+    uint32_t last;                      /**< Number of the last block,
+                                             UINT32_MAX while unknown */
+    uint32_t received;                  /**< Blocks received from base on,
+                                             bit 0 is block base */
+    uint16_t opt_offset;                /**< Offset of the Block2 option in
+                                             the PDU buffer */
+    uint8_t lastonum;                   /**< Option preceding Block2 */
+    uint8_t szx;                        /**< Block size exponent in use */
+    bool enabled;                       /**< Request can be continued; the PDU
+                                             buffer is used, even if
+                                             non-confirmable */
+} gcoap_block2_memo_t;
+
 /**
  * @brief   Memo to handle a response for a request
  */
@@ -474,6 +559,7 @@ typedef struct {
     gcoap_resp_handler_t resp_handler;  /**< Callback for the response */
     xtimer_t response_timer;            /**< Limits wait for response */
     msg_t timeout_msg;                  /**< For response timer */
+    gcoap_block2_memo_t block2;         /**< Block2 transfer state */
 } gcoap_request_memo_t;
 
 /**
@@ -486,6 +572,52 @@ typedef struct {
     unsigned token_len;                 /**< Actual length of token attribute */
 } gcoap_observe_memo_t;
 
+/**
+ * @brief   Resource served block-wise by gcoap_block_handler()
+ *
+ * Use a pointer to this struct as the context of the coap_resource_t.
+ */
+typedef struct {
+    /**
+     * @brief   Reads the data of a GET response
+     *
+     * @param[in]  arg      gcoap_block_resource_t::arg
+     * @param[in]  offset   offset of the block within the resource
+     * @param[out] buf      buffer for the block
+     * @param[in]  len      size of the block
+     *
+     * @return  number of bytes read, less than @p len only for the last block
+     * @return  < 0 on error, gcoap responds with 5.00
+     */
+    ssize_t (*read)(void *arg, size_t offset, void *buf, size_t len);
+    /**
+     * @brief   Writes the payload of a PUT or POST request
+     *
+     * @param[in] arg       gcoap_block_resource_t::arg
+     * @param[in] offset    offset of the block within the resource
+     * @param[in] buf       payload of the block
+     * @param[in] len       length of the payload
+     * @param[in] more      true if more blocks follow
+     *
+     * @return  >= 0 on success
+     * @return  < 0 on error, gcoap responds with 5.00
+     */
+    ssize_t (*write)(void *arg, size_t offset, const void *buf, size_t len,
+                     bool more);
+    /**
+     * @brief   Gets the total size of the resource, may be NULL
+     *
+     * If NULL, the end of the resource is found by reading one more byte.
+     *
+     * @param[in] arg       gcoap_block_resource_t::arg
+     *
+     * @return  size of the resource in bytes
+     */
+    size_t (*size)(void *arg);
+    void *arg;                          /**< Argument for the callbacks */
+    uint16_t format;                    /**< Content-Format of the data */
+} gcoap_block_resource_t;
+
 /**
  * @brief   Initializes the gcoap thread and device
  *
@@ -687,6 +819,58 @@ uint8_t gcoap_op_state(void);
  */
 int gcoap_get_resource_list(void *buf, size_t maxlen, uint8_t cf);
 
+/**
+ * @brief   Resource handler for block-wise transfers
+ *
+ * Serves GET requests with gcoap_block_resource_t::read() and PUT or POST
+ * requests with gcoap_block_resource_t::write().
+ *
+ * @param[in,out] pdu   Request, the response is written to the same buffer
+ * @param[out] buf      Buffer for the response
+ * @param[in] len       Length of the buffer
+ * @param[in] ctx       Pointer to a gcoap_block_resource_t
+ *
+ * @return  size of the response PDU
+ * @return  < 0 on error
+ */
+ssize_t gcoap_block_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                            void *ctx);
+
+/**
+ * @brief   Adds a Block1 option to a CoAP PDU
+ *
+ * Call between initializing and finishing the PDU.
+ *
+ * @param[out] pdu      The package that is being build
+ * @param[in]  blknum   Block number
+ * @param[in]  szx      Block size exponent
+ * @param[in]  more     true if more blocks follow
+ */
+static inline void gcoap_add_block1(coap_pkt_t *pdu, uint32_t blknum,
+                                    unsigned szx, bool more)
+{
+    pdu->block1 = (blknum << COAP_BLOCKWISE_NUM_OFF)
+                  | ((uint32_t)more << COAP_BLOCKWISE_MORE_OFF) | szx;
+}
+
+/**
+ * @brief   Adds a Block2 option to a CoAP PDU
+ *
+ * Call between initializing and finishing the PDU. In a request, @p more
+ * must be false.
+ *
+ * @param[out] pdu      The package that is being build
+ * @param[in]  blknum   Block number
+ * @param[in]  szx      Block size exponent
+ * @param[in]  more     true if more blocks follow
+ */
+static inline void gcoap_add_block2(coap_pkt_t *pdu, uint32_t blknum,
+                                    unsigned szx, bool more)
+{
+    pdu->block2 = (blknum << COAP_BLOCKWISE_NUM_OFF)
+                  | ((uint32_t)more << COAP_BLOCKWISE_MORE_OFF) | szx;
+}
+
 /**
  * @brief   Adds a single Uri-Query option to a CoAP request
  *
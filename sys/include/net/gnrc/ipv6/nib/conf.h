@@ -262,6 +262,19 @@ extern "C" {
 #define GNRC_IPV6_NIB_OFFL_NUMOF            (8)
 #endif
 
+/**
+ * @brief   Number of hash buckets for host routes in the off-link entries
+ *
+ * Off-link entries are searched linearly by default. Nodes with a large
+ * forwarding table, e.g. the root of a RPL DODAG in storing mode, can set
+ * this to a power of two to find routes to a single address (with a prefix
+ * length of 128) in constant time. All other prefixes are still searched
+ * linearly, but only among themselves. Set to 0 to disable the index.
+ */
+#ifndef GNRC_IPV6_NIB_OFFL_HASH_NUMOF
+#define GNRC_IPV6_NIB_OFFL_HASH_NUMOF       (0)
+#endif
+
 #if GNRC_IPV6_NIB_CONF_MULTIHOP_P6C || defined(DOXYGEN)
 /**
  * @brief   Number of authoritative border router entries in NIB
@@ -41,6 +41,11 @@ extern "C" {
 
 /**
  * @brief   Number of RPL parents
+ *
+ * The parents are kept ordered by preference, a DIO only moves its sender
+ * within this list. Downward routes of a storing mode DODAG are stored in
+ * the forwarding table of the NIB, see @ref GNRC_IPV6_NIB_OFFL_NUMOF and
+ * @ref GNRC_IPV6_NIB_OFFL_HASH_NUMOF to scale it for large DODAGs.
  */
 #ifndef GNRC_RPL_PARENTS_NUMOF
 #define GNRC_RPL_PARENTS_NUMOF (3)
@@ -29,6 +29,22 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   Number of flows to cache compressed headers for
+ *
+ * Encoding a header requires context lookups and, for link-local source
+ * addresses, querying the interface for its IID. For every flow, i.e. packets
+ * with the same IPv6 header (apart from the payload length), UDP ports and
+ * link-layer addresses, the compressed header is cached, so subsequent
+ * packets only copy it and patch the UDP checksum. Entries are replaced
+ * round-robin and become stale when the 6LoWPAN contexts change.
+ *
+ * Set to 0 to disable the cache.
+ */
+#ifndef GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE
+#define GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE (0)
+#endif
+
 /**
  * @brief   Decompresses a received 6LoWPAN IPHC frame.
  *
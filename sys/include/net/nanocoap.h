@@ -72,6 +72,7 @@ extern "C" {
 #define COAP_OPT_LOCATION_QUERY (20)
 #define COAP_OPT_BLOCK2         (23)
 #define COAP_OPT_BLOCK1         (27)
+#define COAP_OPT_SIZE2          (28)
 /** @} */
 
 /**
@@ -133,6 +134,7 @@ extern "C" {
 #define COAP_CODE_CONTENT      ((2 << 5) | 5)
 #define COAP_CODE_205          ((2 << 5) | 5)
 #define COAP_CODE_231          ((2 << 5) | 31)
+#define COAP_CODE_CONTINUE     ((2 << 5) | 31)
 /** @} */
 
 /**
@@ -274,6 +276,12 @@ typedef struct {
     uint8_t qs[NANOCOAP_QS_MAX];                /**< parsed query string     */
     uint16_t content_type;                      /**< content type            */
     uint32_t observe_value;                     /**< observe value           */
+    uint32_t block1;                            /**< Block1 value to write,
+                                                     UINT32_MAX if none      */
+    uint32_t block2;                            /**< Block2 value to write,
+                                                     UINT32_MAX if none      */
+    uint32_t size2;                             /**< Size2 value to write,
+                                                     UINT32_MAX if none      */
 #endif
 } coap_pkt_t;
 
@@ -294,6 +302,8 @@ typedef struct {
 
 /**
  * @brief   Block1 helper struct
+ *
+ * Also used for the Block2 option, see coap_get_block2().
  */
 typedef struct {
     size_t offset;                  /**< offset of received data            */
@@ -583,6 +593,34 @@ int coap_get_block1(coap_pkt_t *pkt, coap_block1_t *block1);
  */
 size_t coap_put_option_block1(uint8_t *buf, uint16_t lastonum, unsigned blknum, unsigned szx, int more);
 
+/**
+ * @brief    Block2 option getter
+ *
+ * Works like coap_get_block1(): if no block2 option is present in @p pkt,
+ * the values in @p block2 are initialized with zero and block2->more is -1.
+ *
+ * @param[in]   pkt     pkt to work on
+ * @param[out]  block2  ptr to preallocated coap_block1_t structure
+ *
+ * @returns     0 if block2 option not present
+ * @returns     1 if structure has been filled
+ */
+int coap_get_block2(coap_pkt_t *pkt, coap_block1_t *block2);
+
+/**
+ * @brief   Insert block2 option into buffer
+ *
+ * @param[out]  buf         buffer to write to
+ * @param[in]   lastonum    number of previous option (for delta calculation),
+ *                          must be < 23
+ * @param[in]   blknum      block number
+ * @param[in]   szx         SXZ value
+ * @param[in]   more        more flag (1 or 0)
+ *
+ * @returns     amount of bytes written to @p buf
+ */
+size_t coap_put_option_block2(uint8_t *buf, uint16_t lastonum, unsigned blknum, unsigned szx, int more);
+
 /**
  * @brief   Insert block1 option into buffer (from coap_block1_t)
  *
@@ -602,6 +640,37 @@ size_t coap_put_option_block1(uint8_t *buf, uint16_t lastonum, unsigned blknum,
  */
 size_t coap_put_block1_ok(uint8_t *pkt_pos, coap_block1_t *block1, uint16_t lastonum);
 
+/**
+ * @brief   Insert an unsigned integer option into buffer
+ *
+ * The value is encoded with the least number of bytes, a value of zero
+ * yields an option without value.
+ *
+ * @param[out]  buf         buffer to write to
+ * @param[in]   lastonum    number of previous option (for delta calculation),
+ *                          or 0 if first option
+ * @param[in]   onum        option number
+ * @param[in]   value       value to encode
+ *
+ * @returns     amount of bytes written to @p buf
+ */
+size_t coap_opt_put_uint(uint8_t *buf, uint16_t lastonum, uint16_t onum,
+                         uint32_t value);
+
+/**
+ * @brief   Get the value of an unsigned integer option
+ *
+ * @param[in]   pkt     packet to work on
+ * @param[in]   opt_num option number to look for
+ * @param[out]  target  value of the option
+ *
+ * @returns     0 on success
+ * @returns     -1 if the option is not present
+ * @returns     -ENOSPC if the option is longer than four bytes
+ * @returns     -EBADMSG if the option is malformed
+ */
+int coap_get_option_uint(coap_pkt_t *pkt, unsigned opt_num, uint32_t *target);
+
 /**
  * @brief   Encode the given string as option(s) into pkt
  *
@@ -51,6 +51,14 @@ typedef struct {
     uint32_t tx_bytes;          /**< sent bytes */
     uint32_t rx_count;          /**< received (data) packets */
     uint32_t rx_bytes;          /**< received bytes */
+    uint32_t tx_batches;        /**< transfers to the device, each carrying
+                                     one or more frames (only counted by
+                                     drivers that batch, e.g. host syscalls
+                                     on native) */
+    uint32_t rx_batches;        /**< transfers from the device, each carrying
+                                     one or more frames (only counted by
+                                     drivers that batch, e.g. host syscalls
+                                     on native) */
 } netstats_t;
 
 #ifdef __cplusplus
@@ -12,6 +12,16 @@
  *
  * @brief       Sock DNS client
  *
+ * With the `sock_dns_cache` module, positive and negative answers are kept
+ * in a small cache for as long as their TTL allows (negative answers for
+ * @ref SOCK_DNS_CACHE_NEG_TTL), so repeated lookups of the same name need no
+ * network round trip.
+ *
+ * With the `sock_dns_async` module, all lookups are multiplexed over a single
+ * UDP sock by a resolver thread. Up to @ref SOCK_DNS_QUERIES_NUMOF queries
+ * can be in flight at the same time, and sock_dns_query_async() allows to
+ * resolve names without blocking the calling thread.
+ *
  * @{
  *
  * @file
@@ -59,8 +69,51 @@ typedef struct {
 
 #define SOCK_DNS_MAX_NAME_LEN   (64U)       /* we're in embedded context. */
 #define SOCK_DNS_QUERYBUF_LEN   (sizeof(sock_dns_hdr_t) + 4 + SOCK_DNS_MAX_NAME_LEN)
+#define SOCK_DNS_REPLY_LEN      (512U)
 /** @} */
 
+/**
+ * @brief   Time to wait for a reply before a query is retransmitted in
+ *          microseconds
+ */
+#ifndef SOCK_DNS_TIMEOUT
+#define SOCK_DNS_TIMEOUT        (1000000U)
+#endif
+
+/**
+ * @brief   Number of cached answers (`sock_dns_cache` module)
+ */
+#ifndef SOCK_DNS_CACHE_SIZE
+#define SOCK_DNS_CACHE_SIZE     (4U)
+#endif
+
+/**
+ * @brief   Time in seconds a negative answer (NXDOMAIN or no matching
+ *          record) is cached (`sock_dns_cache` module)
+ */
+#ifndef SOCK_DNS_CACHE_NEG_TTL
+#define SOCK_DNS_CACHE_NEG_TTL  (30U)
+#endif
+
+/**
+ * @brief   Maximum number of queries in flight at the same time
+ *          (`sock_dns_async` module)
+ */
+#ifndef SOCK_DNS_QUERIES_NUMOF
+#define SOCK_DNS_QUERIES_NUMOF  (4U)
+#endif
+
+/**
+ * @brief   Callback for sock_dns_query_async()
+ *
+ * @param[in] res   length of @p addr (4 or 16) on success, or one of the
+ *                  negative return values of sock_dns_query()
+ * @param[in] addr  the resolved address, only valid for the duration of the
+ *                  call
+ * @param[in] arg   argument given to sock_dns_query_async()
+ */
+typedef void (*sock_dns_cb_t)(int res, const void *addr, void *arg);
+
 /**
  * @brief Get IP address for DNS name
  *
@@ -80,11 +133,41 @@ typedef struct {
  * @param[out]  addr_out        buffer to write result into
  * @param[in]   family          Either AF_INET, AF_INET6 or AF_UNSPEC
  *
- * @return      0 on success
- * @return      !=0 otherwise
+ * @return      length of the address in @p addr_out (4 or 16) on success
+ * @return      -ECONNREFUSED if no DNS server is configured
+ * @return      -ENOSPC if @p domain_name is too long
+ * @return      -EHOSTUNREACH if the name does not exist, has no record of
+ *              the requested type or the server failed
+ * @return      -ETIMEDOUT if the server did not reply
+ * @return      -EBADMSG on a malformed reply
+ * @return      other negative values on sock errors
  */
 int sock_dns_query(const char *domain_name, void *addr_out, int family);
 
+/**
+ * @brief Resolve a DNS name without blocking (`sock_dns_async` module)
+ *
+ * The query is sent from the calling thread, @p cb is called from the
+ * resolver thread once the reply arrived or all retransmissions timed out.
+ * If the answer is cached (`sock_dns_cache` module), @p cb is called before
+ * this function returns.
+ *
+ * @warning Do not call sock_dns_query() from within @p cb.
+ *
+ * @param[in]   domain_name     DNS name to resolve into address
+ * @param[in]   family          Either AF_INET, AF_INET6 or AF_UNSPEC
+ * @param[in]   cb              callback for the result
+ * @param[in]   arg             argument for @p cb
+ *
+ * @return      0 if the query was started (or answered from the cache)
+ * @return      -ECONNREFUSED if no DNS server is configured
+ * @return      -ENOSPC if @p domain_name is too long
+ * @return      -ENOBUFS if @ref SOCK_DNS_QUERIES_NUMOF queries are in flight
+ * @return      other negative values on sock errors
+ */
+int sock_dns_query_async(const char *domain_name, int family,
+                         sock_dns_cb_t cb, void *arg);
+
 /**
  * @brief global DNS server endpoint
  */
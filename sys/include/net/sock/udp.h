@@ -273,6 +273,7 @@
 #include <stdlib.h>
 #include <sys/types.h>
 
+#include "iolist.h"
 #include "net/sock.h"
 
 #ifdef __cplusplus
@@ -402,6 +403,91 @@ int sock_udp_get_remote(sock_udp_t *sock, sock_udp_ep_t *ep);
 ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
                       uint32_t timeout, sock_udp_ep_t *remote);
 
+/**
+ * @brief   Receives a UDP message from a remote end point without copying it
+ *
+ * Lends the payload of the received message to the caller in the stack's
+ * own packet buffer. The buffer is not available to the stack until it is
+ * given back with sock_udp_recv_buf_release(), so release it as soon as
+ * possible.
+ *
+ * @pre `(sock != NULL) && (data != NULL) && (buf_ctx != NULL)`
+ *
+ * @param[in] sock      A UDP sock object.
+ * @param[out] data     Set to the payload of the received message.
+ * @param[out] buf_ctx  Set to the stack-internal buffer holding @p data.
+ *                      Must be passed to sock_udp_recv_buf_release().
+ * @param[in] timeout   Timeout for receive in microseconds.
+ *                      If 0 and no data is available, the function returns
+ *                      immediately.
+ *                      May be @ref SOCK_NO_TIMEOUT for no timeout (wait until
+ *                      data is available).
+ * @param[out] remote   Remote end point of the received data.
+ *                      May be `NULL`, if it is not required by the application.
+ *
+ * @note    Function blocks if no packet is currently waiting.
+ *
+ * @return  The number of bytes received on success. Only then @p data and
+ *          @p buf_ctx are valid.
+ * @return  -EADDRNOTAVAIL, if local of @p sock is not given.
+ * @return  -EAGAIN, if @p timeout is `0` and no data is available.
+ * @return  -EINVAL, if @p remote is invalid or @p sock is not properly
+ *          initialized (or closed while sock_udp_recv_buf() blocks).
+ * @return  -ENOMEM, if no memory was available to receive @p data.
+ * @return  -EPROTO, if source address of received packet did not equal
+ *          the remote of @p sock.
+ * @return  -ETIMEDOUT, if @p timeout expired.
+ */
+ssize_t sock_udp_recv_buf(sock_udp_t *sock, void **data, void **buf_ctx,
+                          uint32_t timeout, sock_udp_ep_t *remote);
+
+/**
+ * @brief   Returns a buffer received with sock_udp_recv_buf() or
+ *          sock_udp_recv_batch() to the stack
+ *
+ * @param[in] buf_ctx   The stack-internal buffer of the message.
+ *                      The payload of the message is invalid afterwards.
+ */
+void sock_udp_recv_buf_release(void *buf_ctx);
+
+/**
+ * @brief   A UDP message received with sock_udp_recv_batch()
+ */
+typedef struct {
+    void *data;                 /**< payload of the message */
+    size_t len;                 /**< length of sock_udp_msg_t::data */
+    void *buf_ctx;              /**< stack-internal buffer of the message,
+                                 *   see sock_udp_recv_buf_release() */
+    sock_udp_ep_t remote;       /**< remote end point of the message */
+} sock_udp_msg_t;
+
+/**
+ * @brief   Receives all UDP messages waiting on a sock at once
+ *
+ * Waits for the first message like sock_udp_recv_buf() and then takes all
+ * further messages already queued for @p sock without blocking, up to
+ * @p max. This saves a wake-up of the receiving thread per message under
+ * load. Messages not matching the remote end point of @p sock are dropped.
+ *
+ * Every message returned must be released with sock_udp_recv_buf_release().
+ *
+ * @pre `(sock != NULL) && (msgs != NULL) && (max > 0)`
+ *
+ * @param[in] sock      A UDP sock object.
+ * @param[out] msgs     Received messages.
+ * @param[in] max       Maximum number of messages to store in @p msgs.
+ * @param[in] timeout   Timeout for the first message in microseconds.
+ *                      If 0 and no data is available, the function returns
+ *                      immediately.
+ *                      May be @ref SOCK_NO_TIMEOUT for no timeout (wait until
+ *                      data is available).
+ *
+ * @return  The number of messages received on success.
+ * @return  Any error sock_udp_recv_buf() returns, if no message was received.
+ */
+int sock_udp_recv_batch(sock_udp_t *sock, sock_udp_msg_t *msgs, unsigned max,
+                        uint32_t timeout);
+
 /**
  * @brief   Sends a UDP message to remote end point
  *
@@ -438,6 +524,31 @@ ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
 ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
                       const sock_udp_ep_t *remote);
 
+/**
+ * @brief   Sends a UDP message gathered from several buffers to remote end
+ *          point
+ *
+ * Like sock_udp_send(), but the message is the concatenation of all elements
+ * of @p snips. This allows to send e.g. a header and a payload kept in
+ * different buffers without copying them into one buffer first.
+ *
+ * @pre `((sock != NULL || remote != NULL))`
+ *
+ * @param[in] sock      A raw IPv4/IPv6 sock object. May be `NULL`.
+ *                      A sensible local end point should be selected by the
+ *                      implementation in that case.
+ * @param[in] snips     List of buffers to send. May be `NULL` for an empty
+ *                      message.
+ * @param[in] remote    Remote end point for the sent data.
+ *                      May be `NULL`, if @p sock has a remote end point.
+ *                      sock_udp_ep_t::port may not be 0.
+ *
+ * @return  The number of bytes sent on success.
+ * @return  Any error sock_udp_send() returns.
+ */
+ssize_t sock_udp_sendv(sock_udp_t *sock, const iolist_t *snips,
+                       const sock_udp_ep_t *remote);
+
 #include "sock_types.h"
 
 #ifdef __cplusplus
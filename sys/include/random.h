@@ -22,6 +22,9 @@
  *  - Simple Park-Miller PRNG
  *  - Musl C PRNG
  *  - Fortuna (CS)PRNG
+ *
+ * On top of the global PRNG, @ref random_xoshiro_t provides a fast generator
+ * with caller provided state, which is seeded from the global PRNG.
  */
 
 #ifndef RANDOM_H
@@ -79,9 +82,23 @@ uint32_t random_uint32(void);
 
 /**
  * @brief writes random bytes in the [0,0xff]-interval to memory
+ *
+ * The aligned part of @p buf is filled with random_fill().
  */
 void random_bytes(uint8_t *buf, size_t size);
 
+/**
+ * @brief   writes @p words random numbers on [0,0xffffffff]-interval to
+ *          memory
+ *
+ * Each word is stored as returned by random_uint32(), without splitting it
+ * up into single bytes.
+ *
+ * @param[out] buf      buffer to fill
+ * @param[in]  words    number of words to write to @p buf
+ */
+void random_fill(uint32_t *buf, size_t words);
+
 /**
  * @brief   generates a random number r with a <= r < b.
  *
@@ -94,6 +111,60 @@ void random_bytes(uint8_t *buf, size_t size);
  */
 uint32_t random_uint32_range(uint32_t a, uint32_t b);
 
+/**
+ * @brief   State of a xoshiro128** generator
+ *
+ * Unlike the global PRNG, the state of this generator is owned by its user,
+ * e.g. one instance per thread. Generating numbers from it does not touch
+ * the global PRNG and needs no locking. It is fast, but not
+ * cryptographically secure.
+ *
+ * See http://xoshiro.di.unimi.it/ for details.
+ */
+typedef struct {
+    uint32_t s[4];              /**< generator state, must not be all zero */
+} random_xoshiro_t;
+
+/**
+ * @brief   Seeds a xoshiro128** generator from the global PRNG
+ *
+ * @param[out] ctx  generator to initialize
+ */
+void random_xoshiro_init(random_xoshiro_t *ctx);
+
+/**
+ * @brief   Generates a random number on [0,0xffffffff]-interval from @p ctx
+ *
+ * @param[in,out] ctx   initialized generator
+ *
+ * @return  a random number on [0,0xffffffff]-interval
+ */
+static inline uint32_t random_xoshiro_uint32(random_xoshiro_t *ctx)
+{
+    uint32_t *s = ctx->s;
+    uint32_t x = s[1] * 5;
+    uint32_t res = ((x << 7) | (x >> 25)) * 9;
+    uint32_t t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 11) | (s[3] >> 21);
+
+    return res;
+}
+
+/**
+ * @brief   Writes random bytes in the [0,0xff]-interval from @p ctx to memory
+ *
+ * @param[in,out] ctx   initialized generator
+ * @param[out] buf      buffer to fill
+ * @param[in]  size     number of bytes to write to @p buf
+ */
+void random_xoshiro_bytes(random_xoshiro_t *ctx, uint8_t *buf, size_t size);
+
 #if PRNG_FLOAT
 /* These real versions are due to Isaku Wada, 2002/01/09 added */
 
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_saul_sampler SAUL sampler
+ * @ingroup     sys
+ * @brief       Periodic batched sampling of SAUL devices
+ * @see @ref sys_saul_reg
+ *
+ * Instead of polling every sensor from its own thread with its own timer, a
+ * single sampler thread reads groups of SAUL devices on shared timer ticks.
+ * The ticks of all groups are aligned to multiples of their interval, so
+ * groups with related intervals (e.g. 100ms and 1s) are served by the same
+ * wake-up.
+ *
+ * Each group owns a ring of timestamped samples that is allocated by the
+ * user. Once a configurable number of samples is pending, the consumer thread
+ * is notified by a message of type @ref SAUL_SAMPLER_MSG_TYPE and fetches the
+ * whole batch with saul_sampler_read(). The sampler never blocks on the
+ * consumer: if the ring is full, new samples are dropped and counted.
+ *
+ * Every channel of a group can be read only on every n-th tick of the group
+ * (downsampling). Channels can also aggregate a number of readings into their
+ * minimum, maximum and/or mean value (using @ref sys_matstat), only the
+ * aggregated samples are stored in the ring.
+ *
+ * @{
+ * @file
+ * @brief       SAUL sampler interface definition
+ */
+
+#ifndef SAUL_SAMPLER_H
+#define SAUL_SAMPLER_H
+
+#include <stdint.h>
+
+#include "kernel_types.h"
+#include "matstat.h"
+#include "phydat.h"
+#include "saul_reg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Stack size of the sampler thread
+ *
+ * SAUL drivers are called from this thread, so make sure it fits the most
+ * demanding driver in use.
+ */
+#ifndef SAUL_SAMPLER_STACKSIZE
+#define SAUL_SAMPLER_STACKSIZE      (THREAD_STACKSIZE_DEFAULT)
+#endif
+
+/**
+ * @brief   Priority of the sampler thread
+ */
+#ifndef SAUL_SAMPLER_PRIO
+#define SAUL_SAMPLER_PRIO           (THREAD_PRIORITY_MAIN - 2)
+#endif
+
+/**
+ * @brief   Message type used to notify consumers about pending samples
+ *
+ * The message's `content.ptr` points to the group the samples belong to.
+ */
+#ifndef SAUL_SAMPLER_MSG_TYPE
+#define SAUL_SAMPLER_MSG_TYPE       (0x5a01)
+#endif
+
+/**
+ * @name    Aggregation flags
+ *
+ * If none of these flags is set for a channel, every reading is stored.
+ * Otherwise one sample per set flag is stored every `decimation` readings.
+ * @{
+ */
+#define SAUL_SAMPLER_AGGR_MIN       (0x01)  /**< minimum of each dimension */
+#define SAUL_SAMPLER_AGGR_MAX       (0x02)  /**< maximum of each dimension */
+#define SAUL_SAMPLER_AGGR_MEAN      (0x04)  /**< mean of each dimension */
+/** @} */
+
+/**
+ * @brief   A timestamped sample
+ */
+typedef struct {
+    uint32_t time;              /**< time of the (last) reading in us, as
+                                 *   returned by xtimer_now_usec() */
+    uint8_t chan;               /**< index of the channel within its group */
+    uint8_t aggr;               /**< aggregation flag, 0 for plain readings */
+    phydat_t data;              /**< the value */
+} saul_sampler_sample_t;
+
+/**
+ * @brief   A SAUL device read as part of a group
+ */
+typedef struct {
+    saul_reg_t *dev;            /**< device to read */
+    uint16_t divider;           /**< read on every n-th tick of the group */
+    uint16_t decimation;        /**< readings per aggregated sample */
+    uint8_t aggr;               /**< aggregation flags */
+    /* internal state */
+    uint8_t dim;                /**< dimensions of the device's data */
+    uint16_t ticks;             /**< ticks left until the next reading */
+    uint16_t reads;             /**< readings aggregated so far */
+    phydat_t last;              /**< last reading */
+    matstat_state_t stat[PHYDAT_DIM];   /**< aggregated values */
+} saul_sampler_chan_t;
+
+/**
+ * @brief   A group of devices read on the same tick
+ */
+typedef struct saul_sampler_group {
+    struct saul_sampler_group *next;    /**< next group of the sampler */
+    saul_sampler_chan_t *chans;         /**< channels of the group */
+    unsigned chans_numof;               /**< number of channels */
+    uint32_t interval;                  /**< tick interval in us */
+    uint64_t deadline;                  /**< time of the next tick */
+    saul_sampler_sample_t *ring;        /**< sample buffer */
+    unsigned ring_mask;                 /**< number of samples - 1 */
+    volatile unsigned head;             /**< written by the sampler */
+    volatile unsigned tail;             /**< written by the consumer */
+    volatile unsigned dropped;          /**< samples lost to a full ring */
+    kernel_pid_t pid;                   /**< thread to notify */
+    unsigned batch;                     /**< samples per notification */
+    volatile uint8_t notified;          /**< notification not handled yet */
+} saul_sampler_group_t;
+
+/**
+ * @brief   Start the sampler thread
+ *
+ * Called by auto_init.
+ */
+void saul_sampler_init(void);
+
+/**
+ * @brief   Initialize a channel
+ *
+ * @param[out] chan         channel to initialize
+ * @param[in] dev           device to read
+ * @param[in] divider       read the device on every @p divider-th tick
+ * @param[in] decimation    number of readings aggregated into one sample,
+ *                          ignored if @p aggr is 0
+ * @param[in] aggr          aggregation flags, 0 to store every reading
+ */
+void saul_sampler_chan_init(saul_sampler_chan_t *chan, saul_reg_t *dev,
+                            unsigned divider, unsigned decimation,
+                            uint8_t aggr);
+
+/**
+ * @brief   Initialize a group
+ *
+ * The consumer is not notified until saul_sampler_notify() is called.
+ *
+ * @param[out] group        group to initialize
+ * @param[in] chans         initialized channels, at most 256
+ * @param[in] chans_numof   number of channels
+ * @param[in] ring          buffer for the samples
+ * @param[in] ring_numof    number of samples @p ring can hold, must be a
+ *                          power of two
+ * @param[in] interval      tick interval in us
+ *
+ * @return  0 on success
+ * @return  -EINVAL on invalid parameters
+ */
+int saul_sampler_group_init(saul_sampler_group_t *group,
+                            saul_sampler_chan_t *chans, unsigned chans_numof,
+                            saul_sampler_sample_t *ring, unsigned ring_numof,
+                            uint32_t interval);
+
+/**
+ * @brief   Set the thread notified about pending samples of a group
+ *
+ * @param[in] group     group to configure
+ * @param[in] pid       thread to send the notification to
+ * @param[in] batch     number of pending samples that triggers a
+ *                      notification
+ */
+void saul_sampler_notify(saul_sampler_group_t *group, kernel_pid_t pid,
+                         unsigned batch);
+
+/**
+ * @brief   Start sampling a group
+ *
+ * The first tick of the group happens at the next multiple of its interval.
+ *
+ * @param[in] group     initialized group
+ */
+void saul_sampler_add(saul_sampler_group_t *group);
+
+/**
+ * @brief   Stop sampling a group
+ *
+ * Samples still in the ring can be read afterwards, partial aggregates are
+ * discarded.
+ *
+ * @param[in] group     group to remove
+ *
+ * @return  0 on success
+ * @return  -ENOENT if @p group is not sampled
+ */
+int saul_sampler_remove(saul_sampler_group_t *group);
+
+/**
+ * @brief   Get the number of samples pending in the ring of a group
+ *
+ * @param[in] group     group to query
+ *
+ * @return  number of samples ready to read
+ */
+static inline unsigned saul_sampler_avail(const saul_sampler_group_t *group)
+{
+    return group->head - group->tail;
+}
+
+/**
+ * @brief   Fetch samples from the ring of a group
+ *
+ * Must only be called by one thread per group. Re-arms the notification.
+ *
+ * @param[in] group     group to read from
+ * @param[out] buf      buffer for the samples
+ * @param[in] max       number of samples @p buf can hold
+ *
+ * @return  number of samples copied to @p buf
+ */
+unsigned saul_sampler_read(saul_sampler_group_t *group,
+                           saul_sampler_sample_t *buf, unsigned max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SAUL_SAMPLER_H */
+/** @} */
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_sched_round_robin Round-robin time slicing
+ * @ingroup     sys
+ * @brief       Time slicing between threads of the same priority
+ *
+ * The scheduler of RIOT always runs the first thread of the highest
+ * priority runqueue, so a thread that never blocks starves all other threads
+ * of its priority until it calls thread_yield(). With this module, a thread
+ * sharing its priority with other runnable threads is moved to the end of
+ * its runqueue after running for a quantum.
+ *
+ * The quantum is enforced by an xtimer, which is only set while the running
+ * thread has a runnable sibling, so there is no periodic tick and no
+ * overhead for priorities with a single runnable thread. A thread preempted
+ * by a higher priority continues its quantum when it runs again, a thread
+ * that blocked or yielded starts a new one.
+ *
+ * Quanta are configured per priority, and can be overridden per thread.
+ * A quantum of 0 disables time slicing.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Round-robin time slicing interface
+ */
+
+#ifndef SCHED_ROUND_ROBIN_H
+#define SCHED_ROUND_ROBIN_H
+
+#include <stdint.h>
+
+#include "kernel_types.h"
+#include "sched.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Default quantum of all priorities in microseconds
+ *
+ * Should be well above the xtimer backoff, as the quantum timer is set from
+ * within the scheduler.
+ */
+#ifndef SCHED_ROUND_ROBIN_QUANTUM
+#define SCHED_ROUND_ROBIN_QUANTUM   (10000U)
+#endif
+
+/**
+ * @brief   Set the quantum of a priority
+ *
+ * @param[in] prio      priority to configure
+ * @param[in] us        quantum in microseconds, 0 disables time slicing
+ */
+void sched_round_robin_set_quantum(uint8_t prio, uint32_t us);
+
+/**
+ * @brief   Override the quantum of the priority of a thread
+ *
+ * The override is cleared when the thread exits.
+ *
+ * @param[in] pid       thread to configure
+ * @param[in] us        quantum in microseconds, 0 to use the quantum of the
+ *                      thread's priority
+ */
+void sched_round_robin_set_thread_quantum(kernel_pid_t pid, uint32_t us);
+
+/**
+ * @brief   Get the quantum the thread @p pid runs with
+ *
+ * @param[in] pid       thread to look up
+ *
+ * @return  quantum in microseconds, 0 if time slicing is disabled
+ */
+uint32_t sched_round_robin_get_quantum(kernel_pid_t pid);
+
+/**
+ * @brief   Start or stop the quantum timer for the thread about to run
+ *
+ * @internal    Called by the scheduler with interrupts disabled, whenever
+ *              @p thread was selected to run or a thread was added to the
+ *              runqueue of @p thread.
+ *
+ * @param[in] thread    the running thread, may be NULL
+ */
+void sched_round_robin_update(thread_t *thread);
+
+/**
+ * @brief   Forget the state of an exiting thread
+ *
+ * @internal    Called by the scheduler with interrupts disabled.
+ *
+ * @param[in] pid       the exiting thread
+ */
+void sched_round_robin_exit(kernel_pid_t pid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCHED_ROUND_ROBIN_H */
+/** @} */
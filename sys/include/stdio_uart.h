@@ -52,6 +52,56 @@ extern "C" {
 #define STDIO_UART_RX_BUFSIZE   (64)
 #endif
 
+/**
+ * @name    Overflow policies of the transmit buffer
+ * @{
+ */
+#define STDIO_UART_TX_BLOCK     (0)     /**< wait until there is space */
+#define STDIO_UART_TX_DROP      (1)     /**< drop data that does not fit */
+#define STDIO_UART_TX_OVERWRITE (2)     /**< drop the oldest buffered data */
+/** @} */
+
+#ifndef STDIO_UART_TX_BUFSIZE
+/**
+ * @brief Transmit buffer size for STDIO, must be a power of two
+ *
+ * Only used with the `stdio_uart_txbuf` module.
+ */
+#define STDIO_UART_TX_BUFSIZE   (256)
+#endif
+
+#ifndef STDIO_UART_TX_POLICY
+/**
+ * @brief Behavior when the transmit buffer is full
+ *
+ * Only used with the `stdio_uart_txbuf` module. In interrupt context or with
+ * interrupts disabled, the buffer is always written out synchronously before
+ * the new data.
+ */
+#define STDIO_UART_TX_POLICY    STDIO_UART_TX_BLOCK
+#endif
+
+/**
+ * @brief Wait until all buffered output was handed to the UART
+ *
+ * With the `stdio_uart_txbuf` module, stdio_write() only copies the data into
+ * a transmit buffer that is sent in the background, driven by the UART's
+ * transmit interrupt. Without the module, this function does nothing.
+ *
+ * From interrupt context or with interrupts disabled, the buffered data is
+ * written synchronously.
+ */
+void stdio_uart_flush(void);
+
+/**
+ * @brief Write out the buffered output and switch to unbuffered output
+ *
+ * Unlike stdio_uart_flush(), this never blocks, even if the transmit lock is
+ * held by the panicking thread or interrupts are disabled. All later output
+ * is written synchronously. Called by core_panic().
+ */
+void stdio_uart_panic(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_stream_verify Streaming image verification
+ * @ingroup     sys
+ * @brief       Verify an image, e.g. a firmware update, while it arrives
+ *
+ * Instead of hashing an image after it has been downloaded completely, the
+ * data is fed into the verification state chunk by chunk as it comes in,
+ * e.g. from the handler of a CoAP block-wise transfer or a TFTP transfer.
+ * When the last chunk has been fed, only the finalization of the hash and
+ * the check of the result remain.
+ *
+ * The image can be checked against
+ *  - an expected SHA-256 digest, e.g. taken from a manifest,
+ *  - an expected HMAC-SHA256 with a pre-shared key, or
+ *  - a signature over the SHA-256 digest, checked by a callback. This way
+ *    any signature scheme working on a SHA-256 digest can be used, e.g.
+ *    ECDSA with `uECC_verify()` of the micro-ecc package.
+ *
+ * With the `mtd` module, stream_verify_mtd_write() writes the chunks to a
+ * MTD, erasing the sectors ahead of the data, and feeds the same chunks into
+ * the verification state.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Streaming image verification interface
+ */
+
+#ifndef STREAM_VERIFY_H
+#define STREAM_VERIFY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hashes/sha256.h"
+#ifdef MODULE_MTD
+#include "mtd.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Kinds of verification
+ */
+typedef enum {
+    STREAM_VERIFY_SHA256,       /**< compare with an expected SHA-256 */
+    STREAM_VERIFY_HMAC_SHA256,  /**< compare with an expected HMAC-SHA256 */
+    STREAM_VERIFY_SIGNATURE,    /**< check the SHA-256 with a callback */
+} stream_verify_type_t;
+
+/**
+ * @brief   Signature check callback
+ *
+ * @param[in] digest    SHA-256 digest of the complete image
+ * @param[in] arg       argument given to stream_verify_init_signature()
+ *
+ * @return  0 if the signature matches @p digest
+ * @return  < 0 otherwise
+ */
+typedef int (*stream_verify_cb_t)(const uint8_t *digest, void *arg);
+
+/**
+ * @brief   Verification state
+ */
+typedef struct {
+    union {
+        sha256_context_t sha256;    /**< state of SHA-256 */
+        hmac_context_t hmac;        /**< state of HMAC-SHA256 */
+    } ctx;                          /**< hash state */
+    stream_verify_type_t type;      /**< kind of verification */
+    const uint8_t *expected;        /**< expected digest or MAC */
+    stream_verify_cb_t cb;          /**< signature check callback */
+    void *arg;                      /**< argument of @p cb */
+    size_t len;                     /**< number of bytes fed so far */
+} stream_verify_t;
+
+/**
+ * @brief   Initializes @p sv to compare with a SHA-256 digest
+ *
+ * @param[out] sv       verification state
+ * @param[in]  digest   expected digest, SHA256_DIGEST_LENGTH bytes, must
+ *                      stay valid until stream_verify_finish()
+ */
+void stream_verify_init_sha256(stream_verify_t *sv, const uint8_t *digest);
+
+/**
+ * @brief   Initializes @p sv to compare with a HMAC-SHA256
+ *
+ * @param[out] sv       verification state
+ * @param[in]  key      pre-shared key
+ * @param[in]  key_len  length of @p key in bytes
+ * @param[in]  mac      expected MAC, SHA256_DIGEST_LENGTH bytes, must stay
+ *                      valid until stream_verify_finish()
+ */
+void stream_verify_init_hmac_sha256(stream_verify_t *sv, const void *key,
+                                    size_t key_len, const uint8_t *mac);
+
+/**
+ * @brief   Initializes @p sv to check a signature over the SHA-256 digest
+ *
+ * @param[out] sv       verification state
+ * @param[in]  cb       callback checking the signature
+ * @param[in]  arg      argument passed to @p cb
+ */
+void stream_verify_init_signature(stream_verify_t *sv, stream_verify_cb_t cb,
+                                  void *arg);
+
+/**
+ * @brief   Feeds the next chunk of the image into @p sv
+ *
+ * @param[in,out] sv    verification state
+ * @param[in]     data  chunk of the image
+ * @param[in]     len   length of @p data in bytes
+ */
+void stream_verify_update(stream_verify_t *sv, const void *data, size_t len);
+
+/**
+ * @brief   Finishes the verification of the image fed into @p sv
+ *
+ * The state can not be used afterwards without initializing it again.
+ *
+ * @param[in,out] sv    verification state
+ *
+ * @return  0 if the image is valid
+ * @return  -EBADMSG if the digest or MAC does not match
+ * @return  the result of the callback for STREAM_VERIFY_SIGNATURE
+ */
+int stream_verify_finish(stream_verify_t *sv);
+
+#if defined(MODULE_MTD) || defined(DOXYGEN)
+/**
+ * @brief   Writer of an image to a MTD
+ */
+typedef struct {
+    stream_verify_t *verify;        /**< verification state fed by the writer */
+    mtd_dev_t *mtd;                 /**< MTD to write to */
+    uint32_t addr;                  /**< address of the next byte */
+    uint32_t erased;                /**< end of the erased area */
+} stream_verify_mtd_t;
+
+/**
+ * @brief   Initializes @p w to write an image to @p mtd
+ *
+ * The sectors are erased right before they are written to.
+ *
+ * @param[out] w        writer
+ * @param[in]  sv       initialized verification state
+ * @param[in]  mtd      MTD to write to
+ * @param[in]  offset   address of the image on @p mtd, must be aligned to
+ *                      a sector
+ *
+ * @return  0 on success
+ * @return  -EINVAL if @p offset is not aligned to a sector
+ */
+int stream_verify_mtd_init(stream_verify_mtd_t *w, stream_verify_t *sv,
+                           mtd_dev_t *mtd, uint32_t offset);
+
+/**
+ * @brief   Writes the next chunk of the image to the MTD and verifies it
+ *
+ * @param[in,out] w     writer
+ * @param[in]     data  chunk of the image
+ * @param[in]     len   length of @p data in bytes
+ *
+ * @return  0 on success
+ * @return  < 0 on errors of the MTD
+ */
+int stream_verify_mtd_write(stream_verify_mtd_t *w, const void *data,
+                            size_t len);
+
+/**
+ * @brief   Finishes the verification of the image written by @p w
+ *
+ * @param[in,out] w     writer
+ *
+ * @return  see stream_verify_finish()
+ */
+static inline int stream_verify_mtd_finish(stream_verify_mtd_t *w)
+{
+    return stream_verify_finish(w->verify);
+}
+#endif /* MODULE_MTD */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STREAM_VERIFY_H */
+/** @} */
@@ -53,6 +53,7 @@
 #ifndef VFS_H
 #define VFS_H
 
+#include <stdbool.h>
 #include <stdint.h>
 /* The stdatomic.h in GCC gives compilation errors with C++
  * see: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=60932
@@ -142,6 +143,26 @@ extern "C" {
 #define VFS_FILE_BUFFER_SIZE (1)
 #endif
 
+#ifndef VFS_BUFFER_SIZE
+/**
+ * @brief Size of a buffer of the vfs_buffer module
+ *
+ * With the vfs_buffer module, reads and writes smaller than this are served
+ * from a buffer, so e.g. many small writes reach the file system driver as a
+ * single write.
+ */
+#define VFS_BUFFER_SIZE (64)
+#endif
+
+#ifndef VFS_BUFFER_NUMOF
+/**
+ * @brief Number of buffers shared by all open files
+ *
+ * Files opened while all buffers are in use are not buffered.
+ */
+#define VFS_BUFFER_NUMOF (2)
+#endif
+
 #ifndef VFS_NAME_MAX
 /**
  * @brief Maximum length of the name in a @c vfs_dirent_t (not including terminating null)
@@ -199,6 +220,8 @@ struct vfs_mount_struct {
     size_t mount_point_len;      /**< Length of mount_point string (set by vfs_mount) */
     atomic_int open_files;       /**< Number of currently open files */
     void *private_data;          /**< File system driver private data, implementation defined */
+    vfs_mount_t *lookup_next[2]; /**< Next mount in each of the two path lookup
+                                      lists (set by vfs_mount) */
 };
 
 /**
@@ -299,6 +322,16 @@ struct vfs_file_ops {
      */
     int (*fstat) (vfs_file_t *filp, struct stat *buf);
 
+    /**
+     * @brief Write any data cached by the file system driver to the device
+     *
+     * @param[in]  filp     pointer to open file
+     *
+     * @return 0 on success
+     * @return <0 on error
+     */
+    int (*fsync) (vfs_file_t *filp);
+
     /**
      * @brief Seek to position in file
      *
@@ -614,6 +647,19 @@ int vfs_fstat(int fd, struct stat *buf);
  */
 int vfs_fstatvfs(int fd, struct statvfs *buf);
 
+/**
+ * @brief Write all buffered data of an open file to the device
+ *
+ * Writes the data buffered by the vfs_buffer module, then lets the file system
+ * driver write its cached data.
+ *
+ * @param[in]  fd       fd number obtained from vfs_open
+ *
+ * @return 0 on success
+ * @return <0 on error
+ */
+int vfs_fsync(int fd);
+
 /**
  * @brief Seek to position in file
  *
@@ -848,6 +894,27 @@ int vfs_statvfs(const char *restrict path, struct statvfs *restrict buf);
  */
 int vfs_bind(int fd, int flags, const vfs_file_ops_t *f_op, void *private_data);
 
+/**
+ * @brief Enable or disable buffering of an open file
+ *
+ * With the vfs_buffer module, files opened by vfs_open() are buffered by
+ * default while one of the @ref VFS_BUFFER_NUMOF buffers is free. Reads fill
+ * the buffer with up to @ref VFS_BUFFER_SIZE bytes ahead, writes are collected
+ * until the buffer is full, the file is read from or seeked in, or until
+ * vfs_fsync() or vfs_close(). Errors of collected writes are therefore
+ * reported by these calls.
+ *
+ * @param[in]  fd       fd number to operate on
+ * @param[in]  enable   true to buffer the file, false to write out and
+ *                      release its buffer
+ *
+ * @return 0 on success
+ * @return -ENOBUFS if all buffers are in use
+ * @return -ENOTSUP without the vfs_buffer module
+ * @return <0 on other errors
+ */
+int vfs_setbuf(int fd, bool enable);
+
 /**
  * @brief Normalize a path
  *
@@ -875,6 +942,8 @@ int vfs_normalize_path(char *buf, const char *path, size_t buflen);
  *
  * Set @p cur to @c NULL to start from the beginning
  *
+ * The mounts are returned by decreasing length of their mount point.
+ *
  * @see @c sc_vfs.c (@c df command) for a usage example
  *
  * @param[in]  cur  current iterator value
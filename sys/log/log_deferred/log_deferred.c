@@ -0,0 +1,481 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_log_deferred
+ * @{
+ *
+ * @file
+ * @brief       Deferred binary logging implementation
+ *
+ * A record in the ring buffer looks like this:
+ *
+ *     | len (1) | level (1) | format (sizeof(char *)) | arguments ... |
+ *
+ * Arguments are stored in native byte order and size, in the order given by
+ * the format string. The width and precision given as `*` are stored as
+ * `int` before the argument they belong to, strings are stored including the
+ * terminating zero.
+ *
+ * @}
+ */
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "irq.h"
+#include "log_deferred.h"
+#include "mutex.h"
+#include "thread.h"
+
+#if (LOG_DEFERRED_BUF_SIZE & (LOG_DEFERRED_BUF_SIZE - 1)) != 0
+#error "LOG_DEFERRED_BUF_SIZE must be a power of two"
+#endif
+
+#if LOG_DEFERRED_MSG_MAX > 255
+#error "LOG_DEFERRED_MSG_MAX must not exceed 255"
+#endif
+
+#define HDR_LEN         (2U)
+#define SPEC_MAX        (24U)
+#define BUF_MASK        (LOG_DEFERRED_BUF_SIZE - 1)
+
+/* argument types as given by conversion specifier and length modifier */
+enum {
+    ARG_NONE,           /* no argument, text is printed literally */
+    ARG_PERCENT,        /* %% */
+    ARG_INT,
+    ARG_LONG,
+    ARG_LLONG,
+    ARG_INTMAX,
+    ARG_SIZE,
+    ARG_PTRDIFF,
+    ARG_DOUBLE,
+    ARG_LDOUBLE,
+    ARG_STR,
+    ARG_PTR,
+    ARG_SKIP,           /* %n, argument is consumed but not stored */
+};
+
+/* a conversion specification in a format string */
+typedef struct {
+    const char *start;  /* the '%' */
+    const char *end;    /* first character after the specification */
+    uint8_t type;       /* type of the argument */
+    uint8_t stars;      /* number of width and precision arguments */
+} _conv_t;
+
+static uint8_t _buf[LOG_DEFERRED_BUF_SIZE];
+/* free running indexes, _head is only written by producers with interrupts
+ * disabled, _tail only by the consumer holding _out_lock */
+static volatile unsigned _head;
+static volatile unsigned _tail;
+static volatile unsigned _dropped;
+static unsigned _reported;
+
+/* unlocked by producers to wake up the output thread */
+static mutex_t _signal = MUTEX_INIT_LOCKED;
+static mutex_t _out_lock = MUTEX_INIT;
+static char _stack[LOG_DEFERRED_STACKSIZE];
+
+static const char *_parse(const char *format, _conv_t *conv)
+{
+    const char *p = strchr(format, '%');
+    unsigned longs = 0;
+    char mod = '\0';
+
+    if (p == NULL) {
+        return NULL;
+    }
+    conv->start = p++;
+    conv->stars = 0;
+
+    /* flags, field width and precision */
+    while ((*p != '\0') && (strchr("-+ #0123456789.*", *p) != NULL)) {
+        if (*p++ == '*') {
+            conv->stars++;
+        }
+    }
+    /* length modifier */
+    while ((*p != '\0') && (strchr("hljztL", *p) != NULL)) {
+        if (*p == 'l') {
+            longs++;
+        }
+        mod = *p++;
+    }
+
+    switch (*p) {
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            conv->type = (longs > 1) ? ARG_LLONG :
+                         (longs == 1) ? ARG_LONG :
+                         (mod == 'j') ? ARG_INTMAX :
+                         (mod == 'z') ? ARG_SIZE :
+                         (mod == 't') ? ARG_PTRDIFF : ARG_INT;
+            break;
+        case 'c':
+            conv->type = ARG_INT;
+            break;
+        case 'a':
+        case 'A':
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+            conv->type = (mod == 'L') ? ARG_LDOUBLE : ARG_DOUBLE;
+            break;
+        case 's':
+            conv->type = ARG_STR;
+            break;
+        case 'p':
+            conv->type = ARG_PTR;
+            break;
+        case 'n':
+            conv->type = ARG_SKIP;
+            break;
+        case '%':
+            conv->type = ARG_PERCENT;
+            break;
+        default:
+            /* invalid or incomplete specification, no argument consumed */
+            conv->type = ARG_NONE;
+            conv->stars = 0;
+            conv->end = p;
+            return conv->start;
+    }
+    conv->end = p + 1;
+    return conv->start;
+}
+
+static bool _put(uint8_t *rec, size_t *len, const void *data, size_t size)
+{
+    if ((*len + size) > LOG_DEFERRED_MSG_MAX) {
+        return false;
+    }
+    memcpy(&rec[*len], data, size);
+    *len += size;
+    return true;
+}
+
+static bool _put_str(uint8_t *rec, size_t *len, const char *str)
+{
+    size_t pos = *len;
+
+    if (pos >= LOG_DEFERRED_MSG_MAX) {
+        return false;
+    }
+    if (str == NULL) {
+        str = "(null)";
+    }
+    /* truncate to the remaining space */
+    while ((*str != '\0') && (pos < (LOG_DEFERRED_MSG_MAX - 1))) {
+        rec[pos++] = *str++;
+    }
+    rec[pos++] = '\0';
+    *len = pos;
+    return true;
+}
+
+#define PUT_ARG(type)   do { \
+        type v = va_arg(args, type); \
+        ok = _put(rec, &len, &v, sizeof(v)); \
+} while (0)
+
+void log_deferred_write(unsigned level, const char *format, ...)
+{
+    uint8_t rec[LOG_DEFERRED_MSG_MAX];
+    size_t len = HDR_LEN;
+    bool ok;
+    _conv_t conv;
+    va_list args;
+
+    ok = _put(rec, &len, &format, sizeof(format));
+    va_start(args, format);
+    for (const char *p = format; ok && _parse(p, &conv); p = conv.end) {
+        for (unsigned i = 0; ok && (i < conv.stars); i++) {
+            PUT_ARG(int);
+        }
+        if (!ok) {
+            break;
+        }
+        switch (conv.type) {
+            case ARG_INT:
+                PUT_ARG(int);
+                break;
+            case ARG_LONG:
+                PUT_ARG(long);
+                break;
+            case ARG_LLONG:
+                PUT_ARG(long long);
+                break;
+            case ARG_INTMAX:
+                PUT_ARG(intmax_t);
+                break;
+            case ARG_SIZE:
+                PUT_ARG(size_t);
+                break;
+            case ARG_PTRDIFF:
+                PUT_ARG(ptrdiff_t);
+                break;
+            case ARG_DOUBLE:
+                PUT_ARG(double);
+                break;
+            case ARG_LDOUBLE:
+                PUT_ARG(long double);
+                break;
+            case ARG_STR:
+                ok = _put_str(rec, &len, va_arg(args, const char *));
+                break;
+            case ARG_PTR:
+                PUT_ARG(void *);
+                break;
+            case ARG_SKIP:
+                (void)va_arg(args, void *);
+                break;
+            default:
+                break;
+        }
+    }
+    va_end(args);
+
+    rec[0] = (uint8_t)len;
+    rec[1] = (uint8_t)level;
+
+    unsigned state = irq_disable();
+    if (ok && ((LOG_DEFERRED_BUF_SIZE - (_head - _tail)) >= len)) {
+        unsigned pos = _head & BUF_MASK;
+        size_t first = LOG_DEFERRED_BUF_SIZE - pos;
+        if (first >= len) {
+            memcpy(&_buf[pos], rec, len);
+        }
+        else {
+            memcpy(&_buf[pos], rec, first);
+            memcpy(&_buf[0], &rec[first], len - first);
+        }
+        _head += len;
+    }
+    else {
+        _dropped++;
+        ok = false;
+    }
+    irq_restore(state);
+
+    if (ok) {
+        mutex_unlock(&_signal);
+    }
+}
+
+static bool _pop(uint8_t *rec)
+{
+    unsigned tail = _tail;
+
+    if (tail == _head) {
+        return false;
+    }
+    size_t len = _buf[tail & BUF_MASK];
+    for (size_t i = 0; i < len; i++) {
+        rec[i] = _buf[(tail + i) & BUF_MASK];
+    }
+    _tail = tail + len;
+    return true;
+}
+
+static bool _get(const uint8_t *rec, size_t *pos, void *data, size_t size)
+{
+    if ((*pos + size) > rec[0]) {
+        return false;
+    }
+    memcpy(data, &rec[*pos], size);
+    *pos += size;
+    return true;
+}
+
+/* copies the conversion specification, width and precision given as `*` are
+ * replaced by the recorded values */
+static bool _spec(const _conv_t *conv, const uint8_t *rec, size_t *pos,
+                  char *spec)
+{
+    size_t n = 0;
+
+    for (const char *c = conv->start; c < conv->end; c++) {
+        if (n >= (SPEC_MAX - 12)) {
+            return false;
+        }
+        if (*c == '*') {
+            int v;
+            if (!_get(rec, pos, &v, sizeof(v))) {
+                return false;
+            }
+            n += snprintf(&spec[n], SPEC_MAX - n, "%d", v);
+        }
+        else {
+            spec[n++] = *c;
+        }
+    }
+    spec[n] = '\0';
+    return true;
+}
+
+#define PRINT_ARG(type) do { \
+        type v; \
+        ok = _get(rec, &pos, &v, sizeof(v)); \
+        if (ok) { \
+            printf(spec, v); \
+        } \
+} while (0)
+
+static void _render(const uint8_t *rec)
+{
+    size_t pos = HDR_LEN;
+    const char *format;
+    const char *p;
+    char spec[SPEC_MAX];
+    bool ok = true;
+    _conv_t conv = { .start = NULL };
+
+    _get(rec, &pos, &format, sizeof(format));
+    for (p = format; _parse(p, &conv); p = conv.end) {
+        printf("%.*s", (int)(conv.start - p), p);
+        ok = _spec(&conv, rec, &pos, spec);
+        if (!ok) {
+            break;
+        }
+        switch (conv.type) {
+            case ARG_NONE:
+                printf("%s", spec);
+                break;
+            case ARG_PERCENT:
+                putchar('%');
+                break;
+            case ARG_INT:
+                PRINT_ARG(int);
+                break;
+            case ARG_LONG:
+                PRINT_ARG(long);
+                break;
+            case ARG_LLONG:
+                PRINT_ARG(long long);
+                break;
+            case ARG_INTMAX:
+                PRINT_ARG(intmax_t);
+                break;
+            case ARG_SIZE:
+                PRINT_ARG(size_t);
+                break;
+            case ARG_PTRDIFF:
+                PRINT_ARG(ptrdiff_t);
+                break;
+            case ARG_DOUBLE:
+                PRINT_ARG(double);
+                break;
+            case ARG_LDOUBLE:
+                PRINT_ARG(long double);
+                break;
+            case ARG_STR:
+                ok = (pos < rec[0]);
+                if (ok) {
+                    printf(spec, (const char *)&rec[pos]);
+                    pos += strlen((const char *)&rec[pos]) + 1;
+                }
+                break;
+            case ARG_PTR:
+                PRINT_ARG(void *);
+                break;
+            default:
+                break;
+        }
+        if (!ok) {
+            break;
+        }
+    }
+    /* remaining text, or the unrendered part of a malformed record */
+    printf("%s", (ok) ? p : conv.start);
+}
+
+static void _dump(const uint8_t *rec)
+{
+    printf("#L");
+    for (unsigned i = 0; i < rec[0]; i++) {
+        printf("%02x", rec[i]);
+    }
+    puts("");
+}
+
+static void _output(void)
+{
+    uint8_t rec[LOG_DEFERRED_MSG_MAX];
+
+    while (_pop(rec)) {
+        if (LOG_DEFERRED_BINARY) {
+            _dump(rec);
+        }
+        else {
+            _render(rec);
+        }
+    }
+    unsigned dropped = _dropped;
+    if (dropped != _reported) {
+        printf("log_deferred: %u messages dropped\n", dropped - _reported);
+        _reported = dropped;
+    }
+}
+
+void log_deferred_flush(void)
+{
+    /* no locking in interrupt context */
+    bool locked = !irq_is_in();
+
+    if (locked) {
+        mutex_lock(&_out_lock);
+    }
+    _output();
+    if (locked) {
+        mutex_unlock(&_out_lock);
+    }
+}
+
+void log_deferred_panic(void)
+{
+    /* the lock may be held by the panicking thread itself or by one that
+     * never runs again, so it is only taken to keep others out if it is
+     * free, and never released, as that could switch threads */
+    mutex_trylock(&_out_lock);
+    _output();
+}
+
+unsigned log_deferred_dropped(void)
+{
+    return _dropped;
+}
+
+static void *_thread(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        mutex_lock(&_signal);
+        log_deferred_flush();
+    }
+    return NULL;
+}
+
+void log_deferred_init(void)
+{
+    thread_create(_stack, sizeof(_stack), LOG_DEFERRED_PRIO,
+                  THREAD_CREATE_STACKTEST, _thread, NULL, "log");
+}
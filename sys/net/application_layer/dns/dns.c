@@ -20,13 +20,14 @@
 
 #include "net/sock/udp.h"
 #include "net/sock/dns.h"
+#include "random.h"
 
 #ifdef RIOT_VERSION
 #include "byteorder.h"
 #endif
 
-/* min domain name length is 1, so minimum record length is 7 */
-#define DNS_MIN_REPLY_LEN   (unsigned)(sizeof(sock_dns_hdr_t ) + 7)
+#include "dns_internal.h"
+
 
 /* global DNS server UDP endpoint */
 sock_udp_ep_t sock_dns_server;
@@ -73,6 +74,13 @@ static unsigned _get_short(uint8_t *buf)
     return _tmp;
 }
 
+static uint32_t _get_long(uint8_t *buf)
+{
+    uint32_t _tmp;
+    memcpy(&_tmp, buf, 4);
+    return _tmp;
+}
+
 static size_t _skip_hostname(uint8_t *buf)
 {
     uint8_t *bufpos = buf;
@@ -88,11 +96,16 @@ static size_t _skip_hostname(uint8_t *buf)
     return (bufpos - buf + 1);
 }
 
-static int _parse_dns_reply(uint8_t *buf, size_t len, void* addr_out, int family)
+int sock_dns_parse_reply(uint8_t *buf, size_t len, void *addr_out,
+                         int family, uint32_t *ttl)
 {
     sock_dns_hdr_t *hdr = (sock_dns_hdr_t*) buf;
     uint8_t *bufpos = buf + sizeof(*hdr);
 
+    if (sock_dns_reply_rcode(buf) == DNS_RCODE_NXDOMAIN) {
+        return -EHOSTUNREACH;
+    }
+
     /* skip all queries that are part of the reply */
     for (unsigned n = 0; n < ntohs(hdr->qdcount); n++) {
         bufpos += _skip_hostname(bufpos);
@@ -101,11 +114,15 @@ static int _parse_dns_reply(uint8_t *buf, size_t len, void* addr_out, int family
 
     for (unsigned n = 0; n < ntohs(hdr->ancount); n++) {
         bufpos += _skip_hostname(bufpos);
+        if ((bufpos + 10) > (buf + len)) {
+            return -EBADMSG;
+        }
         uint16_t _type = ntohs(_get_short(bufpos));
         bufpos += 2;
         uint16_t class = ntohs(_get_short(bufpos));
         bufpos += 2;
-        bufpos += 4; /* skip ttl */
+        uint32_t _ttl = ntohl(_get_long(bufpos));
+        bufpos += 4;
 
         unsigned addrlen = ntohs(_get_short(bufpos));
         bufpos += 2;
@@ -123,29 +140,25 @@ static int _parse_dns_reply(uint8_t *buf, size_t len, void* addr_out, int family
             continue;
         }
 
+        /* the length decides how much is copied into addr_out */
+        if (addrlen != ((_type == DNS_TYPE_A) ? 4U : 16U)) {
+            return -EBADMSG;
+        }
+
         memcpy(addr_out, bufpos, addrlen);
+        *ttl = _ttl;
         return addrlen;
     }
 
-    return -1;
+    return -EHOSTUNREACH;
 }
 
-int sock_dns_query(const char *domain_name, void *addr_out, int family)
+size_t sock_dns_compose_query(uint8_t *buf, const char *domain_name,
+                              int family, uint16_t id)
 {
-    uint8_t buf[SOCK_DNS_QUERYBUF_LEN];
-    uint8_t reply_buf[512];
-
-    if (sock_dns_server.port == 0) {
-        return -ECONNREFUSED;
-    }
-
-    if (strlen(domain_name) > SOCK_DNS_MAX_NAME_LEN) {
-        return -ENOSPC;
-    }
-
     sock_dns_hdr_t *hdr = (sock_dns_hdr_t*) buf;
     memset(hdr, 0, sizeof(*hdr));
-    hdr->id = 0; /* random? */
+    hdr->id = id;
     hdr->flags = htons(0x0120);
     hdr->qdcount = htons(1 + (family == AF_UNSPEC));
 
@@ -170,28 +183,63 @@ int sock_dns_query(const char *domain_name, void *addr_out, int family)
         bufpos += _put_short(bufpos, htons(DNS_CLASS_IN));
     }
 
+    return bufpos - buf;
+}
+
+#ifndef MODULE_SOCK_DNS_ASYNC
+int sock_dns_query(const char *domain_name, void *addr_out, int family)
+{
+    uint8_t buf[SOCK_DNS_QUERYBUF_LEN];
+    uint8_t reply_buf[SOCK_DNS_REPLY_LEN];
+    uint32_t ttl = 0;
+
+    if (sock_dns_server.port == 0) {
+        return -ECONNREFUSED;
+    }
+
+    if (strlen(domain_name) > SOCK_DNS_MAX_NAME_LEN) {
+        return -ENOSPC;
+    }
+
+    ssize_t res = sock_dns_cache_get(domain_name, addr_out, family);
+    if (res != 0) {
+        return res;
+    }
+
+    /* a random ID makes it harder to spoof replies */
+    uint16_t id = random_uint32();
+    size_t len = sock_dns_compose_query(buf, domain_name, family, id);
+
     sock_udp_t sock_dns;
 
-    ssize_t res = sock_udp_create(&sock_dns, NULL, &sock_dns_server, 0);
+    res = sock_udp_create(&sock_dns, NULL, &sock_dns_server, 0);
     if (res) {
-            puts("a");
-        goto out;
+        return res;
     }
 
+    res = -ETIMEDOUT;
     for (int i = 0; i < SOCK_DNS_RETRIES; i++) {
-        res = sock_udp_send(&sock_dns, buf, (bufpos-buf), NULL);
-        if (res <= 0) {
+        ssize_t tmp = sock_udp_send(&sock_dns, buf, len, NULL);
+        if (tmp <= 0) {
+            res = tmp;
             continue;
         }
-        res = sock_udp_recv(&sock_dns, reply_buf, sizeof(reply_buf), 1000000LU, NULL);
-        if ((res > 0) && (res > (int)DNS_MIN_REPLY_LEN)) {
-            if ((res = _parse_dns_reply(reply_buf, res, addr_out, family)) > 0) {
-                goto out;
+        tmp = sock_udp_recv(&sock_dns, reply_buf, sizeof(reply_buf),
+                            SOCK_DNS_TIMEOUT, NULL);
+        /* replies to earlier, timed out queries are ignored */
+        if ((tmp > (int)DNS_MIN_REPLY_LEN) &&
+            (sock_dns_reply_id(reply_buf) == id)) {
+            res = sock_dns_parse_reply(reply_buf, tmp, addr_out, family, &ttl);
+            if (res != -EBADMSG) {
+                if (sock_dns_reply_cacheable(reply_buf, res)) {
+                    sock_dns_cache_add(domain_name, addr_out, res, family, ttl);
+                }
+                break;
             }
         }
     }
 
-out:
     sock_udp_close(&sock_dns);
     return res;
 }
+#endif
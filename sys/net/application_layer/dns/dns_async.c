@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup net_sock_dns
+ * @{
+ * @file
+ * @brief   sock DNS resolver thread
+ *
+ * All queries share one UDP sock. Queries are sent by the thread starting
+ * them, the resolver thread receives the replies, matches them to the
+ * outstanding queries by their (random) ID and retransmits queries that timed
+ * out.
+ * @}
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "random.h"
+#include "thread.h"
+#include "thread_flags.h"
+#include "xtimer.h"
+
+#include "dns_internal.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+/**
+ * @brief   Stack size of the resolver thread
+ */
+#ifndef SOCK_DNS_STACKSIZE
+#define SOCK_DNS_STACKSIZE      (THREAD_STACKSIZE_DEFAULT + SOCK_DNS_REPLY_LEN)
+#endif
+
+/**
+ * @brief   Priority of the resolver thread
+ */
+#ifndef SOCK_DNS_PRIO
+#define SOCK_DNS_PRIO           (THREAD_PRIORITY_MAIN - 1)
+#endif
+
+/* set when the first query is added to an empty table */
+#define FLAG_QUERY      (0x0001)
+
+typedef struct {
+    sock_dns_cb_t cb;           /* NULL if the slot is unused */
+    void *arg;
+    uint32_t deadline;          /* time of next retransmission */
+    uint16_t id;
+    uint8_t tries_left;
+    uint8_t family;
+    uint8_t len;
+    uint8_t buf[SOCK_DNS_QUERYBUF_LEN];
+    char name[SOCK_DNS_MAX_NAME_LEN + 1];
+} _query_t;
+
+typedef struct {
+    mutex_t done;
+    int res;
+    void *addr_out;
+} _sync_query_t;
+
+static _query_t _queries[SOCK_DNS_QUERIES_NUMOF];
+static unsigned _queries_numof;
+static mutex_t _lock = MUTEX_INIT;
+static sock_udp_t _sock;
+static kernel_pid_t _pid = KERNEL_PID_UNDEF;
+static char _stack[SOCK_DNS_STACKSIZE];
+
+static void _finish(_query_t *query, int res, const void *addr)
+{
+    sock_dns_cb_t cb = query->cb;
+    void *arg = query->arg;
+
+    query->cb = NULL;
+    _queries_numof--;
+    mutex_unlock(&_lock);
+    cb(res, addr, arg);
+    mutex_lock(&_lock);
+}
+
+static _query_t *_find(uint16_t id)
+{
+    for (unsigned i = 0; i < SOCK_DNS_QUERIES_NUMOF; i++) {
+        if ((_queries[i].cb != NULL) && (_queries[i].id == id)) {
+            return &_queries[i];
+        }
+    }
+    return NULL;
+}
+
+static void _handle_reply(uint8_t *buf, size_t len)
+{
+    _query_t *query = _find(sock_dns_reply_id(buf));
+    uint8_t addr[16];
+    uint32_t ttl = 0;
+
+    if (query == NULL) {
+        DEBUG("sock_dns: reply to unknown or timed out query\n");
+        return;
+    }
+
+    int res = sock_dns_parse_reply(buf, len, addr, query->family, &ttl);
+
+    if (res == -EBADMSG) {
+        /* wait for retransmission */
+        return;
+    }
+    if (sock_dns_reply_cacheable(buf, res)) {
+        sock_dns_cache_add(query->name, addr, res, query->family, ttl);
+    }
+    _finish(query, res, addr);
+}
+
+/* returns time until the next deadline, or SOCK_NO_TIMEOUT if no query is
+ * outstanding */
+static uint32_t _handle_timeouts(void)
+{
+    uint32_t now = xtimer_now_usec();
+    uint32_t timeout = SOCK_NO_TIMEOUT;
+
+    for (unsigned i = 0; i < SOCK_DNS_QUERIES_NUMOF; i++) {
+        _query_t *query = &_queries[i];
+
+        if (query->cb == NULL) {
+            continue;
+        }
+        if ((int32_t)(query->deadline - now) <= 0) {
+            if (query->tries_left == 0) {
+                _finish(query, -ETIMEDOUT, NULL);
+                continue;
+            }
+            DEBUG("sock_dns: retransmitting query %04x\n", query->id);
+            query->tries_left--;
+            query->deadline = now + SOCK_DNS_TIMEOUT;
+            sock_udp_send(&_sock, query->buf, query->len, &sock_dns_server);
+        }
+        if ((query->deadline - now) < timeout) {
+            timeout = query->deadline - now;
+        }
+    }
+    return timeout;
+}
+
+static void *_resolver(void *arg)
+{
+    static uint8_t buf[SOCK_DNS_REPLY_LEN];
+
+    (void)arg;
+    while (1) {
+        mutex_lock(&_lock);
+        uint32_t timeout = _handle_timeouts();
+        bool idle = (_queries_numof == 0);
+        mutex_unlock(&_lock);
+
+        if (idle) {
+            /* new queries always have the latest deadline, so we only need
+             * to be woken up for the first one */
+            thread_flags_wait_any(FLAG_QUERY);
+            continue;
+        }
+        if (timeout == SOCK_NO_TIMEOUT) {
+            /* query was added while a callback was running */
+            timeout = SOCK_DNS_TIMEOUT;
+        }
+
+        ssize_t res = sock_udp_recv(&_sock, buf, sizeof(buf), timeout, NULL);
+
+        if (res > (ssize_t)DNS_MIN_REPLY_LEN) {
+            mutex_lock(&_lock);
+            _handle_reply(buf, res);
+            mutex_unlock(&_lock);
+        }
+    }
+    return NULL;
+}
+
+static int _init(void)
+{
+    sock_udp_ep_t local = { .family = sock_dns_server.family };
+    int res = sock_udp_create(&_sock, &local, NULL, 0);
+
+    if (res < 0) {
+        return res;
+    }
+    _pid = thread_create(_stack, sizeof(_stack), SOCK_DNS_PRIO,
+                         THREAD_CREATE_STACKTEST, _resolver, NULL, "dns");
+    if (_pid <= KERNEL_PID_UNDEF) {
+        sock_udp_close(&_sock);
+        return -ENOMEM;
+    }
+    return 0;
+}
+
+static uint16_t _new_id(void)
+{
+    uint16_t id;
+
+    do {
+        id = random_uint32();
+    } while (_find(id) != NULL);
+    return id;
+}
+
+int sock_dns_query_async(const char *domain_name, int family,
+                         sock_dns_cb_t cb, void *arg)
+{
+    _query_t *query = NULL;
+    uint8_t addr[16];
+    int res;
+
+    if (sock_dns_server.port == 0) {
+        return -ECONNREFUSED;
+    }
+    if (strlen(domain_name) > SOCK_DNS_MAX_NAME_LEN) {
+        return -ENOSPC;
+    }
+    res = sock_dns_cache_get(domain_name, addr, family);
+    if (res != 0) {
+        cb(res, addr, arg);
+        return 0;
+    }
+
+    mutex_lock(&_lock);
+    if ((_pid == KERNEL_PID_UNDEF) && ((res = _init()) < 0)) {
+        goto out;
+    }
+    for (unsigned i = 0; i < SOCK_DNS_QUERIES_NUMOF; i++) {
+        if (_queries[i].cb == NULL) {
+            query = &_queries[i];
+            break;
+        }
+    }
+    if (query == NULL) {
+        res = -ENOBUFS;
+        goto out;
+    }
+    query->id = _new_id();
+    query->family = family;
+    query->len = sock_dns_compose_query(query->buf, domain_name, family,
+                                        query->id);
+    strcpy(query->name, domain_name);
+    res = sock_udp_send(&_sock, query->buf, query->len, &sock_dns_server);
+    if (res < 0) {
+        goto out;
+    }
+    res = 0;
+    query->cb = cb;
+    query->arg = arg;
+    query->tries_left = SOCK_DNS_RETRIES - 1;
+    query->deadline = xtimer_now_usec() + SOCK_DNS_TIMEOUT;
+    if (_queries_numof++ == 0) {
+        thread_flags_set((thread_t *)thread_get(_pid), FLAG_QUERY);
+    }
+
+out:
+    mutex_unlock(&_lock);
+    return res;
+}
+
+static void _sync_cb(int res, const void *addr, void *arg)
+{
+    _sync_query_t *sync = arg;
+
+    if (res > 0) {
+        memcpy(sync->addr_out, addr, res);
+    }
+    sync->res = res;
+    mutex_unlock(&sync->done);
+}
+
+int sock_dns_query(const char *domain_name, void *addr_out, int family)
+{
+    _sync_query_t sync = { .done = MUTEX_INIT_LOCKED, .addr_out = addr_out };
+    int res = sock_dns_query_async(domain_name, family, _sync_cb, &sync);
+
+    if (res < 0) {
+        return res;
+    }
+    mutex_lock(&sync.done);
+    return sync.res;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup net_sock_dns
+ * @{
+ * @file
+ * @brief   sock DNS client cache
+ * @}
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "xtimer.h"
+
+#include "dns_internal.h"
+
+typedef struct {
+    uint32_t expires;       /* in seconds since boot, 0 if unused */
+    uint32_t hash;          /* hash of name, to skip most strcmp()s */
+    int8_t res;             /* address length or -EHOSTUNREACH */
+    uint8_t family;
+    uint8_t addr[16];
+    char name[SOCK_DNS_MAX_NAME_LEN + 1];
+} _cache_entry_t;
+
+static _cache_entry_t _cache[SOCK_DNS_CACHE_SIZE];
+static mutex_t _lock = MUTEX_INIT;
+
+static uint32_t _now(void)
+{
+    /* + 1 so an expiry time of 0 always means "unused" */
+    return (uint32_t)(xtimer_now_usec64() / US_PER_SEC) + 1;
+}
+
+static uint32_t _hash(const char *name)
+{
+    uint32_t hash = 5381;
+
+    while (*name) {
+        hash = (hash * 33) ^ (uint8_t)*name++;
+    }
+    return hash;
+}
+
+static _cache_entry_t *_find(const char *name, uint32_t hash, int family,
+                             uint32_t now)
+{
+    for (unsigned i = 0; i < SOCK_DNS_CACHE_SIZE; i++) {
+        _cache_entry_t *entry = &_cache[i];
+
+        if ((entry->expires > now) && (entry->hash == hash) &&
+            (entry->family == family) && (strcmp(entry->name, name) == 0)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+int sock_dns_cache_get(const char *domain_name, void *addr_out, int family)
+{
+    int res = 0;
+
+    mutex_lock(&_lock);
+    _cache_entry_t *entry = _find(domain_name, _hash(domain_name), family,
+                                  _now());
+    if (entry != NULL) {
+        res = entry->res;
+        if (res > 0) {
+            memcpy(addr_out, entry->addr, res);
+        }
+    }
+    mutex_unlock(&_lock);
+    return res;
+}
+
+void sock_dns_cache_add(const char *domain_name, const void *addr, int res,
+                        int family, uint32_t ttl)
+{
+    if (res == -EHOSTUNREACH) {
+        ttl = SOCK_DNS_CACHE_NEG_TTL;
+    }
+    else if ((res <= 0) || (res > (int)sizeof(_cache[0].addr))) {
+        return;
+    }
+    if (ttl == 0) {
+        return;
+    }
+
+    uint32_t hash = _hash(domain_name);
+    uint32_t now = _now();
+
+    mutex_lock(&_lock);
+    _cache_entry_t *entry = _find(domain_name, hash, family, now);
+    if (entry == NULL) {
+        /* replace the entry that expires first, unused ones included */
+        entry = &_cache[0];
+        for (unsigned i = 1; i < SOCK_DNS_CACHE_SIZE; i++) {
+            if (_cache[i].expires < entry->expires) {
+                entry = &_cache[i];
+            }
+        }
+        entry->hash = hash;
+        entry->family = family;
+        strncpy(entry->name, domain_name, SOCK_DNS_MAX_NAME_LEN);
+        entry->name[SOCK_DNS_MAX_NAME_LEN] = '\0';
+    }
+    entry->res = res;
+    if (res > 0) {
+        memcpy(entry->addr, addr, res);
+    }
+    entry->expires = ((UINT32_MAX - now) > ttl) ? (now + ttl) : UINT32_MAX;
+    mutex_unlock(&_lock);
+}
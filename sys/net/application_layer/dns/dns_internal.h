@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_sock_dns
+ * @{
+ *
+ * @file
+ * @brief       sock DNS client internals
+ */
+
+#ifndef DNS_INTERNAL_H
+#define DNS_INTERNAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "net/sock/dns.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* min domain name length is 1, so minimum record length is 7 */
+#define DNS_MIN_REPLY_LEN   (unsigned)(sizeof(sock_dns_hdr_t ) + 7)
+
+/* response codes of a reply */
+#define DNS_RCODE_NOERROR   (0U)
+#define DNS_RCODE_NXDOMAIN  (3U)
+#define DNS_RCODE_MASK      (0x0fU)
+
+/**
+ * @brief   Write a query for @p domain_name into @p buf
+ *
+ * @param[out] buf          buffer of at least @ref SOCK_DNS_QUERYBUF_LEN bytes
+ * @param[in] domain_name   name to query
+ * @param[in] family        AF_INET, AF_INET6 or AF_UNSPEC
+ * @param[in] id            query ID
+ *
+ * @return  length of the query
+ */
+size_t sock_dns_compose_query(uint8_t *buf, const char *domain_name,
+                              int family, uint16_t id);
+
+/**
+ * @brief   Extract the first address of @p family from a reply
+ *
+ * @param[in] buf       the reply
+ * @param[in] len       length of @p buf
+ * @param[out] addr_out the address
+ * @param[in] family    AF_INET, AF_INET6 or AF_UNSPEC
+ * @param[out] ttl      time to live of the answer in seconds
+ *
+ * @return  length of the address
+ * @return  -EHOSTUNREACH if the reply contains no such address
+ * @return  -EBADMSG if the reply is malformed
+ */
+int sock_dns_parse_reply(uint8_t *buf, size_t len, void *addr_out,
+                         int family, uint32_t *ttl);
+
+/**
+ * @brief   Get the ID of a reply
+ */
+static inline uint16_t sock_dns_reply_id(const uint8_t *buf)
+{
+    return ((const sock_dns_hdr_t *)buf)->id;
+}
+
+/**
+ * @brief   Get the response code of a reply
+ */
+static inline unsigned sock_dns_reply_rcode(const uint8_t *buf)
+{
+    /* the response code is the low nibble of the second flags byte */
+    const uint8_t *flags = (const uint8_t *)&((const sock_dns_hdr_t *)buf)->flags;
+
+    return flags[1] & DNS_RCODE_MASK;
+}
+
+/**
+ * @brief   Check if the result @p res of parsing a reply may be cached
+ *
+ * Negative results are only cached if the name does not exist (NXDOMAIN) or
+ * has no record of the queried family (NOERROR without a matching answer).
+ * Server failures are not cached, the next lookup asks again.
+ */
+static inline bool sock_dns_reply_cacheable(const uint8_t *buf, int res)
+{
+    unsigned rcode = sock_dns_reply_rcode(buf);
+
+    return (res > 0) || (rcode == DNS_RCODE_NOERROR) ||
+           (rcode == DNS_RCODE_NXDOMAIN);
+}
+
+#if defined(MODULE_SOCK_DNS_CACHE) || defined(DOXYGEN)
+/**
+ * @brief   Look up an answer in the cache
+ *
+ * @return  length of the address in @p addr_out on a (positive) hit
+ * @return  -EHOSTUNREACH on a negative hit
+ * @return  0 on a miss
+ */
+int sock_dns_cache_get(const char *domain_name, void *addr_out, int family);
+
+/**
+ * @brief   Add an answer to the cache
+ *
+ * @param[in] domain_name   the queried name
+ * @param[in] addr          the address
+ * @param[in] res           length of @p addr or -EHOSTUNREACH for a
+ *                          negative answer. Other values are not cached.
+ * @param[in] family        the queried family
+ * @param[in] ttl           time to live of the answer in seconds
+ */
+void sock_dns_cache_add(const char *domain_name, const void *addr, int res,
+                        int family, uint32_t ttl);
+#else
+static inline int sock_dns_cache_get(const char *domain_name, void *addr_out,
+                                     int family)
+{
+    (void)domain_name;
+    (void)addr_out;
+    (void)family;
+    return 0;
+}
+
+static inline void sock_dns_cache_add(const char *domain_name,
+                                      const void *addr, int res, int family,
+                                      uint32_t ttl)
+{
+    (void)domain_name;
+    (void)addr;
+    (void)res;
+    (void)family;
+    (void)ttl;
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DNS_INTERNAL_H */
+/** @} */
@@ -20,9 +20,11 @@
 
 #include <string.h>
 
+#include "irq.h"
 #include "log.h"
 #include "mutex.h"
 #include "sched.h"
+#include "sema.h"
 #include "xtimer.h"
 #include "byteorder.h"
 #include "thread_flags.h"
@@ -41,7 +43,32 @@
 #define TFLAGS_RESP         (0x0001)
 #define TFLAGS_TIMEOUT      (0x0002)
 #define TFLAGS_ANY          (TFLAGS_RESP | TFLAGS_TIMEOUT)
+#define TFLAGS_FLUSH        (0x0004)
 
+#define T_RETRY_US          (EMCUTE_T_RETRY * US_PER_SEC)
+
+/**
+ * @brief   Context of a emcute_reg_multi() call
+ */
+typedef struct {
+    mutex_t done;               /**< unlocked when all topics are done */
+    unsigned pending;           /**< number of topics not acknowledged yet */
+    int res;                    /**< first error */
+} reg_waiter_t;
+
+/**
+ * @brief   QoS 1 PUBLISH or REGISTER message awaiting its acknowledgment
+ */
+typedef struct {
+    uint16_t len;               /**< length of buf, 0 if slot is unused */
+    uint16_t id;                /**< message ID */
+    uint8_t type;               /**< PUBLISH or REGISTER */
+    uint8_t retries;            /**< retransmissions left */
+    uint32_t deadline;          /**< time of the next retransmission */
+    emcute_topic_t *topic;      /**< topic to register (REGISTER only) */
+    reg_waiter_t *waiter;       /**< waiting caller (REGISTER only) */
+    uint8_t buf[EMCUTE_BUFSIZE];
+} inflight_t;
 
 static const char *cli_id;
 static sock_udp_t sock;
@@ -60,6 +87,22 @@ static volatile uint8_t waiton = 0xff;
 static volatile uint16_t waitonid = 0;
 static volatile int result;
 
+static inflight_t window[EMCUTE_WINDOW_SIZE];
+static sema_t window_free = SEMA_CREATE(EMCUTE_WINDOW_SIZE);
+static mutex_t winlock = MUTEX_INIT;
+static unsigned inflight;
+static int window_res = EMCUTE_OK;
+static thread_t *flusher;
+
+static uint16_t next_id(void)
+{
+    unsigned state = irq_disable();
+    uint16_t id = id_next++;
+
+    irq_restore(state);
+    return id;
+}
+
 static size_t set_len(uint8_t *buf, size_t len)
 {
     if (len < (0xff - 7)) {
@@ -68,7 +111,7 @@ static size_t set_len(uint8_t *buf, size_t len)
     }
     else {
         buf[0] = 0x01;
-        byteorder_htobebufs(&tbuf[1], (uint16_t)(len + 3));
+        byteorder_htobebufs(&buf[1], (uint16_t)(len + 3));
         return 3;
     }
 }
@@ -90,6 +133,104 @@ static void time_evt(void *arg)
     thread_flags_set((thread_t *)arg, TFLAGS_TIMEOUT);
 }
 
+/* reserves a window slot, returns with winlock held */
+static inflight_t *window_get(void)
+{
+    sema_wait(&window_free);
+    mutex_lock(&winlock);
+    for (unsigned i = 0; i < EMCUTE_WINDOW_SIZE; i++) {
+        if (window[i].len == 0) {
+            return &window[i];
+        }
+    }
+    /* the semaphore guarantees a free slot */
+    assert(0);
+    return NULL;
+}
+
+/* sends the message in slot and releases winlock */
+static void window_send(inflight_t *slot, size_t len)
+{
+    slot->len = len;
+    slot->retries = EMCUTE_N_RETRY;
+    slot->deadline = xtimer_now_usec() + T_RETRY_US;
+    inflight++;
+    sock_udp_send(&sock, slot->buf, len, &gateway);
+    mutex_unlock(&winlock);
+}
+
+/* must be called with winlock held */
+static void window_release(inflight_t *slot, int res)
+{
+    reg_waiter_t *waiter = slot->waiter;
+
+    if (waiter) {
+        if ((res != EMCUTE_OK) && (waiter->res == EMCUTE_OK)) {
+            waiter->res = res;
+        }
+        if (--waiter->pending == 0) {
+            mutex_unlock(&waiter->done);
+        }
+    }
+    else if ((res != EMCUTE_OK) && (window_res == EMCUTE_OK)) {
+        window_res = res;
+    }
+    slot->len = 0;
+    slot->waiter = NULL;
+    inflight--;
+    sema_post(&window_free);
+    if ((inflight == 0) && flusher) {
+        thread_flags_set(flusher, TFLAGS_FLUSH);
+    }
+}
+
+/* retransmits due messages and returns the time until the next is due */
+static uint32_t window_timeout(uint32_t now)
+{
+    uint32_t t_out = T_RETRY_US;
+
+    mutex_lock(&winlock);
+    for (unsigned i = 0; i < EMCUTE_WINDOW_SIZE; i++) {
+        inflight_t *slot = &window[i];
+
+        if (slot->len == 0) {
+            continue;
+        }
+        if ((int32_t)(slot->deadline - now) <= 0) {
+            if (slot->retries == 0) {
+                DEBUG("[emcute] window: message %u timed out\n",
+                      (unsigned)slot->id);
+                window_release(slot, EMCUTE_TIMEOUT);
+                continue;
+            }
+            slot->retries--;
+            if (slot->type == PUBLISH) {
+                /* flags follow the 1 or 3 byte length field and type */
+                slot->buf[(slot->buf[0] == 0x01) ? 4 : 2] |= EMCUTE_DUP;
+            }
+            sock_udp_send(&sock, slot->buf, slot->len, &gateway);
+            slot->deadline = now + T_RETRY_US;
+        }
+        if ((slot->deadline - now) < t_out) {
+            t_out = slot->deadline - now;
+        }
+    }
+    mutex_unlock(&winlock);
+    return t_out;
+}
+
+/* fails all messages in flight */
+static void window_clear(void)
+{
+    mutex_lock(&winlock);
+    for (unsigned i = 0; i < EMCUTE_WINDOW_SIZE; i++) {
+        if (window[i].len != 0) {
+            window_release(&window[i], EMCUTE_NOGW);
+        }
+    }
+    mutex_unlock(&winlock);
+}
+
 static int syncsend(uint8_t resp, size_t len, bool unlock)
 {
     int res = EMCUTE_TIMEOUT;
@@ -147,6 +288,33 @@ static void on_ack(uint8_t type, int id_pos, int ret_pos, int res_pos)
     }
 }
 
+static void on_window_ack(uint8_t type, size_t len)
+{
+    /* PUBACK and REGACK: len, type, topic ID, message ID, return code */
+    if (len < 7) {
+        return;
+    }
+
+    uint8_t req = (type == PUBACK) ? PUBLISH : REGISTER;
+    uint16_t id = byteorder_bebuftohs(&rbuf[4]);
+
+    mutex_lock(&winlock);
+    for (unsigned i = 0; i < EMCUTE_WINDOW_SIZE; i++) {
+        inflight_t *slot = &window[i];
+
+        if ((slot->len != 0) && (slot->type == req) && (slot->id == id)) {
+            int res = (rbuf[6] == ACCEPT) ? EMCUTE_OK : EMCUTE_REJECT;
+
+            if ((req == REGISTER) && (res == EMCUTE_OK)) {
+                slot->topic->id = byteorder_bebuftohs(&rbuf[2]);
+            }
+            window_release(slot, res);
+            break;
+        }
+    }
+    mutex_unlock(&winlock);
+}
+
 static void on_publish(size_t len, size_t pos)
 {
     /* make sure packet length is valid - if not, drop packet silently */
@@ -293,42 +461,58 @@ int emcute_discon(void)
     tbuf[0] = 2;
     tbuf[1] = DISCONNECT;
 
-    return syncsend(DISCONNECT, 2, true);
+    int res = syncsend(DISCONNECT, 2, true);
+    if (res == EMCUTE_OK) {
+        window_clear();
+    }
+    return res;
 }
 
 int emcute_reg(emcute_topic_t *topic)
 {
-    assert(topic && topic->name);
+    return emcute_reg_multi(topic, 1);
+}
+
+int emcute_reg_multi(emcute_topic_t *topics, size_t numof)
+{
+    assert(topics && (numof > 0));
 
     if (gateway.port == 0) {
         return EMCUTE_NOGW;
     }
-    if (strlen(topic->name) > EMCUTE_TOPIC_MAXLEN) {
-        return EMCUTE_OVERFLOW;
+    for (size_t i = 0; i < numof; i++) {
+        assert(topics[i].name);
+        if (strlen(topics[i].name) > EMCUTE_TOPIC_MAXLEN) {
+            return EMCUTE_OVERFLOW;
+        }
     }
 
-    mutex_lock(&txlock);
+    reg_waiter_t waiter = { .done = MUTEX_INIT_LOCKED, .pending = numof,
+                            .res = EMCUTE_OK };
 
-    tbuf[0] = (strlen(topic->name) + 6);
-    tbuf[1] = REGISTER;
-    byteorder_htobebufs(&tbuf[2], 0);
-    byteorder_htobebufs(&tbuf[4], id_next);
-    waitonid = id_next++;
-    memcpy(&tbuf[6], topic->name, strlen(topic->name));
+    for (size_t i = 0; i < numof; i++) {
+        inflight_t *slot = window_get();
+        size_t name_len = strlen(topics[i].name);
 
-    int res = syncsend(REGACK, (size_t)tbuf[0], true);
-    if (res > 0) {
-        topic->id = (uint16_t)res;
-        res = EMCUTE_OK;
+        slot->type = REGISTER;
+        slot->id = next_id();
+        slot->topic = &topics[i];
+        slot->waiter = &waiter;
+        slot->buf[0] = (name_len + 6);
+        slot->buf[1] = REGISTER;
+        byteorder_htobebufs(&slot->buf[2], 0);
+        byteorder_htobebufs(&slot->buf[4], slot->id);
+        memcpy(&slot->buf[6], topics[i].name, name_len);
+        window_send(slot, slot->buf[0]);
     }
-    return res;
+
+    mutex_lock(&waiter.done);
+    return waiter.res;
 }
 
 int emcute_pub(emcute_topic_t *topic, const void *data, size_t len,
                unsigned flags)
 {
-    int res = EMCUTE_OK;
-
     assert((topic->id != 0) && data && (len > 0) && !(flags & ~PUB_FLAGS));
 
     if (gateway.port == 0) {
@@ -341,27 +525,57 @@ int emcute_pub(emcute_topic_t *topic, const void *data, size_t len,
         return EMCUTE_NOTSUP;
     }
 
-    mutex_lock(&txlock);
+    uint8_t *buf;
+    inflight_t *slot = NULL;
 
-    size_t pos = set_len(tbuf, (len + 6));
-    len += (pos + 6);
-    tbuf[pos++] = PUBLISH;
-    tbuf[pos++] = flags;
-    byteorder_htobebufs(&tbuf[pos], topic->id);
+    if (flags & EMCUTE_QOS_1) {
+        slot = window_get();
+        buf = slot->buf;
+    }
+    else {
+        mutex_lock(&txlock);
+        buf = tbuf;
+    }
+
+    uint16_t id = next_id();
+    size_t pos = set_len(buf, (len + 6));
+    buf[pos++] = PUBLISH;
+    buf[pos++] = flags;
+    byteorder_htobebufs(&buf[pos], topic->id);
     pos += 2;
-    byteorder_htobebufs(&tbuf[pos], id_next);
-    waitonid = id_next++;
+    byteorder_htobebufs(&buf[pos], id);
     pos += 2;
-    memcpy(&tbuf[pos], data, len);
+    memcpy(&buf[pos], data, len);
+    len += pos;
 
-    if (flags & EMCUTE_QOS_1) {
-        res = syncsend(PUBACK, len, true);
+    if (slot) {
+        slot->type = PUBLISH;
+        slot->id = id;
+        slot->topic = NULL;
+        slot->waiter = NULL;
+        window_send(slot, len);
     }
     else {
         sock_udp_send(&sock, tbuf, len, &gateway);
         mutex_unlock(&txlock);
     }
 
+    return EMCUTE_OK;
+}
+
+int emcute_flush(void)
+{
+    mutex_lock(&winlock);
+    flusher = (thread_t *)sched_active_thread;
+    while (inflight > 0) {
+        mutex_unlock(&winlock);
+        thread_flags_wait_any(TFLAGS_FLUSH);
+        mutex_lock(&winlock);
+    }
+    flusher = NULL;
+    int res = window_res;
+    window_res = EMCUTE_OK;
+    mutex_unlock(&winlock);
     return res;
 }
 
@@ -381,8 +595,8 @@ int emcute_sub(emcute_sub_t *sub, unsigned flags)
     tbuf[0] = (strlen(sub->topic.name) + 5);
     tbuf[1] = SUBSCRIBE;
     tbuf[2] = flags;
-    byteorder_htobebufs(&tbuf[3], id_next);
-    waitonid = id_next++;
+    waitonid = next_id();
+    byteorder_htobebufs(&tbuf[3], waitonid);
     memcpy(&tbuf[5], sub->topic.name, strlen(sub->topic.name));
 
     int res = syncsend(SUBACK, (size_t)tbuf[0], false);
@@ -417,8 +631,8 @@ int emcute_unsub(emcute_sub_t *sub)
     tbuf[0] = (strlen(sub->topic.name) + 5);
     tbuf[1] = UNSUBSCRIBE;
     tbuf[2] = 0;
-    byteorder_htobebufs(&tbuf[3], id_next);
-    waitonid = id_next++;
+    waitonid = next_id();
+    byteorder_htobebufs(&tbuf[3], waitonid);
     memcpy(&tbuf[5], sub->topic.name, strlen(sub->topic.name));
 
     int res = syncsend(UNSUBACK, (size_t)tbuf[0], false);
@@ -536,9 +750,9 @@ void emcute_run(uint16_t port, const char *id)
                 case CONNACK:       on_ack(type, 0, 2, 0);              break;
                 case WILLTOPICREQ:  on_ack(type, 0, 0, 0);              break;
                 case WILLMSGREQ:    on_ack(type, 0, 0, 0);              break;
-                case REGACK:        on_ack(type, 4, 6, 2);              break;
+                case REGACK:        on_window_ack(type, pkt_len);       break;
                 case PUBLISH:       on_publish((size_t)pkt_len, pos);   break;
-                case PUBACK:        on_ack(type, 4, 6, 0);              break;
+                case PUBACK:        on_window_ack(type, pkt_len);       break;
                 case SUBACK:        on_ack(type, 5, 7, 3);              break;
                 case UNSUBACK:      on_ack(type, 2, 0, 0);              break;
                 case PINGREQ:       on_pingreq(&remote);                break;
@@ -561,5 +775,11 @@ void emcute_run(uint16_t port, const char *id)
         else {
             t_out = (EMCUTE_KEEPALIVE * US_PER_SEC) - (now - start);
         }
+
+        /* wake up in time for retransmissions of queued messages */
+        uint32_t t_win = window_timeout(now);
+        if (t_win < t_out) {
+            t_out = t_win;
+        }
     }
 }
@@ -30,6 +30,8 @@
 #include "random.h"
 #include "thread.h"
 
+#include "gcoap_internal.h"
+
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
@@ -38,6 +40,10 @@
 #define GCOAP_RESOURCE_WRONG_METHOD -1
 #define GCOAP_RESOURCE_NO_PATH -2
 
+#if GCOAP_BLOCK2_WINDOW > 32
+#error "GCOAP_BLOCK2_WINDOW must not exceed 32"
+#endif
+
 /* Internal functions */
 static void *_event_loop(void *arg);
 static void _listen(sock_udp_t *sock);
@@ -56,6 +62,11 @@ static int _find_obs_memo(gcoap_observe_memo_t **memo, sock_udp_ep_t *remote,
                                                        coap_pkt_t *pdu);
 static void _find_obs_memo_resource(gcoap_observe_memo_t **memo,
                                    const coap_resource_t *resource);
+static int _resp_init(coap_pkt_t *pdu, uint8_t *buf, size_t len, unsigned code,
+                      size_t opt_len);
+static bool _alloc_pdu_buf(gcoap_request_memo_t *memo, const uint8_t *buf,
+                           size_t len);
+static int _block2_request(gcoap_request_memo_t *memo);
 
 /* Internal variables */
 const coap_resource_t _default_resources[] = {
@@ -97,6 +108,18 @@ static char _msg_stack[GCOAP_STACK_SIZE];
 static msg_t _msg_queue[GCOAP_MSG_QUEUE_SIZE];
 static sock_udp_t _sock;
 
+/* Returns true if the memo keeps the full request PDU in a resend buffer. */
+static inline bool _memo_has_pdu(const gcoap_request_memo_t *memo)
+{
+    return (memo->send_limit != GCOAP_SEND_LIMIT_NON) || memo->block2.enabled;
+}
+
+/* Returns the header of the request for a memo. */
+static inline coap_hdr_t *_memo_hdr(gcoap_request_memo_t *memo)
+{
+    return (coap_hdr_t *)(_memo_has_pdu(memo) ? memo->msg.data.pdu_buf
+                                              : &memo->msg.hdr_buf[0]);
+}
 
 /* Event/Message loop for gcoap _pid thread. */
 static void *_event_loop(void *arg)
@@ -229,18 +252,36 @@ static void _listen(sock_udp_t *sock)
         if (memo) {
             switch (coap_get_type(&pdu)) {
             case COAP_TYPE_NON:
-            case COAP_TYPE_ACK:
+            case COAP_TYPE_ACK: {
+                int more = gcoap_block2_response(&memo->block2, &pdu);
+                if (more < 0) {
+                    DEBUG("gcoap: dropping duplicate block\n");
+                    break;
+                }
                 xtimer_remove(&memo->response_timer);
                 memo->state = GCOAP_MEMO_RESP;
                 if (memo->resp_handler) {
                     memo->resp_handler(memo->state, &pdu, &remote);
                 }
 
-                if (memo->send_limit >= 0) {        /* if confirmable */
+                if (more) {
+                    if (_block2_request(memo) == 0) {
+                        memo->state = GCOAP_MEMO_WAIT;
+                        break;
+                    }
+                    memo->state = GCOAP_MEMO_ERR;
+                    if (memo->resp_handler) {
+                        coap_pkt_t req;
+                        req.hdr = (coap_hdr_t *)memo->msg.data.pdu_buf;
+                        memo->resp_handler(memo->state, &req, NULL);
+                    }
+                }
+                if (_memo_has_pdu(memo)) {
                     *memo->msg.data.pdu_buf = 0;    /* clear resend PDU buffer */
                 }
                 memo->state = GCOAP_MEMO_UNUSED;
                 break;
+            }
             case COAP_TYPE_CON:
                 DEBUG("gcoap: separate CON response not handled yet\n");
                 break;
@@ -468,12 +509,7 @@ static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *src_pdu,
             continue;
 
         gcoap_request_memo_t *memo = &_coap_state.open_reqs[i];
-        if (memo->send_limit == GCOAP_SEND_LIMIT_NON) {
-            memo_pdu->hdr = (coap_hdr_t *) &memo->msg.hdr_buf[0];
-        }
-        else {
-            memo_pdu->hdr = (coap_hdr_t *) memo->msg.data.pdu_buf;
-        }
+        memo_pdu->hdr = _memo_hdr(memo);
 
         if (coap_get_token_len(memo_pdu) == cmplen) {
             memo_pdu->token = &memo_pdu->hdr->data[0];
@@ -495,15 +531,10 @@ static void _expire_request(gcoap_request_memo_t *memo)
         /* Pass response to handler */
         if (memo->resp_handler) {
             coap_pkt_t req;
-            if (memo->send_limit == GCOAP_SEND_LIMIT_NON) {
-                req.hdr = (coap_hdr_t *)&memo->msg.hdr_buf[0];   /* for reference */
-            }
-            else {
-                req.hdr = (coap_hdr_t *)memo->msg.data.pdu_buf;
-            }
+            req.hdr = _memo_hdr(memo);      /* for reference */
             memo->resp_handler(memo->state, &req, NULL);
         }
-        if (memo->send_limit != GCOAP_SEND_LIMIT_NON) {
+        if (_memo_has_pdu(memo)) {
             *memo->msg.data.pdu_buf = 0;    /* clear resend buffer */
         }
         memo->state = GCOAP_MEMO_UNUSED;
@@ -579,10 +610,30 @@ static ssize_t _write_options(coap_pkt_t *pdu, uint8_t *buf, size_t len)
 
     /* Uri-query for requests */
     if (coap_get_code_class(pdu) == COAP_CLASS_REQ) {
-        bufpos += coap_opt_put_uri_query(bufpos, last_optnum,
-                                         (char *)pdu->qs);
+        size_t opt_len = coap_opt_put_uri_query(bufpos, last_optnum,
+                                                (char *)pdu->qs);
+        if (opt_len) {
+            bufpos += opt_len;
+            last_optnum = COAP_OPT_URI_QUERY;
+        }
+    }
+
+    /* Block-wise transfer */
+    if (pdu->block2 != UINT32_MAX) {
+        bufpos += coap_opt_put_uint(bufpos, last_optnum, COAP_OPT_BLOCK2,
+                                    pdu->block2);
+        last_optnum = COAP_OPT_BLOCK2;
+    }
+    if (pdu->block1 != UINT32_MAX) {
+        bufpos += coap_opt_put_uint(bufpos, last_optnum, COAP_OPT_BLOCK1,
+                                    pdu->block1);
+        last_optnum = COAP_OPT_BLOCK1;
+    }
+    if (pdu->size2 != UINT32_MAX) {
+        bufpos += coap_opt_put_uint(bufpos, last_optnum, COAP_OPT_SIZE2,
+                                    pdu->size2);
         /* uncomment when further options are added below ... */
-        /* last_optnum = COAP_OPT_URI_QUERY; */
+        /* last_optnum = COAP_OPT_SIZE2; */
     }
 
     /* write payload marker */
@@ -682,6 +733,202 @@ static void _find_obs_memo_resource(gcoap_observe_memo_t **memo,
     }
 }
 
+/*
+ * Initializes a response on the buffer of the request, reserving opt_len
+ * bytes for options.
+ */
+static int _resp_init(coap_pkt_t *pdu, uint8_t *buf, size_t len, unsigned code,
+                      size_t opt_len)
+{
+    if (coap_get_type(pdu) == COAP_TYPE_CON) {
+        coap_hdr_set_type(pdu->hdr, COAP_TYPE_ACK);
+    }
+    coap_hdr_set_code(pdu->hdr, code);
+
+    /* Reserve some space between the header and payload to write options later */
+    pdu->payload      = buf + coap_get_total_hdr_len(pdu) + opt_len;
+    /* Payload length really zero at this point, but we set this to the available
+     * length in the buffer. Allows us to reconstruct buffer length later. */
+    pdu->payload_len  = len - (pdu->payload - buf);
+    pdu->content_type = COAP_FORMAT_NONE;
+    pdu->block1       = UINT32_MAX;
+    pdu->block2       = UINT32_MAX;
+    pdu->size2        = UINT32_MAX;
+
+    return 0;
+}
+
+/*
+ * Copies a request PDU to a free resend buffer for the memo.
+ *
+ * return true on success, false if no buffer is free
+ */
+static bool _alloc_pdu_buf(gcoap_request_memo_t *memo, const uint8_t *buf,
+                           size_t len)
+{
+    if (len > GCOAP_PDU_BUF_SIZE) {
+        return false;
+    }
+    for (int i = 0; i < GCOAP_RESEND_BUFS_MAX; i++) {
+        if (!_coap_state.resend_bufs[i][0]) {
+            memo->msg.data.pdu_buf = &_coap_state.resend_bufs[i][0];
+            memcpy(memo->msg.data.pdu_buf, buf, len);
+            memo->msg.data.pdu_len = len;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Requests the following blocks of a transfer, and restarts the response
+ * timer. For a non-confirmable request of known size, keeps up to
+ * GCOAP_BLOCK2_WINDOW requests in flight, otherwise one.
+ *
+ * return 0 on success, or < 0 if no request is in flight
+ */
+static int _block2_request(gcoap_request_memo_t *memo)
+{
+    gcoap_block2_memo_t *block2 = &memo->block2;
+    uint8_t *buf      = memo->msg.data.pdu_buf;
+    bool non          = (memo->send_limit == GCOAP_SEND_LIMIT_NON);
+    uint32_t window   = (non && (block2->last != UINT32_MAX))
+                            ? GCOAP_BLOCK2_WINDOW : 1;
+    uint32_t timeout  = GCOAP_NON_TIMEOUT;
+
+    /* a Block2 option takes at most five bytes: the header, an extended
+     * delta if the option before it is numbered below 10, and a value of
+     * three bytes from block 4096 on */
+    if (block2->opt_offset + 5 > GCOAP_PDU_BUF_SIZE) {
+        return -ENOSPC;
+    }
+
+    while ((block2->next < block2->base + window)
+            && (block2->next <= block2->last)) {
+        memo->msg.data.pdu_len = gcoap_block2_put_next(block2, buf);
+
+        uint16_t msgid = (uint16_t)atomic_fetch_add(&_coap_state.next_message_id, 1);
+        ((coap_hdr_t *)buf)->id = htons(msgid);
+
+        ssize_t bytes = sock_udp_send(&_sock, buf, memo->msg.data.pdu_len,
+                                      &memo->remote_ep);
+        if (bytes <= 0) {
+            DEBUG("gcoap: sock send block %" PRIu32 " failed: %d\n",
+                  block2->next, (int)bytes);
+            /* fine as long as the block at base still is in flight */
+            if (block2->next == block2->base) {
+                return -EIO;
+            }
+            break;
+        }
+        block2->next++;
+    }
+
+    if (!non) {
+        memo->send_limit  = COAP_MAX_RETRANSMIT;
+        timeout           = (uint32_t)COAP_ACK_TIMEOUT * US_PER_SEC;
+        uint32_t variance = (uint32_t)COAP_ACK_VARIANCE * US_PER_SEC;
+        timeout = random_uint32_range(timeout, timeout + variance);
+    }
+    xtimer_set_msg(&memo->response_timer, timeout, &memo->timeout_msg, _pid);
+    return 0;
+}
+
+/*
+ * Serves a GET request for a block-wise resource.
+ */
+static ssize_t _block2_read(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                            const gcoap_block_resource_t *resource)
+{
+    coap_block1_t block;
+    unsigned szx = GCOAP_BLOCK_SZX;
+    size_t size  = SIZE_MAX;
+
+    if (coap_get_block2(pdu, &block)) {
+        if (block.szx == COAP_BLOCKWISE_SZX_MAX) {
+            return gcoap_response(pdu, buf, len, COAP_CODE_BAD_REQUEST);
+        }
+        if (block.szx < szx) {
+            szx = block.szx;
+        }
+    }
+    if (resource->size) {
+        size = resource->size(resource->arg);
+    }
+    if (block.offset && (block.offset >= size)) {
+        return gcoap_response(pdu, buf, len, COAP_CODE_BAD_OPTION);
+    }
+
+    _resp_init(pdu, buf, len, COAP_CODE_CONTENT,
+               GCOAP_RESP_OPTIONS_BUF + GCOAP_BLOCK_OPTIONS_BUF);
+    if ((size_t)(pdu->payload - buf) >= len) {
+        return -ENOBUFS;
+    }
+    /* offset still is aligned to a smaller block size */
+    while (szx && (coap_szx2size(szx) > pdu->payload_len)) {
+        szx--;
+    }
+    if (coap_szx2size(szx) > pdu->payload_len) {
+        return -ENOBUFS;
+    }
+
+    size_t blksize = coap_szx2size(szx);
+    ssize_t n = resource->read(resource->arg, block.offset, pdu->payload,
+                               blksize);
+    if (n < 0) {
+        return n;
+    }
+
+    bool more;
+    if (resource->size) {
+        more = (block.offset + n < size);
+    }
+    else {
+        uint8_t probe;
+        more = ((size_t)n == blksize)
+               && (resource->read(resource->arg, block.offset + n, &probe, 1) > 0);
+    }
+
+    /* a small resource needs no Block2 option, unless the client asked */
+    if (more || block.offset || (block.more >= 0)) {
+        gcoap_add_block2(pdu, block.offset >> (szx + 4), szx, more);
+        if (resource->size && (block.offset == 0)) {
+            pdu->size2 = size;
+        }
+    }
+    return gcoap_finish(pdu, n, resource->format);
+}
+
+/*
+ * Serves a PUT or POST request for a block-wise resource.
+ */
+static ssize_t _block1_write(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             const gcoap_block_resource_t *resource)
+{
+    coap_block1_t block;
+
+    if (coap_get_block1(pdu, &block)
+            && ((block.szx == COAP_BLOCKWISE_SZX_MAX)
+                || ((block.more == 1)
+                    && (pdu->payload_len != coap_szx2size(block.szx))))) {
+        return gcoap_response(pdu, buf, len, COAP_CODE_BAD_REQUEST);
+    }
+
+    /* consume the payload before the response overwrites it */
+    ssize_t res = resource->write(resource->arg, block.offset, pdu->payload,
+                                  pdu->payload_len, (block.more == 1));
+    if (res < 0) {
+        return res;
+    }
+
+    gcoap_resp_init(pdu, buf, len,
+                    (block.more == 1) ? COAP_CODE_CONTINUE : COAP_CODE_CHANGED);
+    if (block.more >= 0) {
+        gcoap_add_block1(pdu, block.blknum, block.szx, (block.more == 1));
+    }
+    return gcoap_finish(pdu, 0, COAP_FORMAT_NONE);
+}
+
 /*
  * gcoap interface functions
  */
@@ -755,6 +1002,9 @@ int gcoap_req_init(coap_pkt_t *pdu, uint8_t *buf, size_t len,
          * length in the buffer. Allows us to reconstruct buffer length later. */
         pdu->payload_len  = len - (pdu->payload - buf);
         pdu->content_type = COAP_FORMAT_NONE;
+        pdu->block1       = UINT32_MAX;
+        pdu->block2       = UINT32_MAX;
+        pdu->size2        = UINT32_MAX;
 
         memcpy(&pdu->url[0], path, strlen(path));
         return 0;
@@ -818,21 +1068,15 @@ size_t gcoap_req_send2(const uint8_t *buf, size_t len,
         }
 
         memo->resp_handler = resp_handler;
+        memo->block2.enabled = false;
         memcpy(&memo->remote_ep, remote, sizeof(sock_udp_ep_t));
 
         switch (msg_type) {
         case COAP_TYPE_CON:
             /* copy buf to resend_bufs record */
-            memo->msg.data.pdu_buf = NULL;
-            for (int i = 0; i < GCOAP_RESEND_BUFS_MAX; i++) {
-                if (!_coap_state.resend_bufs[i][0]) {
-                    memo->msg.data.pdu_buf = &_coap_state.resend_bufs[i][0];
-                    memcpy(memo->msg.data.pdu_buf, buf, GCOAP_PDU_BUF_SIZE);
-                    memo->msg.data.pdu_len = len;
-                    break;
-                }
-            }
-            if (memo->msg.data.pdu_buf) {
+            if (_alloc_pdu_buf(memo, buf, len)) {
+                memo->block2.enabled = (resp_handler != NULL)
+                    && gcoap_block2_init(&memo->block2, buf, len, false);
                 memo->send_limit  = COAP_MAX_RETRANSMIT;
                 timeout           = (uint32_t)COAP_ACK_TIMEOUT * US_PER_SEC;
                 uint32_t variance = (uint32_t)COAP_ACK_VARIANCE * US_PER_SEC;
@@ -846,7 +1090,15 @@ size_t gcoap_req_send2(const uint8_t *buf, size_t len,
 
         case COAP_TYPE_NON:
             memo->send_limit = GCOAP_SEND_LIMIT_NON;
-            memcpy(&memo->msg.hdr_buf[0], buf, GCOAP_HEADER_MAXLEN);
+            /* keep the whole PDU only to continue a block-wise request */
+            if ((resp_handler != NULL)
+                    && gcoap_block2_init(&memo->block2, buf, len, true)
+                    && _alloc_pdu_buf(memo, buf, len)) {
+                memo->block2.enabled = true;
+            }
+            else {
+                memcpy(&memo->msg.hdr_buf[0], buf, GCOAP_HEADER_MAXLEN);
+            }
             timeout = GCOAP_NON_TIMEOUT;
             break;
         default:
@@ -889,7 +1141,7 @@ size_t gcoap_req_send2(const uint8_t *buf, size_t len,
     }
     if (res <= 0) {
         if (memo != NULL) {
-            if (msg_type == COAP_TYPE_CON) {
+            if (_memo_has_pdu(memo)) {
                 *memo->msg.data.pdu_buf = 0;    /* clear resend buffer */
             }
             memo->state = GCOAP_MEMO_UNUSED;
@@ -901,19 +1153,7 @@ size_t gcoap_req_send2(const uint8_t *buf, size_t len,
 
 int gcoap_resp_init(coap_pkt_t *pdu, uint8_t *buf, size_t len, unsigned code)
 {
-    if (coap_get_type(pdu) == COAP_TYPE_CON) {
-        coap_hdr_set_type(pdu->hdr, COAP_TYPE_ACK);
-    }
-    coap_hdr_set_code(pdu->hdr, code);
-
-    /* Reserve some space between the header and payload to write options later */
-    pdu->payload      = buf + coap_get_total_hdr_len(pdu) + GCOAP_RESP_OPTIONS_BUF;
-    /* Payload length really zero at this point, but we set this to the available
-     * length in the buffer. Allows us to reconstruct buffer length later. */
-    pdu->payload_len  = len - (pdu->payload - buf);
-    pdu->content_type = COAP_FORMAT_NONE;
-
-    return 0;
+    return _resp_init(pdu, buf, len, code, GCOAP_RESP_OPTIONS_BUF);
 }
 
 int gcoap_obs_init(coap_pkt_t *pdu, uint8_t *buf, size_t len,
@@ -942,6 +1182,9 @@ int gcoap_obs_init(coap_pkt_t *pdu, uint8_t *buf, size_t len,
          * length in the buffer. Allows us to reconstruct buffer length later. */
         pdu->payload_len   = len - (pdu->payload - buf);
         pdu->content_type  = COAP_FORMAT_NONE;
+        pdu->block1        = UINT32_MAX;
+        pdu->block2        = UINT32_MAX;
+        pdu->size2         = UINT32_MAX;
 
         return GCOAP_OBS_INIT_OK;
     }
@@ -1021,6 +1264,27 @@ int gcoap_get_resource_list(void *buf, size_t maxlen, uint8_t cf)
     return (int)pos;
 }
 
+ssize_t gcoap_block_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                            void *ctx)
+{
+    const gcoap_block_resource_t *resource = ctx;
+
+    switch (coap_get_code_detail(pdu)) {
+        case COAP_METHOD_GET:
+            if (resource->read) {
+                return _block2_read(pdu, buf, len, resource);
+            }
+            break;
+        case COAP_METHOD_PUT:
+        case COAP_METHOD_POST:
+            if (resource->write) {
+                return _block1_write(pdu, buf, len, resource);
+            }
+            break;
+    }
+    return gcoap_response(pdu, buf, len, COAP_CODE_METHOD_NOT_ALLOWED);
+}
+
 int gcoap_add_qstring(coap_pkt_t *pdu, const char *key, const char *val)
 {
     size_t qs_len = strlen((char *)pdu->qs);
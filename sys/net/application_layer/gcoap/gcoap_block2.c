@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gcoap
+ * @{
+ *
+ * @file
+ * @brief       State of block-wise client transfers
+ *
+ * Kept apart from the messaging in gcoap.c, so it can be tested without a
+ * network.
+ *
+ * @}
+ */
+
+#include "gcoap_internal.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+bool gcoap_block2_init(gcoap_block2_memo_t *block2, const uint8_t *buf,
+                       size_t len, bool need_opt)
+{
+    coap_pkt_t pdu;
+    coap_block1_t block;
+
+    block2->enabled = false;
+    if ((len < 2) || (buf[1] != COAP_METHOD_GET)
+            || (coap_parse(&pdu, (uint8_t *)buf, len) < 0)
+            || pdu.payload_len) {
+        return false;
+    }
+
+    unsigned count  = pdu.options_len;
+    unsigned lastnr = (count) ? pdu.options[count - 1].opt_num : 0;
+    if (coap_get_block2(&pdu, &block)) {
+        if (lastnr != COAP_OPT_BLOCK2) {
+            return false;
+        }
+        /* the Block2 option is rewritten for each block */
+        block2->opt_offset = pdu.options[count - 1].offset;
+        block2->lastonum   = (count > 1) ? pdu.options[count - 2].opt_num : 0;
+        block2->szx        = block.szx;
+    }
+    else {
+        if (need_opt || (lastnr > COAP_OPT_BLOCK2)) {
+            return false;
+        }
+        /* the Block2 option is appended for the following blocks */
+        block2->opt_offset = len;
+        block2->lastonum   = lastnr;
+        block2->szx        = GCOAP_BLOCK_SZX;
+    }
+    block2->base     = block.blknum;
+    block2->next     = block.blknum + 1;
+    block2->last     = UINT32_MAX;
+    block2->received = 0;
+    return true;
+}
+
+int gcoap_block2_response(gcoap_block2_memo_t *block2, coap_pkt_t *pdu)
+{
+    coap_block1_t block;
+    uint32_t size2;
+
+    if (!block2->enabled || (coap_get_code_class(pdu) != COAP_CLASS_SUCCESS)
+            || !coap_get_block2(pdu, &block)) {
+        return 0;
+    }
+
+    if (block.szx != block2->szx) {
+        /* the server chose the block size; numbers follow from this block */
+        if (block2->received || (block2->next != block2->base + 1)) {
+            DEBUG("gcoap: block size changed during transfer\n");
+            return 0;
+        }
+        block2->szx  = block.szx;
+        block2->base = block.blknum;
+        block2->next = block.blknum + 1;
+        block2->last = UINT32_MAX;
+    }
+
+    uint32_t bit = block.blknum - block2->base;
+    if ((block.blknum < block2->base) || (bit >= 32)
+            || (block2->received & (1UL << bit))) {
+        return -1;
+    }
+
+    if (!block.more) {
+        block2->last = block.blknum;
+    }
+    else if ((block2->last == UINT32_MAX)
+            && (coap_get_option_uint(pdu, COAP_OPT_SIZE2, &size2) == 0)) {
+        block2->last = (size2) ? ((size2 - 1) >> (block2->szx + 4)) : 0;
+    }
+
+    block2->received |= (1UL << bit);
+    while (block2->received & 1) {
+        block2->received >>= 1;
+        block2->base++;
+    }
+    return (block2->base <= block2->last) ? 1 : 0;
+}
+
+size_t gcoap_block2_put_next(const gcoap_block2_memo_t *block2, uint8_t *buf)
+{
+    return block2->opt_offset
+           + coap_put_option_block2(buf + block2->opt_offset, block2->lastonum,
+                                    block2->next, block2->szx, 0);
+}
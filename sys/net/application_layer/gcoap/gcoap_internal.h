@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gcoap
+ * @{
+ *
+ * @file
+ * @brief       gcoap internals for block-wise client transfers
+ */
+
+#ifndef GCOAP_INTERNAL_H
+#define GCOAP_INTERNAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "net/gcoap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Check if a request may be continued block-wise and initialize the
+ *          Block2 state for it
+ *
+ * Applies to a GET without payload, which has no options following Block2.
+ *
+ * @param[out] block2   state of the transfer; not enabled yet
+ * @param[in] buf       the request PDU
+ * @param[in] len       length of @p buf
+ * @param[in] need_opt  the request must include a Block2 option
+ *
+ * @return  true if the request may be continued
+ */
+bool gcoap_block2_init(gcoap_block2_memo_t *block2, const uint8_t *buf,
+                       size_t len, bool need_opt);
+
+/**
+ * @brief   Track a response for a request, which may be continued block-wise
+ *
+ * @param[in,out] block2    state of the transfer
+ * @param[in] pdu           the response
+ *
+ * @return  1 if blocks are missing
+ * @return  0 if the transfer is complete or the response is not part of a
+ *          block-wise transfer
+ * @return  -1 to drop a duplicate block
+ */
+int gcoap_block2_response(gcoap_block2_memo_t *block2, coap_pkt_t *pdu);
+
+/**
+ * @brief   Rewrite the request in @p buf to ask for block
+ *          gcoap_block2_memo_t::next
+ *
+ * @param[in] block2    state of the transfer
+ * @param[in,out] buf   the request PDU, at least
+ *                      gcoap_block2_memo_t::opt_offset + 5 bytes long
+ *
+ * @return  new length of the request
+ */
+size_t gcoap_block2_put_next(const gcoap_block2_memo_t *block2, uint8_t *buf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GCOAP_INTERNAL_H */
+/** @} */
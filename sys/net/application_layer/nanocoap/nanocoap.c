@@ -31,7 +31,6 @@
 #include "debug.h"
 
 static int _decode_value(unsigned val, uint8_t **pkt_pos_ptr, uint8_t *pkt_end);
-int coap_get_option_uint(coap_pkt_t *pkt, unsigned opt_num, uint32_t *target);
 static uint32_t _decode_uint(uint8_t *pkt_pos, unsigned nbytes);
 static size_t _encode_uint(uint32_t *val);
 
@@ -125,6 +124,10 @@ int coap_parse(coap_pkt_t *pkt, uint8_t *buf, size_t len)
     if (coap_get_option_uint(pkt, COAP_OPT_OBSERVE, &pkt->observe_value) != 0) {
         pkt->observe_value = UINT32_MAX;
     }
+    /* block options are only written, use coap_get_block*() to read them */
+    pkt->block1 = UINT32_MAX;
+    pkt->block2 = UINT32_MAX;
+    pkt->size2 = UINT32_MAX;
 #endif
 
     DEBUG("coap pkt parsed. code=%u detail=%u payload_len=%u, nopts=%u, 0x%02x\n",
@@ -537,11 +540,17 @@ size_t coap_put_option_ct(uint8_t *buf, uint16_t lastonum, uint16_t content_type
     }
 }
 
+size_t coap_opt_put_uint(uint8_t *buf, uint16_t lastonum, uint16_t onum,
+                         uint32_t value)
+{
+    size_t olen = _encode_uint(&value);
+    return coap_put_option(buf, lastonum, onum, (uint8_t *)&value, olen);
+}
+
 static size_t coap_put_option_block(uint8_t *buf, uint16_t lastonum, unsigned blknum, unsigned szx, int more, uint16_t option)
 {
     uint32_t blkopt = (blknum << 4) | szx | (more ? 0x8 : 0);
-    size_t olen = _encode_uint(&blkopt);
-    return coap_put_option(buf, lastonum, option, (uint8_t*)&blkopt, olen);
+    return coap_opt_put_uint(buf, lastonum, option, blkopt);
 }
 
 size_t coap_put_option_block1(uint8_t *buf, uint16_t lastonum, unsigned blknum, unsigned szx, int more)
@@ -549,22 +558,37 @@ size_t coap_put_option_block1(uint8_t *buf, uint16_t lastonum, unsigned blknum,
     return coap_put_option_block(buf, lastonum, blknum, szx, more, COAP_OPT_BLOCK1);
 }
 
-int coap_get_block1(coap_pkt_t *pkt, coap_block1_t *block1)
+size_t coap_put_option_block2(uint8_t *buf, uint16_t lastonum, unsigned blknum, unsigned szx, int more)
+{
+    return coap_put_option_block(buf, lastonum, blknum, szx, more, COAP_OPT_BLOCK2);
+}
+
+static int _get_block(coap_pkt_t *pkt, coap_block1_t *block, uint16_t option)
 {
     uint32_t blknum;
     unsigned szx;
-    block1->more = coap_get_blockopt(pkt, COAP_OPT_BLOCK1, &blknum, &szx);
-    if (block1->more >= 0) {
-        block1->offset = blknum << (szx + 4);
+    block->more = coap_get_blockopt(pkt, option, &blknum, &szx);
+    if (block->more >= 0) {
+        block->offset = blknum << (szx + 4);
     }
     else {
-        block1->offset = 0;
+        block->offset = 0;
     }
 
-    block1->blknum = blknum;
-    block1->szx = szx;
+    block->blknum = blknum;
+    block->szx = szx;
 
-    return (block1->more >= 0);
+    return (block->more >= 0);
+}
+
+int coap_get_block1(coap_pkt_t *pkt, coap_block1_t *block1)
+{
+    return _get_block(pkt, block1, COAP_OPT_BLOCK1);
+}
+
+int coap_get_block2(coap_pkt_t *pkt, coap_block1_t *block2)
+{
+    return _get_block(pkt, block2, COAP_OPT_BLOCK2);
 }
 
 size_t coap_put_block1_ok(uint8_t *pkt_pos, coap_block1_t *block1, uint16_t lastonum)
@@ -42,6 +42,27 @@ static _nib_dr_entry_t _def_routers[GNRC_IPV6_NIB_DEFAULT_ROUTER_NUMOF];
 static _nib_abr_entry_t _abrs[GNRC_IPV6_NIB_ABR_NUMOF];
 #endif  /* GNRC_IPV6_NIB_CONF_MULTIHOP_P6C */
 
+#if GNRC_IPV6_NIB_OFFL_HASH_NUMOF
+#if (GNRC_IPV6_NIB_OFFL_HASH_NUMOF & (GNRC_IPV6_NIB_OFFL_HASH_NUMOF - 1)) != 0
+#error "GNRC_IPV6_NIB_OFFL_HASH_NUMOF must be a power of two"
+#endif
+#if GNRC_IPV6_NIB_OFFL_NUMOF >= 65535
+#error "GNRC_IPV6_NIB_OFFL_NUMOF too large for the hash index"
+#endif
+
+/* index of the last chain, holding all entries with a prefix length < 128 */
+#define _OFFL_PFX_CHAIN     (GNRC_IPV6_NIB_OFFL_HASH_NUMOF)
+
+/* Allocated off-link entries are linked into chains by their index + 1, with
+ * 0 terminating a chain: one chain per hash bucket for host routes and one
+ * for all other prefixes. Freed entries are linked into _offl_free, entries
+ * from _offl_unused on were never allocated. */
+static uint16_t _offl_chains[GNRC_IPV6_NIB_OFFL_HASH_NUMOF + 1];
+static uint16_t _offl_next[GNRC_IPV6_NIB_OFFL_NUMOF];
+static uint16_t _offl_free;
+static uint16_t _offl_unused;
+#endif  /* GNRC_IPV6_NIB_OFFL_HASH_NUMOF */
+
 static char addr_str[IPV6_ADDR_MAX_STR_LEN];
 
 mutex_t _nib_mutex = MUTEX_INIT;
@@ -59,6 +80,11 @@ void _nib_init(void)
     memset(_nodes, 0, sizeof(_nodes));
     memset(_def_routers, 0, sizeof(_def_routers));
     memset(_dsts, 0, sizeof(_dsts));
+#if GNRC_IPV6_NIB_OFFL_HASH_NUMOF
+    memset(_offl_chains, 0, sizeof(_offl_chains));
+    _offl_free = 0;
+    _offl_unused = 0;
+#endif  /* GNRC_IPV6_NIB_OFFL_HASH_NUMOF */
 #if GNRC_IPV6_NIB_CONF_MULTIHOP_P6C
     memset(_abrs, 0, sizeof(_abrs));
 #endif  /* GNRC_IPV6_NIB_CONF_MULTIHOP_P6C */
@@ -437,6 +463,118 @@ void _nib_drl_ft_get(const _nib_dr_entry_t *drl, gnrc_ipv6_nib_ft_t *fte)
     fte->iface = _nib_onl_get_if(drl->next_hop);
 }
 
+#if GNRC_IPV6_NIB_OFFL_HASH_NUMOF
+static inline unsigned _offl_chain(const ipv6_addr_t *pfx, unsigned pfx_len)
+{
+    if (pfx_len < IPV6_ADDR_BIT_LEN) {
+        return _OFFL_PFX_CHAIN;
+    }
+    /* host routes mostly differ in the interface identifier */
+    uint32_t hash = pfx->u32[2].u32 ^ pfx->u32[3].u32;
+
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3bU;
+    hash ^= hash >> 16;
+    return hash & (GNRC_IPV6_NIB_OFFL_HASH_NUMOF - 1);
+}
+
+static inline _nib_offl_entry_t *_offl_entry(unsigned link)
+{
+    return (link != 0) ? &_dsts[link - 1] : NULL;
+}
+
+/* first candidate for an entry with the given prefix */
+static inline _nib_offl_entry_t *_offl_first(const ipv6_addr_t *pfx,
+                                             unsigned pfx_len)
+{
+    return _offl_entry(_offl_chains[_offl_chain(pfx, pfx_len)]);
+}
+
+static inline _nib_offl_entry_t *_offl_next_entry(const _nib_offl_entry_t *dst)
+{
+    return _offl_entry(_offl_next[dst - _dsts]);
+}
+
+static void _offl_link(_nib_offl_entry_t *dst)
+{
+    unsigned idx = dst - _dsts;
+    uint16_t *chain = &_offl_chains[_offl_chain(&dst->pfx, dst->pfx_len)];
+
+    _offl_next[idx] = *chain;
+    *chain = idx + 1;
+}
+
+static void _offl_unlink(_nib_offl_entry_t *dst)
+{
+    unsigned idx = dst - _dsts;
+    uint16_t *link = &_offl_chains[_offl_chain(&dst->pfx, dst->pfx_len)];
+
+    while (*link != 0) {
+        if (*link == (idx + 1)) {
+            *link = _offl_next[idx];
+            break;
+        }
+        link = &_offl_next[*link - 1];
+    }
+}
+
+static _nib_offl_entry_t *_offl_take_free(void)
+{
+    _nib_offl_entry_t *dst = _offl_entry(_offl_free);
+
+    if (dst != NULL) {
+        _offl_free = _offl_next[_offl_free - 1];
+    }
+    else if (_offl_unused < GNRC_IPV6_NIB_OFFL_NUMOF) {
+        dst = &_dsts[_offl_unused++];
+    }
+    return dst;
+}
+
+static void _offl_put_free(_nib_offl_entry_t *dst)
+{
+    unsigned idx = dst - _dsts;
+
+    _offl_next[idx] = _offl_free;
+    _offl_free = idx + 1;
+}
+#else   /* GNRC_IPV6_NIB_OFFL_HASH_NUMOF */
+static inline _nib_offl_entry_t *_offl_first(const ipv6_addr_t *pfx,
+                                             unsigned pfx_len)
+{
+    (void)pfx;
+    (void)pfx_len;
+    return _dsts;
+}
+
+static inline _nib_offl_entry_t *_offl_next_entry(const _nib_offl_entry_t *dst)
+{
+    return (dst < &_dsts[GNRC_IPV6_NIB_OFFL_NUMOF - 1]) ?
+           (_nib_offl_entry_t *)(dst + 1) : NULL;
+}
+
+static inline void _offl_link(_nib_offl_entry_t *dst)
+{
+    (void)dst;
+}
+
+static inline void _offl_unlink(_nib_offl_entry_t *dst)
+{
+    (void)dst;
+}
+
+/* free entries are found while searching for an exact match */
+static inline _nib_offl_entry_t *_offl_take_free(void)
+{
+    return NULL;
+}
+
+static inline void _offl_put_free(_nib_offl_entry_t *dst)
+{
+    (void)dst;
+}
+#endif  /* GNRC_IPV6_NIB_OFFL_HASH_NUMOF */
+
 _nib_offl_entry_t *_nib_offl_alloc(const ipv6_addr_t *next_hop, unsigned iface,
                                    const ipv6_addr_t *pfx, unsigned pfx_len)
 {
@@ -451,8 +589,8 @@ _nib_offl_entry_t *_nib_offl_alloc(const ipv6_addr_t *next_hop, unsigned iface,
           iface);
     DEBUG("pfx = %s/%u)\n", ipv6_addr_to_str(addr_str, pfx,
                                              sizeof(addr_str)), pfx_len);
-    for (unsigned i = 0; i < GNRC_IPV6_NIB_OFFL_NUMOF; i++) {
-        _nib_offl_entry_t *tmp = &_dsts[i];
+    for (_nib_offl_entry_t *tmp = _offl_first(pfx, pfx_len); tmp != NULL;
+         tmp = _offl_next_entry(tmp)) {
         _nib_onl_entry_t *tmp_node = tmp->next_hop;
 
         if ((tmp->pfx_len == pfx_len) &&                /* prefix length matches and */
@@ -472,18 +610,23 @@ _nib_offl_entry_t *_nib_offl_alloc(const ipv6_addr_t *next_hop, unsigned iface,
             dst = tmp;
         }
     }
+    if (dst == NULL) {
+        dst = _offl_take_free();
+    }
     if (dst != NULL) {
         DEBUG("  using %p\n", (void *)dst);
         dst->next_hop = _nib_onl_alloc(next_hop, iface);
 
         if (dst->next_hop == NULL) {
             memset(dst, 0, sizeof(_nib_offl_entry_t));
+            _offl_put_free(dst);
             return NULL;
         }
         _override_node(next_hop, iface, dst->next_hop);
         dst->next_hop->mode |= _DST;
         ipv6_addr_init_prefix(&dst->pfx, pfx, pfx_len);
         dst->pfx_len = pfx_len;
+        _offl_link(dst);
     }
     return dst;
 }
@@ -515,7 +658,9 @@ void _nib_offl_clear(_nib_offl_entry_t *dst)
             dst->next_hop->mode &= ~(_DST);
             _nib_onl_clear(dst->next_hop);
         }
+        _offl_unlink(dst);
         memset(dst, 0, sizeof(_nib_offl_entry_t));
+        _offl_put_free(dst);
     }
 }
 
@@ -538,6 +683,18 @@ bool _nib_offl_is_entry(const _nib_offl_entry_t *entry)
     return (entry >= _dsts) && _in_dsts(entry);
 }
 
+_nib_offl_entry_t *_nib_offl_get(const ipv6_addr_t *pfx, unsigned pfx_len)
+{
+    for (_nib_offl_entry_t *entry = _offl_first(pfx, pfx_len); entry != NULL;
+         entry = _offl_next_entry(entry)) {
+        if ((entry->mode != _EMPTY) && (entry->pfx_len == pfx_len) &&
+            (ipv6_addr_match_prefix(&entry->pfx, pfx) >= pfx_len)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
 static _nib_offl_entry_t *_nib_offl_get_match(const ipv6_addr_t *dst)
 {
     _nib_offl_entry_t *res = NULL;
@@ -545,7 +702,19 @@ static _nib_offl_entry_t *_nib_offl_get_match(const ipv6_addr_t *dst)
 
     DEBUG("nib: get match for destination %s from NIB\n",
           ipv6_addr_to_str(addr_str, dst, sizeof(addr_str)));
-    for (_nib_offl_entry_t *entry = _dsts; _in_dsts(entry); entry++) {
+#if GNRC_IPV6_NIB_OFFL_HASH_NUMOF
+    /* a host route is the longest possible match */
+    for (_nib_offl_entry_t *entry = _offl_first(dst, IPV6_ADDR_BIT_LEN);
+         entry != NULL; entry = _offl_next_entry(entry)) {
+        if ((entry->mode != _EMPTY) && ipv6_addr_equal(&entry->pfx, dst)) {
+            DEBUG("nib: host route found\n");
+            return entry;
+        }
+    }
+#endif  /* GNRC_IPV6_NIB_OFFL_HASH_NUMOF */
+    /* with the hash index, only prefixes shorter than 128 remain */
+    for (_nib_offl_entry_t *entry = _offl_first(dst, 0); entry != NULL;
+         entry = _offl_next_entry(entry)) {
         if (entry->mode != _EMPTY) {
             uint8_t match = ipv6_addr_match_prefix(&entry->pfx, dst);
 
@@ -527,6 +527,17 @@ void _nib_offl_clear(_nib_offl_entry_t *dst);
  */
 _nib_offl_entry_t *_nib_offl_iter(const _nib_offl_entry_t *last);
 
+/**
+ * @brief   Gets an off-link entry by its prefix
+ *
+ * @param[in] pfx       The prefix of the entry.
+ * @param[in] pfx_len   The length in bits of @p pfx.
+ *
+ * @return  The first off-link entry with exactly @p pfx / @p pfx_len.
+ * @return  NULL, if there is no such entry.
+ */
+_nib_offl_entry_t *_nib_offl_get(const ipv6_addr_t *pfx, unsigned pfx_len);
+
 /**
  * @brief   Checks if @p entry was allocated using _nib_offl_alloc()
  *
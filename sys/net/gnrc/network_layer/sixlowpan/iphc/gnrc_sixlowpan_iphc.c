@@ -33,6 +33,10 @@
 
 #include "net/gnrc/sixlowpan/iphc.h"
 
+#if GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE
+#include "xtimer.h"
+#endif
+
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
@@ -622,6 +626,12 @@ static inline size_t iphc_nhc_udp_encode(uint8_t *nhc_data,
 }
 #endif
 
+static inline uint16_t _ctx_ltime(uint16_t ltime,
+                                  const gnrc_sixlowpan_ctx_t *ctx)
+{
+    return ((ctx != NULL) && (ctx->ltime < ltime)) ? ctx->ltime : ltime;
+}
+
 static inline bool _compressible(gnrc_pktsnip_t *hdr)
 {
     switch (hdr->type) {
@@ -636,68 +646,17 @@ static inline bool _compressible(gnrc_pktsnip_t *hdr)
     }
 }
 
-void gnrc_sixlowpan_iphc_send(gnrc_pktsnip_t *pkt, void *ctx, unsigned page)
+/* encodes the IPHC header (and NHC header) of a packet to iphc_hdr and returns
+ * its length, ctx_ltime is set to the shortest remaining lifetime of the
+ * contexts used */
+static size_t _iphc_encode(uint8_t *iphc_hdr, gnrc_netif_hdr_t *netif_hdr,
+                           ipv6_hdr_t *ipv6_hdr, const gnrc_pktsnip_t *udp,
+                           uint16_t *ctx_ltime)
 {
-    assert(pkt != NULL);
-    gnrc_netif_hdr_t *netif_hdr = pkt->data;
-    ipv6_hdr_t *ipv6_hdr;
-    uint8_t *iphc_hdr;
     gnrc_sixlowpan_ctx_t *src_ctx = NULL, *dst_ctx = NULL;
-    gnrc_pktsnip_t *dispatch, *ptr = pkt->next;
     bool addr_comp = false;
-    size_t dispatch_size = 0;
-    /* datagram size before compression */
-    size_t orig_datagram_size = gnrc_pkt_len(pkt->next);
     uint16_t inline_pos = SIXLOWPAN_IPHC_HDR_LEN;
 
-    (void)ctx;
-    dispatch = NULL;    /* use dispatch as temporary pointer for prev */
-    /* determine maximum dispatch size and write protect all headers until
-     * then because they will be removed */
-    while (_compressible(ptr)) {
-        gnrc_pktsnip_t *tmp = gnrc_pktbuf_start_write(ptr);
-
-        if (tmp == NULL) {
-            DEBUG("6lo iphc: unable to write protect compressible header\n");
-            if (addr_comp) {    /* addr_comp was used as release indicator */
-                gnrc_pktbuf_release(pkt);
-            }
-            return;
-        }
-        ptr = tmp;
-        if (dispatch == NULL) {
-            /* pkt was already write protected in gnrc_sixlowpan.c:_send so
-             * we shouldn't do it again */
-            pkt->next = ptr;    /* reset original packet */
-        }
-        else {
-            dispatch->next = ptr;
-        }
-        if (ptr->type == GNRC_NETTYPE_UNDEF) {
-            /* most likely UDP for now so use that (XXX: extend if extension
-             * headers make problems) */
-            dispatch_size += sizeof(udp_hdr_t);
-            break;  /* nothing special after UDP so quit even if more UNDEF
-                     * come */
-        }
-        else {
-            dispatch_size += ptr->size;
-        }
-        dispatch = ptr; /* use dispatch as temporary point for prev */
-        ptr = ptr->next;
-    }
-    ipv6_hdr = pkt->next->data;
-    dispatch = gnrc_pktbuf_add(NULL, NULL, dispatch_size,
-                               GNRC_NETTYPE_SIXLOWPAN);
-
-    if (dispatch == NULL) {
-        DEBUG("6lo iphc: error allocating dispatch space\n");
-        gnrc_pktbuf_release(pkt);
-        return;
-    }
-
-    iphc_hdr = dispatch->data;
-
     /* set initial dispatch value*/
     iphc_hdr[IPHC1_IDX] = SIXLOWPAN_IPHC1_DISP;
     iphc_hdr[IPHC2_IDX] = 0;
@@ -721,6 +680,9 @@ void gnrc_sixlowpan_iphc_send(gnrc_pktsnip_t *pkt, void *ctx, unsigned page)
         }
     }
 
+    *ctx_ltime = _ctx_ltime(UINT16_MAX, src_ctx);
+    *ctx_ltime = _ctx_ltime(*ctx_ltime, dst_ctx);
+
     /* if contexts available and both != 0 */
     /* since this moves inline_pos we have to do this ahead*/
     if (((src_ctx != NULL) &&
@@ -917,6 +879,7 @@ void gnrc_sixlowpan_iphc_send(gnrc_pktsnip_t *pkt, void *ctx, unsigned page)
                  * (https://tools.ietf.org/html/rfc3306) with given context
                  * for unicast prefix -> context based compression */
                 iphc_hdr[IPHC2_IDX] |= SIXLOWPAN_IPHC2_DAC;
+                *ctx_ltime = _ctx_ltime(*ctx_ltime, ctx);
                 if ((ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK) != 0) {
                     iphc_hdr[CID_EXT_IDX] |= (ctx->flags_id & GNRC_SIXLOWPAN_CTX_FLAGS_CID_MASK);
                 }
@@ -974,13 +937,244 @@ void gnrc_sixlowpan_iphc_send(gnrc_pktsnip_t *pkt, void *ctx, unsigned page)
         inline_pos += 16;
     }
 
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+    if (ipv6_hdr->nh == PROTNUM_UDP) {
+        assert(udp->size >= sizeof(udp_hdr_t));
+        inline_pos += iphc_nhc_udp_encode(&iphc_hdr[inline_pos], udp);
+    }
+#else
+    (void)udp;
+#endif
+
+    return inline_pos;
+}
+
+#if GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE
+/* longest possible encoding: CID extension, TF and hop limit inline, both
+ * addresses inline and UDP NHC with both ports inline */
+#define FLOW_HDR_MAX        (SIXLOWPAN_IPHC_HDR_LEN + \
+                             SIXLOWPAN_IPHC_CID_EXT_LEN + 4U + 1U + 1U + \
+                             (2 * sizeof(ipv6_addr_t)) + 7U)
+#define FLOW_L2ADDR_MAX     (IEEE802154_LONG_ADDRESS_LEN)
+
+/* everything the encoding depends on, apart from the contexts */
+typedef struct {
+    ipv6_addr_t src;
+    ipv6_addr_t dst;
+    network_uint32_t v_tc_fl;
+    network_uint16_t src_port;
+    network_uint16_t dst_port;
+    kernel_pid_t if_pid;
+    uint8_t nh;
+    uint8_t hl;
+    uint8_t src_l2addr_len;
+    uint8_t dst_l2addr_len;
+    uint8_t src_l2addr[FLOW_L2ADDR_MAX];
+    uint8_t dst_l2addr[FLOW_L2ADDR_MAX];
+} _flow_key_t;
+
+typedef struct {
+    _flow_key_t key;
+    uint32_t expires;       /* minute the first context used expires */
+    uint16_t ctx_version;   /* version of the contexts used for encoding */
+    uint8_t len;            /* length of hdr, 0 if the entry is unused */
+    bool cksum;             /* hdr ends with the inline UDP checksum */
+    uint8_t hdr[FLOW_HDR_MAX];
+} _flow_t;
+
+static _flow_t _flows[GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE];
+static unsigned _flow_next;
+
+static inline uint32_t _current_minute(void)
+{
+    return xtimer_now_usec() / (US_PER_SEC * 60);
+}
+
+static bool _flow_key(_flow_key_t *key, gnrc_netif_hdr_t *netif_hdr,
+                      const ipv6_hdr_t *ipv6_hdr, const gnrc_pktsnip_t *udp)
+{
+    const uint8_t *src_l2addr = gnrc_netif_hdr_get_src_addr(netif_hdr);
+    uint8_t src_l2addr_len = netif_hdr->src_l2addr_len;
+
+    if ((src_l2addr_len != 2) && (src_l2addr_len != 4) &&
+        (src_l2addr_len != 8)) {
+#if GNRC_NETIF_L2ADDR_MAXLEN > 0
+        /* the IID is derived from the interface's address in this case */
+        gnrc_netif_t *netif = gnrc_netif_get_by_pid(netif_hdr->if_pid);
+
+        if (netif == NULL) {
+            return false;
+        }
+        src_l2addr = netif->l2addr;
+        src_l2addr_len = netif->l2addr_len;
+#else
+        return false;
+#endif
+    }
+    if ((src_l2addr_len > FLOW_L2ADDR_MAX) ||
+        (netif_hdr->dst_l2addr_len > FLOW_L2ADDR_MAX)) {
+        return false;
+    }
+
+    /* zero padding to compare keys with memcmp() */
+    memset(key, 0, sizeof(*key));
+    key->src = ipv6_hdr->src;
+    key->dst = ipv6_hdr->dst;
+    key->v_tc_fl = ipv6_hdr->v_tc_fl;
+    key->if_pid = netif_hdr->if_pid;
+    key->nh = ipv6_hdr->nh;
+    key->hl = ipv6_hdr->hl;
+    key->src_l2addr_len = src_l2addr_len;
+    memcpy(key->src_l2addr, src_l2addr, src_l2addr_len);
+    key->dst_l2addr_len = netif_hdr->dst_l2addr_len;
+    memcpy(key->dst_l2addr, gnrc_netif_hdr_get_dst_addr(netif_hdr),
+           netif_hdr->dst_l2addr_len);
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+    if (ipv6_hdr->nh == PROTNUM_UDP) {
+        const udp_hdr_t *udp_hdr = udp->data;
+
+        key->src_port = udp_hdr->src_port;
+        key->dst_port = udp_hdr->dst_port;
+    }
+#else
+    (void)udp;
+#endif
+    return true;
+}
+
+/* encodes a packet by copying the cached header of its flow */
+static size_t _flow_encode(uint8_t *iphc_hdr, gnrc_netif_hdr_t *netif_hdr,
+                           ipv6_hdr_t *ipv6_hdr, const gnrc_pktsnip_t *udp)
+{
+    _flow_key_t key;
+    _flow_t *flow = NULL;
+    uint16_t ctx_ltime;
+    uint16_t ctx_version = gnrc_sixlowpan_ctx_version();
+
+    if (!_flow_key(&key, netif_hdr, ipv6_hdr, udp)) {
+        return _iphc_encode(iphc_hdr, netif_hdr, ipv6_hdr, udp, &ctx_ltime);
+    }
+    for (unsigned i = 0; i < GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE; i++) {
+        if ((_flows[i].len > 0) &&
+            (memcmp(&_flows[i].key, &key, sizeof(key)) == 0)) {
+            flow = &_flows[i];
+            break;
+        }
+    }
+    if ((flow != NULL) && (flow->ctx_version == ctx_version) &&
+        ((flow->expires == UINT32_MAX) ||
+         (_current_minute() < flow->expires))) {
+        DEBUG("6lo iphc: using cached header for flow %u\n",
+              (unsigned)(flow - _flows));
+        memcpy(iphc_hdr, flow->hdr, flow->len);
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+        if (flow->cksum) {
+            const udp_hdr_t *udp_hdr = udp->data;
+
+            memcpy(&iphc_hdr[flow->len - sizeof(udp_hdr->checksum)],
+                   &udp_hdr->checksum, sizeof(udp_hdr->checksum));
+        }
+#endif
+        return flow->len;
+    }
+
+    size_t len = _iphc_encode(iphc_hdr, netif_hdr, ipv6_hdr, udp, &ctx_ltime);
+
+    if (flow == NULL) {
+        /* replace entries round-robin, stale entries are updated in place */
+        flow = &_flows[_flow_next];
+        _flow_next = (_flow_next + 1) % GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE;
+    }
+    assert(len <= sizeof(flow->hdr));
+    flow->key = key;
+    flow->expires = (ctx_ltime == UINT16_MAX) ? UINT32_MAX :
+                    _current_minute() + ctx_ltime;
+    flow->ctx_version = ctx_version;
+    flow->len = len;
+#ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
+    flow->cksum = (ipv6_hdr->nh == PROTNUM_UDP);
+#else
+    flow->cksum = false;
+#endif
+    memcpy(flow->hdr, iphc_hdr, len);
+    return len;
+}
+#endif
+
+void gnrc_sixlowpan_iphc_send(gnrc_pktsnip_t *pkt, void *ctx, unsigned page)
+{
+    assert(pkt != NULL);
+    gnrc_netif_hdr_t *netif_hdr = pkt->data;
+    ipv6_hdr_t *ipv6_hdr;
+    uint8_t *iphc_hdr;
+    gnrc_pktsnip_t *dispatch, *ptr = pkt->next;
+    bool addr_comp = false;
+    size_t dispatch_size = 0;
+    /* datagram size before compression */
+    size_t orig_datagram_size = gnrc_pkt_len(pkt->next);
+    uint16_t inline_pos;
+
+    (void)ctx;
+    dispatch = NULL;    /* use dispatch as temporary pointer for prev */
+    /* determine maximum dispatch size and write protect all headers until
+     * then because they will be removed */
+    while (_compressible(ptr)) {
+        gnrc_pktsnip_t *tmp = gnrc_pktbuf_start_write(ptr);
+
+        if (tmp == NULL) {
+            DEBUG("6lo iphc: unable to write protect compressible header\n");
+            if (addr_comp) {    /* addr_comp was used as release indicator */
+                gnrc_pktbuf_release(pkt);
+            }
+            return;
+        }
+        ptr = tmp;
+        if (dispatch == NULL) {
+            /* pkt was already write protected in gnrc_sixlowpan.c:_send so
+             * we shouldn't do it again */
+            pkt->next = ptr;    /* reset original packet */
+        }
+        else {
+            dispatch->next = ptr;
+        }
+        if (ptr->type == GNRC_NETTYPE_UNDEF) {
+            /* most likely UDP for now so use that (XXX: extend if extension
+             * headers make problems) */
+            dispatch_size += sizeof(udp_hdr_t);
+            break;  /* nothing special after UDP so quit even if more UNDEF
+                     * come */
+        }
+        else {
+            dispatch_size += ptr->size;
+        }
+        dispatch = ptr; /* use dispatch as temporary point for prev */
+        ptr = ptr->next;
+    }
+    ipv6_hdr = pkt->next->data;
+    dispatch = gnrc_pktbuf_add(NULL, NULL, dispatch_size,
+                               GNRC_NETTYPE_SIXLOWPAN);
+
+    if (dispatch == NULL) {
+        DEBUG("6lo iphc: error allocating dispatch space\n");
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+
+    iphc_hdr = dispatch->data;
+
+#if GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE
+    inline_pos = _flow_encode(iphc_hdr, netif_hdr, ipv6_hdr, pkt->next->next);
+#else
+    uint16_t ctx_ltime;
+    inline_pos = _iphc_encode(iphc_hdr, netif_hdr, ipv6_hdr, pkt->next->next,
+                              &ctx_ltime);
+#endif
+
 #ifdef MODULE_GNRC_SIXLOWPAN_IPHC_NHC
     switch (ipv6_hdr->nh) {
         case PROTNUM_UDP: {
             gnrc_pktsnip_t *udp = pkt->next->next;
 
-            assert(udp->size >= sizeof(udp_hdr_t));
-            inline_pos += iphc_nhc_udp_encode(&iphc_hdr[inline_pos], udp);
             /* remove UDP header */
             if (udp->size > sizeof(udp_hdr_t)) {
                 udp = gnrc_pktbuf_mark(udp, sizeof(udp_hdr_t),
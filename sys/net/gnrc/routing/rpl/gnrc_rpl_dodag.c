@@ -38,7 +38,8 @@
 
 static char addr_str[IPV6_ADDR_MAX_STR_LEN];
 
-static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *dodag);
+static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *dodag,
+                                                          gnrc_rpl_parent_t *parent);
 
 static void _rpl_trickle_send_dio(void *args)
 {
@@ -154,6 +155,7 @@ bool gnrc_rpl_dodag_init(gnrc_rpl_instance_t *instance, ipv6_addr_t *dodag_id, k
     dodag->dao_seq = GNRC_RPL_COUNTER_INIT;
     dodag->dtsn = 0;
     dodag->dao_ack_received = false;
+    dodag->dao_scheduled = false;
     dodag->dao_counter = 0;
     dodag->instance = instance;
     dodag->iface = iface;
@@ -288,20 +290,72 @@ void gnrc_rpl_parent_update(gnrc_rpl_dodag_t *dodag, gnrc_rpl_parent_t *parent)
 #endif
     }
 
-    if (_gnrc_rpl_find_preferred_parent(dodag) == NULL) {
+    if (_gnrc_rpl_find_preferred_parent(dodag, parent) == NULL) {
         gnrc_rpl_local_repair(dodag);
     }
 }
 
+/**
+ * @brief   Move @p parent to its position in the otherwise ordered parent list
+ *
+ * Equally preferred parents keep their order, as with a stable sort of the
+ * whole list.
+ *
+ * @param[in] dodag     Pointer to the DODAG
+ * @param[in] parent    Pointer to the parent whose preference changed
+ */
+static void _gnrc_rpl_parent_reorder(gnrc_rpl_dodag_t *dodag, gnrc_rpl_parent_t *parent)
+{
+    int (*cmp)(gnrc_rpl_parent_t *, gnrc_rpl_parent_t *) = dodag->instance->of->parent_cmp;
+    gnrc_rpl_parent_t *prev = NULL, *elt;
+    bool up;
+
+    for (elt = dodag->parents; (elt != NULL) && (elt != parent); elt = elt->next) {
+        prev = elt;
+    }
+    if (elt == NULL) {
+        return;
+    }
+    up = (prev != NULL) && (cmp(prev, parent) > 0);
+    if (!up && ((parent->next == NULL) || (cmp(parent, parent->next) <= 0))) {
+        /* still in order */
+        return;
+    }
+
+    LL_DELETE(dodag->parents, parent);
+    /* moving up, equally preferred parents in front stay in front, moving
+     * down, those behind stay behind */
+    prev = NULL;
+    for (elt = dodag->parents; elt != NULL; elt = elt->next) {
+        int res = cmp(parent, elt);
+        if ((res < 0) || (!up && (res == 0))) {
+            break;
+        }
+        prev = elt;
+    }
+    if (prev == NULL) {
+        LL_PREPEND(dodag->parents, parent);
+    }
+    else {
+        parent->next = prev->next;
+        prev->next = parent;
+    }
+}
+
 /**
  * @brief   Find the parent with the lowest rank and update the DODAG's preferred parent
  *
+ * The parent list is kept ordered by preference. If only a single @p parent
+ * changed, only this parent is moved and checked against the new rank.
+ *
  * @param[in] dodag     Pointer to the DODAG
+ * @param[in] parent    Pointer to the changed parent, NULL to order all parents
  *
  * @return  Pointer to the preferred parent, on success.
  * @return  NULL, otherwise.
  */
-static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *dodag)
+static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *dodag,
+                                                          gnrc_rpl_parent_t *parent)
 {
     gnrc_rpl_parent_t *old_best = dodag->parents;
     gnrc_rpl_parent_t *new_best = old_best;
@@ -312,7 +366,13 @@ static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *doda
         return NULL;
     }
 
-    LL_SORT(dodag->parents, dodag->instance->of->parent_cmp);
+    if ((parent != NULL) && (parent->state != GNRC_RPL_PARENT_UNUSED)) {
+        _gnrc_rpl_parent_reorder(dodag, parent);
+    }
+    else {
+        LL_SORT(dodag->parents, dodag->instance->of->parent_cmp);
+        parent = NULL;
+    }
     new_best = dodag->parents;
 
     if (new_best->rank == GNRC_RPL_INFINITE_RANK) {
@@ -344,6 +404,16 @@ static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *doda
         trickle_reset_timer(&dodag->trickle);
     }
 
+    if ((dodag->my_rank == old_rank) && (parent != NULL)) {
+        /* all other parents were checked against this rank already */
+        if ((parent != dodag->parents) &&
+            (DAGRANK(dodag->my_rank, dodag->instance->min_hop_rank_inc)
+             <= DAGRANK(parent->rank, dodag->instance->min_hop_rank_inc))) {
+            gnrc_rpl_parent_remove(parent);
+        }
+        return dodag->parents;
+    }
+
     LL_FOREACH_SAFE(dodag->parents, elt, tmp) {
         if (DAGRANK(dodag->my_rank, dodag->instance->min_hop_rank_inc)
             <= DAGRANK(elt->rank, dodag->instance->min_hop_rank_inc)) {
@@ -59,26 +59,27 @@ ssize_t gnrc_sock_recv(gnrc_sock_reg_t *reg, gnrc_pktsnip_t **pkt_out,
     if (reg->mbox.cib.mask != (SOCK_MBOX_SIZE - 1)) {
         return -EINVAL;
     }
+    /* only arm the timeout if we actually have to wait */
+    if (!mbox_try_get(&reg->mbox, &msg)) {
+        if (timeout == 0) {
+            return -EAGAIN;
+        }
 #ifdef MODULE_XTIMER
-    xtimer_t timeout_timer;
+        xtimer_t timeout_timer;
 
-    if ((timeout != SOCK_NO_TIMEOUT) && (timeout != 0)) {
-        timeout_timer.callback = _callback_put;
-        timeout_timer.arg = reg;
-        xtimer_set(&timeout_timer, timeout);
-    }
+        if (timeout != SOCK_NO_TIMEOUT) {
+            timeout_timer.callback = _callback_put;
+            timeout_timer.arg = reg;
+            xtimer_set(&timeout_timer, timeout);
+        }
 #endif
-    if (timeout != 0) {
         mbox_get(&reg->mbox, &msg);
-    }
-    else {
-        if (!mbox_try_get(&reg->mbox, &msg)) {
-            return -EAGAIN;
-        }
-    }
 #ifdef MODULE_XTIMER
-    xtimer_remove(&timeout_timer);
+        if (timeout != SOCK_NO_TIMEOUT) {
+            xtimer_remove(&timeout_timer);
+        }
 #endif
+    }
     switch (msg.type) {
         case GNRC_NETAPI_MSG_TYPE_RCV:
             pkt = msg.content.ptr;
@@ -114,6 +115,31 @@ ssize_t gnrc_sock_recv(gnrc_sock_reg_t *reg, gnrc_pktsnip_t **pkt_out,
     return 0;
 }
 
+gnrc_pktsnip_t *gnrc_sock_payload_build(const iolist_t *snips)
+{
+    gnrc_pktsnip_t *payload;
+    uint8_t *pos;
+
+    if ((snips == NULL) || (snips->iol_next == NULL)) {
+        /* a single buffer is copied by the packet buffer itself */
+        return gnrc_pktbuf_add(NULL, (snips) ? snips->iol_base : NULL,
+                               (snips) ? snips->iol_len : 0,
+                               GNRC_NETTYPE_UNDEF);
+    }
+    /* one snip for all elements keeps the number of allocations at one */
+    payload = gnrc_pktbuf_add(NULL, NULL, iolist_size(snips),
+                              GNRC_NETTYPE_UNDEF);
+    if (payload == NULL) {
+        return NULL;
+    }
+    pos = payload->data;
+    for (; snips != NULL; snips = snips->iol_next) {
+        memcpy(pos, snips->iol_base, snips->iol_len);
+        pos += snips->iol_len;
+    }
+    return payload;
+}
+
 ssize_t gnrc_sock_send(gnrc_pktsnip_t *payload, sock_ip_ep_t *local,
                        const sock_ip_ep_t *remote, uint8_t nh)
 {
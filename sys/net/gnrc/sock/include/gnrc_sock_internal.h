@@ -25,6 +25,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include "iolist.h"
 #include "mbox.h"
 #include "net/af.h"
 #include "net/gnrc.h"
@@ -129,6 +130,14 @@ void gnrc_sock_create(gnrc_sock_reg_t *reg, gnrc_nettype_t type, uint32_t demux_
 ssize_t gnrc_sock_recv(gnrc_sock_reg_t *reg, gnrc_pktsnip_t **pkt, uint32_t timeout,
                        sock_ip_ep_t *remote);
 
+/**
+ * @brief   Gather the elements of an iolist into a payload snip
+ * @internal
+ *
+ * @return  the payload snip, NULL if the packet buffer is full
+ */
+gnrc_pktsnip_t *gnrc_sock_payload_build(const iolist_t *snips);
+
 /**
  * @brief   Send a packet internally
  * @internal
@@ -18,6 +18,7 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 
 #include "log.h"
 #include "luid.h"
@@ -49,18 +50,61 @@ void auto_init_random(void)
     random_init(seed);
 }
 
+void random_fill(uint32_t *buf, size_t words)
+{
+    while (words--) {
+        *buf++ = random_uint32();
+    }
+}
+
 void random_bytes(uint8_t *target, size_t n)
 {
     uint32_t random;
-    uint8_t *random_pos = (uint8_t*)&random;
-    unsigned _n = 0;
-
-    while (n--) {
-        if (! (_n++ & 0x3)) {
-            random = random_uint32();
-            random_pos = (uint8_t *) &random;
-        }
-        *target++ = *random_pos++;
+    /* bytes up to the next word boundary of target */
+    size_t head = (-(uintptr_t)target) & (sizeof(uint32_t) - 1);
+
+    if (head > n) {
+        head = n;
+    }
+    if (head) {
+        random = random_uint32();
+        memcpy(target, &random, head);
+        target += head;
+        n -= head;
+    }
+
+    random_fill((uint32_t *)target, n / sizeof(uint32_t));
+    target += n & ~(sizeof(uint32_t) - 1);
+    n &= sizeof(uint32_t) - 1;
+
+    if (n) {
+        random = random_uint32();
+        memcpy(target, &random, n);
+    }
+}
+
+void random_xoshiro_init(random_xoshiro_t *ctx)
+{
+    random_fill(ctx->s, sizeof(ctx->s) / sizeof(ctx->s[0]));
+    if (!(ctx->s[0] | ctx->s[1] | ctx->s[2] | ctx->s[3])) {
+        /* the all zero state would only ever produce zeros */
+        ctx->s[0] = 1;
+    }
+}
+
+void random_xoshiro_bytes(random_xoshiro_t *ctx, uint8_t *buf, size_t size)
+{
+    uint32_t random;
+
+    while (size >= sizeof(random)) {
+        random = random_xoshiro_uint32(ctx);
+        memcpy(buf, &random, sizeof(random));
+        buf += sizeof(random);
+        size -= sizeof(random);
+    }
+    if (size) {
+        random = random_xoshiro_uint32(ctx);
+        memcpy(buf, &random, size);
     }
 }
 
@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_saul_sampler
+ * @{
+ *
+ * @file
+ * @brief       SAUL sampler implementation
+ *
+ * The ring of a group is a single producer, single consumer queue: only the
+ * sampler thread advances `head`, only the consumer advances `tail`. Both are
+ * free running, so no locking is needed between the two.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "msg.h"
+#include "mutex.h"
+#include "saul_sampler.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define MSG_QUEUE_SIZE      (4U)
+
+/* protects the list of groups and their channel state */
+static mutex_t _lock = MUTEX_INIT;
+static saul_sampler_group_t *_groups;
+static kernel_pid_t _pid = KERNEL_PID_UNDEF;
+static char _stack[SAUL_SAMPLER_STACKSIZE];
+
+/* converts a reading to the scale of the first reading aggregated */
+static int32_t _rescale(int32_t val, int diff)
+{
+    for (; (diff > 0) && (val > INT16_MIN) && (val < INT16_MAX); diff--) {
+        val *= 10;
+    }
+    for (; diff < 0; diff++) {
+        val /= 10;
+    }
+    if (val > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (val < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return val;
+}
+
+static void _push(saul_sampler_group_t *group, uint8_t chan, uint8_t aggr,
+                  uint32_t time, const phydat_t *data)
+{
+    unsigned head = group->head;
+
+    if ((head - group->tail) > group->ring_mask) {
+        group->dropped++;
+        return;
+    }
+    saul_sampler_sample_t *sample = &group->ring[head & group->ring_mask];
+    sample->time = time;
+    sample->chan = chan;
+    sample->aggr = aggr;
+    sample->data = *data;
+    group->head = head + 1;
+}
+
+static void _push_aggr(saul_sampler_group_t *group, uint8_t idx, uint32_t time)
+{
+    saul_sampler_chan_t *chan = &group->chans[idx];
+    phydat_t data = chan->last;
+
+    for (uint8_t flag = SAUL_SAMPLER_AGGR_MIN; flag <= SAUL_SAMPLER_AGGR_MEAN;
+         flag <<= 1) {
+        if (!(chan->aggr & flag)) {
+            continue;
+        }
+        for (unsigned i = 0; i < chan->dim; i++) {
+            const matstat_state_t *stat = &chan->stat[i];
+            data.val[i] = (flag == SAUL_SAMPLER_AGGR_MIN) ? stat->min :
+                          (flag == SAUL_SAMPLER_AGGR_MAX) ? stat->max :
+                          matstat_mean(stat);
+        }
+        _push(group, idx, flag, time, &data);
+    }
+}
+
+static void _sample(saul_sampler_group_t *group, uint8_t idx)
+{
+    saul_sampler_chan_t *chan = &group->chans[idx];
+    phydat_t data;
+
+    int dim = saul_reg_read(chan->dev, &data);
+    uint32_t time = xtimer_now_usec();
+    if (dim <= 0) {
+        DEBUG("saul_sampler: reading %s failed (%d)\n", chan->dev->name, dim);
+        return;
+    }
+    if (dim > (int)PHYDAT_DIM) {
+        dim = PHYDAT_DIM;
+    }
+
+    if (chan->aggr == 0) {
+        _push(group, idx, 0, time, &data);
+        return;
+    }
+
+    if (chan->reads == 0) {
+        /* the first reading determines unit and scale of the aggregate */
+        chan->last = data;
+        chan->dim = dim;
+        for (unsigned i = 0; i < PHYDAT_DIM; i++) {
+            matstat_clear(&chan->stat[i]);
+        }
+    }
+    for (unsigned i = 0; i < chan->dim; i++) {
+        matstat_add(&chan->stat[i],
+                    _rescale(data.val[i], data.scale - chan->last.scale));
+    }
+    if (++chan->reads >= chan->decimation) {
+        _push_aggr(group, idx, time);
+        chan->reads = 0;
+    }
+}
+
+static void _tick(saul_sampler_group_t *group)
+{
+    for (unsigned i = 0; i < group->chans_numof; i++) {
+        saul_sampler_chan_t *chan = &group->chans[i];
+
+        if (--chan->ticks == 0) {
+            chan->ticks = chan->divider;
+            _sample(group, i);
+        }
+    }
+
+    if ((group->pid != KERNEL_PID_UNDEF) && !group->notified &&
+        (saul_sampler_avail(group) >= group->batch)) {
+        msg_t msg;
+
+        msg.type = SAUL_SAMPLER_MSG_TYPE;
+        msg.content.ptr = group;
+        /* the consumer may be busy, try again on the next tick */
+        group->notified = (msg_try_send(&msg, group->pid) == 1);
+    }
+}
+
+static uint64_t _next_deadline(uint64_t now, uint32_t interval)
+{
+    return ((now / interval) + 1) * interval;
+}
+
+static void *_thread(void *arg)
+{
+    msg_t queue[MSG_QUEUE_SIZE];
+
+    (void)arg;
+    msg_init_queue(queue, MSG_QUEUE_SIZE);
+
+    while (1) {
+        uint64_t now = xtimer_now_usec64();
+        uint64_t next = UINT64_MAX;
+
+        mutex_lock(&_lock);
+        for (saul_sampler_group_t *g = _groups; g != NULL; g = g->next) {
+            if (g->deadline <= now) {
+                _tick(g);
+                /* skip ticks missed by a slow driver */
+                g->deadline += g->interval;
+                if (g->deadline <= now) {
+                    g->deadline = _next_deadline(now, g->interval);
+                }
+            }
+            if (g->deadline < next) {
+                next = g->deadline;
+            }
+        }
+        mutex_unlock(&_lock);
+
+        msg_t msg;
+        if (next == UINT64_MAX) {
+            /* nothing to sample, wait for saul_sampler_add() */
+            msg_receive(&msg);
+            continue;
+        }
+        now = xtimer_now_usec64();
+        if (next > now) {
+            xtimer_msg_receive_timeout64(&msg, next - now);
+        }
+    }
+
+    return NULL;
+}
+
+void saul_sampler_init(void)
+{
+    _pid = thread_create(_stack, sizeof(_stack), SAUL_SAMPLER_PRIO,
+                         THREAD_CREATE_STACKTEST, _thread, NULL,
+                         "saul_sampler");
+}
+
+void saul_sampler_chan_init(saul_sampler_chan_t *chan, saul_reg_t *dev,
+                            unsigned divider, unsigned decimation,
+                            uint8_t aggr)
+{
+    memset(chan, 0, sizeof(*chan));
+    chan->dev = dev;
+    chan->divider = (divider) ? divider : 1;
+    chan->decimation = (decimation) ? decimation : 1;
+    chan->aggr = aggr;
+}
+
+int saul_sampler_group_init(saul_sampler_group_t *group,
+                            saul_sampler_chan_t *chans, unsigned chans_numof,
+                            saul_sampler_sample_t *ring, unsigned ring_numof,
+                            uint32_t interval)
+{
+    if ((chans == NULL) || (chans_numof == 0) || (chans_numof > 256) ||
+        (ring == NULL) || (ring_numof == 0) ||
+        (ring_numof & (ring_numof - 1)) || (interval == 0)) {
+        return -EINVAL;
+    }
+    memset(group, 0, sizeof(*group));
+    group->chans = chans;
+    group->chans_numof = chans_numof;
+    group->ring = ring;
+    group->ring_mask = ring_numof - 1;
+    group->interval = interval;
+    group->pid = KERNEL_PID_UNDEF;
+    group->batch = 1;
+    return 0;
+}
+
+void saul_sampler_notify(saul_sampler_group_t *group, kernel_pid_t pid,
+                         unsigned batch)
+{
+    group->batch = (batch) ? batch : 1;
+    group->pid = pid;
+}
+
+void saul_sampler_add(saul_sampler_group_t *group)
+{
+    msg_t msg;
+
+    mutex_lock(&_lock);
+    for (unsigned i = 0; i < group->chans_numof; i++) {
+        /* read all channels on the first tick */
+        group->chans[i].ticks = 1;
+        group->chans[i].reads = 0;
+    }
+    group->deadline = _next_deadline(xtimer_now_usec64(), group->interval);
+    group->next = _groups;
+    _groups = group;
+    mutex_unlock(&_lock);
+
+    /* let the sampler thread recompute its timeout */
+    msg.type = SAUL_SAMPLER_MSG_TYPE;
+    msg.content.ptr = group;
+    msg_try_send(&msg, _pid);
+}
+
+int saul_sampler_remove(saul_sampler_group_t *group)
+{
+    int res = -ENOENT;
+
+    mutex_lock(&_lock);
+    for (saul_sampler_group_t **g = &_groups; *g != NULL; g = &(*g)->next) {
+        if (*g == group) {
+            *g = group->next;
+            group->next = NULL;
+            res = 0;
+            break;
+        }
+    }
+    mutex_unlock(&_lock);
+    return res;
+}
+
+unsigned saul_sampler_read(saul_sampler_group_t *group,
+                           saul_sampler_sample_t *buf, unsigned max)
+{
+    unsigned tail = group->tail;
+    unsigned n = 0;
+
+    /* re-arm first, samples added meanwhile trigger a new notification */
+    group->notified = false;
+    for (; (n < max) && (tail != group->head); n++, tail++) {
+        buf[n] = group->ring[tail & group->ring_mask];
+    }
+    group->tail = tail;
+    return n;
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_sched_round_robin
+ * @{
+ *
+ * @file
+ * @brief       Round-robin time slicing implementation
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+
+#include "clist.h"
+#include "irq.h"
+#include "sched_round_robin.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/* quanta of the priorities flagged in _prio_set, the others use the default */
+static uint32_t _prio_quantum[SCHED_PRIO_LEVELS];
+static uint32_t _prio_set;
+/* per thread overrides, 0 if not set */
+static uint32_t _thread_quantum[KERNEL_PID_LAST + 1];
+
+static xtimer_t _timer;
+/* thread the timer was set for */
+static thread_t *_owner;
+/* end of the quantum of _owner */
+static uint32_t _deadline;
+static bool _armed;
+
+/* rest of the quantum of the preempted head of each runqueue */
+static thread_t *_preempted[SCHED_PRIO_LEVELS];
+static uint32_t _rest[SCHED_PRIO_LEVELS];
+
+/* shorter rests can not be timed and count as expired */
+#define REST_MIN    (xtimer_usec_from_ticks(xtimer_ticks(XTIMER_BACKOFF)))
+
+static uint32_t _quantum(const thread_t *thread)
+{
+    if (_thread_quantum[thread->pid]) {
+        return _thread_quantum[thread->pid];
+    }
+    if (_prio_set & (1UL << thread->priority)) {
+        return _prio_quantum[thread->priority];
+    }
+    return SCHED_ROUND_ROBIN_QUANTUM;
+}
+
+static void _expire(void *arg)
+{
+    (void)arg;
+
+    unsigned state = irq_disable();
+    thread_t *active = (thread_t *)sched_active_thread;
+
+    _armed = false;
+    if ((active != NULL) && (active == _owner)) {
+        clist_node_t *rq = &sched_runqueues[active->priority];
+
+        /* the siblings may have blocked in the meantime */
+        if ((clist_lpeek(rq) == &active->rq_entry) &&
+            (clist_rpeek(rq) != &active->rq_entry)) {
+            DEBUG("sched_round_robin: quantum of %" PRIkernel_pid " expired\n",
+                  active->pid);
+            clist_lpoprpush(rq);
+            _owner = NULL;
+            sched_context_switch_request = 1;
+        }
+    }
+    irq_restore(state);
+}
+
+void sched_round_robin_set_quantum(uint8_t prio, uint32_t us)
+{
+    assert(prio < SCHED_PRIO_LEVELS);
+
+    unsigned state = irq_disable();
+    _prio_quantum[prio] = us;
+    _prio_set |= (1UL << prio);
+    irq_restore(state);
+}
+
+void sched_round_robin_set_thread_quantum(kernel_pid_t pid, uint32_t us)
+{
+    assert(pid_is_valid(pid));
+
+    unsigned state = irq_disable();
+    _thread_quantum[pid] = us;
+    irq_restore(state);
+}
+
+uint32_t sched_round_robin_get_quantum(kernel_pid_t pid)
+{
+    const thread_t *thread = (const thread_t *)thread_get(pid);
+
+    return (thread) ? _quantum(thread) : 0;
+}
+
+/* saves the rest of the quantum of the owner, which stops running */
+static void _preempt(thread_t *owner)
+{
+    clist_node_t *rq = &sched_runqueues[owner->priority];
+    uint32_t rest = _deadline - xtimer_now_usec();
+
+    if (clist_lpeek(rq) != &owner->rq_entry) {
+        /* the owner blocked or yielded, its next quantum is a new one */
+        return;
+    }
+    if ((int32_t)rest <= (int32_t)REST_MIN) {
+        DEBUG("sched_round_robin: quantum of %" PRIkernel_pid " expired "
+              "while preempted\n", owner->pid);
+        clist_lpoprpush(rq);
+        return;
+    }
+    /* a higher priority took over, the owner continues its quantum when
+     * it is back, otherwise frequent preemption would keep it from ever
+     * expiring */
+    _preempted[owner->priority] = owner;
+    _rest[owner->priority] = rest;
+}
+
+void sched_round_robin_update(thread_t *thread)
+{
+    if ((thread == _owner) && _armed) {
+        /* keep the running quantum */
+        return;
+    }
+    if (_armed) {
+        xtimer_remove(&_timer);
+        _armed = false;
+        if (_owner != NULL) {
+            _preempt(_owner);
+        }
+    }
+    _owner = thread;
+    if (thread == NULL) {
+        return;
+    }
+
+    clist_node_t *rq = &sched_runqueues[thread->priority];
+    uint32_t quantum, rest = 0;
+
+    /* only the head of a runqueue runs, so a rest of another thread is
+     * stale */
+    if (_preempted[thread->priority] == thread) {
+        rest = _rest[thread->priority];
+    }
+    _preempted[thread->priority] = NULL;
+
+    /* nothing to do if no sibling is runnable */
+    if ((clist_lpeek(rq) == clist_rpeek(rq)) ||
+        ((quantum = _quantum(thread)) == 0)) {
+        return;
+    }
+    if (rest && (rest < quantum)) {
+        quantum = rest;
+    }
+    _timer.callback = _expire;
+    _armed = true;
+    _deadline = xtimer_now_usec() + quantum;
+    xtimer_set(&_timer, quantum);
+}
+
+void sched_round_robin_exit(kernel_pid_t pid)
+{
+    _thread_quantum[pid] = 0;
+    if ((_owner != NULL) && (_owner->pid == pid)) {
+        /* makes the next update stop the timer */
+        _owner = NULL;
+    }
+}
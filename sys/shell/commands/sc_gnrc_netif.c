@@ -109,6 +109,11 @@ static const char *_netstats_module_to_str(uint8_t module)
     }
 }
 
+static unsigned _frames_per_batch(uint32_t frames, uint32_t batches)
+{
+    return (batches > 0) ? (unsigned)(((uint64_t)frames * 100) / batches) : 0;
+}
+
 static int _netif_stats(kernel_pid_t iface, unsigned module, bool reset)
 {
     netstats_t *stats;
@@ -135,6 +140,19 @@ static int _netif_stats(kernel_pid_t iface, unsigned module, bool reset)
                (unsigned) stats->tx_bytes,
                (unsigned) stats->tx_success,
                (unsigned) stats->tx_failed);
+        if ((stats->rx_batches > 0) || (stats->tx_batches > 0)) {
+            unsigned tx_count = stats->tx_unicast_count + stats->tx_mcast_count;
+
+            /* frames per batch with two decimal places */
+            printf("            RX batches %u (%u.%02u frames/batch)\n"
+                   "            TX batches %u (%u.%02u frames/batch)\n",
+                   (unsigned) stats->rx_batches,
+                   _frames_per_batch(stats->rx_count, stats->rx_batches) / 100,
+                   _frames_per_batch(stats->rx_count, stats->rx_batches) % 100,
+                   (unsigned) stats->tx_batches,
+                   _frames_per_batch(tx_count, stats->tx_batches) / 100,
+                   _frames_per_batch(tx_count, stats->tx_batches) % 100);
+        }
         res = 0;
     }
     return res;
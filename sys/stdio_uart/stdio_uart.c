@@ -33,6 +33,15 @@
 #include "periph/uart.h"
 #include "isrpipe.h"
 
+#if defined(MODULE_STDIO_UART_TXBUF) && !defined(USE_ETHOS_FOR_STDIO)
+#define TX_BUFFERED     (1)
+#include <stdbool.h>
+
+#include "irq.h"
+#include "mutex.h"
+#include "tsrb.h"
+#endif
+
 #ifdef USE_ETHOS_FOR_STDIO
 #include "ethos.h"
 extern ethos_t ethos;
@@ -49,6 +58,97 @@ extern ethos_t ethos;
 static char _rx_buf_mem[STDIO_UART_RX_BUFSIZE];
 isrpipe_t stdio_uart_isrpipe = ISRPIPE_INIT(_rx_buf_mem);
 
+#ifdef TX_BUFFERED
+static char _tx_buf_mem[STDIO_UART_TX_BUFSIZE];
+static tsrb_t _tx_buf = TSRB_INIT(_tx_buf_mem);
+/* serializes writers, so at most one thread waits for the transmitter */
+static mutex_t _tx_lock = MUTEX_INIT;
+/* unlocked by the transmit callback to wake up the waiting thread */
+static mutex_t _tx_wait = MUTEX_INIT_LOCKED;
+static volatile bool _tx_active;
+static volatile bool _tx_waiting;
+/* set on a panic, bypasses the buffer and its locks from then on */
+static volatile bool _tx_sync;
+
+static int _tx_cb(void *arg)
+{
+    (void)arg;
+
+    unsigned state = irq_disable();
+    int c = tsrb_get_one(&_tx_buf);
+    if (c < 0) {
+        _tx_active = false;
+    }
+    /* wake up a waiting writer when it can make progress in larger chunks */
+    bool wake = _tx_waiting &&
+                ((c < 0) || (tsrb_free(&_tx_buf) >= (STDIO_UART_TX_BUFSIZE / 2)));
+    if (wake) {
+        _tx_waiting = false;
+    }
+    irq_restore(state);
+
+    if (wake) {
+        mutex_unlock(&_tx_wait);
+    }
+    return c;
+}
+
+/* with interrupts disabled or in interrupt context the transmit callback cannot
+ * run and waiting is impossible, so the buffered data is written out
+ * synchronously to keep the order of the output */
+static void _flush_sync(void)
+{
+    char chunk[16];
+    int n;
+
+    unsigned state = irq_disable();
+    while ((n = tsrb_get(&_tx_buf, chunk, sizeof(chunk))) > 0) {
+        uart_write(STDIO_UART_DEV, (const uint8_t *)chunk, n);
+    }
+    irq_restore(state);
+}
+
+static void _write_buffered(const char *data, size_t len)
+{
+    size_t pos = 0;
+
+    mutex_lock(&_tx_lock);
+    while (pos < len) {
+        unsigned state = irq_disable();
+        if (STDIO_UART_TX_POLICY == STDIO_UART_TX_OVERWRITE) {
+            if ((len - pos) > STDIO_UART_TX_BUFSIZE) {
+                pos = len - STDIO_UART_TX_BUFSIZE;
+            }
+            unsigned free = tsrb_free(&_tx_buf);
+            if (free < (len - pos)) {
+                tsrb_drop(&_tx_buf, (len - pos) - free);
+            }
+        }
+        pos += tsrb_add(&_tx_buf, &data[pos], len - pos);
+
+        bool start = !_tx_active && !tsrb_empty(&_tx_buf);
+        if (start) {
+            _tx_active = true;
+        }
+        bool wait = (pos < len) && (STDIO_UART_TX_POLICY == STDIO_UART_TX_BLOCK);
+        if (wait) {
+            _tx_waiting = true;
+        }
+        irq_restore(state);
+
+        if (start) {
+            uart_tx_start(STDIO_UART_DEV, _tx_cb, NULL);
+        }
+        if (!wait) {
+            /* with STDIO_UART_TX_DROP, the rest is dropped */
+            break;
+        }
+        mutex_lock(&_tx_wait);
+    }
+    mutex_unlock(&_tx_lock);
+}
+#endif /* TX_BUFFERED */
+
 void stdio_init(void)
 {
 #ifndef USE_ETHOS_FOR_STDIO
@@ -68,10 +168,51 @@ ssize_t stdio_read(void* buffer, size_t count)
 
 ssize_t stdio_write(const void* buffer, size_t len)
 {
-#ifndef USE_ETHOS_FOR_STDIO
+#if defined(TX_BUFFERED)
+    if (irq_is_in() || !irq_is_enabled() || _tx_sync) {
+        _flush_sync();
+        uart_write(STDIO_UART_DEV, (const uint8_t *)buffer, len);
+    }
+    else {
+        _write_buffered(buffer, len);
+    }
+#elif !defined(USE_ETHOS_FOR_STDIO)
     uart_write(STDIO_UART_DEV, (const uint8_t *)buffer, len);
 #else
     ethos_send_frame(&ethos, (const uint8_t *)buffer, len, ETHOS_FRAME_TYPE_TEXT);
 #endif
     return len;
 }
+
+void stdio_uart_flush(void)
+{
+#ifdef TX_BUFFERED
+    if (irq_is_in() || !irq_is_enabled()) {
+        _flush_sync();
+        return;
+    }
+
+    mutex_lock(&_tx_lock);
+    while (1) {
+        unsigned state = irq_disable();
+        bool done = !_tx_active;
+        if (!done) {
+            _tx_waiting = true;
+        }
+        irq_restore(state);
+        if (done) {
+            break;
+        }
+        mutex_lock(&_tx_wait);
+    }
+    mutex_unlock(&_tx_lock);
+#endif
+}
+
+void stdio_uart_panic(void)
+{
+#ifdef TX_BUFFERED
+    _tx_sync = true;
+    _flush_sync();
+#endif
+}
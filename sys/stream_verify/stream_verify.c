@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_stream_verify
+ * @{
+ *
+ * @file
+ * @brief       Streaming image verification implementation
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <errno.h>
+
+#include "crypto/helper.h"
+#include "stream_verify.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+void stream_verify_init_sha256(stream_verify_t *sv, const uint8_t *digest)
+{
+    assert(digest != NULL);
+
+    sha256_init(&sv->ctx.sha256);
+    sv->type = STREAM_VERIFY_SHA256;
+    sv->expected = digest;
+    sv->cb = NULL;
+    sv->arg = NULL;
+    sv->len = 0;
+}
+
+void stream_verify_init_hmac_sha256(stream_verify_t *sv, const void *key,
+                                    size_t key_len, const uint8_t *mac)
+{
+    assert(mac != NULL);
+
+    hmac_sha256_init(&sv->ctx.hmac, key, key_len);
+    sv->type = STREAM_VERIFY_HMAC_SHA256;
+    sv->expected = mac;
+    sv->cb = NULL;
+    sv->arg = NULL;
+    sv->len = 0;
+}
+
+void stream_verify_init_signature(stream_verify_t *sv, stream_verify_cb_t cb,
+                                  void *arg)
+{
+    assert(cb != NULL);
+
+    sha256_init(&sv->ctx.sha256);
+    sv->type = STREAM_VERIFY_SIGNATURE;
+    sv->expected = NULL;
+    sv->cb = cb;
+    sv->arg = arg;
+    sv->len = 0;
+}
+
+void stream_verify_update(stream_verify_t *sv, const void *data, size_t len)
+{
+    if (sv->type == STREAM_VERIFY_HMAC_SHA256) {
+        hmac_sha256_update(&sv->ctx.hmac, data, len);
+    }
+    else {
+        sha256_update(&sv->ctx.sha256, data, len);
+    }
+    sv->len += len;
+}
+
+int stream_verify_finish(stream_verify_t *sv)
+{
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+
+    DEBUG("stream_verify: finish after %u bytes\n", (unsigned)sv->len);
+    switch (sv->type) {
+        case STREAM_VERIFY_HMAC_SHA256:
+            hmac_sha256_final(&sv->ctx.hmac, digest);
+            break;
+        default:
+            sha256_final(&sv->ctx.sha256, digest);
+            break;
+    }
+    if (sv->type == STREAM_VERIFY_SIGNATURE) {
+        return sv->cb(digest, sv->arg);
+    }
+    /* compared in constant time, not to leak how much of a MAC matched */
+    return crypto_equals(digest, (uint8_t *)sv->expected,
+                         SHA256_DIGEST_LENGTH) ? 0 : -EBADMSG;
+}
+
+#ifdef MODULE_MTD
+int stream_verify_mtd_init(stream_verify_mtd_t *w, stream_verify_t *sv,
+                           mtd_dev_t *mtd, uint32_t offset)
+{
+    uint32_t sector_size = mtd->pages_per_sector * mtd->page_size;
+
+    if (offset % sector_size) {
+        return -EINVAL;
+    }
+    w->verify = sv;
+    w->mtd = mtd;
+    w->addr = offset;
+    w->erased = offset;
+    return 0;
+}
+
+int stream_verify_mtd_write(stream_verify_mtd_t *w, const void *data,
+                            size_t len)
+{
+    mtd_dev_t *mtd = w->mtd;
+    uint32_t sector_size = mtd->pages_per_sector * mtd->page_size;
+    const uint8_t *src = data;
+    size_t left = len;
+
+    while (left) {
+        if (w->addr == w->erased) {
+            int res = mtd_erase(mtd, w->erased, sector_size);
+            if (res < 0) {
+                DEBUG("stream_verify: erase at 0x%lx: %d\n",
+                      (unsigned long)w->erased, res);
+                return res;
+            }
+            w->erased += sector_size;
+        }
+        /* writes must not cross a page boundary */
+        size_t chunk = mtd->page_size - (w->addr % mtd->page_size);
+        if (chunk > left) {
+            chunk = left;
+        }
+        int res = mtd_write(mtd, src, w->addr, chunk);
+        if (res < 0) {
+            DEBUG("stream_verify: write at 0x%lx: %d\n",
+                  (unsigned long)w->addr, res);
+            return res;
+        }
+        w->addr += chunk;
+        src += chunk;
+        left -= chunk;
+    }
+    stream_verify_update(w->verify, data, len);
+    return 0;
+}
+#endif /* MODULE_MTD */
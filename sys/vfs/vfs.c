@@ -24,6 +24,7 @@
 #include <unistd.h> /* for STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO */
 
 #include "vfs.h"
+#include "irq.h"
 #include "mutex.h"
 #include "thread.h"
 #include "kernel_types.h"
@@ -55,10 +56,41 @@ static vfs_file_t _vfs_open_files[VFS_MAX_OPEN_FILES];
  * @brief List handle for list of all currently mounted file systems
  *
  * This singly linked list is used to dispatch vfs calls to the appropriate file
- * system driver.
+ * system driver. It is sorted by decreasing length of the mount point, so the
+ * first mount point matching a path is the longest match.
  */
 static clist_node_t _vfs_mounts_list;
 
+/**
+ * @internal
+ * @brief Heads of the two lists used for path lookups
+ *
+ * Both lists hold the mounts in the order of _vfs_mounts_list, linked through
+ * vfs_mount_t::lookup_next. _find_mount() walks the list selected by the lowest
+ * bit of _mounts_gen without taking a lock. vfs_mount() and vfs_umount() build
+ * the other list and then publish it by incrementing _mounts_gen, so the list
+ * in use is never changed. A lookup that sees _mounts_gen change retries, as
+ * its list may have been rebuilt by a later update.
+ */
+static vfs_mount_t *_lookup_head[2];
+
+/**
+ * @internal
+ * @brief Generation of the mount table, incremented on every change
+ */
+static atomic_uint _mounts_gen = ATOMIC_VAR_INIT(0);
+
+/**
+ * @internal
+ * @brief Sort mounts by decreasing length of the mount point
+ */
+static int _mount_cmp(clist_node_t *a, clist_node_t *b)
+{
+    const vfs_mount_t *ma = container_of(a, vfs_mount_t, list_entry);
+    const vfs_mount_t *mb = container_of(b, vfs_mount_t, list_entry);
+    return (int)mb->mount_point_len - (int)ma->mount_point_len;
+}
+
 /**
  * @internal
  * @brief Find an unused entry in the _vfs_open_files array and mark it as used
@@ -129,8 +161,235 @@ static inline int _find_mount(vfs_mount_t **mountpp, const char *name, const cha
  */
 static inline int _fd_is_valid(int fd);
 
+/**
+ * @internal
+ * @brief Serializes mount table changes, lookups do not take it
+ */
 static mutex_t _mount_mutex = MUTEX_INIT;
-static mutex_t _open_mutex = MUTEX_INIT;
+
+/**
+ * @internal
+ * @brief Publish the current _vfs_mounts_list to _find_mount()
+ *
+ * Must be called with _mount_mutex locked.
+ */
+static void _publish_mounts(void)
+{
+    unsigned gen = atomic_load(&_mounts_gen) + 1;
+    unsigned idx = gen & 1;
+    vfs_mount_t **next = &_lookup_head[idx];
+    clist_node_t *node = _vfs_mounts_list.next;
+
+    if (node != NULL) {
+        do {
+            node = node->next;
+            vfs_mount_t *it = container_of(node, vfs_mount_t, list_entry);
+            *next = it;
+            next = &it->lookup_next[idx];
+        } while (node != _vfs_mounts_list.next);
+    }
+    *next = NULL;
+    atomic_store(&_mounts_gen, gen);
+}
+
+/**
+ * @internal
+ * @brief First fd number handed out by _allocate_fd for VFS_ANY_FD
+ *
+ * Do not auto-allocate the stdio file descriptor numbers to avoid conflicts
+ * between normal file system users and stdio drivers such as stdio_uart,
+ * stdio_rtt which need to be able to bind to these specific file descriptor
+ * numbers.
+ */
+#define _FD_FIRST_ANY   (STDERR_FILENO + 1)
+
+/**
+ * @internal
+ * @brief End of the list of free fds
+ */
+#define _FD_NONE        (UINT8_MAX)
+
+#if VFS_MAX_OPEN_FILES >= _FD_NONE
+#error "VFS_MAX_OPEN_FILES is too large for the free list of fds"
+#endif
+
+/**
+ * @internal
+ * @brief Free list of fd numbers from _FD_FIRST_ANY on
+ *
+ * _vfs_fd_next[fd] is the free fd following @p fd. The list is modified with
+ * interrupts disabled, so opening and closing files never blocks on a mutex.
+ */
+static uint8_t _vfs_fd_next[VFS_MAX_OPEN_FILES];
+static uint8_t _vfs_fd_free = _FD_NONE;
+static bool _vfs_fd_free_init;
+
+/**
+ * @internal
+ * @brief Seek in an open file without regard to its buffer
+ */
+static off_t _lseek(vfs_file_t *filp, off_t off, int whence);
+
+#ifdef MODULE_VFS_BUFFER
+/**
+ * @internal
+ * @brief Buffer of an open file
+ *
+ * A buffer holds either data to be written (@c dirty is set), or data read
+ * ahead, of which the bytes from @c pos on were not read yet.
+ */
+typedef struct {
+    uint8_t data[VFS_BUFFER_SIZE];  /**< buffered data */
+    uint16_t len;                   /**< number of bytes in data */
+    uint16_t pos;                   /**< read position in data */
+    bool dirty;                     /**< data is to be written */
+    bool used;                      /**< buffer belongs to an open file */
+} _vfs_buffer_t;
+
+/**
+ * @internal
+ * @brief Buffer pool shared by all open files
+ */
+static _vfs_buffer_t _vfs_buffers[VFS_BUFFER_NUMOF];
+
+/**
+ * @internal
+ * @brief Buffer of each entry in _vfs_open_files, NULL if not buffered
+ */
+static _vfs_buffer_t *_vfs_file_buffers[VFS_MAX_OPEN_FILES];
+
+/**
+ * @internal
+ * @brief Take a buffer from the pool for @p fd
+ *
+ * @return 0 on success
+ * @return -ENOBUFS if all buffers are in use
+ */
+static int _buffer_attach(int fd)
+{
+    unsigned state = irq_disable();
+    for (unsigned i = 0; i < VFS_BUFFER_NUMOF; i++) {
+        _vfs_buffer_t *buf = &_vfs_buffers[i];
+        if (!buf->used) {
+            buf->used = true;
+            buf->dirty = false;
+            buf->len = 0;
+            buf->pos = 0;
+            _vfs_file_buffers[fd] = buf;
+            irq_restore(state);
+            return 0;
+        }
+    }
+    irq_restore(state);
+    return -ENOBUFS;
+}
+
+/**
+ * @internal
+ * @brief Return the buffer of @p fd to the pool
+ */
+static void _buffer_detach(int fd)
+{
+    unsigned state = irq_disable();
+    if (_vfs_file_buffers[fd] != NULL) {
+        _vfs_file_buffers[fd]->used = false;
+        _vfs_file_buffers[fd] = NULL;
+    }
+    irq_restore(state);
+}
+
+/**
+ * @internal
+ * @brief Empty the buffer of @p fd
+ *
+ * Data to be written is written to the file. If data was read ahead, the
+ * file position is moved back to the first byte not read yet.
+ *
+ * @return 0 on success
+ * @return <0 on error, written data is kept in the buffer
+ */
+static int _buffer_sync(int fd)
+{
+    _vfs_buffer_t *buf = _vfs_file_buffers[fd];
+    vfs_file_t *filp = &_vfs_open_files[fd];
+    if ((buf == NULL) || (buf->len == 0)) {
+        return 0;
+    }
+    if (buf->dirty) {
+        while (buf->pos < buf->len) {
+            ssize_t res = filp->f_op->write(filp, &buf->data[buf->pos],
+                                            buf->len - buf->pos);
+            if (res <= 0) {
+                DEBUG("vfs: _buffer_sync: write: ERR %d!\n", (int)res);
+                return (res < 0) ? res : -EIO;
+            }
+            buf->pos += res;
+        }
+    }
+    else if (buf->pos < buf->len) {
+        off_t res = _lseek(filp, -(off_t)(buf->len - buf->pos), SEEK_CUR);
+        if (res < 0) {
+            DEBUG("vfs: _buffer_sync: lseek: ERR %d!\n", (int)res);
+            return res;
+        }
+    }
+    buf->dirty = false;
+    buf->len = 0;
+    buf->pos = 0;
+    return 0;
+}
+
+static ssize_t _buffer_read(int fd, void *dest, size_t count)
+{
+    _vfs_buffer_t *buf = _vfs_file_buffers[fd];
+    vfs_file_t *filp = &_vfs_open_files[fd];
+    if (buf->dirty) {
+        int res = _buffer_sync(fd);
+        if (res < 0) {
+            return res;
+        }
+    }
+    if (buf->pos == buf->len) {
+        if (count >= VFS_BUFFER_SIZE) {
+            /* nothing to gain from buffering */
+            return filp->f_op->read(filp, dest, count);
+        }
+        ssize_t res = filp->f_op->read(filp, buf->data, VFS_BUFFER_SIZE);
+        if (res <= 0) {
+            return res;
+        }
+        buf->len = res;
+        buf->pos = 0;
+    }
+    /* like read(), return fewer bytes than requested rather than reading
+     * again when the buffered data is exhausted */
+    if (count > (size_t)(buf->len - buf->pos)) {
+        count = buf->len - buf->pos;
+    }
+    memcpy(dest, &buf->data[buf->pos], count);
+    buf->pos += count;
+    return count;
+}
+
+static ssize_t _buffer_write(int fd, const void *src, size_t count)
+{
+    _vfs_buffer_t *buf = _vfs_file_buffers[fd];
+    vfs_file_t *filp = &_vfs_open_files[fd];
+    if ((!buf->dirty) || (count > (size_t)(VFS_BUFFER_SIZE - buf->len))) {
+        int res = _buffer_sync(fd);
+        if (res < 0) {
+            return res;
+        }
+        if (count >= VFS_BUFFER_SIZE) {
+            return filp->f_op->write(filp, src, count);
+        }
+    }
+    memcpy(&buf->data[buf->len], src, count);
+    buf->len += count;
+    buf->dirty = true;
+    return count;
+}
+#endif /* MODULE_VFS_BUFFER */
 
 int vfs_close(int fd)
 {
@@ -140,10 +399,15 @@ int vfs_close(int fd)
         return res;
     }
     vfs_file_t *filp = &_vfs_open_files[fd];
+#ifdef MODULE_VFS_BUFFER
+    res = _buffer_sync(fd);
+#endif
     if (filp->f_op->close != NULL) {
         /* We will invalidate the fd regardless of the outcome of the file
          * system driver close() call below */
-        res = filp->f_op->close(filp);
+        int close_res = filp->f_op->close(filp);
+        /* report the first error */
+        res = (res < 0) ? res : close_res;
     }
     _free_fd(fd);
     return res;
@@ -189,6 +453,13 @@ int vfs_fstat(int fd, struct stat *buf)
         /* driver does not implement fstat() */
         return -EINVAL;
     }
+#ifdef MODULE_VFS_BUFFER
+    /* make buffered writes count towards the file size */
+    res = _buffer_sync(fd);
+    if (res < 0) {
+        return res;
+    }
+#endif
     return filp->f_op->fstat(filp, buf);
 }
 
@@ -214,6 +485,26 @@ int vfs_fstatvfs(int fd, struct statvfs *buf)
     return filp->mp->fs->fs_op->fstatvfs(filp->mp, filp, buf);
 }
 
+int vfs_fsync(int fd)
+{
+    DEBUG("vfs_fsync: %d\n", fd);
+    int res = _fd_is_valid(fd);
+    if (res < 0) {
+        return res;
+    }
+    vfs_file_t *filp = &_vfs_open_files[fd];
+#ifdef MODULE_VFS_BUFFER
+    res = _buffer_sync(fd);
+    if (res < 0) {
+        return res;
+    }
+#endif
+    if (filp->f_op->fsync != NULL) {
+        return filp->f_op->fsync(filp);
+    }
+    return 0;
+}
+
 off_t vfs_lseek(int fd, off_t off, int whence)
 {
     DEBUG("vfs_lseek: %d, %ld, %d\n", fd, (long)off, whence);
@@ -221,7 +512,17 @@ off_t vfs_lseek(int fd, off_t off, int whence)
     if (res < 0) {
         return res;
     }
-    vfs_file_t *filp = &_vfs_open_files[fd];
+#ifdef MODULE_VFS_BUFFER
+    res = _buffer_sync(fd);
+    if (res < 0) {
+        return res;
+    }
+#endif
+    return _lseek(&_vfs_open_files[fd], off, whence);
+}
+
+static off_t _lseek(vfs_file_t *filp, off_t off, int whence)
+{
     if (filp->f_op->lseek == NULL) {
         /* driver does not implement lseek() */
         /* default seek functionality is naive */
@@ -264,9 +565,7 @@ int vfs_open(const char *name, int flags, mode_t mode)
         DEBUG("vfs_open: no matching mount\n");
         return res;
     }
-    mutex_lock(&_open_mutex);
     int fd = _init_fd(VFS_ANY_FD, mountp->fs->f_op, mountp, flags, NULL);
-    mutex_unlock(&_open_mutex);
     if (fd < 0) {
         DEBUG("vfs_open: _init_fd: ERR %d!\n", fd);
         /* remember to decrement the open_files count */
@@ -284,6 +583,10 @@ int vfs_open(const char *name, int flags, mode_t mode)
             return res;
         }
     }
+#ifdef MODULE_VFS_BUFFER
+    /* files are buffered as long as buffers are left */
+    _buffer_attach(fd);
+#endif
     DEBUG("vfs_open: opened %d\n", fd);
     return fd;
 }
@@ -307,6 +610,11 @@ ssize_t vfs_read(int fd, void *dest, size_t count)
         /* driver does not implement read() */
         return -EINVAL;
     }
+#ifdef MODULE_VFS_BUFFER
+    if (_vfs_file_buffers[fd] != NULL) {
+        return _buffer_read(fd, dest, count);
+    }
+#endif
     return filp->f_op->read(filp, dest, count);
 }
 
@@ -330,6 +638,11 @@ ssize_t vfs_write(int fd, const void *src, size_t count)
         /* driver does not implement write() */
         return -EINVAL;
     }
+#ifdef MODULE_VFS_BUFFER
+    if (_vfs_file_buffers[fd] != NULL) {
+        return _buffer_write(fd, src, count);
+    }
+#endif
     return filp->f_op->write(filp, src, count);
 }
 
@@ -481,8 +794,11 @@ int vfs_mount(vfs_mount_t *mountp)
             }
         }
     }
-    /* insert last in list */
-    clist_rpush(&_vfs_mounts_list, &mountp->list_entry);
+    /* insert sorted, the sort is stable so the newest of several mounts with
+     * the same mount point length is found first, like before */
+    clist_lpush(&_vfs_mounts_list, &mountp->list_entry);
+    clist_sort(&_vfs_mounts_list, _mount_cmp);
+    _publish_mounts();
     mutex_unlock(&_mount_mutex);
     DEBUG("vfs_mount: mount done\n");
     return 0;
@@ -510,17 +826,6 @@ int vfs_umount(vfs_mount_t *mountp)
         mutex_unlock(&_mount_mutex);
         return -EBUSY;
     }
-    if (mountp->fs->fs_op != NULL) {
-        if (mountp->fs->fs_op->umount != NULL) {
-            int res = mountp->fs->fs_op->umount(mountp);
-            if (res < 0) {
-                /* umount failed */
-                DEBUG("vfs_umount: ERR %d!\n", res);
-                mutex_unlock(&_mount_mutex);
-                return res;
-            }
-        }
-    }
     /* find mountp in the list and remove it */
     clist_node_t *node = clist_remove(&_vfs_mounts_list, &mountp->list_entry);
     if (node == NULL) {
@@ -529,8 +834,25 @@ int vfs_umount(vfs_mount_t *mountp)
         mutex_unlock(&_mount_mutex);
         return -EINVAL;
     }
+    _publish_mounts();
+    /* a lookup that took a reference before the mount was unpublished holds
+     * it now; one that took it after sees the new generation and drops it */
+    int res = 0;
+    if (atomic_load(&mountp->open_files) > 0) {
+        res = -EBUSY;
+    }
+    else if ((mountp->fs->fs_op != NULL) && (mountp->fs->fs_op->umount != NULL)) {
+        res = mountp->fs->fs_op->umount(mountp);
+        DEBUG("vfs_umount: umount returned %d\n", res);
+    }
+    if (res < 0) {
+        /* still mounted */
+        clist_lpush(&_vfs_mounts_list, &mountp->list_entry);
+        clist_sort(&_vfs_mounts_list, _mount_cmp);
+        _publish_mounts();
+    }
     mutex_unlock(&_mount_mutex);
-    return 0;
+    return res;
 }
 
 int vfs_rename(const char *from_path, const char *to_path)
@@ -766,9 +1088,7 @@ int vfs_bind(int fd, int flags, const vfs_file_ops_t *f_op, void *private_data)
     if (f_op == NULL) {
         return -EINVAL;
     }
-    mutex_lock(&_open_mutex);
     fd = _init_fd(fd, f_op, NULL, flags, private_data);
-    mutex_unlock(&_open_mutex);
     if (fd < 0) {
         DEBUG("vfs_bind: _init_fd: ERR %d!\n", fd);
         return fd;
@@ -777,6 +1097,32 @@ int vfs_bind(int fd, int flags, const vfs_file_ops_t *f_op, void *private_data)
     return fd;
 }
 
+int vfs_setbuf(int fd, bool enable)
+{
+    DEBUG("vfs_setbuf: %d, %d\n", fd, (int)enable);
+    int res = _fd_is_valid(fd);
+    if (res < 0) {
+        return res;
+    }
+#ifdef MODULE_VFS_BUFFER
+    if (enable) {
+        if (_vfs_file_buffers[fd] == NULL) {
+            res = _buffer_attach(fd);
+        }
+    }
+    else {
+        res = _buffer_sync(fd);
+        if (res == 0) {
+            _buffer_detach(fd);
+        }
+    }
+    return res;
+#else
+    (void)enable;
+    return -ENOTSUP;
+#endif
+}
+
 int vfs_normalize_path(char *buf, const char *path, size_t buflen)
 {
     DEBUG("vfs_normalize_path: %p, \"%s\" (%p), %lu\n",
@@ -866,35 +1212,48 @@ const vfs_mount_t *vfs_iterate_mounts(const vfs_mount_t *cur)
 
 static inline int _allocate_fd(int fd)
 {
-    if (fd < 0) {
-        for (fd = 0; fd < VFS_MAX_OPEN_FILES; ++fd) {
-            if ((fd == STDIN_FILENO) || (fd == STDOUT_FILENO) || (fd == STDERR_FILENO)) {
-                /* Do not auto-allocate the stdio file descriptor numbers to
-                 * avoid conflicts between normal file system users and stdio
-                 * drivers such as stdio_uart, stdio_rtt which need to be able
-                 * to bind to these specific file descriptor numbers. */
-                continue;
-            }
-            if (_vfs_open_files[fd].pid == KERNEL_PID_UNDEF) {
-                break;
-            }
-        }
+    kernel_pid_t pid = thread_getpid();
+    if (pid == KERNEL_PID_UNDEF) {
+        /* This happens when calling vfs_bind during boot, before threads have
+         * been started. */
+        pid = -1;
     }
     if (fd >= VFS_MAX_OPEN_FILES) {
-        /* The _vfs_open_files array is full */
         return -ENFILE;
     }
+    unsigned state = irq_disable();
+    if (!_vfs_fd_free_init) {
+        /* lowest numbers first, like the linear search this replaces */
+        for (int i = VFS_MAX_OPEN_FILES - 1; i >= _FD_FIRST_ANY; i--) {
+            _vfs_fd_next[i] = _vfs_fd_free;
+            _vfs_fd_free = i;
+        }
+        _vfs_fd_free_init = true;
+    }
+    if (fd < 0) {
+        if (_vfs_fd_free == _FD_NONE) {
+            /* The _vfs_open_files array is full */
+            irq_restore(state);
+            return -ENFILE;
+        }
+        fd = _vfs_fd_free;
+        _vfs_fd_free = _vfs_fd_next[fd];
+    }
     else if (_vfs_open_files[fd].pid != KERNEL_PID_UNDEF) {
         /* The desired fd is already in use */
+        irq_restore(state);
         return -EEXIST;
     }
-    kernel_pid_t pid = thread_getpid();
-    if (pid == KERNEL_PID_UNDEF) {
-        /* This happens when calling vfs_bind during boot, before threads have
-         * been started. */
-        pid = -1;
+    else if (fd >= _FD_FIRST_ANY) {
+        /* explicitly requested fds have to be unlinked from the free list */
+        uint8_t *prev = &_vfs_fd_free;
+        while (*prev != fd) {
+            prev = &_vfs_fd_next[*prev];
+        }
+        *prev = _vfs_fd_next[fd];
     }
     _vfs_open_files[fd].pid = pid;
+    irq_restore(state);
     return fd;
 }
 
@@ -904,7 +1263,16 @@ static inline void _free_fd(int fd)
     if (_vfs_open_files[fd].mp != NULL) {
         atomic_fetch_sub(&_vfs_open_files[fd].mp->open_files, 1);
     }
+#ifdef MODULE_VFS_BUFFER
+    _buffer_detach(fd);
+#endif
+    unsigned state = irq_disable();
     _vfs_open_files[fd].pid = KERNEL_PID_UNDEF;
+    if (fd >= _FD_FIRST_ANY) {
+        _vfs_fd_next[fd] = _vfs_fd_free;
+        _vfs_fd_free = fd;
+    }
+    irq_restore(state);
 }
 
 static inline int _init_fd(int fd, const vfs_file_ops_t *f_op, vfs_mount_t *mountp, int flags, void *private_data)
@@ -922,55 +1290,55 @@ static inline int _init_fd(int fd, const vfs_file_ops_t *f_op, vfs_mount_t *moun
     return fd;
 }
 
+static inline bool _mount_matches(const vfs_mount_t *mountp, const char *name,
+                                  size_t name_len)
+{
+    size_t len = mountp->mount_point_len;
+    if (len > name_len) {
+        /* path name is shorter than the mount point name */
+        return false;
+    }
+    if ((len > 1) && (name[len] != '/') && (name[len] != '\0')) {
+        /* name does not have a directory separator where mount point name ends */
+        return false;
+    }
+    return (strncmp(name, mountp->mount_point, len) == 0);
+}
+
 static inline int _find_mount(vfs_mount_t **mountpp, const char *name, const char **rel_path)
 {
-    size_t longest_match = 0;
     size_t name_len = strlen(name);
-    mutex_lock(&_mount_mutex);
+    vfs_mount_t *mountp;
+    unsigned gen;
 
-    clist_node_t *node = _vfs_mounts_list.next;
-    if (node == NULL) {
-        /* list empty */
-        mutex_unlock(&_mount_mutex);
-        return -ENOENT;
-    }
-    vfs_mount_t *mountp = NULL;
-    do {
-        node = node->next;
-        vfs_mount_t *it = container_of(node, vfs_mount_t, list_entry);
-        size_t len = it->mount_point_len;
-        if (len < longest_match) {
-            /* Already found a longer prefix */
-            continue;
-        }
-        if (len > name_len) {
-            /* path name is shorter than the mount point name */
-            continue;
-        }
-        if ((len > 1) && (name[len] != '/') && (name[len] != '\0')) {
-            /* name does not have a directory separator where mount point name ends */
-            continue;
-        }
-        if (strncmp(name, it->mount_point, len) == 0) {
-            /* mount_point is a prefix of name */
-            /* special check for mount_point == "/" */
-            if (len > 1) {
-                longest_match = len;
-            }
-            mountp = it;
+retry:
+    gen = atomic_load(&_mounts_gen);
+    mountp = _lookup_head[gen & 1];
+    /* the first match is the longest one, as the list is sorted */
+    while ((mountp != NULL) && !_mount_matches(mountp, name, name_len)) {
+        mountp = mountp->lookup_next[gen & 1];
+        if (atomic_load(&_mounts_gen) != gen) {
+            /* the list may be rebuilt under our feet */
+            goto retry;
         }
-    } while (node != _vfs_mounts_list.next);
+    }
     if (mountp == NULL) {
-        /* not found */
-        mutex_unlock(&_mount_mutex);
+        if (atomic_load(&_mounts_gen) != gen) {
+            goto retry;
+        }
         return -ENOENT;
     }
-    /* Increment open files counter for this mount */
+    /* Increment open files counter for this mount, it only counts if the
+     * mount was still published afterwards, see vfs_umount() */
     atomic_fetch_add(&mountp->open_files, 1);
-    mutex_unlock(&_mount_mutex);
+    if (atomic_load(&_mounts_gen) != gen) {
+        atomic_fetch_sub(&mountp->open_files, 1);
+        goto retry;
+    }
     *mountpp = mountp;
     if (rel_path != NULL) {
-        *rel_path = name + longest_match;
+        /* special check for mount_point == "/" */
+        *rel_path = name + ((mountp->mount_point_len > 1) ? mountp->mount_point_len : 0);
     }
     return 0;
 }
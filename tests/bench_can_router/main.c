@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measure CAN frames dispatched by the CAN router per second
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "thread.h"
+#include "msg.h"
+#include "xtimer.h"
+
+#include "can/can.h"
+#include "can/common.h"
+#include "can/pkt.h"
+#include "can/raw.h"
+#include "can/router.h"
+
+#ifndef TEST_DURATION
+#define TEST_DURATION       (1000000U)
+#endif
+
+#ifndef FILTER_NUMOF
+#define FILTER_NUMOF        (200U)
+#endif
+
+#ifndef RANGE_NUMOF
+#define RANGE_NUMOF         (4U)
+#endif
+
+#ifndef RECEIVER_NUMOF
+#define RECEIVER_NUMOF      (2U)
+#endif
+
+#define RECEIVER_QUEUE_SIZE (8U)
+#define RANGE_MASK          (0x700)
+#define IFNUM               (0)
+
+volatile unsigned _flag = 0;
+static uint32_t _delivered = 0;
+static char _stacks[RECEIVER_NUMOF][THREAD_STACKSIZE_MAIN];
+static kernel_pid_t _receivers[RECEIVER_NUMOF];
+
+static void _timer_callback(void*arg)
+{
+    (void)arg;
+
+    _flag = 1;
+}
+
+static void *_receiver(void *arg)
+{
+    (void)arg;
+    msg_t queue[RECEIVER_QUEUE_SIZE];
+    msg_t msg;
+
+    msg_init_queue(queue, RECEIVER_QUEUE_SIZE);
+    while (1) {
+        msg_receive(&msg);
+        if (msg.type == CAN_MSG_RX_INDICATION) {
+            _delivered++;
+            raw_can_free_frame(msg.content.ptr);
+        }
+    }
+
+    return NULL;
+}
+
+static void _register(unsigned idx, canid_t can_id, canid_t mask)
+{
+    can_reg_entry_t entry = { .ifnum = IFNUM,
+                              .target.pid = _receivers[idx % RECEIVER_NUMOF] };
+
+#ifdef MODULE_CAN_MBOX
+    entry.type = CAN_TYPE_DEFAULT;
+#endif
+    if (can_router_register(&entry, can_id, mask, NULL) < 0) {
+        printf("unable to register filter 0x%03x/0x%03x\n",
+               (unsigned)can_id, (unsigned)mask);
+    }
+}
+
+int main(void)
+{
+    printf("main starting\n");
+
+    for (unsigned i = 0; i < RECEIVER_NUMOF; i++) {
+        _receivers[i] = thread_create(_stacks[i], sizeof(_stacks[i]),
+                                      (THREAD_PRIORITY_MAIN - 1),
+                                      THREAD_CREATE_STACKTEST,
+                                      _receiver, NULL, "receiver");
+    }
+    for (unsigned i = 0; i < FILTER_NUMOF; i++) {
+        _register(i, i & CAN_SFF_MASK, CAN_SFF_MASK);
+    }
+    for (unsigned i = 0; i < RANGE_NUMOF; i++) {
+        _register(i, (i << 8) & RANGE_MASK, RANGE_MASK);
+    }
+
+    xtimer_t timer;
+    timer.callback = _timer_callback;
+
+    struct can_frame frame = { .can_dlc = 8 };
+
+    uint32_t n = 0;
+
+    xtimer_set(&timer, TEST_DURATION);
+    while(!_flag) {
+        /* cycle through registered and unregistered IDs */
+        frame.can_id = n % (2 * FILTER_NUMOF);
+
+        can_pkt_t *pkt = can_pkt_alloc_rx(IFNUM, &frame);
+        if (!pkt) {
+            puts("out of packet buffer");
+            break;
+        }
+        can_router_dispatch_rx_indic(pkt);
+        n++;
+    }
+
+    printf("{ \"result\" : %"PRIu32", \"delivered\" : %"PRIu32" }\n",
+           n, _delivered);
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief Memory and switch latency of threads, executors and coroutines
+ *
+ * @}
+ */
+
+#include <cstdio>
+#include <malloc.h>
+
+#include "mutex.h"
+#include "xtimer.h"
+
+#include "riot/mutex.hpp"
+#include "riot/thread.hpp"
+#include "riot/condition_variable.hpp"
+#include "riot/executor.hpp"
+#include "riot/task.hpp"
+
+#ifndef TASKS_NUMOF
+#define TASKS_NUMOF (4U)
+#endif
+
+#ifndef ROUNDS
+#define ROUNDS      (10000U)
+#endif
+
+#define WORKERS     (2U)
+
+using namespace riot;
+
+namespace {
+
+mutex mtx;
+condition_variable cv;
+bool released;
+unsigned turn;
+
+/* newlib and glibc both provide mallinfo(), glibc deprecates it */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+unsigned heap_used() {
+  return mallinfo().uordblks;
+}
+#pragma GCC diagnostic pop
+
+/* blocks until release() is called */
+void gate() {
+  unique_lock<mutex> lk(mtx);
+  while (!released) {
+    cv.wait(lk);
+  }
+}
+
+void release() {
+  lock_guard<mutex> lk(mtx);
+  released = true;
+  cv.notify_all();
+}
+
+void print(const char* name, unsigned heap, uint32_t us) {
+  printf("%s: %u bytes heap per task, %u us for %u switches\n", name,
+         heap / TASKS_NUMOF, static_cast<unsigned>(us), 2 * ROUNDS);
+}
+
+void bench_thread() {
+  thread threads[TASKS_NUMOF];
+
+  released = false;
+  unsigned before = heap_used();
+  for (auto& t : threads) {
+    t = thread(gate);
+  }
+  unsigned heap = heap_used() - before;
+  release();
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  /* the thread waits for turn 1, main for turn 0 */
+  turn = 0;
+  thread t([] {
+    for (unsigned i = 0; i < ROUNDS; i++) {
+      unique_lock<mutex> lk(mtx);
+      while (turn != 1) {
+        cv.wait(lk);
+      }
+      turn = 0;
+      cv.notify_one();
+    }
+  });
+  uint32_t start = xtimer_now_usec();
+  for (unsigned i = 0; i < ROUNDS; i++) {
+    unique_lock<mutex> lk(mtx);
+    turn = 1;
+    cv.notify_one();
+    while (turn != 0) {
+      cv.wait(lk);
+    }
+  }
+  uint32_t us = xtimer_now_usec() - start;
+  t.join();
+  print("thread", heap, us);
+}
+
+unsigned bench_executor() {
+  static static_executor<WORKERS, TASKS_NUMOF> ex;
+
+  released = false;
+  unsigned before = heap_used();
+  for (unsigned i = 0; i < TASKS_NUMOF; i++) {
+    ex.post(gate);
+  }
+  unsigned heap = heap_used() - before;
+  release();
+  ex.wait_idle();
+
+  /* every round switches to a worker and back */
+  uint32_t start = xtimer_now_usec();
+  for (unsigned i = 0; i < ROUNDS; i++) {
+    ex.post([] {});
+    ex.wait_idle();
+  }
+  uint32_t us = xtimer_now_usec() - start;
+  printf("executor: %u bytes heap per task, %u bytes per job slot, "
+         "%u us for %u switches\n", heap / TASKS_NUMOF,
+         static_cast<unsigned>(sizeof(detail::job_slot<4 * sizeof(void*)>)),
+         static_cast<unsigned>(us), 2 * ROUNDS);
+  return (ROUNDS * US_PER_SEC) / ((us) ? us : 1);
+}
+
+#ifdef __cpp_impl_coroutine
+char loop_stack[THREAD_STACKSIZE_MAIN];
+loop* the_loop;
+/* unlocked by the loop thread when the loop is ready and after each run */
+mutex_t loop_done = MUTEX_INIT_LOCKED;
+unsigned finished;
+
+void* loop_thread(void*) {
+  loop l;
+  the_loop = &l;
+  mutex_unlock(&loop_done);
+  l.run();
+}
+
+task<> sleeper(loop& l) {
+  co_await l.sleep_for(std::chrono::milliseconds(100));
+}
+
+task<> yielder(loop& l) {
+  for (unsigned i = 0; i < ROUNDS; i++) {
+    co_await l.yield();
+  }
+  if (++finished == 2) {
+    mutex_unlock(&loop_done);
+  }
+}
+
+void bench_coroutine() {
+  thread_create(loop_stack, sizeof(loop_stack), THREAD_PRIORITY_MAIN - 1,
+                THREAD_CREATE_STACKTEST, loop_thread, nullptr, "loop");
+  mutex_lock(&loop_done);
+
+  unsigned before = heap_used();
+  for (unsigned i = 0; i < TASKS_NUMOF; i++) {
+    the_loop->spawn(sleeper(*the_loop));
+  }
+  unsigned heap = heap_used() - before;
+  xtimer_usleep(200U * US_PER_MS);
+
+  /* two coroutines taking turns on the loop */
+  uint32_t start = xtimer_now_usec();
+  the_loop->spawn(yielder(*the_loop));
+  the_loop->spawn(yielder(*the_loop));
+  mutex_lock(&loop_done);
+  uint32_t us = xtimer_now_usec() - start;
+  print("coroutine", heap, us);
+}
+#else
+void bench_coroutine() {
+  puts("coroutine: not supported by the compiler");
+}
+#endif
+
+} // namespace
+
+int main() {
+  printf("tasks: %u, rounds: %u\n", TASKS_NUMOF, ROUNDS);
+
+  bench_thread();
+  unsigned result = bench_executor();
+  bench_coroutine();
+
+  printf("{ \"result\" : %u }\n", result);
+  return 0;
+}
@@ -0,0 +1,25 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+def testfunc(child):
+    child.expect(r"tasks: \d+, rounds: \d+")
+    child.expect(r"thread: \d+ bytes heap per task, \d+ us for \d+ switches")
+    child.expect(r"executor: \d+ bytes heap per task, \d+ bytes per job slot, "
+                 r"\d+ us for \d+ switches")
+    idx = child.expect([r"coroutine: \d+ bytes heap per task, "
+                        r"\d+ us for \d+ switches",
+                        r"coroutine: not supported by the compiler"])
+    child.expect(r"{ \"result\" : \d+ }")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       emCute QoS 1 publish throughput benchmark
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "net/emcute.h"
+#include "net/ipv6/addr.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#ifndef GW_RTT
+#define GW_RTT          (2000U)     /**< emulated round trip time in us */
+#endif
+
+#ifndef TOPICS_NUMOF
+#define TOPICS_NUMOF    (8U)
+#endif
+
+#ifndef PUB_NUMOF
+#define PUB_NUMOF       (500U)
+#endif
+
+#define PAYLOAD_LEN     (32U)
+#define GW_PORT         (EMCUTE_DEFAULT_PORT + 1)
+/* enough for all acknowledgments of a full window and the registrations */
+#define GW_QUEUE_SIZE   (EMCUTE_WINDOW_SIZE + TOPICS_NUMOF)
+
+/* MQTT-SN message types */
+enum {
+    CONNECT     = 0x04,
+    CONNACK     = 0x05,
+    REGISTER    = 0x0a,
+    REGACK      = 0x0b,
+    PUBLISH     = 0x0c,
+    PUBACK      = 0x0d,
+    DISCONNECT  = 0x18,
+};
+
+typedef struct {
+    uint32_t due;
+    uint8_t len;
+    uint8_t buf[7];
+} reply_t;
+
+static char _emcute_stack[THREAD_STACKSIZE_DEFAULT];
+static char _gw_stack[THREAD_STACKSIZE_DEFAULT];
+
+static reply_t _replies[GW_QUEUE_SIZE];
+static unsigned _replies_head, _replies_numof;
+static unsigned _acked;
+
+static emcute_topic_t _topics[TOPICS_NUMOF];
+static char _topic_names[TOPICS_NUMOF][sizeof("bench/00")];
+
+static void *_emcute_thread(void *arg)
+{
+    (void)arg;
+    emcute_run(EMCUTE_DEFAULT_PORT, "bench");
+    return NULL;
+}
+
+static reply_t *_reply(uint8_t len, uint8_t type)
+{
+    if (_replies_numof == GW_QUEUE_SIZE) {
+        puts("gateway: queue overflow");
+        return NULL;
+    }
+
+    reply_t *reply = &_replies[(_replies_head + _replies_numof++)
+                               % GW_QUEUE_SIZE];
+
+    /* all replies have the same delay, so they are due in FIFO order */
+    reply->due = xtimer_now_usec() + GW_RTT;
+    reply->len = len;
+    reply->buf[0] = len;
+    reply->buf[1] = type;
+    return reply;
+}
+
+static void _handle(uint8_t *buf, size_t len)
+{
+    static uint16_t topic_id;
+    reply_t *reply;
+
+    if ((len < 2) || (buf[0] == 0x01)) {
+        /* all messages of the benchmark have a 1 byte length field */
+        return;
+    }
+    switch (buf[1]) {
+        case CONNECT:
+            if ((reply = _reply(3, CONNACK))) {
+                reply->buf[2] = 0;
+            }
+            break;
+        case REGISTER:
+            if ((len >= 6) && (reply = _reply(7, REGACK))) {
+                byteorder_htobebufs(&reply->buf[2], ++topic_id);
+                memcpy(&reply->buf[4], &buf[4], 2);     /* message ID */
+                reply->buf[6] = 0;
+            }
+            break;
+        case PUBLISH:
+            if ((len >= 7) && (buf[2] & EMCUTE_QOS_1) &&
+                (reply = _reply(7, PUBACK))) {
+                memcpy(&reply->buf[2], &buf[3], 4);     /* topic and msg ID */
+                reply->buf[6] = 0;
+                _acked++;
+            }
+            break;
+        case DISCONNECT:
+            _reply(2, DISCONNECT);
+            break;
+        default:
+            break;
+    }
+}
+
+static void *_gw_thread(void *arg)
+{
+    static uint8_t buf[EMCUTE_BUFSIZE];
+    sock_udp_ep_t local = { .family = AF_INET6, .port = GW_PORT };
+    sock_udp_ep_t client;
+    sock_udp_t sock;
+
+    (void)arg;
+    sock_udp_create(&sock, &local, NULL, 0);
+    while (1) {
+        uint32_t timeout = SOCK_NO_TIMEOUT;
+
+        if (_replies_numof > 0) {
+            int32_t diff = _replies[_replies_head].due - xtimer_now_usec();
+            timeout = (diff > 0) ? (uint32_t)diff : 0;
+        }
+
+        ssize_t res = sock_udp_recv(&sock, buf, sizeof(buf), timeout,
+                                    &client);
+        if (res > 0) {
+            _handle(buf, res);
+        }
+
+        /* send all due replies */
+        while ((_replies_numof > 0) &&
+               ((int32_t)(_replies[_replies_head].due - xtimer_now_usec())
+                <= 0)) {
+            reply_t *reply = &_replies[_replies_head];
+
+            sock_udp_send(&sock, reply->buf, reply->len, &client);
+            _replies_head = (_replies_head + 1) % GW_QUEUE_SIZE;
+            _replies_numof--;
+        }
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    sock_udp_ep_t gw = { .family = AF_INET6, .port = GW_PORT };
+    uint8_t payload[PAYLOAD_LEN];
+    uint32_t start, reg_time, pub_time;
+    int res;
+
+    memcpy(gw.addr.ipv6, &ipv6_addr_loopback, sizeof(gw.addr.ipv6));
+    memset(payload, 0xaa, sizeof(payload));
+
+    thread_create(_gw_stack, sizeof(_gw_stack), THREAD_PRIORITY_MAIN - 2,
+                  THREAD_CREATE_STACKTEST, _gw_thread, NULL, "gateway");
+    thread_create(_emcute_stack, sizeof(_emcute_stack),
+                  THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
+                  _emcute_thread, NULL, "emcute");
+
+    printf("window: %u, rtt: %u us\n", EMCUTE_WINDOW_SIZE, GW_RTT);
+
+    if ((res = emcute_con(&gw, true, NULL, NULL, 0, 0)) != EMCUTE_OK) {
+        printf("error: unable to connect (%d)\n", res);
+        return 1;
+    }
+
+    for (unsigned i = 0; i < TOPICS_NUMOF; i++) {
+        snprintf(_topic_names[i], sizeof(_topic_names[i]), "bench/%02u", i);
+        _topics[i].name = _topic_names[i];
+    }
+    start = xtimer_now_usec();
+    res = emcute_reg_multi(_topics, TOPICS_NUMOF);
+    reg_time = xtimer_now_usec() - start;
+    if (res != EMCUTE_OK) {
+        printf("error: unable to register topics (%d)\n", res);
+        return 1;
+    }
+    printf("registered %u topics in %u us\n", TOPICS_NUMOF,
+           (unsigned)reg_time);
+
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < PUB_NUMOF; i++) {
+        res = emcute_pub(&_topics[i % TOPICS_NUMOF], payload, sizeof(payload),
+                         EMCUTE_QOS_1);
+        if (res != EMCUTE_OK) {
+            printf("error: unable to publish (%d)\n", res);
+            return 1;
+        }
+    }
+    res = emcute_flush();
+    pub_time = xtimer_now_usec() - start;
+    printf("published %u messages in %u us, %u acknowledged\n", PUB_NUMOF,
+           (unsigned)pub_time, _acked);
+    if (res != EMCUTE_OK) {
+        printf("error: %d\n", res);
+    }
+
+    emcute_discon();
+
+    printf("{ \"result\" : %u }\n",
+           (unsigned)(((uint64_t)PUB_NUMOF * US_PER_SEC) / pub_time));
+    return 0;
+}
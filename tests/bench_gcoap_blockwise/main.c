@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark of block-wise transfers with gcoap
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "net/gcoap.h"
+#include "net/ipv6/addr.h"
+#include "xtimer.h"
+
+#ifndef RESOURCE_SIZE
+#define RESOURCE_SIZE       (8192U)
+#endif
+
+#ifndef ROUNDS
+#define ROUNDS              (4U)
+#endif
+
+#define PATH_DATA           "/data"
+#define PATH_STREAM         "/stream"
+
+static mutex_t _done = MUTEX_INIT_LOCKED;
+static size_t _received;
+static unsigned _errors;
+static sock_udp_ep_t _remote = {
+    .family = AF_INET6,
+    .netif  = SOCK_ADDR_ANY_NETIF,
+    .port   = GCOAP_PORT,
+};
+
+static uint8_t _pattern(size_t offset)
+{
+    return (uint8_t)(offset ^ (offset >> 8));
+}
+
+static ssize_t _read(void *arg, size_t offset, void *buf, size_t len)
+{
+    (void)arg;
+    uint8_t *out = buf;
+    size_t i;
+
+    for (i = 0; (i < len) && (offset + i < RESOURCE_SIZE); i++) {
+        out[i] = _pattern(offset + i);
+    }
+    return i;
+}
+
+static ssize_t _write(void *arg, size_t offset, const void *buf, size_t len,
+                      bool more)
+{
+    (void)arg;
+    (void)more;
+    const uint8_t *in = buf;
+
+    for (size_t i = 0; i < len; i++) {
+        if (in[i] != _pattern(offset + i)) {
+            return -EINVAL;
+        }
+    }
+    return len;
+}
+
+static size_t _size(void *arg)
+{
+    (void)arg;
+    return RESOURCE_SIZE;
+}
+
+static gcoap_block_resource_t _data = {
+    .read   = _read,
+    .write  = _write,
+    .size   = _size,
+    .format = COAP_FORMAT_OCTET,
+};
+
+/* without size, the end is found by reading ahead */
+static gcoap_block_resource_t _stream = {
+    .read   = _read,
+    .format = COAP_FORMAT_OCTET,
+};
+
+static const coap_resource_t _resources[] = {
+    { PATH_DATA, COAP_GET | COAP_PUT, gcoap_block_handler, &_data },
+    { PATH_STREAM, COAP_GET, gcoap_block_handler, &_stream },
+};
+
+static gcoap_listener_t _listener = {
+    &_resources[0],
+    sizeof(_resources) / sizeof(_resources[0]),
+    NULL
+};
+
+static void _get_handler(unsigned req_state, coap_pkt_t *pdu,
+                         sock_udp_ep_t *remote)
+{
+    (void)remote;
+    coap_block1_t block;
+
+    if ((req_state != GCOAP_MEMO_RESP)
+            || (coap_get_code_class(pdu) != COAP_CLASS_SUCCESS)) {
+        _errors++;
+        mutex_unlock(&_done);
+        return;
+    }
+    coap_get_block2(pdu, &block);
+    for (unsigned i = 0; i < pdu->payload_len; i++) {
+        if (pdu->payload[i] != _pattern(block.offset + i)) {
+            _errors++;
+            break;
+        }
+    }
+    /* blocks may arrive out of order, so the last one is not the end */
+    _received += pdu->payload_len;
+    if (_received == RESOURCE_SIZE) {
+        mutex_unlock(&_done);
+    }
+}
+
+static void _put_handler(unsigned req_state, coap_pkt_t *pdu,
+                         sock_udp_ep_t *remote)
+{
+    (void)remote;
+
+    if ((req_state != GCOAP_MEMO_RESP)
+            || (coap_get_code_class(pdu) != COAP_CLASS_SUCCESS)) {
+        _errors++;
+    }
+    mutex_unlock(&_done);
+}
+
+static void _get(const char *path, unsigned type)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+
+    _received = 0;
+    gcoap_req_init(&pdu, buf, sizeof(buf), COAP_METHOD_GET, path);
+    coap_hdr_set_type(pdu.hdr, type);
+    if (type == COAP_TYPE_NON) {
+        /* a non-confirmable request is only continued when asked for */
+        gcoap_add_block2(&pdu, 0, GCOAP_BLOCK_SZX, false);
+    }
+    ssize_t len = gcoap_finish(&pdu, 0, COAP_FORMAT_NONE);
+    if ((len <= 0) || !gcoap_req_send2(buf, len, &_remote, _get_handler)) {
+        puts("send [FAILED]");
+        _errors++;
+        return;
+    }
+    mutex_lock(&_done);
+}
+
+static void _put(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    unsigned szx = GCOAP_BLOCK_SZX;
+    size_t offset = 0;
+
+    while (offset < RESOURCE_SIZE) {
+        gcoap_req_init(&pdu, buf, sizeof(buf), COAP_METHOD_PUT, PATH_DATA);
+        while (szx && (coap_szx2size(szx) > pdu.payload_len)) {
+            szx--;
+        }
+        size_t blksize = coap_szx2size(szx);
+        size_t n = _read(NULL, offset, pdu.payload, blksize);
+        gcoap_add_block1(&pdu, offset / blksize, szx,
+                         (offset + n < RESOURCE_SIZE));
+        ssize_t len = gcoap_finish(&pdu, n, COAP_FORMAT_OCTET);
+        if ((len <= 0) || !gcoap_req_send2(buf, len, &_remote, _put_handler)) {
+            puts("send [FAILED]");
+            _errors++;
+            return;
+        }
+        mutex_lock(&_done);
+        offset += n;
+    }
+}
+
+static unsigned _bench(const char *mode, const char *path, unsigned type)
+{
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        if (path) {
+            _get(path, type);
+        }
+        else {
+            _put();
+        }
+    }
+
+    uint32_t us = xtimer_now_usec() - start;
+    unsigned rate = (unsigned)(((uint64_t)ROUNDS * RESOURCE_SIZE * US_PER_SEC) /
+                               ((us) ? us : 1));
+    printf("%s: %u us (%u bytes/s)\n", mode, (unsigned)us, rate);
+    return rate;
+}
+
+int main(void)
+{
+    memcpy(&_remote.addr.ipv6[0], &ipv6_addr_loopback, sizeof(ipv6_addr_t));
+    gcoap_register_listener(&_listener);
+
+    printf("resource: %u bytes, blocks: %u bytes, window: %u\n",
+           RESOURCE_SIZE, coap_szx2size(GCOAP_BLOCK_SZX),
+           (unsigned)GCOAP_BLOCK2_WINDOW);
+
+    _bench("con", PATH_DATA, COAP_TYPE_CON);
+    _bench("non stream", PATH_STREAM, COAP_TYPE_NON);
+    unsigned result = _bench("non window", PATH_DATA, COAP_TYPE_NON);
+    _bench("put", NULL, COAP_TYPE_NON);
+
+    if (_errors) {
+        printf("%u errors [FAILED]\n", _errors);
+        return 1;
+    }
+    printf("{ \"result\" : %u }\n", result);
+    return 0;
+}
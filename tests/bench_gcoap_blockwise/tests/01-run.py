@@ -0,0 +1,21 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+def testfunc(child):
+    child.expect(r"resource: \d+ bytes, blocks: \d+ bytes, window: \d+")
+    for mode in ("con", "non stream", "non window", "put"):
+        child.expect(r"{}: \d+ us \(\d+ bytes/s\)".format(mode))
+    child.expect(r"{ \"result\" : \d+ }")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc, timeout=120))
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Throughput of SHA-256
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "hashes/sha256.h"
+#include "xtimer.h"
+
+#ifndef BUF_SIZE
+#define BUF_SIZE            (1024U)
+#endif
+
+#ifndef ROUNDS
+#define ROUNDS              (64U)
+#endif
+
+#ifndef CHAIN_LENGTH
+#define CHAIN_LENGTH        (1024U)
+#endif
+
+static uint8_t _buf[SHA256_MULTI_LANES][BUF_SIZE];
+static uint8_t _digest[SHA256_MULTI_LANES][SHA256_DIGEST_LENGTH];
+
+static unsigned _report(const char *name, uint32_t start, uint32_t bytes)
+{
+    uint32_t us = xtimer_now_usec() - start;
+    unsigned rate = (unsigned)(((uint64_t)bytes * US_PER_SEC / 1024) /
+                               ((us) ? us : 1));
+
+    printf("%s: %u us (%u KiB/s)\n", name, (unsigned)us, rate);
+    return rate;
+}
+
+int main(void)
+{
+    const void *data[SHA256_MULTI_LANES];
+    void *digest[SHA256_MULTI_LANES];
+    uint32_t start;
+
+    printf("buffer: %u bytes, lanes: %u, chain: %u elements\n",
+           BUF_SIZE, SHA256_MULTI_LANES, CHAIN_LENGTH);
+
+    for (unsigned l = 0; l < SHA256_MULTI_LANES; l++) {
+        for (unsigned i = 0; i < BUF_SIZE; i++) {
+            _buf[l][i] = i + l;
+        }
+        data[l] = _buf[l];
+        digest[l] = _digest[l];
+    }
+
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        sha256(_buf[0], BUF_SIZE, _digest[0]);
+    }
+    unsigned result = _report("sha256", start, ROUNDS * BUF_SIZE);
+
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < ROUNDS / SHA256_MULTI_LANES; i++) {
+        sha256_multi(data, BUF_SIZE, digest, SHA256_MULTI_LANES);
+    }
+    _report("sha256_multi", start, ROUNDS * BUF_SIZE);
+
+    start = xtimer_now_usec();
+    sha256_chain(_buf[0], SHA256_DIGEST_LENGTH, CHAIN_LENGTH, _digest[0]);
+    _report("sha256_chain", start, CHAIN_LENGTH * SHA256_DIGEST_LENGTH);
+
+    printf("{ \"result\" : %u }\n", result);
+    return 0;
+}
@@ -0,0 +1,21 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+def testfunc(child):
+    child.expect(r"buffer: \d+ bytes, lanes: \d+, chain: \d+ elements")
+    for case in ("sha256", "sha256_multi", "sha256_chain"):
+        child.expect(r"{}: \d+ us \(\d+ KiB/s\)".format(case))
+    child.expect(r"{ \"result\" : \d+ }")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc, timeout=120))
@@ -0,0 +1,103 @@
+/* A small application script: sensor configuration, a state machine and
+ * some report formatting. Most of the work is done at load time, the code
+ * run afterwards is short. */
+
+var sensors = [
+    { name: "temperature", unit: "C", scale: 100, min: -4000, max: 8500 },
+    { name: "humidity", unit: "%", scale: 100, min: 0, max: 10000 },
+    { name: "pressure", unit: "hPa", scale: 10, min: 3000, max: 11000 },
+    { name: "light", unit: "lx", scale: 1, min: 0, max: 65535 },
+    { name: "voltage", unit: "mV", scale: 1, min: 0, max: 5000 }
+];
+
+var thresholds = {
+    temperature: { low: 500, high: 3500 },
+    humidity: { low: 2000, high: 8000 },
+    pressure: { low: 9500, high: 10500 },
+    light: { low: 10, high: 50000 },
+    voltage: { low: 3000, high: 4300 }
+};
+
+var states = {
+    idle: function (ctx, event) {
+        return (event === "measure") ? "measuring" : "idle";
+    },
+    measuring: function (ctx, event) {
+        if (event === "done") {
+            ctx.samples++;
+            return "reporting";
+        }
+        if (event === "error") {
+            ctx.errors++;
+            return "idle";
+        }
+        return "measuring";
+    },
+    reporting: function (ctx, event) {
+        if (event === "sent") {
+            return "idle";
+        }
+        if (event === "timeout") {
+            ctx.retries++;
+            if (ctx.retries > 3) {
+                return "idle";
+            }
+        }
+        return "reporting";
+    }
+};
+
+function step(ctx, event) {
+    ctx.state = states[ctx.state](ctx, event);
+    return ctx.state;
+}
+
+function clamp(value, min, max) {
+    return (value < min) ? min : ((value > max) ? max : value);
+}
+
+function check(sensor, value) {
+    var t = thresholds[sensor.name];
+    value = clamp(value, sensor.min, sensor.max);
+    if (value < t.low) {
+        return { value: value, status: "low" };
+    }
+    if (value > t.high) {
+        return { value: value, status: "high" };
+    }
+    return { value: value, status: "ok" };
+}
+
+function format(sensor, value, status) {
+    var int = Math.floor(value / sensor.scale);
+    var frac = value % sensor.scale;
+    if (sensor.scale === 1) {
+        return sensor.name + "=" + int + sensor.unit + " (" + status + ")";
+    }
+    return sensor.name + "=" + int + "." + ((frac < 10) ? "0" : "") + frac +
+           sensor.unit + " (" + status + ")";
+}
+
+function report(values) {
+    var lines = [];
+    var alarms = 0;
+    for (var i = 0; i < sensors.length; i++) {
+        var res = check(sensors[i], values[i]);
+        if (res.status !== "ok") {
+            alarms++;
+        }
+        lines.push(format(sensors[i], res.value, res.status));
+    }
+    return { text: lines.join(", "), alarms: alarms };
+}
+
+var ctx = { state: "idle", samples: 0, errors: 0, retries: 0 };
+var events = [ "measure", "done", "timeout", "sent", "measure", "error",
+               "measure", "done", "sent" ];
+for (var i = 0; i < events.length; i++) {
+    step(ctx, events[i]);
+}
+
+/* read by the application */
+var result = ctx.samples * 100 + ctx.errors * 10 +
+             report([ 2150, 4530, 10132, 120, 3700 ]).alarms;
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Startup time and heap usage of JavaScript from source and
+ *              from a precompiled snapshot
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "jerryscript.h"
+#include "xtimer.h"
+
+#include "bench.js.h"
+#include "bench.js.snapshot.h"
+
+#ifndef ROUNDS
+#define ROUNDS              (20U)
+#endif
+
+static size_t _peak;
+
+static jerry_value_t _run_source(void)
+{
+    jerry_value_t parsed = jerry_parse(NULL, 0, bench_js, bench_js_len,
+                                       JERRY_PARSE_NO_OPTS);
+
+    if (jerry_value_is_error(parsed)) {
+        return parsed;
+    }
+    jerry_value_t res = jerry_run(parsed);
+    jerry_release_value(parsed);
+    return res;
+}
+
+static jerry_value_t _run_snapshot(void)
+{
+    /* without JERRY_SNAPSHOT_EXEC_COPY_DATA, the byte code is executed
+     * directly from the snapshot in ROM */
+    return jerry_exec_snapshot((const uint32_t *)bench_js_snapshot,
+                               bench_js_snapshot_len, 0, 0);
+}
+
+static int _run(jerry_value_t (*run)(void), uint32_t *us)
+{
+    int res = -1;
+    jerry_heap_stats_t stats;
+    uint32_t start = xtimer_now_usec();
+
+    jerry_init(JERRY_INIT_EMPTY);
+    jerry_value_t ret = run();
+    if (jerry_value_is_error(ret)) {
+        puts("script error [FAILED]");
+    }
+    else {
+        jerry_value_t global = jerry_get_global_object();
+        jerry_value_t name = jerry_create_string((const jerry_char_t *)"result");
+        jerry_value_t value = jerry_get_property(global, name);
+
+        if (jerry_value_is_number(value)) {
+            res = (int)jerry_get_number_value(value);
+        }
+        jerry_release_value(value);
+        jerry_release_value(name);
+        jerry_release_value(global);
+    }
+    jerry_release_value(ret);
+    _peak = (jerry_get_memory_stats(&stats)) ? stats.peak_allocated_bytes : 0;
+    jerry_cleanup();
+    *us += xtimer_now_usec() - start;
+    return res;
+}
+
+static uint32_t _bench(const char *name, jerry_value_t (*run)(void), size_t len)
+{
+    uint32_t us = 0;
+    int res = 0;
+
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        res = _run(run, &us);
+    }
+    printf("%s: %u bytes, startup %u us, peak heap %u bytes, returned %d\n",
+           name, (unsigned)len, (unsigned)(us / ROUNDS), (unsigned)_peak, res);
+    return us / ROUNDS;
+}
+
+int main(void)
+{
+    _bench("source", _run_source, bench_js_len);
+    uint32_t result = _bench("snapshot", _run_snapshot, bench_js_snapshot_len);
+
+    printf("{ \"result\" : %u }\n", (unsigned)result);
+    return 0;
+}
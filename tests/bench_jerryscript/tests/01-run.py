@@ -0,0 +1,24 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+def testfunc(child):
+    child.expect(r"source: \d+ bytes, startup \d+ us, "
+                 r"peak heap \d+ bytes, returned (\d+)")
+    source = child.match.group(1)
+    child.expect(r"snapshot: \d+ bytes, startup \d+ us, "
+                 r"peak heap \d+ bytes, returned (\d+)")
+    assert child.match.group(1) == source
+    child.expect(r"{ \"result\" : \d+ }")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
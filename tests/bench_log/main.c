@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Compare the cost of a log call with printf and log_deferred
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "log.h"
+#include "log_deferred.h"
+#include "xtimer.h"
+
+#ifndef CALLS_NUMOF
+#define CALLS_NUMOF     (128U)
+#endif
+
+#define MSG_FORMAT      "bench: message %u of %s, value 0x%08x\n"
+
+static uint32_t _results[3];
+
+static void _print(const char *name, uint32_t us)
+{
+    printf("%s: %u calls in %u us (%u ns/call)\n", name, CALLS_NUMOF,
+           (unsigned)us, (unsigned)((us * 1000) / CALLS_NUMOF));
+}
+
+static uint32_t _bench_printf(void)
+{
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < CALLS_NUMOF; i++) {
+        printf(MSG_FORMAT, i, "printf", i * 0x01010101);
+    }
+    return xtimer_now_usec() - start;
+}
+
+static uint32_t _bench_log(void)
+{
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < CALLS_NUMOF; i++) {
+        LOG_INFO(MSG_FORMAT, i, "log", i * 0x01010101);
+    }
+    return xtimer_now_usec() - start;
+}
+
+int main(void)
+{
+    /* the output thread has the lowest priority, so messages logged by this
+     * thread are only printed when it calls log_deferred_flush() */
+    _results[0] = _bench_printf();
+
+    _results[1] = _bench_log();
+    log_deferred_flush();
+
+    /* fill the buffer so all of the measured calls are dropped */
+    unsigned dropped = log_deferred_dropped();
+    while (log_deferred_dropped() == dropped) {
+        LOG_INFO(MSG_FORMAT, 0, "fill", 0);
+    }
+    dropped = log_deferred_dropped();
+    _results[2] = _bench_log();
+    dropped = log_deferred_dropped() - dropped;
+    log_deferred_flush();
+
+    _print("printf", _results[0]);
+    _print("log_deferred", _results[1]);
+    _print("log_deferred (dropped)", _results[2]);
+    printf("%u of %u calls dropped\n", dropped, CALLS_NUMOF);
+    printf("{ \"result\" : %u }\n", (unsigned)((_results[1] * 1000) / CALLS_NUMOF));
+
+    return 0;
+}
@@ -0,0 +1,22 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+def testfunc(child):
+    for name in ("printf", r"log_deferred", r"log_deferred \(dropped\)"):
+        child.expect(r"{}: \d+ calls in \d+ us \(\d+ ns/call\)".format(name))
+    child.expect(r"(\d+) of (\d+) calls dropped")
+    assert child.match.group(1) == child.match.group(2)
+    child.expect(r"{ \"result\" : \d+ }")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
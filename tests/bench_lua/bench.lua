@@ -0,0 +1,111 @@
+-- A small application script: sensor configuration, a state machine and
+-- some report formatting. Most of the work is done at load time, the code
+-- run afterwards is short.
+
+local sensors = {
+    { name = "temperature", unit = "C", scale = 100, min = -4000, max = 8500 },
+    { name = "humidity", unit = "%", scale = 100, min = 0, max = 10000 },
+    { name = "pressure", unit = "hPa", scale = 10, min = 3000, max = 11000 },
+    { name = "light", unit = "lx", scale = 1, min = 0, max = 65535 },
+    { name = "voltage", unit = "mV", scale = 1, min = 0, max = 5000 },
+}
+
+local thresholds = {
+    temperature = { low = 500, high = 3500 },
+    humidity = { low = 2000, high = 8000 },
+    pressure = { low = 9500, high = 10500 },
+    light = { low = 10, high = 50000 },
+    voltage = { low = 3000, high = 4300 },
+}
+
+local states = {}
+
+function states.idle(ctx, event)
+    if event == "measure" then
+        return "measuring"
+    end
+    return "idle"
+end
+
+function states.measuring(ctx, event)
+    if event == "done" then
+        ctx.samples = ctx.samples + 1
+        return "reporting"
+    elseif event == "error" then
+        ctx.errors = ctx.errors + 1
+        return "idle"
+    end
+    return "measuring"
+end
+
+function states.reporting(ctx, event)
+    if event == "sent" then
+        return "idle"
+    elseif event == "timeout" then
+        ctx.retries = ctx.retries + 1
+        if ctx.retries > 3 then
+            return "idle"
+        end
+    end
+    return "reporting"
+end
+
+local function step(ctx, event)
+    ctx.state = states[ctx.state](ctx, event)
+    return ctx.state
+end
+
+local function clamp(value, min, max)
+    if value < min then
+        return min
+    elseif value > max then
+        return max
+    end
+    return value
+end
+
+local function check(sensor, value)
+    local t = thresholds[sensor.name]
+    value = clamp(value, sensor.min, sensor.max)
+    if value < t.low then
+        return value, "low"
+    elseif value > t.high then
+        return value, "high"
+    end
+    return value, "ok"
+end
+
+local function format(sensor, value, status)
+    local int = value // sensor.scale
+    local frac = value % sensor.scale
+    if sensor.scale == 1 then
+        return string.format("%s=%d%s (%s)", sensor.name, int, sensor.unit,
+                             status)
+    end
+    return string.format("%s=%d.%02d%s (%s)", sensor.name, int, frac,
+                         sensor.unit, status)
+end
+
+local function report(values)
+    local lines = {}
+    local alarms = 0
+    for i, sensor in ipairs(sensors) do
+        local value, status = check(sensor, values[i])
+        if status ~= "ok" then
+            alarms = alarms + 1
+        end
+        lines[#lines + 1] = format(sensor, value, status)
+    end
+    return table.concat(lines, ", "), alarms
+end
+
+local ctx = { state = "idle", samples = 0, errors = 0, retries = 0 }
+local events = { "measure", "done", "timeout", "sent", "measure", "error",
+                 "measure", "done", "sent" }
+for _, event in ipairs(events) do
+    step(ctx, event)
+end
+
+local _, alarms = report({ 2150, 4530, 10132, 120, 3700 })
+
+return ctx.samples * 100 + ctx.errors * 10 + alarms
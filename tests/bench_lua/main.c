@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Startup time and heap usage of Lua scripts from source and
+ *              from precompiled bytecode
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "lauxlib.h"
+#include "lua_run.h"
+#include "xtimer.h"
+
+#include "bench.lua.h"
+#include "bench.luac.h"
+
+#ifndef ROUNDS
+#define ROUNDS              (20U)
+#endif
+
+#define LUA_MEM_SIZE        (40000U)
+#define LUA_LIBS            (LUAR_LOAD_BASE | LUAR_LOAD_TABLE | \
+                             LUAR_LOAD_STRING | LUAR_LOAD_MATH)
+
+typedef struct {
+    lua_Alloc alloc;        /**< allocator of the state */
+    void *ud;               /**< its user data */
+    size_t used;
+    size_t peak;
+} heap_stats_t;
+
+static char lua_mem[LUA_MEM_SIZE] __attribute__ ((aligned(__BIGGEST_ALIGNMENT__)));
+static heap_stats_t _stats;
+
+static void *_count_alloc(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+    heap_stats_t *stats = ud;
+    void *res = stats->alloc(stats->ud, ptr, osize, nsize);
+
+    if (ptr == NULL) {
+        /* osize is the type of the new object */
+        osize = 0;
+    }
+    if ((res != NULL) || (nsize == 0)) {
+        stats->used += nsize - osize;
+        if (stats->used > stats->peak) {
+            stats->peak = stats->used;
+        }
+    }
+    return res;
+}
+
+static int _run(const unsigned char *buf, size_t len, const char *mode,
+                uint32_t *load_us, uint32_t *total_us)
+{
+    int res = -1;
+    uint32_t start = xtimer_now_usec();
+    lua_State *L = lua_riot_newstate(lua_mem, sizeof(lua_mem), NULL);
+
+    if (L == NULL) {
+        puts("cannot create state [FAILED]");
+        return -1;
+    }
+    lua_riot_openlibs(L, LUA_LIBS);
+
+    /* only count what is allocated for the script */
+    _stats.alloc = lua_getallocf(L, &_stats.ud);
+    _stats.used = 0;
+    _stats.peak = 0;
+    lua_setallocf(L, _count_alloc, &_stats);
+
+    uint32_t load = xtimer_now_usec();
+    if (luaL_loadbufferx(L, (const char *)buf, len, "=bench", mode) != LUA_OK) {
+        printf("load: %s [FAILED]\n", lua_tostring(L, -1));
+    }
+    else {
+        *load_us += xtimer_now_usec() - load;
+        if (lua_pcall(L, 0, 1, 0) != LUA_OK) {
+            printf("run: %s [FAILED]\n", lua_tostring(L, -1));
+        }
+        else {
+            res = lua_tointeger(L, -1);
+        }
+    }
+    lua_close(L);
+    *total_us += xtimer_now_usec() - start;
+    return res;
+}
+
+static uint32_t _bench(const char *name, const unsigned char *buf, size_t len,
+                       const char *mode)
+{
+    uint32_t load_us = 0;
+    uint32_t total_us = 0;
+    int res = 0;
+
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        res = _run(buf, len, mode, &load_us, &total_us);
+    }
+    printf("%s: %u bytes, load %u us, startup %u us, peak heap %u bytes, "
+           "returned %d\n", name, (unsigned)len, (unsigned)(load_us / ROUNDS),
+           (unsigned)(total_us / ROUNDS), (unsigned)_stats.peak, res);
+    return load_us / ROUNDS;
+}
+
+int main(void)
+{
+    _bench("source", bench_lua, bench_lua_len, "t");
+    uint32_t result = _bench("bytecode", bench_luac, bench_luac_len, "b");
+
+    printf("{ \"result\" : %u }\n", (unsigned)result);
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       TCP throughput benchmark for lwIP over netdev_tap
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "lwip/netif.h"
+#include "net/ipv6/addr.h"
+#include "net/sock/tcp.h"
+#include "xtimer.h"
+
+#ifndef SERVER_PORT
+#define SERVER_PORT         (12345U)
+#endif
+
+#ifndef DATA_LEN
+#define DATA_LEN            (1024U * 1024U)
+#endif
+
+#define CHUNK_LEN           (1024U)
+
+static sock_tcp_t _sock_queue[1];
+static sock_tcp_queue_t _queue;
+static uint8_t _buf[CHUNK_LEN];
+
+static unsigned _kbit(uint32_t bytes, uint32_t us)
+{
+    return (unsigned)(((uint64_t)bytes * 8 * 1000) / ((us) ? us : 1));
+}
+
+static unsigned _recv(sock_tcp_t *sock)
+{
+    uint32_t received = 0;
+    uint32_t start = 0;
+
+    while (received < DATA_LEN) {
+        ssize_t res = sock_tcp_read(sock, _buf, sizeof(_buf), SOCK_NO_TIMEOUT);
+        if (res <= 0) {
+            printf("read failed: %d\n", (int)res);
+            return 0;
+        }
+        if (received == 0) {
+            /* the connection is up once the first segment arrives */
+            start = xtimer_now_usec();
+        }
+        received += res;
+    }
+    uint32_t us = xtimer_now_usec() - start;
+
+    printf("received %u bytes in %u us (%u kbit/s)\n", (unsigned)received,
+           (unsigned)us, _kbit(received, us));
+    return _kbit(received, us);
+}
+
+static void _send(sock_tcp_t *sock)
+{
+    uint32_t sent = 0;
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < sizeof(_buf); i++) {
+        _buf[i] = i;
+    }
+    while (sent < DATA_LEN) {
+        ssize_t res = sock_tcp_write(sock, _buf, sizeof(_buf));
+        if (res <= 0) {
+            printf("write failed: %d\n", (int)res);
+            return;
+        }
+        sent += res;
+    }
+    uint32_t us = xtimer_now_usec() - start;
+
+    printf("sent %u bytes in %u us (%u kbit/s)\n", (unsigned)sent,
+           (unsigned)us, _kbit(sent, us));
+}
+
+int main(void)
+{
+    sock_tcp_ep_t local = SOCK_IPV6_EP_ANY;
+    sock_tcp_t *sock;
+    char addr_str[IPV6_ADDR_MAX_STR_LEN];
+
+    if (netif_list == NULL) {
+        puts("no network interface [FAILED]");
+        return 1;
+    }
+    local.port = SERVER_PORT;
+    if (sock_tcp_listen(&_queue, &local, _sock_queue, 1, 0) < 0) {
+        puts("listen [FAILED]");
+        return 1;
+    }
+    ipv6_addr_to_str(addr_str, (const ipv6_addr_t *)netif_ip6_addr(netif_list, 0),
+                     sizeof(addr_str));
+    printf("listening on [%s]:%u, data: %u bytes\n", addr_str, SERVER_PORT,
+           DATA_LEN);
+
+    if (sock_tcp_accept(&_queue, &sock, SOCK_NO_TIMEOUT) < 0) {
+        puts("accept [FAILED]");
+        return 1;
+    }
+    unsigned result = _recv(sock);
+    _send(sock);
+    sock_tcp_disconnect(sock);
+
+    printf("{ \"result\" : %u }\n", result);
+    return 0;
+}
@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import os
+import socket
+import sys
+import time
+from testrunner import run
+
+
+def _connect(addr, port, tap):
+    scope = socket.if_nametoindex(tap)
+    # wait for duplicate address detection of the node
+    for _ in range(10):
+        try:
+            return socket.create_connection((addr + "%" + str(scope), port))
+        except OSError:
+            time.sleep(1)
+    raise RuntimeError("can not connect to [{}]:{}".format(addr, port))
+
+
+def testfunc(child):
+    child.expect(r"listening on \[([0-9a-f:]+)\]:(\d+), data: (\d+) bytes")
+    addr, port = child.match.group(1), int(child.match.group(2))
+    data_len = int(child.match.group(3))
+    sock = _connect(addr, port, os.environ.get("PORT", "tap0"))
+
+    chunk = bytes(range(256)) * 4
+    sent = 0
+    while sent < data_len:
+        sent += sock.send(chunk[:data_len - sent])
+    child.expect(r"received (\d+) bytes in \d+ us")
+    assert int(child.match.group(1)) == data_len
+
+    received = 0
+    while received < data_len:
+        data = sock.recv(4096)
+        if not data:
+            break
+        received += len(data)
+    sock.close()
+    assert received == data_len
+    child.expect(r"sent \d+ bytes in \d+ us")
+    child.expect(r"{ \"result\" : \d+ }")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc, timeout=60))
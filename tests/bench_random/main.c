@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Throughput of the PRNG interface
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "random.h"
+#include "xtimer.h"
+
+#ifndef PRNG_NAME
+#define PRNG_NAME           "default"
+#endif
+
+#ifndef BYTES
+#define BYTES               (16U * 1024U)
+#endif
+
+#ifndef BUF_SIZE
+#define BUF_SIZE            (64U)
+#endif
+
+static uint32_t _buf[BUF_SIZE / sizeof(uint32_t)];
+static random_xoshiro_t _xoshiro;
+
+static void _uint32(void)
+{
+    for (unsigned i = 0; i < BUF_SIZE / sizeof(uint32_t); i++) {
+        _buf[i] = random_uint32();
+    }
+}
+
+/* random_bytes() before it switched to random_fill() */
+static void _byte_wise(void)
+{
+    uint8_t *target = (uint8_t *)_buf;
+    uint32_t random;
+    uint8_t *random_pos = (uint8_t *)&random;
+    unsigned _n = 0;
+
+    for (unsigned n = BUF_SIZE; n; n--) {
+        if (!(_n++ & 0x3)) {
+            random = random_uint32();
+            random_pos = (uint8_t *)&random;
+        }
+        *target++ = *random_pos++;
+    }
+}
+
+static void _bytes(void)
+{
+    random_bytes((uint8_t *)_buf, BUF_SIZE);
+}
+
+static void _fill(void)
+{
+    random_fill(_buf, BUF_SIZE / sizeof(uint32_t));
+}
+
+static void _xoshiro_uint32(void)
+{
+    for (unsigned i = 0; i < BUF_SIZE / sizeof(uint32_t); i++) {
+        _buf[i] = random_xoshiro_uint32(&_xoshiro);
+    }
+}
+
+static void _xoshiro_bytes(void)
+{
+    random_xoshiro_bytes(&_xoshiro, (uint8_t *)_buf, BUF_SIZE);
+}
+
+static unsigned _bench(const char *name, void (*fill)(void))
+{
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < BYTES / BUF_SIZE; i++) {
+        fill();
+    }
+    uint32_t us = xtimer_now_usec() - start;
+    unsigned rate = (unsigned)(((uint64_t)BYTES * US_PER_SEC / 1024) /
+                               ((us) ? us : 1));
+
+    printf("%s: %u us (%u KiB/s)\n", name, (unsigned)us, rate);
+    return rate;
+}
+
+int main(void)
+{
+    printf("prng: %s, %u bytes\n", PRNG_NAME, BYTES);
+
+    random_xoshiro_init(&_xoshiro);
+
+    _bench("random_uint32", _uint32);
+    _bench("byte-wise", _byte_wise);
+    unsigned result = _bench("random_bytes", _bytes);
+    _bench("random_fill", _fill);
+    _bench("xoshiro_uint32", _xoshiro_uint32);
+    _bench("xoshiro_bytes", _xoshiro_bytes);
+
+    printf("{ \"result\" : %u }\n", result);
+    return 0;
+}
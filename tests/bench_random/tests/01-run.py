@@ -0,0 +1,25 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+METHODS = ("random_uint32", "byte-wise", "random_bytes", "random_fill",
+           "xoshiro_uint32", "xoshiro_bytes")
+
+
+def testfunc(child):
+    child.expect(r"prng: \w+, \d+ bytes")
+    for method in METHODS:
+        child.expect(r"{}: \d+ us \(\d+ KiB/s\)".format(method))
+    child.expect(r"{ \"result\" : \d+ }")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc, timeout=120))
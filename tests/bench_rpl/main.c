@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       RPL benchmark for a DODAG root with a large simulated topology
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "net/gnrc/ipv6/nib/ft.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/dodag.h"
+#include "net/icmpv6.h"
+#include "xtimer.h"
+
+#ifndef NODES_NUMOF
+#define NODES_NUMOF         (500U)
+#endif
+
+#ifndef FANOUT
+#define FANOUT              (8U)    /**< children per node in the topology */
+#endif
+
+#ifndef TARGETS_PER_DAO
+#define TARGETS_PER_DAO     (16U)
+#endif
+
+#ifndef LOOKUP_ROUNDS
+#define LOOKUP_ROUNDS       (20U)
+#endif
+
+#ifndef PARENTS_NUMOF
+#define PARENTS_NUMOF       (GNRC_RPL_PARENTS_NUMOF)
+#endif
+
+#ifndef DIO_ROUNDS
+#define DIO_ROUNDS          (50U)
+#endif
+
+#define ROOT_INSTANCE       (1U)
+#define NODE_INSTANCE       (2U)
+#define DAOS_NUMOF          ((NODES_NUMOF / TARGETS_PER_DAO) + FANOUT + 1)
+#define DAO_SIZE            (sizeof(icmpv6_hdr_t) + sizeof(gnrc_rpl_dao_t) + \
+                             (TARGETS_PER_DAO * sizeof(gnrc_rpl_opt_target_t)) + \
+                             sizeof(gnrc_rpl_opt_transit_t))
+#define DIO_SIZE            (sizeof(icmpv6_hdr_t) + sizeof(gnrc_rpl_dio_t) + \
+                             sizeof(gnrc_rpl_opt_dodag_conf_t))
+
+typedef struct {
+    uint16_t src;                   /**< node sending the DAO */
+    uint16_t len;
+    uint8_t buf[DAO_SIZE];
+} dao_t;
+
+/* child of the root each node is reached through */
+static uint16_t _via[NODES_NUMOF + 1];
+static dao_t _daos[DAOS_NUMOF];
+static unsigned _daos_numof;
+static uint8_t _dio[DIO_SIZE];
+
+static gnrc_netif_t *_netif;
+
+static void _node_addr(ipv6_addr_t *addr, const char *prefix, uint16_t node)
+{
+    ipv6_addr_from_str(addr, prefix);
+    addr->u16[7] = byteorder_htons(node);
+}
+
+static unsigned _rate(unsigned ops, uint32_t us)
+{
+    return (unsigned)(((uint64_t)ops * US_PER_SEC) / ((us) ? us : 1));
+}
+
+/* terminates the DAO with a transit option for all its targets */
+static void _close_dao(dao_t *dao, gnrc_rpl_opt_target_t *end)
+{
+    gnrc_rpl_opt_transit_t *transit = (gnrc_rpl_opt_transit_t *)end;
+
+    transit->type = GNRC_RPL_OPT_TRANSIT;
+    transit->length = GNRC_RPL_OPT_TRANSIT_INFO_LEN;
+    transit->e_flags = 0;
+    transit->path_control = 0;
+    transit->path_sequence = 0;
+    transit->path_lifetime = GNRC_RPL_DEFAULT_LIFETIME;
+    dao->len = (uint8_t *)(transit + 1) - dao->buf;
+}
+
+static void _build_daos(void)
+{
+    gnrc_rpl_opt_target_t *target = NULL;
+    dao_t *dao = NULL;
+
+    /* node i is a child of node (i - 1) / FANOUT, 0 being the root */
+    for (unsigned i = 1; i <= NODES_NUMOF; i++) {
+        unsigned parent = (i - 1) / FANOUT;
+        _via[i] = (parent == 0) ? i : _via[parent];
+    }
+
+    /* every child of the root announces the nodes of its sub-DODAG */
+    for (unsigned child = 1; child <= FANOUT; child++) {
+        unsigned targets = TARGETS_PER_DAO;
+
+        for (unsigned i = 1; i <= NODES_NUMOF; i++) {
+            if (_via[i] != child) {
+                continue;
+            }
+            if (targets == TARGETS_PER_DAO) {
+                dao = &_daos[_daos_numof++];
+                dao->src = child;
+                gnrc_rpl_dao_t *hdr = (gnrc_rpl_dao_t *)(dao->buf + sizeof(icmpv6_hdr_t));
+                hdr->instance_id = ROOT_INSTANCE;
+                hdr->k_d_flags = 0;
+                hdr->reserved = 0;
+                hdr->dao_sequence = _daos_numof;
+                target = (gnrc_rpl_opt_target_t *)(hdr + 1);
+                targets = 0;
+            }
+            target->type = GNRC_RPL_OPT_TARGET;
+            target->length = GNRC_RPL_OPT_TARGET_LEN;
+            target->flags = 0;
+            target->prefix_length = IPV6_ADDR_BIT_LEN;
+            _node_addr(&target->target, "2001:db8::", i);
+            target++;
+            if (++targets == TARGETS_PER_DAO) {
+                _close_dao(dao, target);
+            }
+        }
+        if (targets < TARGETS_PER_DAO) {
+            _close_dao(dao, target);
+        }
+    }
+}
+
+static uint32_t _feed_daos(void)
+{
+    ipv6_addr_t src, dst;
+    uint32_t start = xtimer_now_usec();
+
+    ipv6_addr_from_str(&dst, "fe80::1");
+    for (unsigned i = 0; i < _daos_numof; i++) {
+        _node_addr(&src, "fe80::", _daos[i].src);
+        gnrc_rpl_recv_DAO((gnrc_rpl_dao_t *)(_daos[i].buf + sizeof(icmpv6_hdr_t)),
+                          _netif->pid, &src, &dst, _daos[i].len);
+    }
+    return xtimer_now_usec() - start;
+}
+
+static unsigned _bench_lookup(void)
+{
+    gnrc_ipv6_nib_ft_t fte;
+    ipv6_addr_t dst, next_hop;
+    unsigned found = 0;
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned round = 0; round < LOOKUP_ROUNDS; round++) {
+        for (unsigned i = 1; i <= NODES_NUMOF; i++) {
+            _node_addr(&dst, "2001:db8::", i);
+            _node_addr(&next_hop, "fe80::", _via[i]);
+            if ((gnrc_ipv6_nib_ft_get(&dst, NULL, &fte) == 0) &&
+                ipv6_addr_equal(&fte.next_hop, &next_hop)) {
+                found++;
+            }
+        }
+    }
+    uint32_t us = xtimer_now_usec() - start;
+
+    printf("lookup: %u of %u routes found in %u us (%u lookups/s)\n",
+           found, LOOKUP_ROUNDS * NODES_NUMOF, (unsigned)us,
+           _rate(LOOKUP_ROUNDS * NODES_NUMOF, us));
+    return _rate(LOOKUP_ROUNDS * NODES_NUMOF, us);
+}
+
+static void _feed_dio(unsigned parent, uint16_t rank)
+{
+    ipv6_addr_t src, dst;
+    gnrc_rpl_dio_t *dio = (gnrc_rpl_dio_t *)(_dio + sizeof(icmpv6_hdr_t));
+
+    ipv6_addr_from_str(&dst, "ff02::1a");
+    _node_addr(&src, "fe80::1:0", parent);
+    dio->rank = byteorder_htons(rank);
+    gnrc_rpl_recv_DIO(dio, _netif->pid, &src, &dst, sizeof(_dio));
+}
+
+static void _bench_dio(void)
+{
+    gnrc_rpl_dio_t *dio = (gnrc_rpl_dio_t *)(_dio + sizeof(icmpv6_hdr_t));
+    gnrc_rpl_opt_dodag_conf_t *conf = (gnrc_rpl_opt_dodag_conf_t *)(dio + 1);
+
+    dio->instance_id = NODE_INSTANCE;
+    dio->version_number = 0;
+    dio->g_mop_prf = GNRC_RPL_DEFAULT_MOP << 3;    /* MOP field */
+    dio->dtsn = 0;
+    dio->flags = 0;
+    dio->reserved = 0;
+    ipv6_addr_from_str(&dio->dodag_id, "2001:db8:1::1");
+    conf->type = GNRC_RPL_OPT_DODAG_CONF;
+    conf->length = GNRC_RPL_OPT_DODAG_CONF_LEN;
+    conf->flags_a_pcs = 0;
+    conf->dio_int_doubl = GNRC_RPL_DEFAULT_DIO_INTERVAL_DOUBLINGS;
+    conf->dio_int_min = GNRC_RPL_DEFAULT_DIO_INTERVAL_MIN;
+    conf->dio_redun = GNRC_RPL_DEFAULT_DIO_REDUNDANCY_CONSTANT;
+    conf->max_rank_inc = byteorder_htons(GNRC_RPL_DEFAULT_MAX_RANK_INCREASE);
+    conf->min_hop_rank_inc = byteorder_htons(GNRC_RPL_DEFAULT_MIN_HOP_RANK_INCREASE);
+    conf->ocp = byteorder_htons(GNRC_RPL_DEFAULT_OCP);
+    conf->reserved = 0;
+    conf->default_lifetime = GNRC_RPL_DEFAULT_LIFETIME;
+    conf->lifetime_unit = byteorder_htons(GNRC_RPL_LIFETIME_UNIT);
+
+    /* all candidates stay in the same DAGRank, so none of them is dropped,
+     * but the preferred parent changes frequently */
+    for (unsigned p = 0; p < PARENTS_NUMOF; p++) {
+        _feed_dio(p, 2 * GNRC_RPL_DEFAULT_MIN_HOP_RANK_INCREASE + p);
+    }
+
+    uint32_t start = xtimer_now_usec();
+    for (unsigned round = 0; round < DIO_ROUNDS; round++) {
+        for (unsigned p = 0; p < PARENTS_NUMOF; p++) {
+            uint16_t rank = (p * 37 + round * 11) % GNRC_RPL_DEFAULT_MIN_HOP_RANK_INCREASE;
+            _feed_dio(p, 2 * GNRC_RPL_DEFAULT_MIN_HOP_RANK_INCREASE + rank);
+        }
+    }
+    uint32_t us = xtimer_now_usec() - start;
+
+    unsigned parents = 0;
+    gnrc_rpl_instance_t *inst = gnrc_rpl_instance_get(NODE_INSTANCE);
+    if (inst != NULL) {
+        for (gnrc_rpl_parent_t *p = inst->dodag.parents; p != NULL; p = p->next) {
+            parents++;
+        }
+    }
+    printf("dio: %u DIOs from %u parents in %u us (%u DIOs/s)\n",
+           DIO_ROUNDS * PARENTS_NUMOF, parents, (unsigned)us,
+           _rate(DIO_ROUNDS * PARENTS_NUMOF, us));
+}
+
+int main(void)
+{
+    ipv6_addr_t addr;
+
+    _netif = gnrc_netif_iter(NULL);
+    if (_netif == NULL) {
+        puts("no network interface [FAILED]");
+        return 1;
+    }
+    printf("nodes: %u, fanout: %u, hash buckets: %u\n", NODES_NUMOF, FANOUT,
+           GNRC_IPV6_NIB_OFFL_HASH_NUMOF);
+
+    ipv6_addr_from_str(&addr, "2001:db8::1");
+    gnrc_netif_ipv6_addr_add(_netif, &addr, 64, GNRC_NETIF_IPV6_ADDRS_FLAGS_STATE_VALID);
+    ipv6_addr_from_str(&addr, "2001:db8:1::2");
+    gnrc_netif_ipv6_addr_add(_netif, &addr, 64, GNRC_NETIF_IPV6_ADDRS_FLAGS_STATE_VALID);
+
+    gnrc_rpl_init(_netif->pid);
+    ipv6_addr_from_str(&addr, "2001:db8::1");
+    if (gnrc_rpl_root_init(ROOT_INSTANCE, &addr, false, false) == NULL) {
+        puts("root init [FAILED]");
+        return 1;
+    }
+
+    _build_daos();
+    uint32_t us = _feed_daos();
+    printf("dao: %u DAOs with %u targets in %u us\n", _daos_numof, NODES_NUMOF,
+           (unsigned)us);
+    us = _feed_daos();
+    printf("dao refresh: %u DAOs with %u targets in %u us\n", _daos_numof,
+           NODES_NUMOF, (unsigned)us);
+
+    unsigned result = _bench_lookup();
+
+    _bench_dio();
+
+    printf("{ \"result\" : %u }\n", result);
+    return 0;
+}
@@ -0,0 +1,24 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+def testfunc(child):
+    child.expect(r"nodes: \d+, fanout: \d+, hash buckets: \d+")
+    child.expect(r"dao: \d+ DAOs with \d+ targets in \d+ us")
+    child.expect(r"dao refresh: \d+ DAOs with \d+ targets in \d+ us")
+    child.expect(r"lookup: (\d+) of (\d+) routes found")
+    assert child.match.group(1) == child.match.group(2)
+    child.expect(r"dio: \d+ DIOs from \d+ parents in \d+ us")
+    child.expect(r"{ \"result\" : \d+ }")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
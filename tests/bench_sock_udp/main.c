@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Receive rate benchmark for UDP sock objects over loopback
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "net/ipv6/addr.h"
+#include "net/sock/udp.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#ifndef PAYLOAD_SIZE
+#define PAYLOAD_SIZE        (64U)
+#endif
+
+#ifndef BURST
+#define BURST               (SOCK_MBOX_SIZE)
+#endif
+
+#ifndef BURSTS_NUMOF
+#define BURSTS_NUMOF        (2000U)
+#endif
+
+#ifndef RECV_TIMEOUT
+#define RECV_TIMEOUT        (US_PER_SEC)
+#endif
+
+#define RX_PORT             (0x1234)
+#define TX_PORT             (0x4321)
+
+static char _tx_stack[THREAD_STACKSIZE_DEFAULT];
+/* locked while the sender waits for the next burst */
+static mutex_t _go = MUTEX_INIT_LOCKED;
+static sock_udp_t _rx, _tx;
+static uint8_t _buf[PAYLOAD_SIZE];
+static uint32_t _seq;
+static unsigned _errors;
+
+static void *_sender(void *arg)
+{
+    sock_udp_ep_t remote = { .family = AF_INET6, .port = RX_PORT };
+    uint8_t payload[PAYLOAD_SIZE];
+    uint32_t seq = 0;
+
+    (void)arg;
+    memset(payload, 0, sizeof(payload));
+    ipv6_addr_set_loopback((ipv6_addr_t *)&remote.addr.ipv6);
+    while (1) {
+        mutex_lock(&_go);
+        for (unsigned i = 0; i < BURST; i++, seq++) {
+            memcpy(payload, &seq, sizeof(seq));
+            if (sock_udp_send(&_tx, payload, sizeof(payload), &remote) < 0) {
+                puts("send failed");
+            }
+        }
+    }
+    return NULL;
+}
+
+static void _check(const void *data, ssize_t len)
+{
+    uint32_t seq;
+
+    memcpy(&seq, data, sizeof(seq));
+    if ((len != PAYLOAD_SIZE) || (seq != _seq)) {
+        _errors++;
+    }
+    _seq++;
+}
+
+static unsigned _recv_copy(void)
+{
+    unsigned n = 0;
+
+    for (; n < BURST; n++) {
+        ssize_t res = sock_udp_recv(&_rx, _buf, sizeof(_buf), RECV_TIMEOUT,
+                                    NULL);
+        if (res < 0) {
+            break;
+        }
+        _check(_buf, res);
+    }
+    return n;
+}
+
+static unsigned _recv_buf(void)
+{
+    unsigned n = 0;
+
+    for (; n < BURST; n++) {
+        void *data, *ctx;
+        ssize_t res = sock_udp_recv_buf(&_rx, &data, &ctx, RECV_TIMEOUT,
+                                        NULL);
+        if (res < 0) {
+            break;
+        }
+        _check(data, res);
+        sock_udp_recv_buf_release(ctx);
+    }
+    return n;
+}
+
+static unsigned _recv_batch(void)
+{
+    sock_udp_msg_t msgs[BURST];
+    unsigned n = 0;
+
+    while (n < BURST) {
+        int res = sock_udp_recv_batch(&_rx, msgs, BURST - n, RECV_TIMEOUT);
+        if (res < 0) {
+            break;
+        }
+        for (int i = 0; i < res; i++) {
+            _check(msgs[i].data, msgs[i].len);
+            sock_udp_recv_buf_release(msgs[i].buf_ctx);
+        }
+        n += res;
+    }
+    return n;
+}
+
+static unsigned _bench(const char *name, unsigned (*recv)(void))
+{
+    unsigned received = 0;
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < BURSTS_NUMOF; i++) {
+        /* the sender preempts us and queues a whole burst */
+        mutex_unlock(&_go);
+        received += recv();
+    }
+    uint32_t us = xtimer_now_usec() - start;
+    unsigned rate = (unsigned)(((uint64_t)received * US_PER_SEC) /
+                               ((us) ? us : 1));
+
+    printf("%s: %u of %u datagrams in %u us (%u datagrams/s)\n", name,
+           received, BURSTS_NUMOF * BURST, (unsigned)us, rate);
+    return rate;
+}
+
+int main(void)
+{
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+
+    printf("payload: %u bytes, burst: %u\n", PAYLOAD_SIZE, BURST);
+
+    local.port = RX_PORT;
+    if (sock_udp_create(&_rx, &local, NULL, 0) < 0) {
+        puts("create rx sock [FAILED]");
+        return 1;
+    }
+    local.port = TX_PORT;
+    if (sock_udp_create(&_tx, &local, NULL, 0) < 0) {
+        puts("create tx sock [FAILED]");
+        return 1;
+    }
+    thread_create(_tx_stack, sizeof(_tx_stack), THREAD_PRIORITY_MAIN - 1,
+                  THREAD_CREATE_STACKTEST, _sender, NULL, "sender");
+
+    _bench("copy", _recv_copy);
+    _bench("buf", _recv_buf);
+    unsigned result = _bench("batch", _recv_batch);
+
+    if (_errors) {
+        printf("%u errors [FAILED]\n", _errors);
+        return 1;
+    }
+    printf("{ \"result\" : %u }\n", result);
+    return 0;
+}
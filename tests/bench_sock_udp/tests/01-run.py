@@ -0,0 +1,22 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+def testfunc(child):
+    child.expect(r"payload: \d+ bytes, burst: \d+")
+    for name in ("copy", "buf", "batch"):
+        child.expect(r"{}: (\d+) of (\d+) datagrams in \d+ us".format(name))
+        assert child.match.group(1) == child.match.group(2)
+    child.expect(r"{ \"result\" : \d+ }")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Throughput benchmark for SPI storage drivers on the native
+ *              SPI emulation
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "mtd_spi_nor.h"
+#include "native_spi.h"
+#include "sdcard_spi.h"
+#include "sdcard_spi_params.h"
+#include "xtimer.h"
+
+#ifndef BLOCKS_NUMOF
+#define BLOCKS_NUMOF        (64U)
+#endif
+
+#ifndef NOR_TEST_SIZE
+#define NOR_TEST_SIZE       (16 * NATIVE_SPI_NOR_SECTOR_SIZE)
+#endif
+
+#define SD_SIZE             (1024UL * 1024UL)
+#define NOR_SIZE            (1024UL * 1024UL)
+#define NOR_CS              GPIO_PIN(0, 8)
+
+static uint8_t _sd_mem[SD_SIZE];
+static uint8_t _nor_mem[NOR_SIZE];
+
+static native_sdcard_t _sd_model;
+static native_spi_nor_t _nor_model;
+
+static sdcard_spi_t _card;
+static mtd_spi_nor_t _nor = {
+    .base = {
+        .driver = &mtd_spi_nor_driver,
+        .page_size = NATIVE_SPI_NOR_PAGE_SIZE,
+        .pages_per_sector = NATIVE_SPI_NOR_SECTOR_SIZE / NATIVE_SPI_NOR_PAGE_SIZE,
+        .sector_count = NOR_SIZE / NATIVE_SPI_NOR_SECTOR_SIZE,
+    },
+    .opcode = &mtd_spi_nor_opcode_default,
+    .spi = SPI_DEV(0),
+    .cs = NOR_CS,
+    .addr_width = 3,
+    .mode = SPI_MODE_0,
+    .clk = SPI_CLK_10MHZ,
+    .flag = SPI_NOR_F_SECT_4K,
+};
+
+static char _data[BLOCKS_NUMOF * SD_HC_BLOCK_SIZE];
+static char _buf[BLOCKS_NUMOF * SD_HC_BLOCK_SIZE];
+
+static unsigned _rate(size_t bytes, uint32_t us)
+{
+    return (unsigned)(((uint64_t)bytes * US_PER_SEC) / (1024 * (uint64_t)us));
+}
+
+static unsigned _print(const char *name, size_t bytes, uint32_t us, bool ok)
+{
+    if (us == 0) {
+        us = 1;
+    }
+    printf("%s: %u bytes in %u us (%u KiB/s) [%s]\n", name, (unsigned)bytes,
+           (unsigned)us, _rate(bytes, us), (ok) ? "OK" : "FAILED");
+    return _rate(bytes, us);
+}
+
+static void _bench_sdcard(unsigned *result)
+{
+    sd_rw_response_t state;
+    uint32_t start;
+    int res;
+
+    start = xtimer_now_usec();
+    res = sdcard_spi_write_blocks(&_card, 0, _data, SD_HC_BLOCK_SIZE,
+                                  BLOCKS_NUMOF, &state);
+    _print("sdcard write multi", sizeof(_data), xtimer_now_usec() - start,
+           (res == BLOCKS_NUMOF) && (state == SD_RW_OK));
+
+    memset(_buf, 0, sizeof(_buf));
+    start = xtimer_now_usec();
+    res = sdcard_spi_read_blocks(&_card, 0, _buf, SD_HC_BLOCK_SIZE,
+                                 BLOCKS_NUMOF, &state);
+    *result = _print("sdcard read multi", sizeof(_buf),
+                     xtimer_now_usec() - start,
+                     (res == BLOCKS_NUMOF) && (state == SD_RW_OK) &&
+                     (memcmp(_buf, _data, sizeof(_buf)) == 0));
+
+    memset(_buf, 0, sizeof(_buf));
+    bool ok = true;
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < BLOCKS_NUMOF; i++) {
+        res = sdcard_spi_read_blocks(&_card, i, &_buf[i * SD_HC_BLOCK_SIZE],
+                                     SD_HC_BLOCK_SIZE, 1, &state);
+        ok = ok && (res == 1) && (state == SD_RW_OK);
+    }
+    _print("sdcard read single", sizeof(_buf), xtimer_now_usec() - start,
+           ok && (memcmp(_buf, _data, sizeof(_buf)) == 0));
+}
+
+static void _bench_nor(void)
+{
+    mtd_dev_t *mtd = &_nor.base;
+    uint32_t start;
+    int res;
+    bool ok = true;
+
+    start = xtimer_now_usec();
+    res = mtd_erase(mtd, 0, NOR_TEST_SIZE);
+    _print("nor erase", NOR_TEST_SIZE, xtimer_now_usec() - start,
+           (res == 0) && (_nor_mem[NOR_TEST_SIZE - 1] == 0xff));
+
+    start = xtimer_now_usec();
+    for (uint32_t addr = 0; addr < NOR_TEST_SIZE; addr += mtd->page_size) {
+        res = mtd_write(mtd, &_data[addr % sizeof(_data)], addr,
+                        mtd->page_size);
+        ok = ok && (res == (int)mtd->page_size);
+    }
+    _print("nor write", NOR_TEST_SIZE, xtimer_now_usec() - start, ok);
+
+    memset(_buf, 0, sizeof(_buf));
+    size_t len = (NOR_TEST_SIZE < sizeof(_buf)) ? NOR_TEST_SIZE : sizeof(_buf);
+    start = xtimer_now_usec();
+    res = mtd_read(mtd, _buf, 0, len);
+    _print("nor read", len, xtimer_now_usec() - start,
+           (res == (int)len) && (memcmp(_buf, _data, len) == 0));
+}
+
+int main(void)
+{
+    unsigned result = 0;
+
+    native_sdcard_init(&_sd_model, _sd_mem, sizeof(_sd_mem));
+    native_spi_attach(sdcard_spi_params[0].spi_dev, &_sd_model.dev,
+                      sdcard_spi_params[0].cs);
+    native_spi_nor_init(&_nor_model, _nor_mem, sizeof(_nor_mem));
+    native_spi_attach(_nor.spi, &_nor_model.dev, NOR_CS);
+
+    for (unsigned i = 0; i < sizeof(_data); i++) {
+        _data[i] = (char)(i * 7 + (i >> 9));
+    }
+
+    if (sdcard_spi_init(&_card, &sdcard_spi_params[0]) != SDCARD_SPI_OK) {
+        puts("sdcard: init [FAILED]");
+        return 1;
+    }
+    puts("sdcard: init [OK]");
+    _bench_sdcard(&result);
+
+    if (mtd_init(&_nor.base) != 0) {
+        puts("nor: init [FAILED]");
+        return 1;
+    }
+    _bench_nor();
+
+    printf("{ \"result\" : %u }\n", result);
+    return 0;
+}
@@ -0,0 +1,23 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+def testfunc(child):
+    child.expect_exact("sdcard: init [OK]")
+    for name in ("sdcard write multi", "sdcard read multi",
+                 "sdcard read single", "nor erase", "nor write", "nor read"):
+        child.expect(r"{}: \d+ bytes in \d+ us \(\d+ KiB/s\) \[OK\]"
+                     .format(name))
+    child.expect(r"{ \"result\" : \d+ }")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Compare blocking and buffered output on the STDIO UART
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "irq.h"
+#include "periph/uart.h"
+#include "stdio_uart.h"
+#include "xtimer.h"
+
+/* number of lines that fit into the transmit buffer */
+#ifndef BURST_LINES
+#define BURST_LINES     (4U)
+#endif
+
+/* number of lines that exceed the transmit buffer */
+#ifndef STREAM_LINES
+#define STREAM_LINES    (32U)
+#endif
+
+static const char _line[] =
+    "stdio_uart benchmark: 0123456789abcdefghijklmnopqrstuvwxyz\n";
+
+static void _print(const char *name, unsigned lines, uint32_t caller,
+                   uint32_t total)
+{
+    printf("%s: %u bytes, caller blocked %u us, sent after %u us\n", name,
+           (unsigned)(lines * (sizeof(_line) - 1)), (unsigned)caller,
+           (unsigned)total);
+}
+
+static void _bench_uart_write(unsigned lines)
+{
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < lines; i++) {
+        uart_write(STDIO_UART_DEV, (const uint8_t *)_line, sizeof(_line) - 1);
+    }
+    uint32_t time = xtimer_now_usec() - start;
+    _print("uart_write", lines, time, time);
+}
+
+static uint32_t _bench_stdio_write(const char *name, unsigned lines)
+{
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < lines; i++) {
+        stdio_write(_line, sizeof(_line) - 1);
+    }
+    uint32_t caller = xtimer_now_usec() - start;
+    stdio_uart_flush();
+    _print(name, lines, caller, xtimer_now_usec() - start);
+    return caller;
+}
+
+/* more than the transmit buffer holds, behind buffered output, with
+ * interrupts disabled: must neither wait for the transmit interrupt nor
+ * for a lock */
+static void _irq_disabled_write(unsigned lines)
+{
+    for (unsigned i = 0; i < BURST_LINES; i++) {
+        stdio_write(_line, sizeof(_line) - 1);
+    }
+
+    uint32_t start = xtimer_now_usec();
+    unsigned state = irq_disable();
+    for (unsigned i = 0; i < lines; i++) {
+        stdio_write(_line, sizeof(_line) - 1);
+    }
+    irq_restore(state);
+    uint32_t time = xtimer_now_usec() - start;
+    stdio_uart_flush();
+    _print("irq_disable", lines, time, time);
+}
+
+int main(void)
+{
+#ifdef BOARD_NATIVE
+    /* on other boards, this is done by the C library */
+    stdio_init();
+#endif
+    stdio_uart_flush();
+
+    _bench_uart_write(BURST_LINES);
+    uint32_t result = _bench_stdio_write("stdio_write burst", BURST_LINES);
+    _bench_uart_write(STREAM_LINES);
+    _bench_stdio_write("stdio_write stream", STREAM_LINES);
+    _irq_disabled_write(STREAM_LINES);
+
+    printf("{ \"result\" : %u }\n", (unsigned)result);
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark of small reads and writes with and without the
+ *              vfs_buffer module
+ *
+ * @}
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "board.h"
+#include "fs/littlefs_fs.h"
+#include "vfs.h"
+#include "xtimer.h"
+
+#ifndef RECORDS
+#define RECORDS             (2000U)
+#endif
+
+#ifndef RECORD_SIZE
+#define RECORD_SIZE         (20U)
+#endif
+
+#define MOUNT_POINT         "/nvm0"
+#define FILE_NAME           MOUNT_POINT "/log"
+
+static littlefs_desc_t _fs_desc = {
+    .lock = MUTEX_INIT,
+};
+
+static vfs_mount_t _mount = {
+    .fs = &littlefs_file_system,
+    .mount_point = MOUNT_POINT,
+    .private_data = &_fs_desc,
+};
+
+static unsigned _errors;
+
+static void _record(uint8_t *rec, unsigned i)
+{
+    memset(rec, ' ', RECORD_SIZE);
+    snprintf((char *)rec, RECORD_SIZE, "%u", i);
+    rec[RECORD_SIZE - 1] = '\n';
+}
+
+static unsigned _report(const char *mode, const char *op, uint32_t start)
+{
+    uint32_t us = xtimer_now_usec() - start;
+    unsigned rate = (unsigned)(((uint64_t)RECORDS * US_PER_SEC) /
+                               ((us) ? us : 1));
+
+    printf("%s %s: %u us (%u records/s)\n", mode, op, (unsigned)us, rate);
+    return rate;
+}
+
+static unsigned _bench(const char *mode, bool buffered)
+{
+    uint8_t rec[RECORD_SIZE], exp[RECORD_SIZE];
+    uint32_t start;
+    unsigned rate;
+
+    vfs_unlink(FILE_NAME);
+    int fd = vfs_open(FILE_NAME, O_CREAT | O_WRONLY | O_APPEND, 0);
+    if (fd < 0) {
+        printf("open: %d\n", fd);
+        _errors++;
+        return 0;
+    }
+    vfs_setbuf(fd, buffered);
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < RECORDS; i++) {
+        _record(rec, i);
+        if (vfs_write(fd, rec, sizeof(rec)) != sizeof(rec)) {
+            _errors++;
+        }
+    }
+    if (vfs_close(fd) < 0) {
+        _errors++;
+    }
+    rate = _report(mode, "write", start);
+
+    fd = vfs_open(FILE_NAME, O_RDONLY, 0);
+    if (fd < 0) {
+        printf("open: %d\n", fd);
+        _errors++;
+        return 0;
+    }
+    vfs_setbuf(fd, buffered);
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < RECORDS; i++) {
+        size_t len = 0;
+        while (len < sizeof(rec)) {
+            ssize_t res = vfs_read(fd, &rec[len], sizeof(rec) - len);
+            if (res <= 0) {
+                break;
+            }
+            len += res;
+        }
+        _record(exp, i);
+        if ((len != sizeof(rec)) || memcmp(rec, exp, sizeof(rec))) {
+            _errors++;
+        }
+    }
+    vfs_close(fd);
+    _report(mode, "read", start);
+    return rate;
+}
+
+int main(void)
+{
+    _fs_desc.dev = MTD_0;
+    printf("records: %u of %u bytes, buffer: %u bytes\n",
+           RECORDS, RECORD_SIZE, (unsigned)VFS_BUFFER_SIZE);
+
+    if ((vfs_format(&_mount) < 0) || (vfs_mount(&_mount) < 0)) {
+        puts("mount [FAILED]");
+        return 1;
+    }
+    _bench("unbuffered", false);
+    unsigned result = _bench("buffered", true);
+    vfs_unlink(FILE_NAME);
+    vfs_umount(&_mount);
+
+    if (_errors) {
+        printf("%u errors [FAILED]\n", _errors);
+        return 1;
+    }
+    printf("{ \"result\" : %u }\n", result);
+    return 0;
+}
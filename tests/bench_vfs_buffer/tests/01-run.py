@@ -0,0 +1,22 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+def testfunc(child):
+    child.expect(r"records: \d+ of \d+ bytes, buffer: \d+ bytes")
+    for mode in ("unbuffered", "buffered"):
+        for op in ("write", "read"):
+            child.expect(r"{} {}: \d+ us \(\d+ records/s\)".format(mode, op))
+    child.expect(r"{ \"result\" : \d+ }")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc, timeout=120))
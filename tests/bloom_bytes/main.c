@@ -13,6 +13,10 @@
  * @file
  * @brief Bloom filter test application
  *
+ * Compares the false positive rate and the add/check throughput of the
+ * classic Bloom filter with the blocked variant (single and batched calls)
+ * at the same size.
+ *
  * @author Christian Mehlis <mehlis@inf.fu-berlin.de>
  *
  * @}
@@ -39,8 +43,25 @@
 
 #define myseed 0x83d385c0 /* random number */
 
+/* elements are generated in chunks of this size, only the calls into the
+ * filter are timed */
+#define CHUNK (BLOOM_BLOCKED_BATCH_SIZE)
+
 #define BUF_SIZE 50
-static uint32_t buf[BUF_SIZE];
+#define BUF_LEN (BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t))
+
+enum {
+    CLASSIC,
+    BLOCKED,
+    BLOCKED_BATCH,
+};
+
+static const char *names[] = { "classic", "blocked", "blocked batch" };
+
+static uint32_t buf[CHUNK][BUF_SIZE];
+static const uint8_t *bufs[CHUNK];
+static size_t lens[CHUNK];
+
 static bloom_t bloom;
 BITFIELD(bf, BLOOM_BITS);
 hashfp_t hashes[BLOOM_HASHF] = {
@@ -49,69 +70,121 @@ hashfp_t hashes[BLOOM_HASHF] = {
     (hashfp_t) rotating_hash, (hashfp_t) one_at_a_time_hash,
 };
 
-static void buf_fill(uint32_t *buf, int len)
+static bloom_blocked_t blocked;
+static uint8_t blocks[BLOOM_BITS / 8]
+    __attribute__((aligned(BLOOM_BLOCKED_BLOCK_SIZE)));
+
+static void buf_fill(uint32_t magic, unsigned numof)
 {
-    for (int k = 0; k < len; k++) {
-        buf[k] = random_uint32();
+    for (unsigned i = 0; i < numof; i++) {
+        for (int k = 0; k < BUF_SIZE; k++) {
+            buf[i][k] = random_uint32();
+        }
+        buf[i][0] = magic;
     }
 }
 
-int main(void)
+static uint32_t add(unsigned variant, unsigned numof)
 {
-    xtimer_init();
+    uint32_t start = xtimer_now_usec();
+
+    switch (variant) {
+        case CLASSIC:
+            for (unsigned i = 0; i < numof; i++) {
+                bloom_add(&bloom, bufs[i], lens[i]);
+            }
+            break;
+        case BLOCKED:
+            for (unsigned i = 0; i < numof; i++) {
+                bloom_blocked_add(&blocked, bufs[i], lens[i]);
+            }
+            break;
+        default:
+            bloom_blocked_add_batch(&blocked, bufs, lens, numof);
+            break;
+    }
+    return xtimer_now_usec() - start;
+}
 
-    bloom_init(&bloom, BLOOM_BITS, bf, hashes, BLOOM_HASHF);
+static uint32_t check(unsigned variant, unsigned numof, unsigned *in)
+{
+    uint32_t start = xtimer_now_usec();
+
+    switch (variant) {
+        case CLASSIC:
+            for (unsigned i = 0; i < numof; i++) {
+                *in += bloom_check(&bloom, bufs[i], lens[i]);
+            }
+            break;
+        case BLOCKED:
+            for (unsigned i = 0; i < numof; i++) {
+                *in += bloom_blocked_check(&blocked, bufs[i], lens[i]);
+            }
+            break;
+        default:
+            *in += bloom_blocked_check_batch(&blocked, bufs, lens, numof,
+                                             NULL);
+            break;
+    }
+    return xtimer_now_usec() - start;
+}
 
-    printf("Testing Bloom filter.\n\n");
-    printf("m: %" PRIu32 " k: %" PRIu32 "\n\n", (uint32_t) bloom.m,
-           (uint32_t) bloom.k);
+static void run(unsigned variant)
+{
+    uint32_t t_add = 0;
+    uint32_t t_check = 0;
+    unsigned in = 0;
 
+    /* every variant sees the same elements */
     random_init(myseed);
 
-    unsigned long t1 = xtimer_now_usec();
-
-    for (int i = 0; i < lenB; i++) {
-        buf_fill(buf, BUF_SIZE);
-        buf[0] = MAGIC_B;
-        bloom_add(&bloom,
-                  (uint8_t *) buf,
-                  BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t));
+    for (unsigned i = 0; i < lenB; i += CHUNK) {
+        buf_fill(MAGIC_B, CHUNK);
+        t_add += add(variant, CHUNK);
     }
+    printf("%s: adding %d elements took %" PRIu32 "us\n",
+           names[variant], lenB, t_add);
 
-    unsigned long t2 = xtimer_now_usec();
-    printf("adding %d elements took %" PRIu32 "ms\n", lenB,
-           (uint32_t) (t2 - t1) / 1000);
+    for (unsigned i = 0; i < lenA; i += CHUNK) {
+        unsigned n = ((lenA - i) < CHUNK) ? (lenA - i) : CHUNK;
 
-    int in = 0;
-    int not_in = 0;
+        buf_fill(MAGIC_A, n);
+        t_check += check(variant, n, &in);
+    }
+    printf("%s: checking %d elements took %" PRIu32 "us\n",
+           names[variant], lenA, t_check);
 
-    unsigned long t3 = xtimer_now_usec();
+    printf("%s: %u elements probably in the filter.\n", names[variant], in);
+    printf("%s: %u elements not in the filter.\n", names[variant], lenA - in);
+    double false_positive_rate = (double) in / (double) lenA;
+    printf("%s: %f false positive rate.\n", names[variant],
+           false_positive_rate);
+    printf("%s: { \"result\" : %" PRIu32 " }\n\n", names[variant],
+           (uint32_t)(((uint64_t)lenA * US_PER_SEC) / (t_check ? t_check : 1)));
+}
 
-    for (int i = 0; i < lenA; i++) {
-        buf_fill(buf, BUF_SIZE);
-        buf[0] = MAGIC_A;
+int main(void)
+{
+    xtimer_init();
 
-        if (bloom_check(&bloom,
-                        (uint8_t *) buf,
-                        BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t))) {
-            in++;
-        }
-        else {
-            not_in++;
-        }
+    for (unsigned i = 0; i < CHUNK; i++) {
+        bufs[i] = (const uint8_t *)buf[i];
+        lens[i] = BUF_LEN;
     }
 
-    unsigned long t4 = xtimer_now_usec();
-    printf("checking %d elements took %" PRIu32 "ms\n", lenA,
-           (uint32_t) (t4 - t3) / 1000);
+    bloom_init(&bloom, BLOOM_BITS, bf, hashes, BLOOM_HASHF);
+    bloom_blocked_init(&blocked, blocks, sizeof(blocks), BLOOM_HASHF);
 
-    printf("\n");
-    printf("%d elements probably in the filter.\n", in);
-    printf("%d elements not in the filter.\n", not_in);
-    double false_positive_rate = (double) in / (double) lenA;
-    printf("%f false positive rate.\n", false_positive_rate);
+    printf("Testing Bloom filter.\n\n");
+    printf("m: %" PRIu32 " k: %" PRIu32 "\n\n", (uint32_t) bloom.m,
+           (uint32_t) bloom.k);
+
+    run(CLASSIC);
+    run(BLOCKED);
+    bloom_blocked_clear(&blocked);
+    run(BLOCKED_BATCH);
 
     bloom_del(&bloom);
-    printf("\nAll done!\n");
+    printf("All done!\n");
     return 0;
 }
@@ -12,15 +12,26 @@ from testrunner import run
 # Biggest step takes 135 seconds on wn430
 TIMEOUT = 150
 
+VARIANTS = ("classic", "blocked", "blocked batch")
+
 
 def testfunc(child):
     child.expect_exact("Testing Bloom filter.")
     child.expect_exact("m: 4096 k: 8")
-    child.expect("adding 512 elements took \d+ms", timeout=TIMEOUT)
-    child.expect("checking 10000 elements took \d+ms", timeout=TIMEOUT)
-    child.expect("\d+ elements probably in the filter.")
-    child.expect("\d+ elements not in the filter.")
-    child.expect(".+ false positive rate.")
+    fp_rates = {}
+    for variant in VARIANTS:
+        child.expect(r"{}: adding 512 elements took \d+us".format(variant),
+                     timeout=TIMEOUT)
+        child.expect(r"{}: checking 10000 elements took \d+us".format(variant),
+                     timeout=TIMEOUT)
+        child.expect(r"{}: (\d+) elements probably in the filter."
+                     .format(variant))
+        fp_rates[variant] = int(child.match.group(1))
+        child.expect(r"{}: \d+ elements not in the filter.".format(variant))
+        child.expect(r"{}: .+ false positive rate.".format(variant))
+        child.expect(r"{}: {{ \"result\" : \d+ }}".format(variant))
+    # single and batched calls must yield the very same filter
+    assert fp_rates["blocked"] == fp_rates["blocked batch"]
     child.expect_exact("All done!")
 
 
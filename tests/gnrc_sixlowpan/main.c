@@ -11,7 +11,8 @@
  * @{
  *
  * @file
- * @brief       Tests extension header handling of gnrc stack.
+ * @brief       Tests extension header handling of gnrc stack and
+ *              benchmarks 6LoWPAN header compression
  *
  * @author      Hauke Petersen <hauke.petersen@fu-berlin.de>
  * @author      Takuo Yonezawa <Yonezawa-T2@mail.dnp.co.jp>
@@ -19,11 +20,14 @@
  * @}
  */
 
+#include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "shell.h"
 #include "msg.h"
 #include "net/ipv6/addr.h"
+#include "net/gnrc/ipv6/hdr.h"
 #include "net/gnrc/pkt.h"
 #include "net/gnrc/pktbuf.h"
 #include "net/gnrc/netreg.h"
@@ -33,13 +37,39 @@
 #include "net/gnrc/netif/ieee802154.h"
 #include "net/gnrc/netif/hdr.h"
 #include "net/gnrc/pktdump.h"
+#include "net/gnrc/sixlowpan/ctx.h"
+#include "net/gnrc/sixlowpan/iphc.h"
+#include "net/gnrc/udp.h"
 #include "net/netdev_test.h"
+#include "net/protnum.h"
+#include "utlist.h"
 #include "xtimer.h"
 
 #define IEEE802154_MAX_FRAG_SIZE    (102)
 
+#ifndef BENCH_PACKETS
+#define BENCH_PACKETS               (1000U)
+#endif
+/* must exceed GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE, so every packet misses */
+#define BENCH_FLOWS                 (16U)
+#define BENCH_PAYLOAD_SIZE          (32U)
+#define BENCH_PORT                  (61616U)
+#define MSG_QUEUE_SIZE              (8U)
+
 static char _netif_stack[THREAD_STACKSIZE_DEFAULT];
 static netdev_test_t _ieee802154_dev;
+static msg_t _msg_queue[MSG_QUEUE_SIZE];
+
+static gnrc_netreg_entry_t _dump_6lowpan = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL, 0);
+static gnrc_netreg_entry_t _dump_ipv6 = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL, 0);
+static gnrc_netreg_entry_t _dump_udp = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL, 0);
+static gnrc_netreg_entry_t _dump_udp_61616 = GNRC_NETREG_ENTRY_INIT_PID(61616, 0);
+
+/* 6LoWPAN part of the last frame sent */
+static uint8_t _frame[IEEE802154_MAX_FRAG_SIZE];
+static size_t _frame_len;
+static unsigned _frames;
+static const uint8_t _payload[BENCH_PAYLOAD_SIZE];
 
 static int _get_netdev_device_type(netdev_t *netdev, void *value, size_t max_len)
 {
@@ -68,6 +98,23 @@ static int _get_netdev_src_len(netdev_t *netdev, void *value, size_t max_len)
     return sizeof(uint16_t);
 }
 
+static int _netdev_send(netdev_t *netdev, const iolist_t *iolist)
+{
+    size_t len = 0;
+
+    (void)netdev;
+    /* skip MAC header, its sequence number changes with every frame */
+    for (iolist = iolist->iol_next; iolist != NULL; iolist = iolist->iol_next) {
+        if ((len + iolist->iol_len) <= sizeof(_frame)) {
+            memcpy(&_frame[len], iolist->iol_base, iolist->iol_len);
+        }
+        len += iolist->iol_len;
+    }
+    _frame_len = len;
+    _frames++;
+    return len;
+}
+
 static void _init_interface(void)
 {
     gnrc_netif_t *netif;
@@ -79,6 +126,7 @@ static void _init_interface(void)
                            _get_netdev_max_packet_size);
     netdev_test_set_get_cb(&_ieee802154_dev, NETOPT_SRC_LEN,
                            _get_netdev_src_len);
+    netdev_test_set_send_cb(&_ieee802154_dev, _netdev_send);
     netif = gnrc_netif_ieee802154_create(
             _netif_stack, THREAD_STACKSIZE_DEFAULT, GNRC_NETIF_PRIO,
             "dummy_netif", (netdev_t *)&_ieee802154_dev);
@@ -171,15 +219,15 @@ static void _send_packet(void)
         0x00, 0x00, 0x00, 0x00,
     };
 
-    gnrc_netreg_entry_t dump_6lowpan = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL, gnrc_pktdump_pid);
-    gnrc_netreg_entry_t dump_ipv6 = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL, gnrc_pktdump_pid);
-    gnrc_netreg_entry_t dump_udp = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL, gnrc_pktdump_pid);
-    gnrc_netreg_entry_t dump_udp_61616 = GNRC_NETREG_ENTRY_INIT_PID(61616, gnrc_pktdump_pid);
+    _dump_6lowpan.target.pid = gnrc_pktdump_pid;
+    _dump_ipv6.target.pid = gnrc_pktdump_pid;
+    _dump_udp.target.pid = gnrc_pktdump_pid;
+    _dump_udp_61616.target.pid = gnrc_pktdump_pid;
 
-    gnrc_netreg_register(GNRC_NETTYPE_SIXLOWPAN, &dump_6lowpan);
-    gnrc_netreg_register(GNRC_NETTYPE_IPV6, &dump_ipv6);
-    gnrc_netreg_register(GNRC_NETTYPE_UDP, &dump_udp);
-    gnrc_netreg_register(GNRC_NETTYPE_UDP, &dump_udp_61616);
+    gnrc_netreg_register(GNRC_NETTYPE_SIXLOWPAN, &_dump_6lowpan);
+    gnrc_netreg_register(GNRC_NETTYPE_IPV6, &_dump_ipv6);
+    gnrc_netreg_register(GNRC_NETTYPE_UDP, &_dump_udp);
+    gnrc_netreg_register(GNRC_NETTYPE_UDP, &_dump_udp_61616);
 
     gnrc_pktsnip_t *netif1 = gnrc_pktbuf_add(NULL,
                                             &netif_hdr,
@@ -204,12 +252,185 @@ static void _send_packet(void)
     gnrc_netapi_dispatch_receive(GNRC_NETTYPE_SIXLOWPAN, GNRC_NETREG_DEMUX_CTX_ALL, pkt2);
 }
 
+static unsigned _rate(unsigned packets, uint32_t us)
+{
+    return (unsigned)(((uint64_t)packets * US_PER_SEC) / ((us) ? us : 1));
+}
+
+static gnrc_pktsnip_t *_build_udp(unsigned flow, uint16_t cksum)
+{
+    gnrc_netif_t *netif = gnrc_netif_iter(NULL);
+    uint8_t dst_l2addr[] = { 0x02, 0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x02 };
+    ipv6_addr_t src, dst;
+    gnrc_pktsnip_t *pkt, *ipv6, *netif_hdr;
+
+    /* link-local source with 16 bit IID, destination compressed with
+     * context 0 */
+    ipv6_addr_from_str(&src, "fe80::ff:fe00:1");
+    ipv6_addr_from_str(&dst, "fd01::ff:fe00:2");
+    dst.u8[15] += flow;
+    dst_l2addr[7] += flow;
+
+    pkt = gnrc_pktbuf_add(NULL, _payload, sizeof(_payload), GNRC_NETTYPE_UNDEF);
+    pkt = gnrc_udp_hdr_build(pkt, BENCH_PORT, BENCH_PORT + 1);
+    if (pkt == NULL) {
+        return NULL;
+    }
+    ((udp_hdr_t *)pkt->data)->checksum = byteorder_htons(cksum);
+    ipv6 = gnrc_ipv6_hdr_build(pkt, &src, &dst);
+    if (ipv6 == NULL) {
+        gnrc_pktbuf_release(pkt);
+        return NULL;
+    }
+    ipv6_hdr_t *hdr = ipv6->data;
+    hdr->nh = PROTNUM_UDP;
+    hdr->hl = 64;
+    hdr->len = byteorder_htons(gnrc_pkt_len(pkt));
+    netif_hdr = gnrc_netif_hdr_build(NULL, 0, dst_l2addr, sizeof(dst_l2addr));
+    if (netif_hdr == NULL) {
+        gnrc_pktbuf_release(ipv6);
+        return NULL;
+    }
+    ((gnrc_netif_hdr_t *)netif_hdr->data)->if_pid = netif->pid;
+    LL_PREPEND(ipv6, netif_hdr);
+    return ipv6;
+}
+
+/* sends packets to BENCH_FLOWS destinations in turn if flows > 1, or to a
+ * single one and checks that all packets are compressed alike */
+static bool _bench_compress(const char *name, unsigned flows)
+{
+    uint8_t ref[sizeof(_frame)];
+    size_t ref_len = 0;
+    bool ok = true;
+    unsigned frames = _frames;
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < BENCH_PACKETS; i++) {
+        gnrc_pktsnip_t *pkt = _build_udp(i % flows, i);
+
+        if ((pkt == NULL) ||
+            !gnrc_netapi_dispatch_send(GNRC_NETTYPE_SIXLOWPAN,
+                                       GNRC_NETREG_DEMUX_CTX_ALL, pkt)) {
+            gnrc_pktbuf_release(pkt);
+            ok = false;
+            break;
+        }
+        if ((flows > 1) || (_frame_len < BENCH_PAYLOAD_SIZE)) {
+            continue;
+        }
+        /* only the UDP checksum, the end of the header, may differ */
+        size_t cksum_pos = _frame_len - BENCH_PAYLOAD_SIZE - 2;
+        if (i == 0) {
+            memcpy(ref, _frame, _frame_len);
+            ref_len = _frame_len;
+        }
+        if ((_frame_len != ref_len) ||
+            (memcmp(ref, _frame, cksum_pos) != 0) ||
+            (_frame[cksum_pos] != (i >> 8)) ||
+            (_frame[cksum_pos + 1] != (i & 0xff))) {
+            ok = false;
+        }
+    }
+    uint32_t us = xtimer_now_usec() - start;
+
+    frames = _frames - frames;
+    printf("compression (%s): %u of %u packets in %u us (%u packets/s)\n",
+           name, frames, BENCH_PACKETS, (unsigned)us, _rate(frames, us));
+    return ok && (frames == BENCH_PACKETS);
+}
+
+static bool _bench_decompress(void)
+{
+    gnrc_netif_t *netif = gnrc_netif_iter(NULL);
+    gnrc_netreg_entry_t udp = GNRC_NETREG_ENTRY_INIT_PID(BENCH_PORT,
+                                                         thread_getpid());
+    struct {
+        gnrc_netif_hdr_t netif_hdr;
+        uint8_t src[8];
+        uint8_t dst[8];
+    } netif_hdr = {
+        .src = { 0x02, 0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x02 },
+        .dst = { 0x02, 0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x01 },
+    };
+    uint8_t frame[24 + BENCH_PAYLOAD_SIZE] = {
+        /* IPHC: TF elided, NH compressed, HLIM 64, SAM 0 bits,
+         * DAM 128 bits */
+        0x7a, 0x30,
+        /* destination address: fd01::1 */
+        0xfd, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+        /* UDP NHC: destination port (0xf0b0) 8 bits inline */
+        0xf2, 0xf0, 0xb1, 0xb0,
+        /* checksum */
+        0x23, 0xb6,
+    };
+    unsigned received = 0;
+    uint32_t start = xtimer_now_usec();
+
+    gnrc_netif_hdr_init(&netif_hdr.netif_hdr, 8, 8);
+    netif_hdr.netif_hdr.if_pid = netif->pid;
+    gnrc_netreg_register(GNRC_NETTYPE_UDP, &udp);
+    for (unsigned i = 0; i < BENCH_PACKETS; i++) {
+        gnrc_pktsnip_t *hdr, *pkt;
+        msg_t msg;
+
+        hdr = gnrc_pktbuf_add(NULL, &netif_hdr, sizeof(netif_hdr),
+                              GNRC_NETTYPE_NETIF);
+        pkt = gnrc_pktbuf_add(hdr, frame, sizeof(frame),
+                              GNRC_NETTYPE_SIXLOWPAN);
+        if ((hdr == NULL) || (pkt == NULL)) {
+            gnrc_pktbuf_release(hdr);
+            break;
+        }
+        gnrc_netapi_dispatch_receive(GNRC_NETTYPE_SIXLOWPAN,
+                                     GNRC_NETREG_DEMUX_CTX_ALL, pkt);
+        /* the stack runs at higher priority, so the packet is delivered by
+         * now */
+        while (msg_try_receive(&msg) == 1) {
+            if (msg.type == GNRC_NETAPI_MSG_TYPE_RCV) {
+                gnrc_pktbuf_release(msg.content.ptr);
+                received++;
+            }
+        }
+    }
+    uint32_t us = xtimer_now_usec() - start;
+    gnrc_netreg_unregister(GNRC_NETTYPE_UDP, &udp);
+
+    printf("decompression: %u of %u packets in %u us (%u packets/s)\n",
+           received, BENCH_PACKETS, (unsigned)us, _rate(received, us));
+    return received == BENCH_PACKETS;
+}
+
+static void _bench(void)
+{
+    ipv6_addr_t prefix;
+    bool ok;
+
+    /* stop dumping packets */
+    gnrc_netreg_unregister(GNRC_NETTYPE_SIXLOWPAN, &_dump_6lowpan);
+    gnrc_netreg_unregister(GNRC_NETTYPE_IPV6, &_dump_ipv6);
+    gnrc_netreg_unregister(GNRC_NETTYPE_UDP, &_dump_udp);
+    gnrc_netreg_unregister(GNRC_NETTYPE_UDP, &_dump_udp_61616);
+
+    ipv6_addr_from_str(&prefix, "fd01::");
+    gnrc_sixlowpan_ctx_update(0, &prefix, 64, 60, true);
+
+    printf("flow cache size: %u\n", GNRC_SIXLOWPAN_IPHC_FLOW_CACHE_SIZE);
+    ok = _bench_compress("single flow", 1);
+    ok = _bench_compress("distinct flows", BENCH_FLOWS) && ok;
+    ok = _bench_decompress() && ok;
+    puts((ok) ? "[SUCCESS]" : "[FAILED]");
+}
+
 int main(void)
 {
     puts("RIOT network stack example application");
 
+    msg_init_queue(_msg_queue, MSG_QUEUE_SIZE);
     _init_interface();
     _send_packet();
+    _bench();
 
     return 0;
 }
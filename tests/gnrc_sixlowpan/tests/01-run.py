@@ -74,6 +74,16 @@ def testfunc(child):
     child.expect_exact("source address: fe80::ff:fe00:2")
     child.expect_exact("destination address: fd01::1")
 
+    # header compression benchmark
+    child.expect(r"flow cache size: \d+")
+    for name in ("single flow", "distinct flows"):
+        child.expect(r"compression \({}\): (\d+) of (\d+) packets in \d+ us"
+                     .format(name))
+        assert child.match.group(1) == child.match.group(2)
+    child.expect(r"decompression: (\d+) of (\d+) packets in \d+ us")
+    assert child.match.group(1) == child.match.group(2)
+    child.expect_exact("[SUCCESS]")
+
 
 if __name__ == "__main__":
     sys.exit(run(testfunc))
@@ -13,6 +13,10 @@
  * @file
  * @brief       sock DNS client test application
  *
+ * If compiled with `DNS_STUB=1`, queries are answered by a stub server within
+ * this application and the hit rate and latency of repeated lookups are
+ * measured.
+ *
  * @author      Kaspar Schleiser <kaspar@schleiser.de>
  *
  * @}
@@ -20,11 +24,16 @@
 
 #include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <arpa/inet.h>
 
+#include "byteorder.h"
+#include "mutex.h"
+#include "net/ipv6/addr.h"
 #include "net/sock/dns.h"
 #include "net/sock/util.h"
+#include "thread.h"
 #include "xtimer.h"
 
 #ifndef TEST_NAME
@@ -35,16 +44,179 @@
 
 extern int _gnrc_netif_config(int argc, char **argv);
 
+#ifdef DNS_STUB
+#define STUB_TTL        (300U)
+#define LOOKUPS         (200U)
+/* the last name does not exist */
+#define NAMES_NUMOF     (8U)
+#define ANSWER_LEN      (12U + 16U)
+
+static const uint8_t _stub_addr6[] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+                                       0, 0, 0, 0, 0, 0, 0, 0x01 };
+static const uint8_t _stub_addr4[] = { 192, 0, 2, 1 };
+
+static char _stub_stack[THREAD_STACKSIZE_DEFAULT + SOCK_DNS_REPLY_LEN];
+static unsigned _stub_queries;
+static unsigned _async_pending;
+static mutex_t _async_done = MUTEX_INIT_LOCKED;
+
+static size_t _stub_answer(uint8_t *buf, size_t len)
+{
+    sock_dns_hdr_t *hdr = (sock_dns_hdr_t *)buf;
+    uint8_t *name = hdr->payload;
+    uint8_t *pos = name;
+    uint16_t type;
+
+    /* response, recursion desired and available */
+    hdr->flags = htons(0x8180);
+    if ((name[0] >= 2) && (name[1] == 'n') && (name[2] == 'x')) {
+        hdr->flags |= htons(3);   /* NXDOMAIN */
+        return len;
+    }
+    while (*pos) {
+        pos += *pos + 1;
+    }
+    memcpy(&type, pos + 1, sizeof(type));
+
+    /* answer the first question only */
+    pos = buf + len;
+    *pos++ = 0xc0;
+    *pos++ = name - buf;
+    memcpy(pos, &type, sizeof(type));
+    pos += 2;
+    *pos++ = 0;
+    *pos++ = DNS_CLASS_IN;
+    *pos++ = 0;
+    *pos++ = 0;
+    *pos++ = STUB_TTL >> 8;
+    *pos++ = STUB_TTL & 0xff;
+    *pos++ = 0;
+    if (ntohs(type) == DNS_TYPE_AAAA) {
+        *pos++ = sizeof(_stub_addr6);
+        memcpy(pos, _stub_addr6, sizeof(_stub_addr6));
+        pos += sizeof(_stub_addr6);
+    }
+    else {
+        *pos++ = sizeof(_stub_addr4);
+        memcpy(pos, _stub_addr4, sizeof(_stub_addr4));
+        pos += sizeof(_stub_addr4);
+    }
+    hdr->ancount = htons(1);
+    return pos - buf;
+}
+
+static void *_stub_server(void *arg)
+{
+    static uint8_t buf[SOCK_DNS_REPLY_LEN];
+    sock_udp_ep_t local = { .family = AF_INET6, .port = SOCK_DNS_PORT };
+    sock_udp_ep_t remote;
+    sock_udp_t sock;
+
+    (void)arg;
+    sock_udp_create(&sock, &local, NULL, 0);
+    while (1) {
+        ssize_t len = sock_udp_recv(&sock, buf, sizeof(buf) - ANSWER_LEN,
+                                    SOCK_NO_TIMEOUT, &remote);
+
+        if (len < (ssize_t)sizeof(sock_dns_hdr_t)) {
+            continue;
+        }
+        _stub_queries++;
+        sock_udp_send(&sock, buf, _stub_answer(buf, len), &remote);
+    }
+    return NULL;
+}
+
+static void _async_cb(int res, const void *addr, void *arg)
+{
+    (void)addr;
+    if (res > 0) {
+        (*(unsigned *)arg)++;
+    }
+    if (--_async_pending == 0) {
+        mutex_unlock(&_async_done);
+    }
+}
+
+static void _bench(void)
+{
+    char name[SOCK_DNS_MAX_NAME_LEN];
+    uint8_t addr[16];
+    uint32_t total = 0, max = 0;
+    unsigned resolved = 0;
+
+    _stub_queries = 0;
+    for (unsigned i = 0; i < LOOKUPS; i++) {
+        unsigned n = i % NAMES_NUMOF;
+
+        if (n == (NAMES_NUMOF - 1)) {
+            strcpy(name, "nx.example.org");
+        }
+        else {
+            sprintf(name, "host%u.example.org", n);
+        }
+
+        uint32_t start = xtimer_now_usec();
+        int res = sock_dns_query(name, addr, AF_INET6);
+        uint32_t diff = xtimer_now_usec() - start;
+
+        total += diff;
+        if (diff > max) {
+            max = diff;
+        }
+        if (res > 0) {
+            resolved++;
+        }
+    }
+    printf("%u lookups, %u resolved, %u server queries, hit rate %u%%\n",
+           LOOKUPS, resolved, _stub_queries,
+           (100 * (LOOKUPS - _stub_queries)) / LOOKUPS);
+    printf("latency: avg %u us, max %u us\n", (unsigned)(total / LOOKUPS),
+           (unsigned)max);
+
+#ifdef MODULE_SOCK_DNS_ASYNC
+    /* fill up all query slots at once */
+    unsigned async_resolved = 0;
+    uint32_t start = xtimer_now_usec();
+
+    _async_pending = SOCK_DNS_QUERIES_NUMOF;
+    for (unsigned i = 0; i < SOCK_DNS_QUERIES_NUMOF; i++) {
+        sprintf(name, "async%u.example.org", i);
+        if (sock_dns_query_async(name, AF_UNSPEC, _async_cb,
+                                 &async_resolved) < 0) {
+            printf("error starting query for %s\n", name);
+            return;
+        }
+    }
+    mutex_lock(&_async_done);
+    printf("async: %u/%u resolved in %u us\n", async_resolved,
+           SOCK_DNS_QUERIES_NUMOF, (unsigned)(xtimer_now_usec() - start));
+#endif
+
+    printf("{ \"result\" : %u }\n", (unsigned)(total / LOOKUPS));
+}
+#endif
+
 int main(void)
 {
     uint8_t addr[16] = {0};
 
+#ifdef DNS_STUB
+    thread_create(_stub_stack, sizeof(_stub_stack), THREAD_PRIORITY_MAIN - 1,
+                  THREAD_CREATE_STACKTEST, _stub_server, NULL, "dns_stub");
+    sock_dns_server.family = AF_INET6;
+    sock_dns_server.port = SOCK_DNS_PORT;
+    sock_dns_server.netif = SOCK_ADDR_ANY_NETIF;
+    memcpy(sock_dns_server.addr.ipv6, &ipv6_addr_loopback,
+           sizeof(sock_dns_server.addr.ipv6));
+#else
     puts("waiting for router advertisement...");
     xtimer_usleep(1U*1000000);
 
     /* print network addresses */
     puts("Configured network interfaces:");
     _gnrc_netif_config(0, NULL);
+#endif
 
     int res = sock_dns_query(TEST_NAME, addr, AF_UNSPEC);
     if (res > 0) {
@@ -56,5 +228,9 @@ int main(void)
         printf("error resolving %s\n", TEST_NAME);
     }
 
+#ifdef DNS_STUB
+    _bench();
+#endif
+
     return 0;
 }
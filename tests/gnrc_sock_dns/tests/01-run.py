@@ -0,0 +1,32 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+LOOKUPS = 200
+NAMES_NUMOF = 8
+
+
+def testfunc(child):
+    child.expect_exact("example.org resolves to 2001:db8::1")
+    child.expect(r"(\d+) lookups, (\d+) resolved, (\d+) server queries, "
+                 r"hit rate (\d+)%")
+    assert int(child.match.group(1)) == LOOKUPS
+    assert int(child.match.group(2)) == \
+        LOOKUPS - (LOOKUPS // NAMES_NUMOF)
+    # every name (including the non-existing one) is queried only once
+    assert int(child.match.group(3)) == NAMES_NUMOF
+    child.expect(r"latency: avg \d+ us, max \d+ us")
+    child.expect(r"async: (\d+)/(\d+) resolved in \d+ us")
+    assert child.match.group(1) == child.match.group(2)
+    child.expect(r"{ \"result\" : \d+ }")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
@@ -11,72 +11,157 @@
  * @{
  *
  * @file
- * @brief   Simple malloc/free test
+ * @brief   malloc/free latency benchmark
  *
+ * Measures the average and worst-case latency of malloc() and free() for
+ * fixed sizes and for a mixed workload that fragments the heap. Build with
+ * `USEMODULE=tlsf-malloc` to benchmark the TLSF allocator instead of the
+ * libc one.
  *
  * @author  Benjamin Valentin <benpicco@zedat.fu-berlin.de>
  *
  * @}
  */
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define CHUNK_SIZE 1024
+#include "xtimer.h"
 
-struct node {
-    struct node *next;
-    void *ptr;
-};
+#ifdef MODULE_TLSF_MALLOC
+#include "tlsf-malloc.h"
+#endif
 
-int total = 0;
+#ifndef REPEAT
+#define REPEAT          (1000U)
+#endif
 
-void fill_memory(struct node *head)
+/* number of blocks live at the same time in the mixed workload */
+#ifndef BLOCKS_NUMOF
+#define BLOCKS_NUMOF    (32U)
+#endif
+
+#ifndef MAX_BLOCK_SIZE
+#define MAX_BLOCK_SIZE  (256U)
+#endif
+
+#ifdef MODULE_TLSF_MALLOC
+#ifndef HEAP_SIZE
+#define HEAP_SIZE       (BLOCKS_NUMOF * MAX_BLOCK_SIZE * 2)
+#endif
+static uint32_t _heap[HEAP_SIZE / sizeof(uint32_t)];
+#endif
+
+typedef struct {
+    uint32_t total;     /**< sum of all latencies in us */
+    uint32_t max;       /**< worst latency in us */
+    uint32_t numof;     /**< number of operations */
+} latency_t;
+
+static const size_t sizes[] = { 16, 64, 256, 1024 };
+static void *blocks[BLOCKS_NUMOF];
+static uint32_t seed = 0x83d385c0;
+
+static inline void _record(latency_t *lat, uint32_t start)
 {
-    while (head && (head->ptr = malloc(CHUNK_SIZE))) {
-        printf("Allocated %d Bytes at 0x%p, total %d\n", CHUNK_SIZE, head->ptr, total += CHUNK_SIZE);
-        memset(head->ptr, '@', CHUNK_SIZE);
-        head = head->next = malloc(sizeof(struct node));
-        head->ptr =  0;
-        head->next = 0;
-        total += sizeof(struct node);
+    uint32_t diff = xtimer_now_usec() - start;
+
+    lat->total += diff;
+    lat->numof++;
+    if (diff > lat->max) {
+        lat->max = diff;
     }
 }
 
-void free_memory(struct node *head)
+static void *_timed_malloc(latency_t *lat, size_t size)
 {
-    struct node *old_head;
+    uint32_t start = xtimer_now_usec();
+    void *ptr = malloc(size);
 
-    while (head) {
-        if (head->ptr) {
-            printf("Free %d Bytes at 0x%p, total %d\n", CHUNK_SIZE, head->ptr, total -= CHUNK_SIZE);
-            free(head->ptr);
-        }
+    _record(lat, start);
+    if (ptr == NULL) {
+        printf("malloc(%u) failed\n", (unsigned)size);
+    }
+    return ptr;
+}
 
-        if (head->next) {
-            old_head = head;
-            head = head->next;
-            free(old_head);
-        }
-        else {
-            free(head);
-            head = 0;
-        }
+static void _timed_free(latency_t *lat, void *ptr)
+{
+    uint32_t start = xtimer_now_usec();
 
-        total -= sizeof(struct node);
-    }
+    free(ptr);
+    _record(lat, start);
+}
+
+static void _print(const char *name, size_t size, const latency_t *lat)
+{
+    /* average in nanoseconds, the timer resolution is too coarse for a
+     * single operation */
+    printf("%-6s %5u: avg %6" PRIu32 " ns, max %4" PRIu32 " us\n", name,
+           (unsigned)size, (uint32_t)(((uint64_t)lat->total * 1000)
+                                      / lat->numof), lat->max);
+}
+
+static size_t _random_size(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return 1 + ((seed >> 16) % MAX_BLOCK_SIZE);
 }
 
 int main(void)
 {
-    while (1) {
-        struct node *head = malloc(sizeof(struct node));
-        total += sizeof(struct node);
+    latency_t mixed_malloc = { 0 };
+    latency_t mixed_free = { 0 };
+    uint32_t start;
+
+#ifdef MODULE_TLSF_MALLOC
+    tlsf_add_global_pool(_heap, sizeof(_heap));
+#endif
 
-        fill_memory(head);
-        free_memory(head);
+    puts("malloc latency benchmark");
+
+    for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        latency_t lat_malloc = { 0 };
+        latency_t lat_free = { 0 };
+
+        for (unsigned n = 0; n < REPEAT; n++) {
+            void *ptr = _timed_malloc(&lat_malloc, sizes[i]);
+
+            _timed_free(&lat_free, ptr);
+        }
+        _print("malloc", sizes[i], &lat_malloc);
+        _print("free", sizes[i], &lat_free);
     }
 
+    /* keep BLOCKS_NUMOF blocks of random size alive and replace a random one
+     * in every step */
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < BLOCKS_NUMOF; i++) {
+        blocks[i] = _timed_malloc(&mixed_malloc, _random_size());
+    }
+    for (unsigned n = 0; n < REPEAT; n++) {
+        unsigned i = _random_size() % BLOCKS_NUMOF;
+
+        _timed_free(&mixed_free, blocks[i]);
+        blocks[i] = _timed_malloc(&mixed_malloc, _random_size());
+    }
+    for (unsigned i = 0; i < BLOCKS_NUMOF; i++) {
+        _timed_free(&mixed_free, blocks[i]);
+    }
+    uint32_t duration = xtimer_now_usec() - start;
+
+    _print("malloc", 0, &mixed_malloc);
+    _print("free", 0, &mixed_free);
+
+#ifdef MODULE_TLSF_MALLOC
+    heap_stats();
+#endif
+
+    /* mixed malloc/free pairs per second */
+    printf("{ \"result\" : %" PRIu32 " }\n",
+           (uint32_t)(((uint64_t)(mixed_malloc.numof) * US_PER_SEC)
+                      / (duration ? duration : 1)));
     return 0;
 }
@@ -0,0 +1,24 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+SIZES = (16, 64, 256, 1024, 0)
+
+
+def testfunc(child):
+    child.expect_exact("malloc latency benchmark")
+    for size in SIZES:
+        child.expect(r"malloc +{}: avg +\d+ ns, max +\d+ us".format(size))
+        child.expect(r"free +{}: avg +\d+ ns, max +\d+ us".format(size))
+    child.expect(r"{ \"result\" : \d+ }")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test application for the SAUL sampler
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "msg.h"
+#include "saul_reg.h"
+#include "saul_sampler.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#ifndef DURATION
+#define DURATION            (2U * US_PER_SEC)
+#endif
+
+#define FAST_INTERVAL       (10U * US_PER_MS)
+#define SLOW_INTERVAL       (20U * US_PER_MS)
+#define DECIMATION          (5U)
+#define MSG_QUEUE_SIZE      (8U)
+
+/* a sensor returning a ramp, the n-th dimension is offset by n */
+typedef struct {
+    int16_t val;
+    uint8_t dim;
+} ramp_t;
+
+static int _ramp_read(const void *dev, phydat_t *res)
+{
+    ramp_t *ramp = (ramp_t *)dev;
+
+    for (unsigned i = 0; i < PHYDAT_DIM; i++) {
+        res->val[i] = (i < ramp->dim) ? ramp->val + i : 0;
+    }
+    res->unit = UNIT_NONE;
+    res->scale = 0;
+    ramp->val++;
+    return ramp->dim;
+}
+
+static const saul_driver_t _ramp_driver = {
+    .read = _ramp_read,
+    .write = saul_notsup,
+    .type = SAUL_SENSE_ANALOG,
+};
+
+static ramp_t _ramps[] = {
+    { .val = 0, .dim = 1 },
+    { .val = 100, .dim = 3 },
+    { .val = -50, .dim = 1 },
+};
+
+static saul_reg_t _devs[] = {
+    { .dev = &_ramps[0], .name = "ramp0", .driver = &_ramp_driver },
+    { .dev = &_ramps[1], .name = "ramp1", .driver = &_ramp_driver },
+    { .dev = &_ramps[2], .name = "ramp2", .driver = &_ramp_driver },
+};
+
+static saul_sampler_chan_t _fast_chans[2];
+static saul_sampler_sample_t _fast_ring[16];
+static saul_sampler_group_t _fast;
+
+static saul_sampler_chan_t _slow_chans[1];
+static saul_sampler_sample_t _slow_ring[8];
+static saul_sampler_group_t _slow;
+
+/* expected value of the next sample per channel */
+static int16_t _next[3];
+static unsigned _count[3];
+static unsigned _errors;
+
+static void _check(const saul_sampler_sample_t *s, unsigned idx, int16_t exp)
+{
+    if (s->data.val[0] != exp) {
+        printf("ch%u: got %d, expected %d\n", idx, s->data.val[0], exp);
+        _errors++;
+    }
+}
+
+static void _handle(saul_sampler_group_t *group)
+{
+    saul_sampler_sample_t buf[8];
+    unsigned n;
+
+    while ((n = saul_sampler_read(group, buf, 8)) > 0) {
+        for (unsigned i = 0; i < n; i++) {
+            const saul_sampler_sample_t *s = &buf[i];
+
+            if (group == &_fast) {
+                _check(s, s->chan, _next[s->chan]++);
+                _count[s->chan]++;
+                if ((s->chan == 1) && (s->data.val[2] != s->data.val[0] + 2)) {
+                    _errors++;
+                }
+                continue;
+            }
+            /* the window of the slow channel holds [first, first + 4] */
+            switch (s->aggr) {
+                case SAUL_SAMPLER_AGGR_MIN:
+                    _check(s, 2, _next[2]);
+                    break;
+                case SAUL_SAMPLER_AGGR_MAX:
+                    _check(s, 2, _next[2] + DECIMATION - 1);
+                    break;
+                case SAUL_SAMPLER_AGGR_MEAN:
+                    _check(s, 2, _next[2] + DECIMATION / 2);
+                    _next[2] += DECIMATION;
+                    _count[2]++;
+                    break;
+                default:
+                    _errors++;
+                    break;
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    msg_t queue[MSG_QUEUE_SIZE];
+    msg_t msg;
+    unsigned batches = 0;
+
+    msg_init_queue(queue, MSG_QUEUE_SIZE);
+    puts("SAUL sampler test application");
+
+    for (unsigned i = 0; i < 3; i++) {
+        saul_reg_add(&_devs[i]);
+        _next[i] = _ramps[i].val;
+    }
+
+    saul_sampler_chan_init(&_fast_chans[0], saul_reg_find_name("ramp0"), 1, 0, 0);
+    saul_sampler_chan_init(&_fast_chans[1], saul_reg_find_name("ramp1"), 2, 0, 0);
+    saul_sampler_group_init(&_fast, _fast_chans, 2, _fast_ring, 16, FAST_INTERVAL);
+    saul_sampler_notify(&_fast, thread_getpid(), 8);
+
+    saul_sampler_chan_init(&_slow_chans[0], saul_reg_find_name("ramp2"), 1,
+                           DECIMATION, SAUL_SAMPLER_AGGR_MIN |
+                           SAUL_SAMPLER_AGGR_MAX | SAUL_SAMPLER_AGGR_MEAN);
+    saul_sampler_group_init(&_slow, _slow_chans, 1, _slow_ring, 8, SLOW_INTERVAL);
+    saul_sampler_notify(&_slow, thread_getpid(), 3);
+
+    saul_sampler_add(&_fast);
+    saul_sampler_add(&_slow);
+
+    uint32_t start = xtimer_now_usec();
+    while ((xtimer_now_usec() - start) < DURATION) {
+        if (xtimer_msg_receive_timeout(&msg, DURATION) < 0) {
+            continue;
+        }
+        if (msg.type == SAUL_SAMPLER_MSG_TYPE) {
+            _handle(msg.content.ptr);
+            batches++;
+        }
+    }
+    saul_sampler_remove(&_fast);
+    saul_sampler_remove(&_slow);
+    _handle(&_fast);
+    _handle(&_slow);
+
+    printf("fast: %u + %u samples, slow: %u aggregates, %u batches\n",
+           _count[0], _count[1], _count[2], batches);
+    printf("dropped: %u\n", _fast.dropped + _slow.dropped);
+
+    /* the divided channel is read on every other tick */
+    if ((_count[0] == 0) || (_count[2] == 0) ||
+        ((_count[0] + 1) / 2 != _count[1])) {
+        _errors++;
+    }
+    if (_errors || _fast.dropped || _slow.dropped) {
+        printf("%u errors [FAILED]\n", _errors);
+        return 1;
+    }
+    puts("[SUCCESS]");
+    return 0;
+}
@@ -0,0 +1,25 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+def testfunc(child):
+    child.expect(r"fast: (\d+) \+ (\d+) samples, slow: (\d+) aggregates, (\d+) batches")
+    fast, divided, slow, batches = (int(g) for g in child.match.groups())
+    assert divided == (fast + 1) // 2
+    assert slow > 0
+    # batches are notified, not single samples
+    assert batches < (fast + divided + 3 * slow) / 2
+    child.expect_exact("dropped: 0")
+    child.expect_exact("[SUCCESS]")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
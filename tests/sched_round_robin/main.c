@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Fairness and overhead of round-robin time slicing
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "sched_round_robin.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#ifndef WORKERS
+#define WORKERS             (3U)
+#endif
+
+#ifndef DURATION
+#define DURATION            (1U * US_PER_SEC)
+#endif
+
+/* how often the workers are preempted in the preempted phase */
+#ifndef PREEMPT_INTERVAL
+#define PREEMPT_INTERVAL    (SCHED_ROUND_ROBIN_QUANTUM / 4)
+#endif
+
+#define WORKER_PRIO         (THREAD_PRIORITY_MAIN + 1)
+#define PREEMPT_PRIO        (THREAD_PRIORITY_MAIN - 1)
+
+static char _stacks[WORKERS][THREAD_STACKSIZE_DEFAULT];
+static char _preempt_stack[THREAD_STACKSIZE_DEFAULT];
+static kernel_pid_t _pids[WORKERS];
+static volatile uint32_t _counts[WORKERS];
+static volatile int _stop;
+
+static void *_worker(void *arg)
+{
+    volatile uint32_t *count = arg;
+
+    while (!_stop) {
+        (*count)++;
+    }
+    return NULL;
+}
+
+/* interrupts the workers more often than their quantum expires */
+static void *_preempter(void *arg)
+{
+    (void)arg;
+
+    while (!_stop) {
+        xtimer_usleep(PREEMPT_INTERVAL);
+    }
+    return NULL;
+}
+
+static void _join(kernel_pid_t pid)
+{
+    while (thread_get(pid) != NULL) {
+        xtimer_usleep(SCHED_ROUND_ROBIN_QUANTUM);
+    }
+}
+
+/* lets n workers count for DURATION, an override is applied to the first */
+static void _run(unsigned n, uint32_t override, bool preempt)
+{
+    kernel_pid_t preempter = KERNEL_PID_UNDEF;
+
+    _stop = 0;
+    for (unsigned i = 0; i < n; i++) {
+        _counts[i] = 0;
+        _pids[i] = thread_create(_stacks[i], sizeof(_stacks[i]), WORKER_PRIO,
+                                 THREAD_CREATE_WOUT_YIELD, _worker,
+                                 (void *)&_counts[i], "worker");
+    }
+    if (override) {
+        sched_round_robin_set_thread_quantum(_pids[0], override);
+    }
+    if (preempt) {
+        preempter = thread_create(_preempt_stack, sizeof(_preempt_stack),
+                                  PREEMPT_PRIO, THREAD_CREATE_WOUT_YIELD,
+                                  _preempter, NULL, "preempter");
+    }
+    xtimer_usleep(DURATION);
+    _stop = 1;
+    for (unsigned i = 0; i < n; i++) {
+        _join(_pids[i]);
+    }
+    if (preempt) {
+        _join(preempter);
+    }
+}
+
+/* lowest count relative to the highest one in permille */
+static unsigned _fairness(uint32_t *total)
+{
+    uint32_t min = UINT32_MAX, max = 0;
+
+    *total = 0;
+    for (unsigned i = 0; i < WORKERS; i++) {
+        *total += _counts[i];
+        min = (_counts[i] < min) ? _counts[i] : min;
+        max = (_counts[i] > max) ? _counts[i] : max;
+    }
+    return (unsigned)(((uint64_t)min * 1000) / ((max) ? max : 1));
+}
+
+static void _print_counts(const char *name)
+{
+    printf("%s:", name);
+    for (unsigned i = 0; i < WORKERS; i++) {
+        printf(" %" PRIu32, _counts[i]);
+    }
+    printf(" iterations");
+}
+
+int main(void)
+{
+    unsigned errors = 0;
+
+    printf("quantum: %u us, workers: %u\n",
+           (unsigned)SCHED_ROUND_ROBIN_QUANTUM, WORKERS);
+
+    _run(1, 0, false);
+    uint32_t single = _counts[0];
+    printf("single: %" PRIu32 " iterations\n", single);
+
+    uint32_t total;
+    _run(WORKERS, 0, false);
+    unsigned fairness = _fairness(&total);
+    int overhead = 1000 - (int)(((uint64_t)total * 1000) / ((single) ? single : 1));
+    _print_counts("shared");
+    printf(", fairness %u permille, overhead %d permille\n", fairness, overhead);
+    if (fairness == 0) {
+        puts("a worker starved [FAILED]");
+        errors++;
+    }
+
+    /* the quantum must keep running across preemptions */
+    _run(WORKERS, 0, true);
+    unsigned preempted = _fairness(&total);
+    _print_counts("preempted");
+    printf(", fairness %u permille\n", preempted);
+    if (preempted == 0) {
+        puts("a worker starved under preemption [FAILED]");
+        errors++;
+    }
+
+    _run(WORKERS, 2 * SCHED_ROUND_ROBIN_QUANTUM, false);
+    _print_counts("override");
+    puts("");
+    for (unsigned i = 1; i < WORKERS; i++) {
+        if (_counts[i] >= _counts[0]) {
+            puts("override not applied [FAILED]");
+            errors++;
+            break;
+        }
+    }
+
+    if (errors) {
+        return 1;
+    }
+    printf("{ \"result\" : %u }\n", fairness);
+    return 0;
+}
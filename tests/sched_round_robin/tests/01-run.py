@@ -0,0 +1,24 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+def testfunc(child):
+    child.expect(r"quantum: \d+ us, workers: \d+")
+    child.expect(r"single: \d+ iterations")
+    child.expect(r"shared: [\d ]+ iterations, fairness \d+ permille, "
+                 r"overhead -?\d+ permille")
+    child.expect(r"preempted: [\d ]+ iterations, fairness \d+ permille")
+    child.expect(r"override: [\d ]+ iterations")
+    child.expect(r"{ \"result\" : \d+ }")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc, timeout=30))
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       End-to-end test of streaming image verification onto a MTD
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "board.h"
+#include "stream_verify.h"
+#include "xtimer.h"
+
+#ifndef IMAGE_SIZE
+#define IMAGE_SIZE          (24U * 1024U + 123U)
+#endif
+
+/* address of the image, the second sector of the MTD */
+#define IMAGE_OFFSET        (MTD_SECTOR_SIZE)
+
+static uint8_t _image[IMAGE_SIZE];
+static uint8_t _digest[SHA256_DIGEST_LENGTH];
+static uint8_t _mac[SHA256_DIGEST_LENGTH];
+static const char _key[] = "pre-shared key";
+
+/* chunk sizes of e.g. CoAP blocks and TFTP packets, and some odd ones */
+static const size_t _chunks[] = { 64, 512, 1, 1024, 37, 16, 512 };
+
+static unsigned _errors;
+
+/* stands in for a real signature check, e.g. uECC_verify() of micro-ecc */
+static int _check_signature(const uint8_t *digest, void *arg)
+{
+    const uint8_t *signed_digest = arg;
+
+    return memcmp(digest, signed_digest, SHA256_DIGEST_LENGTH) ? -EBADMSG : 0;
+}
+
+static int _stream(const char *name, stream_verify_t *sv, size_t len,
+                   int corrupt)
+{
+    stream_verify_mtd_t w;
+    uint8_t chunk[1024];
+    size_t off = 0;
+
+    if (stream_verify_mtd_init(&w, sv, MTD_0, IMAGE_OFFSET) < 0) {
+        puts("stream_verify_mtd_init [FAILED]");
+        _errors++;
+        return -1;
+    }
+    for (unsigned i = 0; off < len; i++) {
+        size_t n = _chunks[i % (sizeof(_chunks) / sizeof(_chunks[0]))];
+        if (n > len - off) {
+            n = len - off;
+        }
+        /* a received chunk is copied out of the packet buffer */
+        memcpy(chunk, &_image[off], n);
+        if (corrupt && (off <= IMAGE_SIZE / 2) && (IMAGE_SIZE / 2 < off + n)) {
+            chunk[IMAGE_SIZE / 2 - off] ^= 0x01;
+        }
+        if (stream_verify_mtd_write(&w, chunk, n) < 0) {
+            printf("%s: write at %u [FAILED]\n", name, (unsigned)off);
+            _errors++;
+            return -1;
+        }
+        off += n;
+    }
+
+    uint32_t start = xtimer_now_usec();
+    int res = stream_verify_mtd_finish(&w);
+    printf("%s: %d (%u us after last chunk)\n", name, res,
+           (unsigned)(xtimer_now_usec() - start));
+    return res;
+}
+
+static void _check_mtd(void)
+{
+    uint8_t buf[256];
+
+    for (size_t off = 0; off < IMAGE_SIZE; off += sizeof(buf)) {
+        size_t n = (IMAGE_SIZE - off < sizeof(buf)) ? IMAGE_SIZE - off : sizeof(buf);
+        if ((mtd_read(MTD_0, buf, IMAGE_OFFSET + off, n) < 0) ||
+            memcmp(buf, &_image[off], n)) {
+            printf("MTD content at %u [FAILED]\n", (unsigned)off);
+            _errors++;
+            return;
+        }
+    }
+}
+
+int main(void)
+{
+    stream_verify_t sv;
+    uint32_t x = 1;
+
+    if (mtd_init(MTD_0) < 0) {
+        puts("mtd_init [FAILED]");
+        return 1;
+    }
+
+    for (unsigned i = 0; i < IMAGE_SIZE; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        _image[i] = x;
+    }
+    /* in a real update, these come with the manifest of the image */
+    uint32_t start = xtimer_now_usec();
+    sha256(_image, IMAGE_SIZE, _digest);
+    printf("image: %u bytes, hashing after download: %u us\n", IMAGE_SIZE,
+           (unsigned)(xtimer_now_usec() - start));
+    hmac_sha256(_key, strlen(_key), _image, IMAGE_SIZE, _mac);
+
+    stream_verify_init_sha256(&sv, _digest);
+    if (_stream("sha256", &sv, IMAGE_SIZE, 0) != 0) {
+        _errors++;
+    }
+    _check_mtd();
+
+    stream_verify_init_hmac_sha256(&sv, _key, strlen(_key), _mac);
+    if (_stream("hmac_sha256", &sv, IMAGE_SIZE, 0) != 0) {
+        _errors++;
+    }
+
+    stream_verify_init_signature(&sv, _check_signature, _digest);
+    if (_stream("signature", &sv, IMAGE_SIZE, 0) != 0) {
+        _errors++;
+    }
+
+    stream_verify_init_sha256(&sv, _digest);
+    if (_stream("corrupted", &sv, IMAGE_SIZE, 1) != -EBADMSG) {
+        _errors++;
+    }
+
+    stream_verify_init_hmac_sha256(&sv, _key, strlen(_key), _mac);
+    if (_stream("truncated", &sv, IMAGE_SIZE - 1, 0) != -EBADMSG) {
+        _errors++;
+    }
+
+    if (_errors) {
+        printf("%u errors [FAILED]\n", _errors);
+        return 1;
+    }
+    puts("SUCCESS");
+    return 0;
+}
@@ -0,0 +1,22 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+def testfunc(child):
+    child.expect(r"image: \d+ bytes, hashing after download: \d+ us")
+    for case in ("sha256", "hmac_sha256", "signature", "corrupted",
+                 "truncated"):
+        child.expect(r"{}: -?\d+ \(\d+ us after last chunk\)".format(case))
+    child.expect_exact("SUCCESS")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc, timeout=60))
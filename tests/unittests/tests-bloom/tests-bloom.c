@@ -22,6 +22,7 @@
 #define TESTS_BLOOM_PROB_IN_FILTER (4)
 #define TESTS_BLOOM_NOT_IN_FILTER (996)
 #define TESTS_BLOOM_FALSE_POS_RATE_THR (0.005)
+#define TESTS_BLOOM_B_NUMOF (sizeof(B) / sizeof(B[0]))
 
 static bloom_t bloom;
 BITFIELD(bf, TESTS_BLOOM_BITS);
@@ -43,6 +44,9 @@ static void load_dictionary_fixture(void)
 
 }
 
+static bloom_blocked_t blocked;
+static uint8_t blocks[BLOOM_BLOCKED_BLOCK_SIZE];
+
 static void set_up_bloom(void)
 {
     bloom_init(&bloom, TESTS_BLOOM_BITS, bf, hashes, TESTS_BLOOM_HASHF);
@@ -85,11 +89,48 @@ static void test_bloom_based_on_dictionary_fixture(void)
     TEST_ASSERT(false_positive_rate < TESTS_BLOOM_FALSE_POS_RATE_THR);
 }
 
+static void test_bloom_blocked_based_on_dictionary_fixture(void)
+{
+    const uint8_t *bufs[TESTS_BLOOM_B_NUMOF];
+    size_t lens[TESTS_BLOOM_B_NUMOF];
+    bool res[TESTS_BLOOM_B_NUMOF];
+    int in = 0;
+
+    bloom_blocked_init(&blocked, blocks, sizeof(blocks), TESTS_BLOOM_HASHF);
+    TEST_ASSERT_EQUAL_INT(1, blocked.numof);
+
+    for (unsigned i = 0; i < TESTS_BLOOM_B_NUMOF; i++) {
+        bufs[i] = (const uint8_t *) B[i];
+        lens[i] = strlen(B[i]);
+    }
+    bloom_blocked_add_batch(&blocked, bufs, lens, TESTS_BLOOM_B_NUMOF);
+
+    for (unsigned i = 0; i < TESTS_BLOOM_B_NUMOF; i++) {
+        TEST_ASSERT(bloom_blocked_check(&blocked, bufs[i], lens[i]));
+    }
+    TEST_ASSERT_EQUAL_INT(TESTS_BLOOM_B_NUMOF,
+                          bloom_blocked_check_batch(&blocked, bufs, lens,
+                                                    TESTS_BLOOM_B_NUMOF, res));
+    for (unsigned i = 0; i < TESTS_BLOOM_B_NUMOF; i++) {
+        TEST_ASSERT(res[i]);
+    }
+
+    for (int i = 0; i < lenA; i++) {
+        in += bloom_blocked_check(&blocked, (const uint8_t *) A[i],
+                                  strlen(A[i]));
+    }
+    TEST_ASSERT((double) in / (double) lenA < TESTS_BLOOM_FALSE_POS_RATE_THR);
+
+    bloom_blocked_clear(&blocked);
+    TEST_ASSERT(!bloom_blocked_check(&blocked, bufs[0], lens[0]));
+}
+
 Test *tests_bloom_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_bloom_parameters_bytes_hashf),
         new_TestFixture(test_bloom_based_on_dictionary_fixture),
+        new_TestFixture(test_bloom_blocked_based_on_dictionary_fixture),
     };
 
     EMB_UNIT_TESTCALLER(bloom_tests, set_up_bloom, tear_down_bloom, fixtures);
@@ -14,11 +14,13 @@
 #include <errno.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "embUnit.h"
 
 #include "net/gcoap.h"
 
+#include "gcoap_internal.h"
 #include "unittests-constants.h"
 #include "tests-gcoap.h"
 
@@ -47,6 +49,53 @@ static gcoap_listener_t listener_second = {
     .next          = NULL
 };
 
+/*
+ * A block-wise resource of 100 bytes, counting up from 0
+ */
+#define BLOCK_RES_SIZE  (100U)
+
+static uint8_t block_written[BLOCK_RES_SIZE];
+static size_t block_written_len;
+static bool block_written_more;
+
+static ssize_t _block_read(void *arg, size_t offset, void *buf, size_t len)
+{
+    (void)arg;
+    uint8_t *out = buf;
+    size_t i;
+
+    for (i = 0; (i < len) && (offset + i < BLOCK_RES_SIZE); i++) {
+        out[i] = offset + i;
+    }
+    return i;
+}
+
+static ssize_t _block_write(void *arg, size_t offset, const void *buf,
+                            size_t len, bool more)
+{
+    (void)arg;
+    if (offset + len > BLOCK_RES_SIZE) {
+        return -ENOSPC;
+    }
+    memcpy(&block_written[offset], buf, len);
+    block_written_len  = offset + len;
+    block_written_more = more;
+    return len;
+}
+
+static size_t _block_size(void *arg)
+{
+    (void)arg;
+    return BLOCK_RES_SIZE;
+}
+
+static gcoap_block_resource_t block_resource = {
+    .read   = _block_read,
+    .write  = _block_write,
+    .size   = _block_size,
+    .format = COAP_FORMAT_OCTET,
+};
+
 static const char *resource_list_str = "</act/switch>,</sensor/temp>,</test/info/all>,</second/part>";
 
 /*
@@ -253,6 +302,360 @@ static void test_gcoap__server_con_resp(void)
     TEST_ASSERT_EQUAL_INT(sizeof(resp_data), res);
 }
 
+/*
+ * Helper for the block tests: writes a request with a Block option and
+ * parses it like the server does.
+ */
+static ssize_t _block_req(coap_pkt_t *pdu, uint8_t *buf, unsigned method,
+                          unsigned option, uint32_t blknum, bool more,
+                          size_t payload_len)
+{
+    gcoap_req_init(pdu, buf, GCOAP_PDU_BUF_SIZE, method, "/block");
+    if (option == COAP_OPT_BLOCK2) {
+        gcoap_add_block2(pdu, blknum, 2, more);
+    }
+    else {
+        gcoap_add_block1(pdu, blknum, 2, more);
+    }
+    for (size_t i = 0; i < payload_len; i++) {
+        pdu->payload[i] = blknum * 64 + i;
+    }
+    ssize_t len = gcoap_finish(pdu, payload_len, COAP_FORMAT_NONE);
+    if (len < 0) {
+        return len;
+    }
+    return coap_parse(pdu, buf, len);
+}
+
+/*
+ * Server block-wise GET. The first block is full and announces the size, the
+ * second one holds the rest.
+ */
+static void test_gcoap__server_block2_resp(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    coap_block1_t block;
+    uint32_t size2;
+    ssize_t len;
+
+    TEST_ASSERT_EQUAL_INT(0, _block_req(&pdu, buf, COAP_METHOD_GET,
+                                        COAP_OPT_BLOCK2, 0, false, 0));
+    len = gcoap_block_handler(&pdu, buf, sizeof(buf), &block_resource);
+    TEST_ASSERT(len > 0);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_CONTENT, pdu.hdr->code);
+    TEST_ASSERT_EQUAL_INT(1, coap_get_block2(&pdu, &block));
+    TEST_ASSERT_EQUAL_INT(0, block.blknum);
+    TEST_ASSERT_EQUAL_INT(2, block.szx);
+    TEST_ASSERT_EQUAL_INT(1, block.more);
+    TEST_ASSERT_EQUAL_INT(0, coap_get_option_uint(&pdu, COAP_OPT_SIZE2, &size2));
+    TEST_ASSERT_EQUAL_INT(BLOCK_RES_SIZE, size2);
+    TEST_ASSERT_EQUAL_INT(64, pdu.payload_len);
+    TEST_ASSERT_EQUAL_INT(63, pdu.payload[63]);
+
+    TEST_ASSERT_EQUAL_INT(0, _block_req(&pdu, buf, COAP_METHOD_GET,
+                                        COAP_OPT_BLOCK2, 1, false, 0));
+    len = gcoap_block_handler(&pdu, buf, sizeof(buf), &block_resource);
+    TEST_ASSERT(len > 0);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT_EQUAL_INT(1, coap_get_block2(&pdu, &block));
+    TEST_ASSERT_EQUAL_INT(1, block.blknum);
+    TEST_ASSERT_EQUAL_INT(0, block.more);
+    TEST_ASSERT_EQUAL_INT(-1, coap_get_option_uint(&pdu, COAP_OPT_SIZE2, &size2));
+    TEST_ASSERT_EQUAL_INT(BLOCK_RES_SIZE - 64, pdu.payload_len);
+    TEST_ASSERT_EQUAL_INT(64, pdu.payload[0]);
+
+    /* beyond the end */
+    TEST_ASSERT_EQUAL_INT(0, _block_req(&pdu, buf, COAP_METHOD_GET,
+                                        COAP_OPT_BLOCK2, 2, false, 0));
+    len = gcoap_block_handler(&pdu, buf, sizeof(buf), &block_resource);
+    TEST_ASSERT(len > 0);
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_BAD_OPTION, pdu.hdr->code);
+}
+
+/*
+ * Server block-wise PUT. Continue is requested until the last block.
+ */
+static void test_gcoap__server_block1_resp(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    coap_block1_t block;
+    ssize_t len;
+
+    TEST_ASSERT_EQUAL_INT(0, _block_req(&pdu, buf, COAP_METHOD_PUT,
+                                        COAP_OPT_BLOCK1, 0, true, 64));
+    len = gcoap_block_handler(&pdu, buf, sizeof(buf), &block_resource);
+    TEST_ASSERT(len > 0);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_CONTINUE, pdu.hdr->code);
+    TEST_ASSERT_EQUAL_INT(1, coap_get_block1(&pdu, &block));
+    TEST_ASSERT_EQUAL_INT(0, block.blknum);
+    TEST_ASSERT_EQUAL_INT(1, block.more);
+    TEST_ASSERT_EQUAL_INT(64, block_written_len);
+    TEST_ASSERT(block_written_more);
+
+    TEST_ASSERT_EQUAL_INT(0, _block_req(&pdu, buf, COAP_METHOD_PUT,
+                                        COAP_OPT_BLOCK1, 1, false, 36));
+    len = gcoap_block_handler(&pdu, buf, sizeof(buf), &block_resource);
+    TEST_ASSERT(len > 0);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_CHANGED, pdu.hdr->code);
+    TEST_ASSERT_EQUAL_INT(1, coap_get_block1(&pdu, &block));
+    TEST_ASSERT_EQUAL_INT(0, block.more);
+    TEST_ASSERT_EQUAL_INT(BLOCK_RES_SIZE, block_written_len);
+    TEST_ASSERT(!block_written_more);
+    for (unsigned i = 0; i < BLOCK_RES_SIZE; i++) {
+        TEST_ASSERT_EQUAL_INT(i, block_written[i]);
+    }
+
+    /* an intermediate block must be complete */
+    TEST_ASSERT_EQUAL_INT(0, _block_req(&pdu, buf, COAP_METHOD_PUT,
+                                        COAP_OPT_BLOCK1, 0, true, 10));
+    len = gcoap_block_handler(&pdu, buf, sizeof(buf), &block_resource);
+    TEST_ASSERT(len > 0);
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_BAD_REQUEST, pdu.hdr->code);
+}
+
+/*
+ * Helper for the client block tests: writes a GET request for /block and
+ * returns its length. No Block2 option is added if szx is negative, no Size2
+ * option if size2 is UINT32_MAX.
+ */
+static ssize_t _block2_client_req(coap_pkt_t *pdu, uint8_t *buf, int szx,
+                                  uint32_t size2)
+{
+    gcoap_req_init(pdu, buf, GCOAP_PDU_BUF_SIZE, COAP_METHOD_GET, "/block");
+    if (szx >= 0) {
+        gcoap_add_block2(pdu, 0, szx, false);
+    }
+    pdu->size2 = size2;
+    return gcoap_finish(pdu, 0, COAP_FORMAT_NONE);
+}
+
+/*
+ * Helper for the client block tests: writes a 2.05 response with a Block2
+ * option and parses it like the client does. No Size2 option is added if
+ * size2 is UINT32_MAX.
+ */
+static void _block2_client_resp(coap_pkt_t *pdu, uint8_t *buf, uint32_t blknum,
+                                unsigned szx, bool more, uint32_t size2)
+{
+    gcoap_req_init(pdu, buf, GCOAP_PDU_BUF_SIZE, COAP_METHOD_GET, "/block");
+    gcoap_add_block2(pdu, blknum, szx, more);
+    pdu->size2 = size2;
+    ssize_t len = gcoap_finish(pdu, 0, COAP_FORMAT_NONE);
+    pdu->hdr->code = COAP_CODE_CONTENT;
+    coap_parse(pdu, buf, len);
+}
+
+/*
+ * Client block-wise GET. Only a GET without payload and without options
+ * following Block2 may be continued.
+ */
+static void test_gcoap__client_block2_init(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    gcoap_block2_memo_t block2;
+    coap_pkt_t pdu;
+    ssize_t len;
+
+    /* Block2 is appended to the request */
+    len = _block2_client_req(&pdu, buf, -1, UINT32_MAX);
+    TEST_ASSERT(gcoap_block2_init(&block2, buf, len, false));
+    TEST_ASSERT(!block2.enabled);
+    TEST_ASSERT_EQUAL_INT(len, block2.opt_offset);
+    TEST_ASSERT_EQUAL_INT(COAP_OPT_URI_PATH, block2.lastonum);
+    TEST_ASSERT_EQUAL_INT(GCOAP_BLOCK_SZX, block2.szx);
+    TEST_ASSERT_EQUAL_INT(0, block2.base);
+    TEST_ASSERT_EQUAL_INT(1, block2.next);
+    TEST_ASSERT(block2.last == UINT32_MAX);
+    TEST_ASSERT_EQUAL_INT(0, block2.received);
+    TEST_ASSERT(!gcoap_block2_init(&block2, buf, len, true));
+
+    /* Block2 of the request is rewritten; it is the last option (1 byte) */
+    len = _block2_client_req(&pdu, buf, 1, UINT32_MAX);
+    TEST_ASSERT(gcoap_block2_init(&block2, buf, len, true));
+    TEST_ASSERT_EQUAL_INT(len - 2, block2.opt_offset);
+    TEST_ASSERT_EQUAL_INT(COAP_OPT_URI_PATH, block2.lastonum);
+    TEST_ASSERT_EQUAL_INT(1, block2.szx);
+
+    /* options following Block2 */
+    len = _block2_client_req(&pdu, buf, 1, 0);
+    TEST_ASSERT(!gcoap_block2_init(&block2, buf, len, true));
+    len = _block2_client_req(&pdu, buf, -1, 0);
+    TEST_ASSERT(!gcoap_block2_init(&block2, buf, len, false));
+
+    /* not a GET without payload */
+    gcoap_req_init(&pdu, buf, GCOAP_PDU_BUF_SIZE, COAP_METHOD_POST, "/block");
+    len = gcoap_finish(&pdu, 0, COAP_FORMAT_NONE);
+    TEST_ASSERT(!gcoap_block2_init(&block2, buf, len, false));
+    gcoap_req_init(&pdu, buf, GCOAP_PDU_BUF_SIZE, COAP_METHOD_GET, "/block");
+    pdu.payload[0] = 0x42;
+    len = gcoap_finish(&pdu, 1, COAP_FORMAT_OCTET);
+    TEST_ASSERT(!gcoap_block2_init(&block2, buf, len, false));
+}
+
+/*
+ * Client block-wise GET. The request for the next block is written at the
+ * position of the Block2 option, growing as needed.
+ */
+static void test_gcoap__client_block2_put_next(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    gcoap_block2_memo_t block2;
+    coap_block1_t block;
+    coap_pkt_t pdu;
+    ssize_t len;
+
+    len = _block2_client_req(&pdu, buf, -1, UINT32_MAX);
+    TEST_ASSERT(gcoap_block2_init(&block2, buf, len, false));
+    len = gcoap_block2_put_next(&block2, buf);
+    TEST_ASSERT_EQUAL_INT(block2.opt_offset + 2, len);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT_EQUAL_STRING("/block", (char *)pdu.url);
+    TEST_ASSERT_EQUAL_INT(1, coap_get_block2(&pdu, &block));
+    TEST_ASSERT_EQUAL_INT(1, block.blknum);
+    TEST_ASSERT_EQUAL_INT(GCOAP_BLOCK_SZX, block.szx);
+    TEST_ASSERT_EQUAL_INT(0, block.more);
+
+    len = _block2_client_req(&pdu, buf, 1, UINT32_MAX);
+    TEST_ASSERT(gcoap_block2_init(&block2, buf, len, true));
+    block2.next = 300;
+    len = gcoap_block2_put_next(&block2, buf);
+    TEST_ASSERT_EQUAL_INT(block2.opt_offset + 3, len);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT_EQUAL_STRING("/block", (char *)pdu.url);
+    TEST_ASSERT_EQUAL_INT(1, coap_get_block2(&pdu, &block));
+    TEST_ASSERT_EQUAL_INT(300, block.blknum);
+    TEST_ASSERT_EQUAL_INT(1, block.szx);
+
+    /* and shrinking again */
+    block2.next = 2;
+    len = gcoap_block2_put_next(&block2, buf);
+    TEST_ASSERT_EQUAL_INT(block2.opt_offset + 2, len);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT_EQUAL_INT(1, coap_get_block2(&pdu, &block));
+    TEST_ASSERT_EQUAL_INT(2, block.blknum);
+
+    /* no Uri-Path before Block2 and a block number of three bytes */
+    len = coap_build_hdr((coap_hdr_t *)buf, COAP_TYPE_NON, NULL, 0,
+                         COAP_METHOD_GET, 1);
+    TEST_ASSERT(gcoap_block2_init(&block2, buf, len, false));
+    block2.next = 4096;
+    len = gcoap_block2_put_next(&block2, buf);
+    TEST_ASSERT_EQUAL_INT(block2.opt_offset + 5, len);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT_EQUAL_INT(1, coap_get_block2(&pdu, &block));
+    TEST_ASSERT_EQUAL_INT(4096, block.blknum);
+    TEST_ASSERT_EQUAL_INT(GCOAP_BLOCK_SZX, block.szx);
+}
+
+/*
+ * Client block-wise GET of 256 bytes in 64 byte blocks, with blocks 1 to 3
+ * requested at once. Blocks arrive out of order and duplicated.
+ */
+static void test_gcoap__client_block2_resp(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    gcoap_block2_memo_t block2;
+    coap_pkt_t pdu;
+    ssize_t len;
+
+    len = _block2_client_req(&pdu, buf, 2, UINT32_MAX);
+    TEST_ASSERT(gcoap_block2_init(&block2, buf, len, true));
+    block2.enabled = true;
+
+    /* the first block announces the size */
+    _block2_client_resp(&pdu, buf, 0, 2, true, 256);
+    TEST_ASSERT_EQUAL_INT(1, gcoap_block2_response(&block2, &pdu));
+    TEST_ASSERT_EQUAL_INT(1, block2.base);
+    TEST_ASSERT_EQUAL_INT(3, block2.last);
+    block2.next = 4;
+
+    _block2_client_resp(&pdu, buf, 2, 2, true, UINT32_MAX);
+    TEST_ASSERT_EQUAL_INT(1, gcoap_block2_response(&block2, &pdu));
+    TEST_ASSERT_EQUAL_INT(1, block2.base);
+    TEST_ASSERT_EQUAL_INT(0x2, block2.received);
+
+    /* duplicates, received or below base */
+    TEST_ASSERT_EQUAL_INT(-1, gcoap_block2_response(&block2, &pdu));
+    _block2_client_resp(&pdu, buf, 0, 2, true, 256);
+    TEST_ASSERT_EQUAL_INT(-1, gcoap_block2_response(&block2, &pdu));
+    TEST_ASSERT_EQUAL_INT(1, block2.base);
+    TEST_ASSERT_EQUAL_INT(0x2, block2.received);
+
+    /* beyond the bitmap */
+    _block2_client_resp(&pdu, buf, 33, 2, true, UINT32_MAX);
+    TEST_ASSERT_EQUAL_INT(-1, gcoap_block2_response(&block2, &pdu));
+
+    /* the gap is filled */
+    _block2_client_resp(&pdu, buf, 1, 2, true, UINT32_MAX);
+    TEST_ASSERT_EQUAL_INT(1, gcoap_block2_response(&block2, &pdu));
+    TEST_ASSERT_EQUAL_INT(3, block2.base);
+    TEST_ASSERT_EQUAL_INT(0, block2.received);
+
+    _block2_client_resp(&pdu, buf, 3, 2, false, UINT32_MAX);
+    TEST_ASSERT_EQUAL_INT(0, gcoap_block2_response(&block2, &pdu));
+    TEST_ASSERT_EQUAL_INT(4, block2.base);
+    TEST_ASSERT_EQUAL_INT(3, block2.last);
+    TEST_ASSERT_EQUAL_INT(4, block2.next);
+
+    /* not part of a transfer */
+    block2.enabled = false;
+    _block2_client_resp(&pdu, buf, 4, 2, true, UINT32_MAX);
+    TEST_ASSERT_EQUAL_INT(0, gcoap_block2_response(&block2, &pdu));
+    block2.enabled = true;
+    pdu.hdr->code = COAP_CODE_PATH_NOT_FOUND;
+    TEST_ASSERT_EQUAL_INT(0, gcoap_block2_response(&block2, &pdu));
+    len = _block2_client_req(&pdu, buf, -1, UINT32_MAX);
+    pdu.hdr->code = COAP_CODE_CONTENT;
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    TEST_ASSERT_EQUAL_INT(0, gcoap_block2_response(&block2, &pdu));
+}
+
+/*
+ * Client block-wise GET. The server may choose a smaller block size, but not
+ * while several blocks are in flight. The size in blocks is unknown then,
+ * until the server announces it again.
+ */
+static void test_gcoap__client_block2_szx(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    gcoap_block2_memo_t block2;
+    coap_pkt_t pdu;
+    ssize_t len;
+
+    len = _block2_client_req(&pdu, buf, 2, UINT32_MAX);
+    TEST_ASSERT(gcoap_block2_init(&block2, buf, len, true));
+    block2.enabled = true;
+
+    /* 100 bytes in 32 byte blocks */
+    _block2_client_resp(&pdu, buf, 0, 1, true, 100);
+    TEST_ASSERT_EQUAL_INT(1, gcoap_block2_response(&block2, &pdu));
+    TEST_ASSERT_EQUAL_INT(1, block2.szx);
+    TEST_ASSERT_EQUAL_INT(1, block2.base);
+    TEST_ASSERT_EQUAL_INT(1, block2.next);
+    TEST_ASSERT_EQUAL_INT(3, block2.last);
+
+    /* block 1 is answered with the 16 byte block at the same offset */
+    block2.next = 2;
+    _block2_client_resp(&pdu, buf, 2, 0, true, UINT32_MAX);
+    TEST_ASSERT_EQUAL_INT(1, gcoap_block2_response(&block2, &pdu));
+    TEST_ASSERT_EQUAL_INT(0, block2.szx);
+    TEST_ASSERT_EQUAL_INT(3, block2.base);
+    TEST_ASSERT_EQUAL_INT(3, block2.next);
+    TEST_ASSERT(block2.last == UINT32_MAX);
+
+    /* again while blocks 3 and 4 are in flight */
+    block2.next = 5;
+    _block2_client_resp(&pdu, buf, 1, 1, true, UINT32_MAX);
+    TEST_ASSERT_EQUAL_INT(0, gcoap_block2_response(&block2, &pdu));
+    TEST_ASSERT_EQUAL_INT(0, block2.szx);
+    TEST_ASSERT_EQUAL_INT(3, block2.base);
+}
+
 /*
  * Test the export of configured resources as CoRE link format string
  */
@@ -287,6 +690,12 @@ Test *tests_gcoap_tests(void)
         new_TestFixture(test_gcoap__server_get_resp),
         new_TestFixture(test_gcoap__server_con_req),
         new_TestFixture(test_gcoap__server_con_resp),
+        new_TestFixture(test_gcoap__server_block2_resp),
+        new_TestFixture(test_gcoap__server_block1_resp),
+        new_TestFixture(test_gcoap__client_block2_init),
+        new_TestFixture(test_gcoap__client_block2_put_next),
+        new_TestFixture(test_gcoap__client_block2_resp),
+        new_TestFixture(test_gcoap__client_block2_szx),
         new_TestFixture(test_gcoap__server_get_resource_list)
     };
 
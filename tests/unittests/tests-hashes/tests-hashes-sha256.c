@@ -212,6 +212,72 @@ static void test_hashes_sha256_hash_long_sequence(void)
                     hlong_sequence));
 }
 
+static const char long_sequence[] =
+    "RIOT is an open-source microkernel-based operating system, designed"
+    " to match the requirements of Internet of Things (IoT) devices and"
+    " other embedded devices. These requirements include a very low memory"
+    " footprint (on the order of a few kilobytes), high energy efficiency"
+    ", real-time capabilities, communication stacks for both wireless and"
+    " wired networks, and support for a wide range of low-power hardware.";
+
+static void test_hashes_sha256_hash_long_sequence_chunked(void)
+{
+    static unsigned char hash[SHA256_DIGEST_LENGTH];
+    sha256_context_t sha256;
+    size_t len = strlen(long_sequence);
+
+    /* updates crossing block boundaries at every offset */
+    sha256_init(&sha256);
+    for (size_t i = 0; i < len; i += 3) {
+        sha256_update(&sha256, &long_sequence[i], (len - i < 3) ? len - i : 3);
+    }
+    sha256_final(&sha256, hash);
+
+    TEST_ASSERT(memcmp(hlong_sequence, hash, SHA256_DIGEST_LENGTH) == 0);
+}
+
+static void test_hashes_sha256_multi_sequence(void)
+{
+    const void *data[] = {
+        "1234567890_1", "1234567890_2", "1234567890_3", "1234567890_4",
+        "Franz jagt im komplett verwahrlosten Taxi quer durch Bayern",
+        "Frank jagt im komplett verwahrlosten Taxi quer durch Bayern",
+    };
+    const unsigned char *expected[] = {
+        h01, h02, h03, h04, hpangramm, hpangramm_no_more,
+    };
+    unsigned char hash[6][SHA256_DIGEST_LENGTH];
+    void *const digest[] = { hash[0], hash[1], hash[2], hash[3], hash[4], hash[5] };
+
+    sha256_multi(&data[0], strlen(data[0]), &digest[0], 4);
+    sha256_multi(&data[4], strlen(data[4]), &digest[4], 2);
+    for (unsigned i = 0; i < 6; i++) {
+        TEST_ASSERT(memcmp(expected[i], hash[i], SHA256_DIGEST_LENGTH) == 0);
+    }
+}
+
+static void test_hashes_sha256_multi_cross_check(void)
+{
+    /* lengths around the padding and block boundaries */
+    static const size_t lens[] = { 0, 1, 55, 56, 63, 64, 65, 119, 120, 300 };
+    const void *data[SHA256_MULTI_LANES + 1];
+    unsigned char hash[SHA256_MULTI_LANES + 1][SHA256_DIGEST_LENGTH];
+    void *digest[SHA256_MULTI_LANES + 1];
+    unsigned char expected[SHA256_DIGEST_LENGTH];
+
+    for (unsigned i = 0; i < SHA256_MULTI_LANES + 1; i++) {
+        data[i] = &long_sequence[i];
+        digest[i] = hash[i];
+    }
+    for (unsigned j = 0; j < sizeof(lens) / sizeof(lens[0]); j++) {
+        sha256_multi(data, lens[j], digest, SHA256_MULTI_LANES + 1);
+        for (unsigned i = 0; i < SHA256_MULTI_LANES + 1; i++) {
+            sha256(data[i], lens[j], expected);
+            TEST_ASSERT(memcmp(expected, hash[i], SHA256_DIGEST_LENGTH) == 0);
+        }
+    }
+}
+
 Test *tests_hashes_sha256_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -227,6 +293,9 @@ Test *tests_hashes_sha256_tests(void)
         new_TestFixture(test_hashes_sha256_hash_sequence_failing_compare),
 
         new_TestFixture(test_hashes_sha256_hash_long_sequence),
+        new_TestFixture(test_hashes_sha256_hash_long_sequence_chunked),
+        new_TestFixture(test_hashes_sha256_multi_sequence),
+        new_TestFixture(test_hashes_sha256_multi_cross_check),
     };
 
     EMB_UNIT_TESTCALLER(hashes_sha256_tests, NULL, NULL,
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Unittests for parsing DNS replies
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "dns_internal.h"
+
+#include "tests-sock_dns.h"
+
+#define TEST_TTL        (300U)
+
+/* reply to a query for example.org: 12 byte header and 17 byte question,
+ * followed by answers of 12 bytes plus the address */
+#define REPLY_HDR(rcode, ancount)                                       \
+    0x12, 0x34, 0x81, 0x80 | (rcode), 0x00, 0x01, 0x00, (ancount),      \
+    0x00, 0x00, 0x00, 0x00,                                             \
+    0x07, 'e', 'x', 'a', 'm', 'p', 'l', 'e', 0x03, 'o', 'r', 'g', 0x00, \
+    0x00, 0x01, 0x00, 0x01
+#define ANSWER(type, rdlen)                                             \
+    0xc0, 0x0c, 0x00, (type), 0x00, 0x01, 0x00, 0x00, 0x01, 0x2c,       \
+    0x00, (rdlen)
+
+#define ADDR6                                                           \
+    0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00,                     \
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01
+
+/* offset of the low byte of the answer's type */
+#define ANSWER_TYPE_POS (32U)
+
+/* catches writes behind the 16 bytes of an address */
+static struct {
+    uint8_t addr[16];
+    uint8_t guard[16];
+} _out;
+
+static void setup(void)
+{
+    memset(&_out, 0, sizeof(_out));
+}
+
+static void test_sock_dns_parse__a(void)
+{
+    uint8_t reply[] = { REPLY_HDR(0, 1), ANSWER(DNS_TYPE_A, 4),
+                        10, 0, 0, 1 };
+    uint32_t ttl = 0;
+
+    TEST_ASSERT_EQUAL_INT(4, sock_dns_parse_reply(reply, sizeof(reply),
+                                                  _out.addr, AF_INET, &ttl));
+    TEST_ASSERT_EQUAL_INT(TEST_TTL, ttl);
+    TEST_ASSERT_EQUAL_INT(10, _out.addr[0]);
+    TEST_ASSERT_EQUAL_INT(1, _out.addr[3]);
+}
+
+static void test_sock_dns_parse__aaaa(void)
+{
+    uint8_t reply[] = { REPLY_HDR(0, 1), ANSWER(DNS_TYPE_AAAA, 16), ADDR6 };
+    const uint8_t addr6[] = { ADDR6 };
+    uint32_t ttl = 0;
+
+    TEST_ASSERT_EQUAL_INT(16, sock_dns_parse_reply(reply, sizeof(reply),
+                                                   _out.addr, AF_INET6, &ttl));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_out.addr, addr6, sizeof(addr6)));
+}
+
+static void test_sock_dns_parse__oversized_rdlength(void)
+{
+    /* an A record claiming 32 bytes of address */
+    uint8_t reply[] = { REPLY_HDR(0, 1), ANSWER(DNS_TYPE_A, 32), ADDR6, ADDR6 };
+    const uint8_t guard[sizeof(_out.guard)] = { 0 };
+    uint32_t ttl = 0;
+
+    TEST_ASSERT_EQUAL_INT(-EBADMSG, sock_dns_parse_reply(reply, sizeof(reply),
+                                                         _out.addr, AF_INET,
+                                                         &ttl));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_out.guard, guard, sizeof(guard)));
+
+    /* the same for an AAAA record */
+    reply[ANSWER_TYPE_POS] = DNS_TYPE_AAAA;
+    TEST_ASSERT_EQUAL_INT(-EBADMSG, sock_dns_parse_reply(reply, sizeof(reply),
+                                                         _out.addr, AF_INET6,
+                                                         &ttl));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_out.guard, guard, sizeof(guard)));
+}
+
+static void test_sock_dns_parse__undersized_rdlength(void)
+{
+    uint8_t reply[] = { REPLY_HDR(0, 1), ANSWER(DNS_TYPE_AAAA, 4),
+                        10, 0, 0, 1 };
+    uint32_t ttl = 0;
+
+    TEST_ASSERT_EQUAL_INT(-EBADMSG, sock_dns_parse_reply(reply, sizeof(reply),
+                                                         _out.addr, AF_INET6,
+                                                         &ttl));
+}
+
+static void test_sock_dns_parse__truncated(void)
+{
+    uint8_t reply[] = { REPLY_HDR(0, 1), ANSWER(DNS_TYPE_A, 4), 10, 0 };
+    uint32_t ttl = 0;
+
+    TEST_ASSERT_EQUAL_INT(-EBADMSG, sock_dns_parse_reply(reply, sizeof(reply),
+                                                         _out.addr, AF_INET,
+                                                         &ttl));
+}
+
+static void test_sock_dns_reply_cacheable(void)
+{
+    uint8_t nxdomain[] = { REPLY_HDR(DNS_RCODE_NXDOMAIN, 0) };
+    uint8_t nodata[] = { REPLY_HDR(DNS_RCODE_NOERROR, 0) };
+    /* SERVFAIL */
+    uint8_t servfail[] = { REPLY_HDR(2, 0) };
+    uint32_t ttl = 0;
+    int res;
+
+    res = sock_dns_parse_reply(nxdomain, sizeof(nxdomain), _out.addr, AF_INET,
+                               &ttl);
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, res);
+    TEST_ASSERT(sock_dns_reply_cacheable(nxdomain, res));
+    res = sock_dns_parse_reply(nodata, sizeof(nodata), _out.addr, AF_INET,
+                               &ttl);
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, res);
+    TEST_ASSERT(sock_dns_reply_cacheable(nodata, res));
+    res = sock_dns_parse_reply(servfail, sizeof(servfail), _out.addr, AF_INET,
+                               &ttl);
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, res);
+    TEST_ASSERT(!sock_dns_reply_cacheable(servfail, res));
+}
+
+Test *tests_sock_dns_all(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_sock_dns_parse__a),
+        new_TestFixture(test_sock_dns_parse__aaaa),
+        new_TestFixture(test_sock_dns_parse__oversized_rdlength),
+        new_TestFixture(test_sock_dns_parse__undersized_rdlength),
+        new_TestFixture(test_sock_dns_parse__truncated),
+        new_TestFixture(test_sock_dns_reply_cacheable),
+    };
+
+    EMB_UNIT_TESTCALLER(sock_dns_tests, setup, NULL, fixtures);
+    return (Test *)&sock_dns_tests;
+}
+
+void tests_sock_dns(void)
+{
+    TESTS_RUN(tests_sock_dns_all());
+}
+/** @} */
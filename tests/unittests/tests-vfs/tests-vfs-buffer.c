@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Unittests for the vfs_buffer module
+ */
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "embUnit/embUnit.h"
+
+#include "vfs.h"
+
+#include "tests-vfs.h"
+
+#ifdef MODULE_VFS_BUFFER
+
+#define _MOCK_FILE_SIZE     (4 * VFS_BUFFER_SIZE)
+#define _RECORD_SIZE        (10)
+
+/* a single file in RAM, counting the calls of the driver */
+static uint8_t _mock_data[_MOCK_FILE_SIZE];
+static size_t _mock_size;
+static unsigned _mock_reads;
+static unsigned _mock_writes;
+static unsigned _mock_fsyncs;
+
+static ssize_t _mock_read(vfs_file_t *filp, void *dest, size_t nbytes)
+{
+    ++_mock_reads;
+    if ((size_t)filp->pos >= _mock_size) {
+        return 0;
+    }
+    if (nbytes > _mock_size - filp->pos) {
+        nbytes = _mock_size - filp->pos;
+    }
+    memcpy(dest, &_mock_data[filp->pos], nbytes);
+    filp->pos += nbytes;
+    return nbytes;
+}
+
+static ssize_t _mock_write(vfs_file_t *filp, const void *src, size_t nbytes)
+{
+    ++_mock_writes;
+    if ((size_t)filp->pos >= sizeof(_mock_data)) {
+        return -ENOSPC;
+    }
+    if (nbytes > sizeof(_mock_data) - filp->pos) {
+        nbytes = sizeof(_mock_data) - filp->pos;
+    }
+    memcpy(&_mock_data[filp->pos], src, nbytes);
+    filp->pos += nbytes;
+    if ((size_t)filp->pos > _mock_size) {
+        _mock_size = filp->pos;
+    }
+    return nbytes;
+}
+
+static off_t _mock_lseek(vfs_file_t *filp, off_t off, int whence)
+{
+    switch (whence) {
+        case SEEK_SET:
+            break;
+        case SEEK_CUR:
+            off += filp->pos;
+            break;
+        case SEEK_END:
+            off += _mock_size;
+            break;
+        default:
+            return -EINVAL;
+    }
+    if (off < 0) {
+        return -EINVAL;
+    }
+    filp->pos = off;
+    return off;
+}
+
+static int _mock_fsync(vfs_file_t *filp)
+{
+    (void)filp;
+    ++_mock_fsyncs;
+    return 0;
+}
+
+static const vfs_file_ops_t _mock_file_ops = {
+    .fsync = _mock_fsync,
+    .lseek = _mock_lseek,
+    .read  = _mock_read,
+    .write = _mock_write,
+};
+
+static const vfs_file_system_t _mock_file_system = {
+    .f_op = &_mock_file_ops,
+};
+
+static vfs_mount_t _test_vfs_mount_buffer = {
+    .mount_point = "/test",
+    .fs = &_mock_file_system,
+    .private_data = NULL,
+};
+
+static int _fd = -1;
+
+static void setup(void)
+{
+    for (unsigned i = 0; i < sizeof(_mock_data); i++) {
+        _mock_data[i] = i;
+    }
+    _mock_size = sizeof(_mock_data);
+    _mock_reads = 0;
+    _mock_writes = 0;
+    _mock_fsyncs = 0;
+    if (vfs_mount(&_test_vfs_mount_buffer) < 0) {
+        return;
+    }
+    _fd = vfs_open("/test/file", O_RDWR, 0);
+}
+
+static void teardown(void)
+{
+    if (_fd >= 0) {
+        vfs_close(_fd);
+        _fd = -1;
+    }
+    vfs_umount(&_test_vfs_mount_buffer);
+}
+
+static void test_vfs_buffer__write_back(void)
+{
+    static const uint8_t record[_RECORD_SIZE] = "record";
+    unsigned records = VFS_BUFFER_SIZE / _RECORD_SIZE;
+
+    TEST_ASSERT(_fd >= 0);
+    for (unsigned i = 0; i < records; i++) {
+        TEST_ASSERT_EQUAL_INT(_RECORD_SIZE, vfs_write(_fd, record, sizeof(record)));
+    }
+    TEST_ASSERT_EQUAL_INT(0, _mock_writes);
+    /* the next record does not fit anymore */
+    TEST_ASSERT_EQUAL_INT(_RECORD_SIZE, vfs_write(_fd, record, sizeof(record)));
+    TEST_ASSERT_EQUAL_INT(1, _mock_writes);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&_mock_data[(records - 1) * _RECORD_SIZE],
+                                    record, sizeof(record)));
+    TEST_ASSERT_EQUAL_INT(0, vfs_fsync(_fd));
+    TEST_ASSERT_EQUAL_INT(2, _mock_writes);
+    TEST_ASSERT_EQUAL_INT(1, _mock_fsyncs);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&_mock_data[records * _RECORD_SIZE],
+                                    record, sizeof(record)));
+}
+
+static void test_vfs_buffer__write_large(void)
+{
+    static const uint8_t data[VFS_BUFFER_SIZE];
+
+    TEST_ASSERT(_fd >= 0);
+    TEST_ASSERT_EQUAL_INT(sizeof(data), vfs_write(_fd, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_INT(1, _mock_writes);
+}
+
+static void test_vfs_buffer__read_ahead(void)
+{
+    uint8_t buf[_RECORD_SIZE];
+
+    TEST_ASSERT(_fd >= 0);
+    for (unsigned i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL_INT(sizeof(buf), vfs_read(_fd, buf, sizeof(buf)));
+        TEST_ASSERT_EQUAL_INT(i * sizeof(buf), buf[0]);
+    }
+    TEST_ASSERT_EQUAL_INT(1, _mock_reads);
+    /* the position accounts for the data read ahead */
+    TEST_ASSERT_EQUAL_INT(2 * sizeof(buf), vfs_lseek(_fd, 0, SEEK_CUR));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), vfs_read(_fd, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(2 * sizeof(buf), buf[0]);
+}
+
+static void test_vfs_buffer__read_after_write(void)
+{
+    static const uint8_t record[_RECORD_SIZE] = "record";
+    uint8_t buf[_RECORD_SIZE];
+
+    TEST_ASSERT(_fd >= 0);
+    /* read ahead first, the write must happen right behind the read data */
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), vfs_read(_fd, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(sizeof(record), vfs_write(_fd, record, sizeof(record)));
+    TEST_ASSERT_EQUAL_INT(0, vfs_lseek(_fd, 0, SEEK_SET));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), vfs_read(_fd, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0, buf[0]);
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), vfs_read(_fd, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, record, sizeof(record)));
+}
+
+static void test_vfs_buffer__close(void)
+{
+    static const uint8_t record[_RECORD_SIZE] = "record";
+
+    TEST_ASSERT(_fd >= 0);
+    TEST_ASSERT_EQUAL_INT(sizeof(record), vfs_write(_fd, record, sizeof(record)));
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(_fd));
+    _fd = -1;
+    TEST_ASSERT_EQUAL_INT(1, _mock_writes);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_mock_data, record, sizeof(record)));
+}
+
+static void test_vfs_buffer__setbuf(void)
+{
+    static const uint8_t record[_RECORD_SIZE] = "record";
+
+    TEST_ASSERT(_fd >= 0);
+    TEST_ASSERT_EQUAL_INT(sizeof(record), vfs_write(_fd, record, sizeof(record)));
+    TEST_ASSERT_EQUAL_INT(0, vfs_setbuf(_fd, false));
+    TEST_ASSERT_EQUAL_INT(1, _mock_writes);
+    TEST_ASSERT_EQUAL_INT(sizeof(record), vfs_write(_fd, record, sizeof(record)));
+    TEST_ASSERT_EQUAL_INT(2, _mock_writes);
+    TEST_ASSERT_EQUAL_INT(0, vfs_setbuf(_fd, true));
+    TEST_ASSERT_EQUAL_INT(sizeof(record), vfs_write(_fd, record, sizeof(record)));
+    TEST_ASSERT_EQUAL_INT(2, _mock_writes);
+}
+
+static void test_vfs_buffer__pool(void)
+{
+    int fds[VFS_BUFFER_NUMOF];
+
+    TEST_ASSERT(_fd >= 0);
+    /* _fd already holds one buffer */
+    for (unsigned i = 1; i < VFS_BUFFER_NUMOF; i++) {
+        fds[i] = vfs_open("/test/file", O_RDWR, 0);
+        TEST_ASSERT(fds[i] >= 0);
+    }
+    fds[0] = vfs_open("/test/file", O_RDWR, 0);
+    TEST_ASSERT(fds[0] >= 0);
+    /* opened without buffer */
+    TEST_ASSERT_EQUAL_INT(-ENOBUFS, vfs_setbuf(fds[0], true));
+    for (unsigned i = 0; i < VFS_BUFFER_NUMOF; i++) {
+        vfs_close(fds[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(0, vfs_setbuf(_fd, true));
+}
+
+Test *tests_vfs_buffer_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_vfs_buffer__write_back),
+        new_TestFixture(test_vfs_buffer__write_large),
+        new_TestFixture(test_vfs_buffer__read_ahead),
+        new_TestFixture(test_vfs_buffer__read_after_write),
+        new_TestFixture(test_vfs_buffer__close),
+        new_TestFixture(test_vfs_buffer__setbuf),
+        new_TestFixture(test_vfs_buffer__pool),
+    };
+
+    EMB_UNIT_TESTCALLER(vfs_buffer_tests, setup, teardown, fixtures);
+
+    return (Test *)&vfs_buffer_tests;
+}
+#endif /* MODULE_VFS_BUFFER */
+
+/** @} */
@@ -128,6 +128,93 @@ static void test_vfs_constfs_open(void)
     TEST_ASSERT_EQUAL_INT(0, res);
 }
 
+static vfs_mount_t _test_vfs_mount_nested = {
+    .mount_point = "/test/nested",
+    .fs = &constfs_file_system,
+    .private_data = (void *)&fs_data,
+};
+
+static void test_vfs_mount__longest_prefix(void)
+{
+    vfs_mount_t *order[][2] = {
+        { &_test_vfs_mount, &_test_vfs_mount_nested },
+        { &_test_vfs_mount_nested, &_test_vfs_mount },
+    };
+
+    for (unsigned i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        TEST_ASSERT_EQUAL_INT(0, vfs_mount(order[i][0]));
+        TEST_ASSERT_EQUAL_INT(0, vfs_mount(order[i][1]));
+        /* only the nested mount has this file */
+        int fd = vfs_open("/test/nested/test.txt", O_RDONLY, 0);
+        TEST_ASSERT(fd >= 0);
+        if (fd >= 0) {
+            TEST_ASSERT_EQUAL_INT(0, vfs_close(fd));
+        }
+        fd = vfs_open("/test/test.txt", O_RDONLY, 0);
+        TEST_ASSERT(fd >= 0);
+        if (fd >= 0) {
+            TEST_ASSERT_EQUAL_INT(0, vfs_close(fd));
+        }
+        TEST_ASSERT_EQUAL_INT(0, vfs_umount(order[i][0]));
+        TEST_ASSERT_EQUAL_INT(0, vfs_umount(order[i][1]));
+    }
+}
+
+static void test_vfs_umount__busy(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, vfs_mount(&_test_vfs_mount));
+    TEST_ASSERT_EQUAL_INT(0, vfs_mount(&_test_vfs_mount_nested));
+
+    int fd = vfs_open("/test/nested/test.txt", O_RDONLY, 0);
+    TEST_ASSERT(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(-EBUSY, vfs_umount(&_test_vfs_mount_nested));
+
+    /* the busy mount is still found, and before the shorter one */
+    int fd2 = vfs_open("/test/nested/data.bin", O_RDONLY, 0);
+    TEST_ASSERT(fd2 >= 0);
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(fd2));
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(fd));
+
+    TEST_ASSERT_EQUAL_INT(0, vfs_umount(&_test_vfs_mount_nested));
+    fd = vfs_open("/test/nested/test.txt", O_RDONLY, 0);
+    TEST_ASSERT_EQUAL_INT(-ENOENT, fd);
+    if (fd >= 0) {
+        vfs_close(fd);
+    }
+    fd = vfs_open("/test/test.txt", O_RDONLY, 0);
+    TEST_ASSERT(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(fd));
+
+    TEST_ASSERT_EQUAL_INT(0, vfs_umount(&_test_vfs_mount));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, vfs_open("/test/test.txt", O_RDONLY, 0));
+}
+
+static void test_vfs_constfs_open__fd_reuse(void)
+{
+    int res;
+    res = vfs_mount(&_test_vfs_mount);
+    TEST_ASSERT_EQUAL_INT(0, res);
+
+    int fd1 = vfs_open("/test/test.txt", O_RDONLY, 0);
+    TEST_ASSERT(fd1 > STDERR_FILENO);
+    int fd2 = vfs_open("/test/data.bin", O_RDONLY, 0);
+    TEST_ASSERT(fd2 > STDERR_FILENO);
+    TEST_ASSERT(fd1 != fd2);
+    /* a closed fd is handed out again */
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(fd1));
+    int fd3 = vfs_open("/test/data.bin", O_RDONLY, 0);
+    TEST_ASSERT_EQUAL_INT(fd1, fd3);
+    if (fd2 >= 0) {
+        vfs_close(fd2);
+    }
+    if (fd3 >= 0) {
+        vfs_close(fd3);
+    }
+
+    res = vfs_umount(&_test_vfs_mount);
+    TEST_ASSERT_EQUAL_INT(0, res);
+}
+
 static void test_vfs_constfs_read_lseek(void)
 {
     int res;
@@ -209,6 +296,9 @@ Test *tests_vfs_mount_constfs_tests(void)
         new_TestFixture(test_vfs_mount__invalid),
         new_TestFixture(test_vfs_umount__invalid_mount),
         new_TestFixture(test_vfs_constfs_open),
+        new_TestFixture(test_vfs_mount__longest_prefix),
+        new_TestFixture(test_vfs_umount__busy),
+        new_TestFixture(test_vfs_constfs_open__fd_reuse),
         new_TestFixture(test_vfs_constfs_read_lseek),
 #if MODULE_NEWLIB || defined(BOARD_NATIVE)
         new_TestFixture(test_vfs_constfs__posix),